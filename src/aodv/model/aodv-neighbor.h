@@ -75,6 +75,8 @@ public:
   void Purge ();
   /// Schedule m_ntimer.
   void ScheduleTimer ();
+  /// Set the policy used to schedule m_ntimer.
+  void SetSchedulePolicy (Timer::SchedulePolicy policy) { m_ntimer.SetSchedulePolicy (policy); }
   /// Remove all entries
   void Clear () { m_nb.clear (); }
 
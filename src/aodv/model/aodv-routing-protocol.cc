@@ -136,6 +136,7 @@ RoutingProtocol::RoutingProtocol () :
   DestinationOnly (false),
   GratuitousReply (true),
   EnableHello (false),
+  EnableTimerWheel (false),
   m_routingTable (DeletePeriod),
   m_queue (MaxQueueLen, MaxQueueTime),
   m_requestId (0),
@@ -253,6 +254,12 @@ RoutingProtocol::GetTypeId (void)
                    MakeBooleanAccessor (&RoutingProtocol::SetBroadcastEnable,
                                         &RoutingProtocol::GetBroadcastEnable),
                    MakeBooleanChecker ())
+    .AddAttribute ("EnableTimerWheel", "Indicates whether the hello, neighbor and RREQ retry timers, "
+                   "which are rescheduled much more often than they expire, are held in a timer wheel.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RoutingProtocol::SetTimerWheelEnable,
+                                        &RoutingProtocol::GetTimerWheelEnable),
+                   MakeBooleanChecker ())
     .AddAttribute ("UniformRv",
                    "Access to the underlying UniformRandomVariable",
                    StringValue ("ns3::UniformRandomVariable"),
@@ -274,6 +281,14 @@ RoutingProtocol::SetMaxQueueTime (Time t)
   MaxQueueTime = t;
   m_queue.SetQueueTimeout (t);
 }
+void
+RoutingProtocol::SetTimerWheelEnable (bool f)
+{
+  EnableTimerWheel = f;
+  Timer::SchedulePolicy policy = f ? Timer::SCHEDULE_WHEEL : Timer::SCHEDULE_EVENT;
+  m_htimer.SetSchedulePolicy (policy);
+  m_nb.SetSchedulePolicy (policy);
+}
 
 RoutingProtocol::~RoutingProtocol ()
 {
@@ -921,7 +936,7 @@ RoutingProtocol::ScheduleRreqRetry (Ipv4Address dst)
   NS_LOG_FUNCTION (this << dst);
   if (m_addressReqTimer.find (dst) == m_addressReqTimer.end ())
     {
-      Timer timer (Timer::CANCEL_ON_DESTROY);
+      Timer timer (Timer::CANCEL_ON_DESTROY, EnableTimerWheel ? Timer::SCHEDULE_WHEEL : Timer::SCHEDULE_EVENT);
       m_addressReqTimer[dst] = timer;
     }
   m_addressReqTimer[dst].SetFunction (&RoutingProtocol::RouteRequestTimerExpire, this);
@@ -89,6 +89,8 @@ public:
   bool GetHelloEnable () const { return EnableHello; }
   void SetBroadcastEnable (bool f) { EnableBroadcast = f; }
   bool GetBroadcastEnable () const { return EnableBroadcast; }
+  void SetTimerWheelEnable (bool f);
+  bool GetTimerWheelEnable () const { return EnableTimerWheel; }
   //\}
 
  /**
@@ -141,6 +143,7 @@ private:
   bool GratuitousReply;              ///< Indicates whether a gratuitous RREP should be unicast to the node originated route discovery.
   bool EnableHello;                  ///< Indicates whether a hello messages enable
   bool EnableBroadcast;              ///< Indicates whether a a broadcast data packets forwarding enable
+  bool EnableTimerWheel;             ///< Indicates whether the hello, neighbor and RREQ retry timers are held in a timer wheel
   //\}
 
   /// IP protocol
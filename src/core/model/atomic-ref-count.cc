@@ -0,0 +1,36 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "atomic-ref-count.h"
+
+namespace ns3 {
+
+uint32_t AtomicRefCounting::m_enabled = 0;
+
+void
+AtomicRefCounting::Enable (void)
+{
+  __sync_fetch_and_add (&m_enabled, 1);
+}
+
+void
+AtomicRefCounting::Disable (void)
+{
+  NS_ASSERT (m_enabled > 0);
+  __sync_fetch_and_sub (&m_enabled, 1);
+}
+
+} // namespace ns3
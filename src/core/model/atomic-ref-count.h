@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef ATOMIC_REF_COUNT_H
+#define ATOMIC_REF_COUNT_H
+
+#include "empty.h"
+#include "default-deleter.h"
+#include "assert.h"
+#include <stdint.h>
+#include <limits>
+
+namespace ns3 {
+
+/**
+ * \ingroup ptr
+ * \brief switch the counters of AtomicRefCount to atomic updates
+ *
+ * The counters are only updated with atomic instructions, which are
+ * several times more expensive than plain increments, while several
+ * threads may share the objects, that is between a call to Enable and the
+ * matching call to Disable. Both must be called while a single thread
+ * uses these objects, typically before the threads are started and after
+ * they are joined.
+ */
+class AtomicRefCounting
+{
+public:
+  static void Enable (void);
+  static void Disable (void);
+  /**
+   * \returns true if the counters are updated atomically
+   */
+  static bool IsEnabled (void)
+  {
+    return m_enabled != 0;
+  }
+private:
+  static uint32_t m_enabled;
+};
+
+/**
+ * \ingroup ptr
+ * \brief A reference counting class whose counter can be shared by threads
+ *
+ * Same as SimpleRefCount, but the reference count is updated with
+ * atomic instructions while AtomicRefCounting is enabled. This is meant
+ * for the objects which are shared by all the simulations of a process,
+ * such as the accessors, checkers and initial values of the attributes
+ * held by the TypeId registry, or the constructor callbacks: the
+ * simulations run in parallel by ReplicationRunner copy their Ptr
+ * concurrently. The other objects belong to a single simulation and
+ * should keep using SimpleRefCount.
+ */
+template <typename T, typename PARENT = empty, typename DELETER = DefaultDeleter<T> >
+class AtomicRefCount : public PARENT
+{
+public:
+  AtomicRefCount ()
+    : m_count (1)
+  {}
+  AtomicRefCount (const AtomicRefCount &)
+    : m_count (1)
+  {}
+  AtomicRefCount &operator = (const AtomicRefCount &)
+  {
+    return *this;
+  }
+  /**
+   * Increment the reference count. This method should not be called
+   * by user code.
+   */
+  inline void Ref (void) const
+  {
+    NS_ASSERT (m_count < std::numeric_limits<uint32_t>::max());
+    if (AtomicRefCounting::IsEnabled ())
+      {
+        __sync_fetch_and_add (&m_count, 1);
+      }
+    else
+      {
+        m_count++;
+      }
+  }
+  /**
+   * Decrement the reference count. This method should not be called
+   * by user code.
+   */
+  inline void Unref (void) const
+  {
+    uint32_t count;
+    if (AtomicRefCounting::IsEnabled ())
+      {
+        count = __sync_sub_and_fetch (&m_count, 1);
+      }
+    else
+      {
+        count = --m_count;
+      }
+    if (count == 0)
+      {
+        DELETER::Delete (static_cast<T*> (const_cast<AtomicRefCount *> (this)));
+      }
+  }
+  /**
+   * Get the reference count of the object.
+   * Normally not needed; for language bindings.
+   */
+  inline uint32_t GetReferenceCount (void) const
+  {
+    return m_count;
+  }
+  /**
+   *  Noop
+   */
+  static void Cleanup (void) {}
+private:
+  mutable uint32_t m_count;
+};
+
+} // namespace ns3
+
+#endif /* ATOMIC_REF_COUNT_H */
@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include "ptr.h"
 #include "simple-ref-count.h"
+#include "atomic-ref-count.h"
 
 namespace ns3 {
 
@@ -53,7 +54,7 @@ class ObjectBase;
  * Most subclasses of this base class are implemented by the 
  * ATTRIBUTE_HELPER_* macros.
  */
-class AttributeValue : public SimpleRefCount<AttributeValue>
+class AttributeValue : public AtomicRefCount<AttributeValue>
 {
 public:
   AttributeValue ();
@@ -99,7 +100,7 @@ public:
  * of this base class are usually provided through the MakeAccessorHelper
  * template functions, hidden behind an ATTRIBUTE_HELPER_* macro.
  */
-class AttributeAccessor : public SimpleRefCount<AttributeAccessor>
+class AttributeAccessor : public AtomicRefCount<AttributeAccessor>
 {
 public:
   AttributeAccessor ();
@@ -151,7 +152,7 @@ public:
  * Most subclasses of this base class are implemented by the 
  * ATTRIBUTE_HELPER_HEADER and ATTRIBUTE_HELPER_CPP macros.
  */
-class AttributeChecker : public SimpleRefCount<AttributeChecker>
+class AttributeChecker : public AtomicRefCount<AttributeChecker>
 {
 public:
   AttributeChecker ();
@@ -28,6 +28,7 @@
 #include "attribute.h"
 #include "attribute-helper.h"
 #include "simple-ref-count.h"
+#include "atomic-ref-count.h"
 #include <typeinfo>
 
 namespace ns3 {
@@ -75,7 +76,7 @@ struct CallbackTraits<T *>
  * Abstract base class for CallbackImpl
  * Provides reference counting and equality test.
  */
-class CallbackImplBase : public SimpleRefCount<CallbackImplBase>
+class CallbackImplBase : public AtomicRefCount<CallbackImplBase>
 {
 public:
   /** Virtual destructor */
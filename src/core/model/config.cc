@@ -24,9 +24,13 @@
 #include "object-ptr-container.h"
 #include "names.h"
 #include "pointer.h"
+#include "trace-source-accessor.h"
 #include "log.h"
+#include "system-mutex.h"
+#include "replication.h"
 
 #include <sstream>
+#include <map>
 
 NS_LOG_COMPONENT_DEFINE ("Config");
 
@@ -94,27 +98,67 @@ MatchContainer::Set (std::string name, const AttributeValue &value)
       object->SetAttribute (name, value);
     }
 }
+namespace {
+
+/**
+ * The matches of a path are usually many objects of the same few types:
+ * this looks up a trace source once per run of objects of the same type
+ * instead of once per object, which is what ObjectBase::TraceConnect and
+ * friends do.
+ */
+class TraceSourceLookup
+{
+public:
+  TraceSourceLookup ()
+    : m_valid (false)
+  {}
+  Ptr<const TraceSourceAccessor> Get (Ptr<Object> object, std::string name)
+  {
+    TypeId tid = object->GetInstanceTypeId ();
+    if (!m_valid || tid != m_tid)
+      {
+        m_tid = tid;
+        m_accessor = tid.LookupTraceSourceByName (name);
+        m_valid = true;
+      }
+    return m_accessor;
+  }
+private:
+  bool m_valid;
+  TypeId m_tid;
+  Ptr<const TraceSourceAccessor> m_accessor;
+};
+
+} // anonymous namespace
+
 void 
 MatchContainer::Connect (std::string name, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << name << &cb);
   NS_ASSERT (m_objects.size () == m_contexts.size ());
+  TraceSourceLookup lookup;
   for (uint32_t i = 0; i < m_objects.size (); ++i)
     {
-      Ptr<Object> object = m_objects[i];
-      std::string ctx = m_contexts[i] + name;
-      object->TraceConnect (name, ctx, cb);
+      Ptr<const TraceSourceAccessor> accessor = lookup.Get (m_objects[i], name);
+      if (accessor != 0)
+        {
+          std::string ctx = m_contexts[i] + name;
+          accessor->Connect (PeekPointer (m_objects[i]), ctx, cb);
+        }
     }
 }
 void 
 MatchContainer::ConnectWithoutContext (std::string name, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << name << &cb);
-
-  for (Iterator tmp = Begin (); tmp != End (); ++tmp)
+  TraceSourceLookup lookup;
+  for (uint32_t i = 0; i < m_objects.size (); ++i)
     {
-      Ptr<Object> object = *tmp;
-      object->TraceConnectWithoutContext (name, cb);
+      Ptr<const TraceSourceAccessor> accessor = lookup.Get (m_objects[i], name);
+      if (accessor != 0)
+        {
+          accessor->ConnectWithoutContext (PeekPointer (m_objects[i]), cb);
+        }
     }
 }
 void 
@@ -122,21 +166,29 @@ MatchContainer::Disconnect (std::string name, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << name << &cb);
   NS_ASSERT (m_objects.size () == m_contexts.size ());
+  TraceSourceLookup lookup;
   for (uint32_t i = 0; i < m_objects.size (); ++i)
     {
-      Ptr<Object> object = m_objects[i];
-      std::string ctx = m_contexts[i] + name;
-      object->TraceDisconnect (name, ctx, cb);
+      Ptr<const TraceSourceAccessor> accessor = lookup.Get (m_objects[i], name);
+      if (accessor != 0)
+        {
+          std::string ctx = m_contexts[i] + name;
+          accessor->Disconnect (PeekPointer (m_objects[i]), ctx, cb);
+        }
     }
 }
 void 
 MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << name << &cb);
-  for (Iterator tmp = Begin (); tmp != End (); ++tmp)
+  TraceSourceLookup lookup;
+  for (uint32_t i = 0; i < m_objects.size (); ++i)
     {
-      Ptr<Object> object = *tmp;
-      object->TraceDisconnectWithoutContext (name, cb);
+      Ptr<const TraceSourceAccessor> accessor = lookup.Get (m_objects[i], name);
+      if (accessor != 0)
+        {
+          accessor->DisconnectWithoutContext (PeekPointer (m_objects[i]), cb);
+        }
     }
 }
 
@@ -148,8 +200,12 @@ public:
   ArrayMatcher (std::string element);
   bool Matches (uint32_t i) const;
 private:
+  void Parse (std::string element);
   bool StringToUint32 (std::string str, uint32_t *value) const;
   std::string m_element;
+  // the ranges of indices matched by m_element, parsed once so that
+  // matching the elements of a large container does not parse strings.
+  std::vector<std::pair<uint32_t, uint32_t> > m_ranges;
 };
 
 
@@ -157,66 +213,61 @@ ArrayMatcher::ArrayMatcher (std::string element)
   : m_element (element)
 {
   NS_LOG_FUNCTION (this << element);
+  Parse (element);
 }
-bool
-ArrayMatcher::Matches (uint32_t i) const
+void
+ArrayMatcher::Parse (std::string element)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      m_ranges.push_back (std::make_pair (0, 0xffffffff));
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      Parse (element.substr (0, tmp-0));
+      Parse (element.substr (tmp+1, element.size () - (tmp + 1)));
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min) && 
           StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
+          min <= max)
         {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
-        }
-      else
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  if (StringToUint32 (element, &value))
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-      return true;
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator j = m_ranges.begin ();
+       j != m_ranges.end (); j++)
+    {
+      if (i >= j->first && i <= j->second)
+        {
+          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+          return true;
+        }
     }
   NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
   return false;
@@ -233,6 +284,107 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
 }
 
 
+namespace {
+
+/**
+ * The attributes of a TypeId which can be followed by a config path,
+ * that is the attributes which hold a pointer to an Object or a
+ * container of Objects.
+ */
+struct ObjectAttribute
+{
+  struct TypeId::AttributeInformation info;
+  bool isContainer;
+  // the accessor of a container, if its items can be read one by one
+  const ObjectPtrContainerAccessor *container;
+};
+
+/**
+ * \param tid a TypeId
+ * \returns the attributes of tid which can be followed by a config path,
+ *          in the order of their declaration.
+ *
+ * The list is built with the checkers of the attributes on the first
+ * call for a TypeId and kept until the tables of the registered TypeIds
+ * change (see TypeId::GetTablesGeneration). The lists built before a
+ * change are not freed, since a Resolver may still be walking them.
+ * The cache is shared by the replications run in parallel, hence the
+ * lock.
+ */
+const std::vector<ObjectAttribute> &
+GetObjectAttributes (TypeId tid)
+{
+  typedef std::pair<uint32_t, uint16_t> Key;
+  static SystemMutex mutex;
+  static std::map<Key, std::vector<ObjectAttribute> > cache;
+  CriticalSection critical (mutex);
+  Key key = std::make_pair (TypeId::GetTablesGeneration (), tid.GetUid ());
+  std::map<Key, std::vector<ObjectAttribute> >::iterator i = cache.find (key);
+  if (i != cache.end ())
+    {
+      return i->second;
+    }
+  std::vector<ObjectAttribute> attributes;
+  for (uint32_t j = 0; j < tid.GetAttributeN (); j++)
+    {
+      ObjectAttribute attribute;
+      attribute.info = tid.GetAttribute (j);
+      const AttributeChecker *checker = PeekPointer (attribute.info.checker);
+      attribute.container = 0;
+      if (dynamic_cast<const PointerChecker *> (checker) != 0)
+        {
+          attribute.isContainer = false;
+        }
+      else if (dynamic_cast<const ObjectPtrContainerChecker *> (checker) != 0)
+        {
+          attribute.isContainer = true;
+          if ((attribute.info.flags & TypeId::ATTR_GET) && attribute.info.accessor->HasGetter ())
+            {
+              attribute.container = 
+                dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (attribute.info.accessor));
+            }
+        }
+      else
+        {
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
+          continue;
+        }
+      attributes.push_back (attribute);
+    }
+  return cache.insert (std::make_pair (key, attributes)).first->second;
+}
+
+/**
+ * \param object an object
+ * \param info an attribute of the type of object
+ * \param value the value of the attribute
+ *
+ * Like ObjectBase::GetAttribute, without looking up the attribute by name.
+ */
+void
+GetObjectAttribute (Ptr<Object> object, const struct TypeId::AttributeInformation &info,
+                    AttributeValue &value)
+{
+  if ((info.flags & TypeId::ATTR_GET) && info.accessor->HasGetter ()
+      && info.accessor->Get (PeekPointer (object), value))
+    {
+      return;
+    }
+  // let ObjectBase report the error
+  object->GetAttribute (info.name, value);
+}
+
+} // anonymous namespace
+
+/**
+ * Resolve a config path against the object graph.
+ *
+ * The path is split once into its segments and each segment which looks
+ * up an aggregated object keeps the TypeId it refers to, so that the
+ * resolution of a path with wildcards does not parse strings for each
+ * object it visits.
+ */
 class Resolver
 {
 public:
@@ -241,14 +393,49 @@ public:
 
   void Resolve (Ptr<Object> root);
 private:
+  struct Segment
+  {
+    std::string item;
+    // the item is a call to GetObject: "$tid"
+    bool isGetObject;
+    // the TypeId of a call to GetObject, looked up on first use
+    bool hasTid;
+    TypeId tid;
+  };
+
   void Canonicalize (void);
-  void DoResolve (std::string path, Ptr<Object> root);
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void Compile (void);
+  TypeId GetSegmentTypeId (uint32_t segment);
+  void DoResolve (uint32_t segment, Ptr<Object> root);
+  void DoArrayResolve (uint32_t segment, Ptr<Object> root, const ObjectAttribute &attribute);
+  void DoArrayResolveOne (uint32_t segment, uint32_t index, Ptr<Object> object);
+  // resolves the items of a container which match a segment
+  class ArrayVisitor : public ObjectPtrContainerAccessor::ItemVisitor
+  {
+  public:
+    ArrayVisitor (Resolver *resolver, uint32_t segment, const ArrayMatcher &matcher)
+      : m_resolver (resolver),
+        m_segment (segment),
+        m_matcher (matcher)
+    {}
+    virtual void Visit (uint32_t index, Ptr<Object> item)
+    {
+      if (m_matcher.Matches (index))
+        {
+          m_resolver->DoArrayResolveOne (m_segment, index, item);
+        }
+    }
+  private:
+    Resolver *m_resolver;
+    uint32_t m_segment;
+    const ArrayMatcher &m_matcher;
+  };
   void DoResolveOne (Ptr<Object> object);
   std::string GetResolvedPath (void) const;
   virtual void DoOne (Ptr<Object> object, std::string path) = 0;
   std::vector<std::string> m_workStack;
   std::string m_path;
+  std::vector<Segment> m_segments;
 };
 
 Resolver::Resolver (std::string path)
@@ -256,6 +443,7 @@ Resolver::Resolver (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
   Canonicalize ();
+  Compile ();
 }
 Resolver::~Resolver ()
 {
@@ -281,12 +469,43 @@ Resolver::Canonicalize (void)
     }
 }
 
+void
+Resolver::Compile (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  std::string::size_type start = 0;
+  std::string::size_type next = m_path.find ("/", start + 1);
+  while (next != std::string::npos)
+    {
+      Segment segment;
+      segment.item = m_path.substr (start + 1, next - start - 1);
+      segment.isGetObject = segment.item.find ("$") == 0;
+      segment.hasTid = false;
+      m_segments.push_back (segment);
+      start = next;
+      next = m_path.find ("/", start + 1);
+    }
+}
+
+TypeId
+Resolver::GetSegmentTypeId (uint32_t segment)
+{
+  Segment &s = m_segments[segment];
+  if (!s.hasTid)
+    {
+      s.tid = TypeId::LookupByName (s.item.substr (1, s.item.size () - 1));
+      s.hasTid = true;
+    }
+  return s.tid;
+}
+
 void 
 Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -312,13 +531,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (uint32_t segment, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << segment << root);
 
-  if (next == std::string::npos)
+  if (segment == m_segments.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name 
@@ -334,8 +551,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const std::string &item = m_segments[segment].item;
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -346,11 +562,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (item.find ("Names") == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (segment + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -367,7 +582,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (segment + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -383,43 +598,38 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       return;
     }
-  std::string::size_type dollarPos = item.find ("$");
-  if (dollarPos == 0)
+  if (m_segments[segment].isGetObject)
     {
       // This is a call to GetObject
-      std::string tidString = item.substr (1, item.size () - 1);
-      NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      TypeId tid = GetSegmentTypeId (segment);
+      NS_LOG_DEBUG ("GetObject="<<tid.GetName ()<<" on path="<<GetResolvedPath ());
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
-          NS_LOG_DEBUG ("GetObject ("<<tidString<<") failed on path="<<GetResolvedPath ());
+          NS_LOG_DEBUG ("GetObject ("<<tid.GetName ()<<") failed on path="<<GetResolvedPath ());
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (segment + 1, object);
       m_workStack.pop_back ();
     }
   else 
     {
       // this is a normal attribute.
-      TypeId tid = root->GetInstanceTypeId ();
+      const std::vector<ObjectAttribute> &attributes = GetObjectAttributes (root->GetInstanceTypeId ());
       bool foundMatch = false;
-      for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+      for (std::vector<ObjectAttribute>::const_iterator i = attributes.begin (); i != attributes.end (); i++)
         {
-          struct TypeId::AttributeInformation info;
-          info = tid.GetAttribute(i);
+          const struct TypeId::AttributeInformation &info = i->info;
           if (info.name != item && item != "*")
             {
               continue;
             }
-          // attempt to cast to a pointer checker.
-          const PointerChecker *ptr = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-          if (ptr != 0)
+          if (!i->isContainer)
             {
               NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
               PointerValue ptr;
-              root->GetAttribute (info.name, ptr);
+              GetObjectAttribute (root, info, ptr);
               Ptr<Object> object = ptr.Get<Object> ();
               if (object == 0)
                 {
@@ -430,24 +640,17 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
                 }
               foundMatch = true;
               m_workStack.push_back (info.name);
-              DoResolve (pathLeft, object);
+              DoResolve (segment + 1, object);
               m_workStack.pop_back ();
             }
-          // attempt to cast to an object vector.
-          const ObjectPtrContainerChecker *vectorChecker = 
-            dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-          if (vectorChecker != 0)
+          else
             {
-              NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
+              NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath ());
               foundMatch = true;
-              ObjectPtrContainerValue vector;
-              root->GetAttribute (info.name, vector);
               m_workStack.push_back (info.name);
-              DoArrayResolve (pathLeft, vector);
+              DoArrayResolve (segment + 1, root, *i);
               m_workStack.pop_back ();
             }
-          // this could be anything else and we don't know what to do with it.
-          // So, we just ignore it.
         }
       if (!foundMatch)
         {
@@ -458,34 +661,45 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (uint32_t segment, Ptr<Object> root, const ObjectAttribute &attribute)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION(this << segment << root);
+  if (segment == m_segments.size ())
     {
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  ArrayMatcher matcher = ArrayMatcher (m_segments[segment].item);
+  if (attribute.container != 0)
+    {
+      // walk the container in place instead of copying it.
+      ArrayVisitor visitor (this, segment, matcher);
+      if (attribute.container->ForEachItem (PeekPointer (root), visitor))
+        {
+          return;
+        }
+    }
+  ObjectPtrContainerValue container;
+  GetObjectAttribute (root, attribute.info, container);
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
       if (matcher.Matches ((*it).first))
         {
-          std::ostringstream oss;
-          oss << (*it).first;
-          m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
-          m_workStack.pop_back ();
+          DoArrayResolveOne (segment, (*it).first, (*it).second);
         }
     }
 }
 
+void
+Resolver::DoArrayResolveOne (uint32_t segment, uint32_t index, Ptr<Object> object)
+{
+  std::ostringstream oss;
+  oss << index;
+  m_workStack.push_back (oss.str ());
+  DoResolve (segment + 1, object);
+  m_workStack.pop_back ();
+}
 
 class ConfigImpl 
 {
@@ -637,6 +851,36 @@ ConfigImpl::GetRootNamespaceObject (uint32_t i) const
   return m_roots[i];
 }
 
+// the config of the replication run by the calling thread
+static __thread ConfigImpl *g_replicationConfig = 0;
+
+static void
+DeleteReplicationConfig (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  delete g_replicationConfig;
+  g_replicationConfig = 0;
+}
+
+/**
+ * \returns the config of the calling thread: each replication has its
+ *          own root namespace objects.
+ */
+static ConfigImpl *
+GetConfigImpl (void)
+{
+  if (Replication::IsActive ())
+    {
+      if (g_replicationConfig == 0)
+        {
+          g_replicationConfig = new ConfigImpl ();
+          Replication::AtExit (MakeCallback (&DeleteReplicationConfig));
+        }
+      return g_replicationConfig;
+    }
+  return Singleton<ConfigImpl>::Get ();
+}
+
 namespace Config {
 
 void Reset (void)
@@ -662,7 +906,7 @@ void Reset (void)
 void Set (std::string path, const AttributeValue &value)
 {
   NS_LOG_FUNCTION (path << &value);
-  Singleton<ConfigImpl>::Get ()->Set (path, value);
+  GetConfigImpl ()->Set (path, value);
 }
 void SetDefault (std::string name, const AttributeValue &value)
 {
@@ -717,53 +961,53 @@ bool SetGlobalFailSafe (std::string name, const AttributeValue &value)
 void ConnectWithoutContext (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (path << &cb);
-  Singleton<ConfigImpl>::Get ()->ConnectWithoutContext (path, cb);
+  GetConfigImpl ()->ConnectWithoutContext (path, cb);
 }
 void DisconnectWithoutContext (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (path << &cb);
-  Singleton<ConfigImpl>::Get ()->DisconnectWithoutContext (path, cb);
+  GetConfigImpl ()->DisconnectWithoutContext (path, cb);
 }
 void 
 Connect (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (path << &cb);
-  Singleton<ConfigImpl>::Get ()->Connect (path, cb);
+  GetConfigImpl ()->Connect (path, cb);
 }
 void 
 Disconnect (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (path << &cb);
-  Singleton<ConfigImpl>::Get ()->Disconnect (path, cb);
+  GetConfigImpl ()->Disconnect (path, cb);
 }
 Config::MatchContainer LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (path);
-  return Singleton<ConfigImpl>::Get ()->LookupMatches (path);
+  return GetConfigImpl ()->LookupMatches (path);
 }
 
 void RegisterRootNamespaceObject (Ptr<Object> obj)
 {
   NS_LOG_FUNCTION (obj);
-  Singleton<ConfigImpl>::Get ()->RegisterRootNamespaceObject (obj);
+  GetConfigImpl ()->RegisterRootNamespaceObject (obj);
 }
 
 void UnregisterRootNamespaceObject (Ptr<Object> obj)
 {
   NS_LOG_FUNCTION (obj);
-  Singleton<ConfigImpl>::Get ()->UnregisterRootNamespaceObject (obj);
+  GetConfigImpl ()->UnregisterRootNamespaceObject (obj);
 }
 
 uint32_t GetRootNamespaceObjectN (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  return Singleton<ConfigImpl>::Get ()->GetRootNamespaceObjectN ();
+  return GetConfigImpl ()->GetRootNamespaceObjectN ();
 }
 
 Ptr<Object> GetRootNamespaceObject (uint32_t i)
 {
   NS_LOG_FUNCTION (i);
-  return Singleton<ConfigImpl>::Get ()->GetRootNamespaceObject (i);
+  return GetConfigImpl ()->GetRootNamespaceObject (i);
 }
 
 } // namespace Config
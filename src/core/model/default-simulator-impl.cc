@@ -25,10 +25,16 @@
 
 #include "ptr.h"
 #include "pointer.h"
+#include "boolean.h"
+#include "double.h"
+#include "string.h"
 #include "assert.h"
 #include "log.h"
 
 #include <cmath>
+#include <fstream>
+#include <iostream>
+#include <vector>
 
 // Note:  Logging in this file is largely avoided due to the
 // number of calls that are made to these functions and the possibility
@@ -46,6 +52,32 @@ DefaultSimulatorImpl::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::DefaultSimulatorImpl")
     .SetParent<SimulatorImpl> ()
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("Profile",
+                   "Record the wall-clock time spent running each type of event and "
+                   "the events of each context, and print a report when the simulator "
+                   "is destroyed.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DefaultSimulatorImpl::SetProfile,
+                                        &DefaultSimulatorImpl::GetProfile),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ProfileFile",
+                   "The file where the profile is written. The profile goes to "
+                   "the standard error when this is empty.",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::m_profileFile),
+                   MakeStringChecker ())
+    .AddAttribute ("RemoveCancelledEvents",
+                   "Remove the cancelled events from the event list right away "
+                   "when the scheduler can do so cheaply.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&DefaultSimulatorImpl::m_removeCancelled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CompactionThreshold",
+                   "The fraction of the event list made of cancelled events above "
+                   "which the event list is compacted. 1 disables the compaction.",
+                   DoubleValue (0.75),
+                   MakeDoubleAccessor (&DefaultSimulatorImpl::m_compactionThreshold),
+                   MakeDoubleChecker<double> (0.0, 1.0))
   ;
   return tid;
 }
@@ -64,13 +96,21 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentTs = 0;
   m_currentContext = 0xffffffff;
   m_unscheduledEvents = 0;
-  m_eventsWithContextEmpty = true;
+  m_removeCancelled = true;
+  m_compactionThreshold = 0.75;
+  m_cancelStats.cancelled = 0;
+  m_cancelStats.removed = 0;
+  m_cancelStats.dead = 0;
+  m_cancelStats.compacted = 0;
+  m_cancelStats.compactions = 0;
   m_main = SystemThread::Self();
+  m_profiler = 0;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
 {
   NS_LOG_FUNCTION (this);
+  delete m_profiler;
 }
 
 void
@@ -80,9 +120,20 @@ DefaultSimulatorImpl::DoDispose (void)
   while (!m_events->IsEmpty ())
     {
       Scheduler::Event next = m_events->RemoveNext ();
+      // an EventId kept across Simulator::Destroy must see its event
+      // as expired, or cancelling it would look for it in the event
+      // list of the next simulation
+      next.impl->Cancel ();
       next.impl->Unref ();
     }
   m_events = 0;
+  InjectedEventQueue::Item event;
+  while (m_eventsWithContext.Pop (&event))
+    {
+      event.event->Unref ();
+    }
+  delete m_profiler;
+  m_profiler = 0;
   SimulatorImpl::DoDispose ();
 }
 void
@@ -99,12 +150,54 @@ DefaultSimulatorImpl::Destroy ()
           ev->Invoke ();
         }
     }
+  if (m_profiler != 0)
+    {
+      if (m_profileFile.empty ())
+        {
+          m_profiler->Report (std::clog);
+        }
+      else
+        {
+          std::ofstream os (m_profileFile.c_str ());
+          m_profiler->Report (os);
+        }
+    }
+}
+
+void
+DefaultSimulatorImpl::SetProfile (bool profile)
+{
+  NS_LOG_FUNCTION (this << profile);
+  if (profile && m_profiler == 0)
+    {
+      m_profiler = new SimulatorProfiler ();
+      if (m_events != 0)
+        {
+          m_events = m_profiler->Wrap (m_events);
+        }
+    }
+  else if (!profile && m_profiler != 0)
+    {
+      if (m_events != 0)
+        {
+          m_events = SimulatorProfiler::Unwrap (m_events);
+        }
+      delete m_profiler;
+      m_profiler = 0;
+    }
+}
+
+bool
+DefaultSimulatorImpl::GetProfile (void) const
+{
+  return m_profiler != 0;
 }
 
 void
 DefaultSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
 {
   NS_LOG_FUNCTION (this << schedulerFactory);
+  m_schedulerFactory = schedulerFactory;
   Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
 
   if (m_events != 0)
@@ -115,6 +208,10 @@ DefaultSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
           scheduler->Insert (next);
         }
     }
+  if (m_profiler != 0)
+    {
+      scheduler = m_profiler->Wrap (scheduler);
+    }
   m_events = scheduler;
 }
 
@@ -125,19 +222,37 @@ DefaultSimulatorImpl::GetSystemId (void) const
   return 0;
 }
 
+template <bool PROFILE>
 void
 DefaultSimulatorImpl::ProcessOneEvent (void)
 {
+  if (PROFILE)
+    {
+      m_profiler->RecordQueueDepth (m_unscheduledEvents);
+    }
   Scheduler::Event next = m_events->RemoveNext ();
 
   NS_ASSERT (next.key.m_ts >= m_currentTs);
   m_unscheduledEvents--;
+  if (m_cancelStats.dead != 0 && next.impl->IsCancelled ())
+    {
+      m_cancelStats.dead--;
+    }
 
   NS_LOG_LOGIC ("handle " << next.key.m_ts);
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (PROFILE)
+    {
+      uint64_t start = SimulatorProfiler::GetTime ();
+      next.impl->Invoke ();
+      m_profiler->RecordEvent (next.impl, next.key.m_context, SimulatorProfiler::GetTime () - start);
+    }
+  else
+    {
+      next.impl->Invoke ();
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -152,22 +267,14 @@ DefaultSimulatorImpl::IsFinished (void) const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
-  if (m_eventsWithContextEmpty)
+  if (m_eventsWithContext.IsEmpty ())
     {
       return;
     }
 
-  // swap queues
-  EventsWithContext eventsWithContext;
-  {
-    CriticalSection cs (m_eventsWithContextMutex);
-    m_eventsWithContext.swap(eventsWithContext);
-    m_eventsWithContextEmpty = true;
-  }
-  while (!eventsWithContext.empty ())
+  InjectedEventQueue::Item event;
+  while (m_eventsWithContext.Pop (&event))
     {
-       EventWithContext event = eventsWithContext.front ();
-       eventsWithContext.pop_front ();
        Scheduler::Event ev;
        ev.impl = event.event;
        ev.key.m_ts = m_currentTs + event.timestamp;
@@ -188,9 +295,19 @@ DefaultSimulatorImpl::Run (void)
   ProcessEventsWithContext ();
   m_stop = false;
 
-  while (!m_events->IsEmpty () && !m_stop) 
+  if (m_profiler != 0)
     {
-      ProcessOneEvent ();
+      while (!m_events->IsEmpty () && !m_stop) 
+        {
+          ProcessOneEvent<true> ();
+        }
+    }
+  else
+    {
+      while (!m_events->IsEmpty () && !m_stop) 
+        {
+          ProcessOneEvent<false> ();
+        }
     }
 
   // If the simulator stopped naturally by lack of events, make a
@@ -255,15 +372,11 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, E
     }
   else
     {
-      EventWithContext ev;
+      InjectedEventQueue::Item ev;
       ev.context = context;
       ev.timestamp = time.GetTimeStep ();
       ev.event = event;
-      {
-        CriticalSection cs (m_eventsWithContextMutex);
-        m_eventsWithContext.push_back(ev);
-        m_eventsWithContextEmpty = false;
-      }
+      m_eventsWithContext.Push (ev);
     }
 }
 
@@ -350,12 +463,72 @@ DefaultSimulatorImpl::Remove (const EventId &id)
 void
 DefaultSimulatorImpl::Cancel (const EventId &id)
 {
-  if (!IsExpired (id))
+  if (IsExpired (id))
+    {
+      return;
+    }
+  m_cancelStats.cancelled++;
+  // destroy events are not in the event list, which is gone once the
+  // simulator is disposed
+  if (id.GetUid () == 2 || m_events == 0)
     {
       id.PeekEventImpl ()->Cancel ();
+      return;
+    }
+  if (m_removeCancelled && m_events->HasFastRemove ())
+    {
+      Remove (id);
+      m_cancelStats.removed++;
+      return;
+    }
+  id.PeekEventImpl ()->Cancel ();
+  m_cancelStats.dead++;
+  // a few dead events are cheaper to pop than to compact
+  if (m_cancelStats.dead >= 1024
+      && m_cancelStats.dead > m_compactionThreshold * m_unscheduledEvents)
+    {
+      Compact ();
     }
 }
 
+void
+DefaultSimulatorImpl::Compact (void)
+{
+  NS_LOG_FUNCTION (this << m_cancelStats.dead << m_unscheduledEvents);
+  // the live events go to a new scheduler: the calendar and ladder
+  // schedulers do not take back events older than the last one they
+  // removed. The events come out in order, which is the cheapest order
+  // to insert them in most schedulers.
+  Ptr<Scheduler> live = m_schedulerFactory.Create<Scheduler> ();
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      if (next.impl->IsCancelled ())
+        {
+          next.impl->Unref ();
+          m_unscheduledEvents--;
+          m_cancelStats.compacted++;
+        }
+      else
+        {
+          live->Insert (next);
+        }
+    }
+  if (m_profiler != 0)
+    {
+      live = m_profiler->Wrap (live);
+    }
+  m_events = live;
+  m_cancelStats.dead = 0;
+  m_cancelStats.compactions++;
+}
+
+DefaultSimulatorImpl::CancelStats
+DefaultSimulatorImpl::GetCancelStats (void) const
+{
+  return m_cancelStats;
+}
+
 bool
 DefaultSimulatorImpl::IsExpired (const EventId &ev) const
 {
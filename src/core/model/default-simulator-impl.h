@@ -25,22 +25,56 @@
 #include "scheduler.h"
 #include "event-impl.h"
 #include "system-thread.h"
-#include "ns3/system-mutex.h"
+#include "injected-event-queue.h"
+#include "simulator-profiler.h"
 
 #include "ptr.h"
 
 #include <list>
+#include <string>
 
 namespace ns3 {
 
 /**
  * \ingroup simulator
+ *
+ * When the Profile attribute is set, the simulator records the
+ * wall-clock time spent running each type of event and the events of
+ * each context, the cost of the scheduler operations and the number
+ * of pending events, and prints a report when Simulator::Destroy is
+ * called (see SimulatorProfiler). Profiling is decided once per call
+ * to Simulator::Run, so it costs nothing per event when it is off.
+ *
+ * A cancelled event is removed from the event list right away when the
+ * scheduler can do so cheaply (see Scheduler::HasFastRemove), unless the
+ * RemoveCancelledEvents attribute is false. Otherwise, it stays in the
+ * event list until it comes up, and the event list is compacted when the
+ * cancelled events make up more than the CompactionThreshold fraction of
+ * it, so that timers which are cancelled and rescheduled over and over do
+ * not fill the event list with dead entries.
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
 public:
   static TypeId GetTypeId (void);
 
+  /**
+   * \brief statistics of the cancelled events
+   */
+  struct CancelStats
+  {
+    /// number of events cancelled before they expired
+    uint64_t cancelled;
+    /// number of cancelled events removed from the event list right away
+    uint64_t removed;
+    /// number of cancelled events currently left in the event list
+    uint64_t dead;
+    /// number of cancelled events dropped by the compactions
+    uint64_t compacted;
+    /// number of compactions of the event list
+    uint64_t compactions;
+  };
+
   DefaultSimulatorImpl ();
   ~DefaultSimulatorImpl ();
 
@@ -63,25 +97,31 @@ public:
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
 
+  /**
+   * \returns the statistics of the events cancelled since the creation
+   *          of the simulator.
+   */
+  CancelStats GetCancelStats (void) const;
+
 private:
   virtual void DoDispose (void);
+  template <bool PROFILE>
   void ProcessOneEvent (void);
+  void SetProfile (bool profile);
+  bool GetProfile (void) const;
   void ProcessEventsWithContext (void);
+  void Compact (void);
  
-  struct EventWithContext {
-    uint32_t context;
-    uint64_t timestamp;
-    EventImpl *event;
-  };
-  typedef std::list<struct EventWithContext> EventsWithContext;
-  EventsWithContext m_eventsWithContext;
-  bool m_eventsWithContextEmpty;
-  SystemMutex m_eventsWithContextMutex;
+  // events scheduled by other threads, with a timestamp relative
+  // to the time at which they are inserted in m_events
+  InjectedEventQueue m_eventsWithContext;
 
   typedef std::list<EventId> DestroyEvents;
   DestroyEvents m_destroyEvents;
   bool m_stop;
   Ptr<Scheduler> m_events;
+  // creates the schedulers of m_events, see Compact
+  ObjectFactory m_schedulerFactory;
 
   uint32_t m_uid;
   uint32_t m_currentUid;
@@ -91,7 +131,15 @@ private:
   // not counting the "destroy" events; this is used for validation
   int m_unscheduledEvents;
 
+  bool m_removeCancelled;
+  double m_compactionThreshold;
+  CancelStats m_cancelStats;
+
   SystemThread::ThreadId m_main;
+
+  // not null when profiling
+  SimulatorProfiler *m_profiler;
+  std::string m_profileFile;
 };
 
 } // namespace ns3
@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "injected-event-queue.h"
+#include "assert.h"
+#include "log.h"
+
+NS_LOG_COMPONENT_DEFINE ("InjectedEventQueue");
+
+namespace ns3 {
+
+namespace {
+uint32_t
+Load (const uint32_t *p)
+{
+  uint32_t v = *static_cast<const volatile uint32_t *> (p);
+  __sync_synchronize ();
+  return v;
+}
+void
+Store (uint32_t *p, uint32_t v)
+{
+  __sync_synchronize ();
+  *static_cast<volatile uint32_t *> (p) = v;
+}
+} // anonymous namespace
+
+InjectedEventQueue::InjectedEventQueue (uint32_t capacity)
+  : m_enqueuePos (0),
+    m_dequeuePos (0),
+    m_overflowing (false)
+{
+  NS_LOG_FUNCTION (this << capacity);
+  uint32_t size = 2;
+  while (size < capacity)
+    {
+      size <<= 1;
+    }
+  m_cells = new Cell[size];
+  m_mask = size - 1;
+  for (uint32_t i = 0; i < size; i++)
+    {
+      m_cells[i].sequence = i;
+    }
+}
+
+InjectedEventQueue::~InjectedEventQueue ()
+{
+  NS_LOG_FUNCTION (this);
+  delete [] m_cells;
+}
+
+bool
+InjectedEventQueue::TryPush (const Item &item)
+{
+  uint32_t pos = Load (&m_enqueuePos);
+  Cell *cell;
+  while (true)
+    {
+      cell = &m_cells[pos & m_mask];
+      int32_t diff = static_cast<int32_t> (Load (&cell->sequence) - pos);
+      if (diff == 0)
+        {
+          // the slot is free: claim it
+          if (__sync_bool_compare_and_swap (&m_enqueuePos, pos, pos + 1))
+            {
+              break;
+            }
+          pos = Load (&m_enqueuePos);
+        }
+      else if (diff < 0)
+        {
+          // the consumer did not read this slot yet: the ring is full
+          return false;
+        }
+      else
+        {
+          // another producer claimed this slot
+          pos = Load (&m_enqueuePos);
+        }
+    }
+  cell->item = item;
+  Store (&cell->sequence, pos + 1);
+  return true;
+}
+
+void
+InjectedEventQueue::Push (const Item &item)
+{
+  if (!*static_cast<volatile bool *> (&m_overflowing) && TryPush (item))
+    {
+      return;
+    }
+  CriticalSection cs (m_overflowMutex);
+  // the ring may have been drained in the meantime, but once an event
+  // of this producer went to the overflow list, the next ones must too.
+  m_overflow.push_back (item);
+  m_overflowing = true;
+}
+
+bool
+InjectedEventQueue::Pop (Item *item)
+{
+  Cell *cell = &m_cells[m_dequeuePos & m_mask];
+  if (Load (&cell->sequence) == m_dequeuePos + 1)
+    {
+      *item = cell->item;
+      Store (&cell->sequence, m_dequeuePos + m_mask + 1);
+      m_dequeuePos++;
+      return true;
+    }
+  // a slot claimed by a producer which did not publish it yet must be
+  // read before the overflow list, which holds newer events.
+  if (Load (&m_enqueuePos) != m_dequeuePos
+      || !*static_cast<volatile bool *> (&m_overflowing))
+    {
+      return false;
+    }
+  CriticalSection cs (m_overflowMutex);
+  if (m_overflow.empty ())
+    {
+      return false;
+    }
+  *item = m_overflow.front ();
+  m_overflow.pop_front ();
+  m_overflowing = !m_overflow.empty ();
+  return true;
+}
+
+bool
+InjectedEventQueue::IsEmpty (void) const
+{
+  return Load (&m_enqueuePos) == m_dequeuePos
+         && !*static_cast<const volatile bool *> (&m_overflowing);
+}
+
+} // namespace ns3
@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef INJECTED_EVENT_QUEUE_H
+#define INJECTED_EVENT_QUEUE_H
+
+#include "system-mutex.h"
+#include <stdint.h>
+#include <list>
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ * \brief the queue of the events scheduled by other threads than the
+ *        simulation thread
+ *
+ * Any number of threads can push events while the simulation thread
+ * pops them. The events are stored in a bounded ring whose slots are
+ * claimed with a compare-and-swap and published with a sequence number,
+ * so that neither the producers nor the consumer ever take a lock while
+ * the ring has free slots. When the ring is full, the events go to an
+ * overflow list protected by a mutex until the consumer empties it,
+ * which keeps the events of each producer in order.
+ */
+class InjectedEventQueue
+{
+public:
+  /**
+   * \brief an event pushed by another thread
+   */
+  struct Item
+  {
+    uint32_t context;
+    // the meaning of the timestamp is left to the simulator
+    uint64_t timestamp;
+    EventImpl *event;
+  };
+
+  /**
+   * \param capacity the number of slots of the ring, rounded up to a
+   *        power of two
+   */
+  InjectedEventQueue (uint32_t capacity = 4096);
+  ~InjectedEventQueue ();
+
+  /**
+   * \param item the event to queue
+   *
+   * Can be called by any thread.
+   */
+  void Push (const Item &item);
+  /**
+   * \param item the oldest event of the queue, if any
+   * \returns false if the queue was empty
+   *
+   * Must only be called by the consumer thread.
+   */
+  bool Pop (Item *item);
+  /**
+   * \returns true if no event is queued
+   *
+   * Must only be called by the consumer thread.
+   */
+  bool IsEmpty (void) const;
+
+private:
+  struct Cell
+  {
+    uint32_t sequence;
+    Item item;
+  };
+  bool TryPush (const Item &item);
+
+  Cell *m_cells;
+  uint32_t m_mask;
+  // next slot to claim by the producers
+  uint32_t m_enqueuePos;
+  // next slot to read by the consumer
+  uint32_t m_dequeuePos;
+
+  SystemMutex m_overflowMutex;
+  std::list<Item> m_overflow;
+  // true while m_overflow is not empty
+  bool m_overflowing;
+};
+
+} // namespace ns3
+
+#endif /* INJECTED_EVENT_QUEUE_H */
@@ -46,6 +46,18 @@ int64x64_t::Umul (uint128_t a, uint128_t b)
   uint128_t result;
   uint128_t hiPart,loPart,midPart;
 
+  // Fast path: when an operand is an integer, as the Time in Time * double,
+  // the product is exact and a.l b.l is zero: skip the zero products.
+  if (aL == 0 || bL == 0)
+    {
+      uint128_t integer = aL == 0 ? aH : bH;
+      uint128_t other = aL == 0 ? b : a;
+      hiPart = integer * (other >> 64);
+      NS_ABORT_MSG_IF ((hiPart & MASK_HI) != 0,
+                       "High precision 128 bits multiplication error: multiplication overflow.");
+      return (hiPart << 64) + integer * (other & MASK_LO);
+    }
+
   // Multiplying (a.h 2^64 + a.l) x (b.h 2^64 + b.l) =
   //			2^128 a.h b.h + 2^64*(a.h b.l+b.h a.l) + a.l b.l
   // get the low part a.l b.l
@@ -78,6 +90,23 @@ int64x64_t::Div (int64x64_t const &o)
 uint128_t
 int64x64_t::Divu (uint128_t a, uint128_t b)
 {
+  // Fast path: an integer divisor, as in Time / Time. Then the quotient
+  // is a / b.h, truncated as below, and is computed with a single division,
+  // or without any 128 bits division when both operands are integers
+  // and the quotient is an integer too.
+  if ((b & MASK_LO) == 0)
+    {
+      uint64_t bH = b >> 64;
+      if ((a & MASK_LO) == 0)
+        {
+          uint64_t aH = a >> 64;
+          if (aH % bH == 0)
+            {
+              return ((uint128_t)(aH / bH)) << 64;
+            }
+        }
+      return a / bH;
+    }
   uint128_t quo = a / b;
   uint128_t rem = (a % b);
   uint128_t result = quo << 64;
@@ -117,6 +146,11 @@ int64x64_t::UmulByInvert (uint128_t a, uint128_t b)
   al = a & MASK_LO;
   bl = b & MASK_LO;
   hi = ah * bh;
+  if (al == 0)
+    {
+      // Fast path: an integer, such as a Time converted to another unit
+      return hi + ((ah * bl) >> 64);
+    }
   mid = ah * bl + al * bh;
   mid >>= 64;
   result = hi + mid;
@@ -43,6 +43,57 @@ namespace ns3 {
      ub = negB ? _cairo_uint128_negate (ub) : ub;                          \
      (negA && !negB) || (!negA && negB); })
 
+/**
+ * \returns (hi 2^64 + lo) / d, for hi < d
+ *
+ * The long division of two 64 bits digits by one, with 32 bits
+ * half-digits, from Hacker's Delight (divlu).
+ */
+static uint64_t
+Divlu (uint64_t hi, uint64_t lo, uint64_t d)
+{
+  const uint64_t b = ((uint64_t)1) << 32;
+  // normalize the divisor
+  int s = 0;
+  while ((d & (((uint64_t)1) << 63)) == 0)
+    {
+      d <<= 1;
+      s++;
+    }
+  uint64_t vn1 = d >> 32;
+  uint64_t vn0 = d & 0xffffffff;
+  uint64_t un32 = s == 0 ? hi : (hi << s) | (lo >> (64 - s));
+  uint64_t un10 = lo << s;
+  uint64_t un1 = un10 >> 32;
+  uint64_t un0 = un10 & 0xffffffff;
+  // first half-digit of the quotient
+  uint64_t q1 = un32 / vn1;
+  uint64_t rhat = un32 - q1 * vn1;
+  while (q1 >= b || q1 * vn0 > b * rhat + un1)
+    {
+      q1--;
+      rhat += vn1;
+      if (rhat >= b)
+        {
+          break;
+        }
+    }
+  // second half-digit, from the remainder (which fits in 64 bits)
+  uint64_t un21 = un32 * b + un1 - q1 * d;
+  uint64_t q0 = un21 / vn1;
+  rhat = un21 - q0 * vn1;
+  while (q0 >= b || q0 * vn0 > b * rhat + un0)
+    {
+      q0--;
+      rhat += vn1;
+      if (rhat >= b)
+        {
+          break;
+        }
+    }
+  return q1 * b + q0;
+}
+
 void
 int64x64_t::Mul (int64x64_t const &o)
 {
@@ -64,6 +115,21 @@ int64x64_t::Umul (cairo_uint128_t a, cairo_uint128_t b)
   cairo_uint128_t result;
   cairo_uint128_t hiPart,loPart,midPart;
 
+  // Fast path: when an operand is an integer, as the Time in Time * double,
+  // the product is exact and a.l b.l is zero: skip the zero products.
+  if (a.lo == 0 || b.lo == 0)
+    {
+      cairo_uint64_t integer = a.lo == 0 ? a.hi : b.hi;
+      cairo_uint128_t other = a.lo == 0 ? b : a;
+      hiPart = _cairo_uint64x64_128_mul (integer, other.hi);
+      NS_ABORT_MSG_IF (hiPart.hi != 0,
+                       "High precision 128 bits multiplication error: multiplication overflow.");
+      midPart = _cairo_uint64x64_128_mul (integer, other.lo);
+      result.lo = midPart.lo;
+      result.hi = _cairo_uint64_add (hiPart.lo, midPart.hi);
+      return result;
+    }
+
   // Multiplying (a.h 2^64 + a.l) x (b.h 2^64 + b.l) =
   //			2^128 a.h b.h + 2^64*(a.h b.l+b.h a.l) + a.l b.l
   // get the low part a.l b.l
@@ -96,6 +162,15 @@ int64x64_t::Div (int64x64_t const &o)
 cairo_uint128_t
 int64x64_t::Udiv (cairo_uint128_t a, cairo_uint128_t b)
 {
+  // Fast path: an integer divisor, as in Time / Time. Then the quotient
+  // is a / b.h, truncated as below, and is computed with 64 bits divisions.
+  if (b.lo == 0)
+    {
+      cairo_uint128_t result;
+      result.hi = a.hi / b.hi;
+      result.lo = Divlu (a.hi % b.hi, a.lo, b.hi);
+      return result;
+    }
   cairo_uquorem128_t qr = _cairo_uint128_divrem (a, b);
   cairo_uint128_t result = _cairo_uint128_lsl (qr.quo, 64);
   // Now, manage the remainder
@@ -132,6 +207,14 @@ int64x64_t::UmulByInvert (cairo_uint128_t a, cairo_uint128_t b)
   cairo_uint128_t result;
   cairo_uint128_t hi, mid;
   hi = _cairo_uint64x64_128_mul (a.hi, b.hi);
+  if (a.lo == 0)
+    {
+      // Fast path: an integer, such as a Time converted to another unit
+      mid = _cairo_uint64x64_128_mul (a.hi, b.lo);
+      mid.lo = mid.hi;
+      mid.hi = 0;
+      return _cairo_uint128_add (hi, mid);
+    }
   mid = _cairo_uint128_add (_cairo_uint64x64_128_mul (a.hi, b.lo),
                             _cairo_uint64x64_128_mul (a.lo, b.hi));
   mid.lo = mid.hi;
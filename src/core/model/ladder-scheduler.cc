@@ -0,0 +1,373 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+namespace {
+// end of a list of nodes
+const uint32_t NONE = 0xffffffff;
+// a bucket with more events than this is spread into a new rung
+const uint32_t THRESHOLD = 50;
+const uint32_t MAX_RUNGS = 8;
+const uint32_t MAX_BUCKETS = 1 << 20;
+
+bool
+KeyGreater (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return a.key > b.key;
+}
+} // anonymous namespace
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .AddConstructor<LadderScheduler> ()
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_free (NONE),
+    m_top (NONE),
+    m_topCount (0),
+    m_topMin (0),
+    m_topMax (0),
+    m_topStart (0),
+    m_nRungs (0),
+    m_size (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+LadderScheduler::AllocNode (const Event &ev)
+{
+  uint32_t node;
+  if (m_free != NONE)
+    {
+      node = m_free;
+      m_free = m_nodes[node].next;
+    }
+  else
+    {
+      node = m_nodes.size ();
+      m_nodes.push_back (Node ());
+    }
+  m_nodes[node].ev = ev;
+  m_nodes[node].next = NONE;
+  return node;
+}
+void
+LadderScheduler::FreeNode (uint32_t node)
+{
+  m_nodes[node].next = m_free;
+  m_free = node;
+}
+
+void
+LadderScheduler::PushTop (uint32_t node)
+{
+  uint64_t ts = m_nodes[node].ev.key.m_ts;
+  if (m_topCount == 0)
+    {
+      m_topMin = ts;
+      m_topMax = ts;
+    }
+  else
+    {
+      m_topMin = std::min (m_topMin, ts);
+      m_topMax = std::max (m_topMax, ts);
+    }
+  m_nodes[node].next = m_top;
+  m_top = node;
+  m_topCount++;
+}
+
+void
+LadderScheduler::PushBottom (const Event &ev)
+{
+  m_bottom.push_back (ev);
+  std::push_heap (m_bottom.begin (), m_bottom.end (), &KeyGreater);
+}
+
+uint32_t
+LadderScheduler::FindRung (uint64_t ts) const
+{
+  for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+      const Rung &rung = m_rungs[i];
+      if (ts >= rung.start + rung.current * rung.width)
+        {
+          return i;
+        }
+    }
+  return m_nRungs;
+}
+
+void
+LadderScheduler::CreateRung (uint32_t head, uint64_t start, uint64_t width, uint64_t nBuckets)
+{
+  NS_LOG_FUNCTION (this << start << width << nBuckets);
+  NS_ASSERT (width > 0 && nBuckets > 0 && nBuckets <= MAX_BUCKETS);
+  if (m_nRungs == m_rungs.size ())
+    {
+      m_rungs.push_back (Rung ());
+    }
+  Rung &rung = m_rungs[m_nRungs];
+  m_nRungs++;
+  rung.start = start;
+  rung.width = width;
+  rung.current = 0;
+  rung.buckets.assign (nBuckets, NONE);
+  while (head != NONE)
+    {
+      Node &node = m_nodes[head];
+      uint32_t next = node.next;
+      uint32_t bucket = (node.ev.key.m_ts - start) / width;
+      NS_ASSERT (bucket < nBuckets);
+      node.next = rung.buckets[bucket];
+      rung.buckets[bucket] = head;
+      head = next;
+    }
+}
+
+void
+LadderScheduler::FillBottom (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_bottom.empty () && m_size > 0);
+  while (true)
+    {
+      if (m_nRungs == 0)
+        {
+          NS_ASSERT (m_topCount > 0);
+          uint32_t head = m_top;
+          uint32_t count = m_topCount;
+          m_top = NONE;
+          m_topCount = 0;
+          // about one event per bucket
+          uint64_t width = (m_topMax - m_topMin) / count + 1;
+          uint64_t nBuckets = (m_topMax - m_topMin) / width + 1;
+          if (nBuckets > MAX_BUCKETS)
+            {
+              width = (m_topMax - m_topMin) / MAX_BUCKETS + 1;
+              nBuckets = (m_topMax - m_topMin) / width + 1;
+            }
+          CreateRung (head, m_topMin, width, nBuckets);
+          const Rung &first = m_rungs[0];
+          m_topStart = first.start + first.buckets.size () * first.width;
+        }
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.current < rung.buckets.size ()
+             && rung.buckets[rung.current] == NONE)
+        {
+          rung.current++;
+        }
+      if (rung.current == rung.buckets.size ())
+        {
+          m_nRungs--;
+          continue;
+        }
+      uint32_t head = rung.buckets[rung.current];
+      rung.buckets[rung.current] = NONE;
+      uint64_t bucketStart = rung.start + rung.current * rung.width;
+      uint64_t bucketWidth = rung.width;
+      rung.current++;
+
+      uint32_t count = 0;
+      uint64_t min = m_nodes[head].ev.key.m_ts;
+      uint64_t max = min;
+      for (uint32_t i = head; i != NONE; i = m_nodes[i].next)
+        {
+          uint64_t ts = m_nodes[i].ev.key.m_ts;
+          min = std::min (min, ts);
+          max = std::max (max, ts);
+          count++;
+        }
+      if (count > THRESHOLD && min != max && m_nRungs < MAX_RUNGS)
+        {
+          // The new rung splits this bucket in THRESHOLD buckets at
+          // most, whatever its number of events, and events inserted
+          // later in the range of this bucket go to the new rung since
+          // the cursor of this rung moved past it.
+          uint64_t width = (bucketWidth + THRESHOLD - 1) / THRESHOLD;
+          CreateRung (head, bucketStart, width, (bucketWidth + width - 1) / width);
+          continue;
+        }
+      while (head != NONE)
+        {
+          uint32_t next = m_nodes[head].next;
+          m_bottom.push_back (m_nodes[head].ev);
+          FreeNode (head);
+          head = next;
+        }
+      std::make_heap (m_bottom.begin (), m_bottom.end (), &KeyGreater);
+      return;
+    }
+}
+
+void
+LadderScheduler::Clear (void)
+{
+  NS_ASSERT (m_size == 0 && m_topCount == 0 && m_bottom.empty ());
+  m_nRungs = 0;
+  m_topStart = 0;
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  m_size++;
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      PushTop (AllocNode (ev));
+      return;
+    }
+  uint32_t i = FindRung (ts);
+  if (i < m_nRungs)
+    {
+      Rung &rung = m_rungs[i];
+      uint32_t bucket = (ts - rung.start) / rung.width;
+      NS_ASSERT (bucket < rung.buckets.size ());
+      uint32_t node = AllocNode (ev);
+      m_nodes[node].next = rung.buckets[bucket];
+      rung.buckets[bucket] = node;
+      return;
+    }
+  PushBottom (ev);
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  return m_size == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  if (m_bottom.empty ())
+    {
+      // Moving events down the ladder does not change the content
+      // of the queue, only where each event is stored.
+      const_cast<LadderScheduler *> (this)->FillBottom ();
+    }
+  return m_bottom.front ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  if (m_bottom.empty ())
+    {
+      FillBottom ();
+    }
+  std::pop_heap (m_bottom.begin (), m_bottom.end (), &KeyGreater);
+  Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  m_size--;
+  if (m_size == 0)
+    {
+      Clear ();
+    }
+  return ev;
+}
+
+bool
+LadderScheduler::RemoveFromList (uint32_t *head, const Event &ev)
+{
+  uint32_t *link = head;
+  while (*link != NONE)
+    {
+      Node &node = m_nodes[*link];
+      if (node.ev.key.m_uid == ev.key.m_uid)
+        {
+          NS_ASSERT (node.ev.impl == ev.impl);
+          uint32_t found = *link;
+          *link = node.next;
+          FreeNode (found);
+          return true;
+        }
+      link = &node.next;
+    }
+  return false;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      bool found = RemoveFromList (&m_top, ev);
+      NS_ASSERT (found);
+      m_topCount--;
+    }
+  else
+    {
+      uint32_t i = FindRung (ts);
+      if (i < m_nRungs)
+        {
+          Rung &rung = m_rungs[i];
+          uint32_t bucket = (ts - rung.start) / rung.width;
+          bool found = RemoveFromList (&rung.buckets[bucket], ev);
+          NS_ASSERT (found);
+        }
+      else
+        {
+          uint32_t j = 0;
+          while (m_bottom[j].key.m_uid != ev.key.m_uid)
+            {
+              j++;
+              NS_ASSERT (j < m_bottom.size ());
+            }
+          m_bottom[j] = m_bottom.back ();
+          m_bottom.pop_back ();
+          std::make_heap (m_bottom.begin (), m_bottom.end (), &KeyGreater);
+        }
+    }
+  m_size--;
+  if (m_size == 0)
+    {
+      Clear ();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * "Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh and
+ * Ian Li-Jin Thng (ACM TOMACS, 2005).
+ *
+ * Events are kept in three tiers:
+ *  - Top: an unsorted list of the events far in the future,
+ *  - Ladder: a stack of rungs, each rung being an array of buckets
+ *    covering a time range. The first rung is created from Top when
+ *    needed, with about one event per bucket, and a bucket holding too
+ *    many events is spread into a new rung which splits the bucket in
+ *    at most THRESHOLD (50) finer buckets instead of being sorted,
+ *  - Bottom: a small binary heap of the earliest events, from which
+ *    events are dequeued.
+ *
+ * Only Bottom is ever ordered, and each bucket is heapified once when it
+ * is moved there, which gives amortized O(1) insert and remove-next
+ * whatever the number of pending events. Events with the same
+ * timestamp are dequeued in uid order, like with the other schedulers.
+ *
+ * All the events held in Top and in the rungs are stored in
+ * singly-linked lists whose nodes live in a single contiguous array
+ * recycled through a free list, so that moving events between tiers
+ * does not allocate memory.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  LadderScheduler ();
+  virtual ~LadderScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+private:
+  struct Node
+  {
+    Event ev;
+    uint32_t next;
+  };
+  struct Rung
+  {
+    // timestamp of the start of bucket 0
+    uint64_t start;
+    // duration of a bucket
+    uint64_t width;
+    // index of the first bucket which was not yet consumed
+    uint32_t current;
+    // head of the list of events of each bucket
+    std::vector<uint32_t> buckets;
+  };
+
+  uint32_t AllocNode (const Event &ev);
+  void FreeNode (uint32_t node);
+  void PushTop (uint32_t node);
+  void PushBottom (const Event &ev);
+  bool RemoveFromList (uint32_t *head, const Event &ev);
+  uint32_t FindRung (uint64_t ts) const;
+  void CreateRung (uint32_t head, uint64_t start, uint64_t width, uint64_t nBuckets);
+  void FillBottom (void);
+  void Clear (void);
+
+  std::vector<Node> m_nodes;
+  uint32_t m_free;
+
+  uint32_t m_top;
+  uint32_t m_topCount;
+  uint64_t m_topMin;
+  uint64_t m_topMax;
+  // events with a timestamp greater or equal are stored in Top
+  uint64_t m_topStart;
+
+  std::vector<Rung> m_rungs;
+  // number of rungs in use in m_rungs
+  uint32_t m_nRungs;
+
+  // a heap whose first element is the next event
+  std::vector<Event> m_bottom;
+
+  uint32_t m_size;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
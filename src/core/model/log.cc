@@ -22,10 +22,28 @@
 #include <list>
 #include <utility>
 #include <iostream>
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <map>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <iterator>
 #include "assert.h"
 #include "ns3/core-config.h"
 #include "fatal-error.h"
 
+#ifdef HAVE_PTHREAD_H
+#include "system-mutex.h"
+#endif
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #ifdef HAVE_GETENV
 #include <cstring>
 #endif
@@ -38,6 +56,7 @@ namespace ns3 {
 
 LogTimePrinter g_logTimePrinter = 0;
 LogNodePrinter g_logNodePrinter = 0;
+LogStampGetter g_logStampGetter = 0;
 
 typedef std::list<std::pair <std::string, LogComponent *> > ComponentList;
 typedef std::list<std::pair <std::string, LogComponent *> >::iterator ComponentListI;
@@ -60,6 +79,19 @@ ComponentList *GetComponentList (void)
 PrintList::PrintList ()
 {
 #ifdef HAVE_GETENV
+  char *ringBuffer = getenv ("NS_LOG_RING_BUFFER");
+  if (ringBuffer != 0 && std::strlen (ringBuffer) != 0)
+    {
+      char *size = getenv ("NS_LOG_RING_BUFFER_SIZE");
+      if (size != 0)
+        {
+          LogRingBufferEnable (ringBuffer, std::strtoul (size, 0, 10));
+        }
+      else
+        {
+          LogRingBufferEnable (ringBuffer);
+        }
+    }
   char *envVar = getenv ("NS_LOG");
   if (envVar == 0)
     {
@@ -272,8 +304,8 @@ LogComponent::Name (void) const
   return m_name;
 }
 
-std::string
-LogComponent::GetLevelLabel(const enum LogLevel level) const
+static std::string
+LevelLabel (const enum LogLevel level)
 {
   if (level == LOG_ERROR)
     {
@@ -307,6 +339,12 @@ LogComponent::GetLevelLabel(const enum LogLevel level) const
     }
 }
 
+std::string
+LogComponent::GetLevelLabel(const enum LogLevel level) const
+{
+  return LevelLabel (level);
+}
+
 void 
 LogComponentEnable (char const *name, enum LogLevel level)
 {
@@ -578,6 +616,962 @@ LogNodePrinter LogGetNodePrinter (void)
   return g_logNodePrinter;
 }
 
+void LogSetStampGetter (LogStampGetter getter)
+{
+  g_logStampGetter = getter;
+}
+LogStampGetter LogGetStampGetter (void)
+{
+  return g_logStampGetter;
+}
+
+
+/*
+ * The file of a log ring buffer holds a RingHeader, a table of the call
+ * sites, and the ring of records. A site is stored as its size, its
+ * identifier, its LogRecord::Kind, and the names of its component and
+ * function, null-terminated. A record is a RecordHeader followed by the
+ * encoded arguments of the message, each a tag and a value; the
+ * records never wrap around the end of the ring, which is padded with
+ * a record of site 0 instead.
+ *
+ * Several threads record messages at the same time: a thread reserves
+ * the space of its record by moving the head with a compare-and-swap,
+ * forgetting the oldest records first if needed, then copies its
+ * record, and sets its end last, which marks the record as complete.
+ * The oldest record is only forgotten once it is complete.
+ */
+namespace {
+
+const char RING_BUFFER_MAGIC[8] = { 'N', 'S', '3', 'L', 'O', 'G', 'R', 'B' };
+const uint32_t RING_BUFFER_VERSION = 2;
+const uint32_t RING_BUFFER_SITES_SIZE = 1 << 20;
+// set in the flags of the records logged without a simulation time
+// and context, that is outside of a simulation.
+const uint32_t RECORD_NO_STAMP = 0x01000000;
+const uint32_t RECORD_LEVEL_MASK = 0x00ffffff;
+
+struct RingHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t headerSize;
+  uint64_t sitesSize;
+  uint64_t sitesUsed;
+  uint64_t ringSize;
+  // the number of bytes written in the ring since it was created
+  uint64_t head;
+  // the number of bytes written before the oldest record
+  uint64_t tail;
+};
+
+struct RecordHeader
+{
+  // including this header, a multiple of 16
+  uint32_t size;
+  uint32_t site;
+  // the position of the end of the record in the ring, as the head,
+  // set once the record is complete
+  uint64_t end;
+  double time;
+  uint32_t context;
+  uint32_t flags;
+};
+
+struct Site
+{
+  uint32_t kind;
+  std::string component;
+  std::string function;
+};
+
+struct RingBuffer
+{
+  RingHeader *header;
+  char *sites;
+  char *ring;
+  uint64_t mapSize;
+  std::string filename;
+};
+
+RingBuffer *g_ringBuffer = 0;
+
+std::vector<Site> *
+GetSites (void)
+{
+  static std::vector<Site> sites;
+  return &sites;
+}
+
+#ifdef HAVE_PTHREAD_H
+// serializes the registration of the sites and the installation of
+// the context buffer
+SystemMutex *
+GetLogMutex (void)
+{
+  static SystemMutex mutex;
+  return &mutex;
+}
+#endif
+
+// the context prefix of the record of the current thread, while
+// NS_LOG_APPEND_CONTEXT runs
+__thread std::string *g_context = 0;
+
+/*
+ * std::clog writes to one of these buffers once a record has captured a
+ * context prefix: what a thread writes while it captures a context
+ * prefix goes to the prefix, and the rest goes to the former buffer of
+ * std::clog, the target. A buffer is never changed, so that std::clog
+ * can be pointed back at it after it was pointed at another buffer.
+ */
+class ContextStreamBuf : public std::streambuf
+{
+public:
+  ContextStreamBuf (std::streambuf *target)
+    : m_target (target)
+  {
+  }
+  std::streambuf *const m_target;
+protected:
+  virtual int overflow (int c)
+  {
+    if (c == traits_type::eof ())
+      {
+        return traits_type::not_eof (c);
+      }
+    if (g_context != 0)
+      {
+        g_context->push_back (traits_type::to_char_type (c));
+        return c;
+      }
+    return m_target->sputc (traits_type::to_char_type (c));
+  }
+  virtual std::streamsize xsputn (const char *s, std::streamsize n)
+  {
+    if (g_context != 0)
+      {
+        g_context->append (s, n);
+        return n;
+      }
+    return m_target->sputn (s, n);
+  }
+  virtual int sync (void)
+  {
+    return m_target->pubsync ();
+  }
+};
+
+// Point std::clog at the ContextStreamBuf of its current buffer. The
+// buffers are never deleted, since std::clog may still use them when
+// the program exits.
+void
+InstallContextStreamBuf (void)
+{
+  static std::map<std::streambuf *, ContextStreamBuf *> *buffers =
+    new std::map<std::streambuf *, ContextStreamBuf *> ();
+  std::streambuf *target = std::clog.rdbuf ();
+  if (dynamic_cast<ContextStreamBuf *> (target) != 0)
+    {
+      return;
+    }
+  std::map<std::streambuf *, ContextStreamBuf *>::iterator i = buffers->find (target);
+  if (i == buffers->end ())
+    {
+      i = buffers->insert (std::make_pair (target, new ContextStreamBuf (target))).first;
+    }
+  std::clog.rdbuf (i->second);
+}
+
+// called with the log mutex held
+void
+WriteSite (uint32_t id, const Site &site)
+{
+  RingHeader *header = g_ringBuffer->header;
+  uint32_t size = 3 * sizeof (uint32_t) + site.component.size () + site.function.size () + 2;
+  size = (size + 3) & ~3;
+  if (header->sitesUsed + size > header->sitesSize)
+    {
+      // the messages of this site will be dumped without their names
+      return;
+    }
+  char *buffer = g_ringBuffer->sites + header->sitesUsed;
+  std::memset (buffer, 0, size);
+  std::memcpy (buffer, &size, sizeof (uint32_t));
+  std::memcpy (buffer + 4, &id, sizeof (uint32_t));
+  std::memcpy (buffer + 8, &site.kind, sizeof (uint32_t));
+  std::memcpy (buffer + 12, site.component.c_str (), site.component.size ());
+  std::memcpy (buffer + 13 + site.component.size (), site.function.c_str (), site.function.size ());
+  header->sitesUsed += size;
+}
+
+uint32_t
+RegisterSite (char const *component, char const *function, uint32_t kind, uint32_t *siteId)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection critical (*GetLogMutex ());
+#endif
+  if (*siteId != 0)
+    {
+      // registered by another thread
+      return *siteId;
+    }
+  std::vector<Site> *sites = GetSites ();
+  Site site;
+  site.kind = kind;
+  site.component = component;
+  site.function = function;
+  sites->push_back (site);
+  uint32_t id = sites->size ();
+  if (g_ringBuffer != 0)
+    {
+      WriteSite (id, site);
+    }
+  // the site is complete before the other threads see its identifier
+  __sync_synchronize ();
+  *siteId = id;
+  return id;
+}
+
+// Forget the oldest record of the ring, once it is complete. Returns
+// false if it is not complete yet.
+bool
+ForgetOldest (uint64_t tail)
+{
+  RingHeader *header = g_ringBuffer->header;
+  char const *oldest = g_ringBuffer->ring + tail % header->ringSize;
+  uint64_t end = *reinterpret_cast<volatile uint64_t const *> (oldest + 8);
+  // read the size after the end, which is set last
+  __sync_synchronize ();
+  uint32_t size;
+  std::memcpy (&size, oldest, sizeof (size));
+  if (end != tail + size)
+    {
+      return false;
+    }
+  // another thread may have forgotten it already
+  __sync_bool_compare_and_swap (&header->tail, tail, end);
+  return true;
+}
+
+void
+WriteRecord (char const *data, uint32_t size)
+{
+  if (g_ringBuffer == 0)
+    {
+      return;
+    }
+  RingHeader *header = g_ringBuffer->header;
+  uint64_t ringSize = header->ringSize;
+  if (size > ringSize / 2)
+    {
+      return;
+    }
+  uint64_t head;
+  uint64_t position;
+  uint64_t needed;
+  while (true)
+    {
+      // the tail is read first, so that it is never past the head
+      uint64_t tail = *reinterpret_cast<volatile uint64_t *> (&header->tail);
+      __sync_synchronize ();
+      head = *reinterpret_cast<volatile uint64_t *> (&header->head);
+      position = head % ringSize;
+      needed = size;
+      if (position + size > ringSize)
+        {
+          needed += ringSize - position;
+        }
+      if (head + needed - tail > ringSize)
+        {
+          // forget the oldest records until there is room for the new one
+          ForgetOldest (tail);
+          continue;
+        }
+      if (__sync_bool_compare_and_swap (&header->head, head, head + needed))
+        {
+          break;
+        }
+    }
+  char *ring = g_ringBuffer->ring;
+  if (position + size > ringSize)
+    {
+      struct RecordHeader padding;
+      std::memset (&padding, 0, sizeof (padding));
+      padding.size = ringSize - position;
+      // the ring size and the positions are multiples of 16, so there
+      // is always room for the size, the site and the end of the padding
+      std::memcpy (ring + position, &padding, 2 * sizeof (uint32_t));
+      __sync_synchronize ();
+      *reinterpret_cast<volatile uint64_t *> (ring + position + 8) = head + padding.size;
+      head += padding.size;
+      position = 0;
+    }
+  uint64_t end = head + size;
+  std::memcpy (ring + position, data, size);
+  __sync_synchronize ();
+  *reinterpret_cast<volatile uint64_t *> (ring + position + 8) = end;
+}
+
+// Print the message of a record as NS_LOG would have printed it on
+// std::clog.
+void
+PrintRecord (std::ostream &os, const RecordHeader &record, char const *args, uint32_t size,
+             const std::map<uint32_t, Site> &sites)
+{
+  std::ostringstream line;
+  Site site;
+  site.kind = LogRecord::MESSAGE;
+  site.component = "?";
+  site.function = "?";
+  std::map<uint32_t, Site>::const_iterator i = sites.find (record.site);
+  if (i != sites.end ())
+    {
+      site = i->second;
+    }
+  bool stamp = (record.flags & RECORD_NO_STAMP) == 0;
+  if (stamp && (record.flags & LOG_PREFIX_TIME))
+    {
+      line << record.time << "s ";
+    }
+  if (stamp && (record.flags & LOG_PREFIX_NODE))
+    {
+      if (record.context == 0xffffffff)
+        {
+          line << "-1";
+        }
+      else
+        {
+          line << record.context;
+        }
+      line << " ";
+    }
+
+  uint32_t offset = 0;
+  bool prefixed = false;
+  while (offset < size && args[offset] != 0)
+    {
+      char tag = args[offset];
+      offset++;
+      if (!prefixed && tag != 'x')
+        {
+          if (site.kind != LogRecord::MESSAGE)
+            {
+              line << site.component << ":" << site.function << "(";
+            }
+          else
+            {
+              if (record.flags & LOG_PREFIX_FUNC)
+                {
+                  line << site.component << ":" << site.function << "(): ";
+                }
+              if (record.flags & LOG_PREFIX_LEVEL)
+                {
+                  line << "[" << LevelLabel ((enum LogLevel)(record.flags & RECORD_LEVEL_MASK)) << "] ";
+                }
+            }
+          prefixed = true;
+        }
+      switch (tag)
+        {
+        case 'i':
+          {
+            int64_t v;
+            std::memcpy (&v, args + offset, sizeof (v));
+            line << v;
+            offset += sizeof (v);
+          }
+          break;
+        case 'u':
+          {
+            uint64_t v;
+            std::memcpy (&v, args + offset, sizeof (v));
+            line << v;
+            offset += sizeof (v);
+          }
+          break;
+        case 'd':
+          {
+            double v;
+            std::memcpy (&v, args + offset, sizeof (v));
+            line << v;
+            offset += sizeof (v);
+          }
+          break;
+        case 'c':
+          line << args[offset];
+          offset++;
+          break;
+        case 'b':
+          line << (args[offset] != 0);
+          offset++;
+          break;
+        case 'p':
+          {
+            uint64_t v;
+            std::memcpy (&v, args + offset, sizeof (v));
+            line << reinterpret_cast<void *> (static_cast<uintptr_t> (v));
+            offset += sizeof (v);
+          }
+          break;
+        case 's':
+        case 'x':
+          {
+            uint32_t length;
+            std::memcpy (&length, args + offset, sizeof (length));
+            offset += sizeof (length);
+            line << std::string (args + offset, std::min (length, size - offset));
+            offset += length;
+          }
+          break;
+        case ',':
+          line << ", ";
+          break;
+        default:
+          line << "<corrupted>";
+          offset = size;
+          break;
+        }
+    }
+  if (!prefixed)
+    {
+      if (site.kind != LogRecord::MESSAGE)
+        {
+          line << site.component << ":" << site.function << "(";
+        }
+      else
+        {
+          if (record.flags & LOG_PREFIX_FUNC)
+            {
+              line << site.component << ":" << site.function << "(): ";
+            }
+          if (record.flags & LOG_PREFIX_LEVEL)
+            {
+              line << "[" << LevelLabel ((enum LogLevel)(record.flags & RECORD_LEVEL_MASK)) << "] ";
+            }
+        }
+    }
+  if (site.kind != LogRecord::MESSAGE)
+    {
+      line << ")";
+    }
+  os << line.str () << std::endl;
+}
+
+class RingBufferCloser
+{
+public:
+  ~RingBufferCloser ()
+  {
+    LogRingBufferDisable ();
+  }
+} g_ringBufferCloser;
+
+} // anonymous namespace
+
+void
+LogRingBufferEnable (char const *filename, uint32_t size)
+{
+#ifdef HAVE_SYS_MMAN_H
+  LogRingBufferDisable ();
+  size &= ~15;
+  if (size < 4096)
+    {
+      size = 4096;
+    }
+  uint64_t headerSize = (sizeof (RingHeader) + 7) & ~7;
+  uint64_t mapSize = headerSize + RING_BUFFER_SITES_SIZE + size;
+  int fd = open (filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1)
+    {
+      NS_FATAL_ERROR ("Could not open log ring buffer \"" << filename << "\": " << std::strerror (errno));
+    }
+  if (ftruncate (fd, mapSize) == -1)
+    {
+      NS_FATAL_ERROR ("Could not resize log ring buffer \"" << filename << "\": " << std::strerror (errno));
+    }
+  void *map = mmap (0, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    {
+      NS_FATAL_ERROR ("Could not map log ring buffer \"" << filename << "\": " << std::strerror (errno));
+    }
+  RingBuffer *ringBuffer = new RingBuffer ();
+  ringBuffer->header = static_cast<RingHeader *> (map);
+  ringBuffer->sites = static_cast<char *> (map) + headerSize;
+  ringBuffer->ring = ringBuffer->sites + RING_BUFFER_SITES_SIZE;
+  ringBuffer->mapSize = mapSize;
+  ringBuffer->filename = filename;
+  RingHeader *header = ringBuffer->header;
+  std::memcpy (header->magic, RING_BUFFER_MAGIC, sizeof (header->magic));
+  header->version = RING_BUFFER_VERSION;
+  header->headerSize = headerSize;
+  header->sitesSize = RING_BUFFER_SITES_SIZE;
+  header->sitesUsed = 0;
+  header->ringSize = size;
+  header->head = 0;
+  header->tail = 0;
+#ifdef HAVE_PTHREAD_H
+  CriticalSection critical (*GetLogMutex ());
+#endif
+  g_ringBuffer = ringBuffer;
+  std::vector<Site> *sites = GetSites ();
+  for (uint32_t i = 0; i < sites->size (); i++)
+    {
+      WriteSite (i + 1, (*sites)[i]);
+    }
+#else
+  NS_FATAL_ERROR ("The log ring buffer needs mmap");
+#endif
+}
+
+void
+LogRingBufferDisable (void)
+{
+#ifdef HAVE_SYS_MMAN_H
+  if (g_ringBuffer == 0)
+    {
+      return;
+    }
+  RingBuffer *ringBuffer = g_ringBuffer;
+  g_ringBuffer = 0;
+  ContextStreamBuf *buffer = dynamic_cast<ContextStreamBuf *> (std::clog.rdbuf ());
+  if (buffer != 0)
+    {
+      std::clog.rdbuf (buffer->m_target);
+    }
+  munmap (ringBuffer->header, ringBuffer->mapSize);
+  delete ringBuffer;
+#endif
+}
+
+bool
+LogRingBufferIsEnabled (void)
+{
+  return g_ringBuffer != 0;
+}
+
+std::string
+LogRingBufferGetFilename (void)
+{
+  return g_ringBuffer != 0 ? g_ringBuffer->filename : "";
+}
+
+uint32_t
+LogRingBufferGetSize (void)
+{
+  return g_ringBuffer != 0 ? g_ringBuffer->header->ringSize : 0;
+}
+
+void
+LogRingBufferDump (char const *filename, std::ostream &os)
+{
+  std::ifstream file (filename, std::ios::in | std::ios::binary);
+  if (!file)
+    {
+      NS_FATAL_ERROR ("Could not open log ring buffer \"" << filename << "\"");
+    }
+  std::vector<char> data ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char> ());
+  RingHeader header;
+  if (data.size () < sizeof (header))
+    {
+      NS_FATAL_ERROR ("\"" << filename << "\" is not a log ring buffer");
+    }
+  std::memcpy (&header, &data[0], sizeof (header));
+  if (std::memcmp (header.magic, RING_BUFFER_MAGIC, sizeof (header.magic)) != 0
+      || header.version != RING_BUFFER_VERSION
+      || data.size () < header.headerSize + header.sitesSize + header.ringSize)
+    {
+      NS_FATAL_ERROR ("\"" << filename << "\" is not a log ring buffer");
+    }
+
+  std::map<uint32_t, Site> sites;
+  char const *buffer = &data[header.headerSize];
+  uint64_t offset = 0;
+  while (offset + 12 <= header.sitesUsed)
+    {
+      uint32_t size, id;
+      Site site;
+      std::memcpy (&size, buffer + offset, sizeof (uint32_t));
+      std::memcpy (&id, buffer + offset + 4, sizeof (uint32_t));
+      std::memcpy (&site.kind, buffer + offset + 8, sizeof (uint32_t));
+      if (size < 12 || offset + size > header.sitesUsed)
+        {
+          break;
+        }
+      site.component = std::string (buffer + offset + 12);
+      site.function = std::string (buffer + offset + 13 + site.component.size ());
+      sites[id] = site;
+      offset += size;
+    }
+
+  char const *ring = &data[header.headerSize + header.sitesSize];
+  for (uint64_t position = header.tail; position < header.head; )
+    {
+      uint64_t start = position % header.ringSize;
+      RecordHeader record;
+      std::memset (&record, 0, sizeof (record));
+      std::memcpy (&record, ring + start, std::min<uint64_t> (sizeof (record), header.ringSize - start));
+      if (record.size == 0 || record.size % 16 != 0 || start + record.size > header.ringSize)
+        {
+          os << "<corrupted log ring buffer>" << std::endl;
+          break;
+        }
+      if (record.end != position + record.size)
+        {
+          // the thread recording it was interrupted
+          os << "<incomplete record>" << std::endl;
+        }
+      else if (record.site != 0)
+        {
+          PrintRecord (os, record, ring + start + sizeof (record), record.size - sizeof (record), sites);
+        }
+      position += record.size;
+    }
+}
+
+LogRecord::LogRecord (const LogComponent &component, enum LogLevel level,
+                      char const *function, enum Kind kind, uint32_t *site)
+  : m_data (m_inline),
+    m_size (sizeof (RecordHeader)),
+    m_capacity (sizeof (m_inline)),
+    m_items (0),
+    m_function (kind == FUNCTION),
+    m_formatted (false),
+    m_text (0)
+{
+  uint32_t id = *site;
+  if (id == 0)
+    {
+      id = RegisterSite (component.Name (), function, kind, site);
+    }
+  RecordHeader header;
+  header.size = 0;
+  header.site = id;
+  header.end = 0;
+  header.flags = level;
+  if (component.IsEnabled (LOG_PREFIX_FUNC))
+    {
+      header.flags |= LOG_PREFIX_FUNC;
+    }
+  if (component.IsEnabled (LOG_PREFIX_TIME))
+    {
+      header.flags |= LOG_PREFIX_TIME;
+    }
+  if (component.IsEnabled (LOG_PREFIX_NODE))
+    {
+      header.flags |= LOG_PREFIX_NODE;
+    }
+  if (component.IsEnabled (LOG_PREFIX_LEVEL))
+    {
+      header.flags |= LOG_PREFIX_LEVEL;
+    }
+  if (g_logStampGetter != 0)
+    {
+      (*g_logStampGetter)(&header.time, &header.context);
+    }
+  else
+    {
+      header.time = 0.0;
+      header.context = 0xffffffff;
+      header.flags |= RECORD_NO_STAMP;
+    }
+  std::memcpy (m_data, &header, sizeof (header));
+}
+
+LogRecord::~LogRecord ()
+{
+  if (m_text != 0)
+    {
+      std::string text = static_cast<std::ostringstream *> (m_text)->str ();
+      if (!text.empty ())
+        {
+          AppendString (TAG_STRING, text.data (), text.size ());
+        }
+      delete m_text;
+    }
+  // terminate the arguments and pad to a multiple of 16
+  uint32_t size = (m_size + 16) & ~15;
+  Reserve (size - m_size);
+  std::memset (m_data + m_size, 0, size - m_size);
+  std::memcpy (m_data, &size, sizeof (size));
+  WriteRecord (m_data, size);
+  if (m_data != m_inline)
+    {
+      delete [] m_data;
+    }
+}
+
+void
+LogRecord::BeginContext (void)
+{
+  if (dynamic_cast<ContextStreamBuf *> (std::clog.rdbuf ()) == 0)
+    {
+#ifdef HAVE_PTHREAD_H
+      CriticalSection critical (*GetLogMutex ());
+#endif
+      InstallContextStreamBuf ();
+    }
+  g_context = &m_context;
+}
+
+void
+LogRecord::EndContext (void)
+{
+  g_context = 0;
+  if (!m_context.empty ())
+    {
+      AppendString (TAG_CONTEXT, m_context.data (), m_context.size ());
+    }
+}
+
+template <typename S, typename T>
+LogRecord &
+LogRecord::Put (uint8_t tag, T v)
+{
+  Separate ();
+  if (m_formatted)
+    {
+      BeginText () << v;
+      return *this;
+    }
+  S value = v;
+  Append (tag, &value, sizeof (value));
+  return *this;
+}
+
+LogRecord &
+LogRecord::operator<< (bool v)
+{
+  return Put<uint8_t> (TAG_BOOL, v);
+}
+LogRecord &
+LogRecord::operator<< (char v)
+{
+  return Put<char> (TAG_CHAR, v);
+}
+LogRecord &
+LogRecord::operator<< (signed char v)
+{
+  return Put<char> (TAG_CHAR, v);
+}
+LogRecord &
+LogRecord::operator<< (unsigned char v)
+{
+  return Put<char> (TAG_CHAR, v);
+}
+LogRecord &
+LogRecord::operator<< (short v)
+{
+  return Put<int64_t> (TAG_INT, v);
+}
+LogRecord &
+LogRecord::operator<< (unsigned short v)
+{
+  return Put<uint64_t> (TAG_UINT, v);
+}
+LogRecord &
+LogRecord::operator<< (int v)
+{
+  return Put<int64_t> (TAG_INT, v);
+}
+LogRecord &
+LogRecord::operator<< (unsigned int v)
+{
+  return Put<uint64_t> (TAG_UINT, v);
+}
+LogRecord &
+LogRecord::operator<< (long v)
+{
+  return Put<int64_t> (TAG_INT, v);
+}
+LogRecord &
+LogRecord::operator<< (unsigned long v)
+{
+  return Put<uint64_t> (TAG_UINT, v);
+}
+LogRecord &
+LogRecord::operator<< (long long v)
+{
+  return Put<int64_t> (TAG_INT, v);
+}
+LogRecord &
+LogRecord::operator<< (unsigned long long v)
+{
+  return Put<uint64_t> (TAG_UINT, v);
+}
+LogRecord &
+LogRecord::operator<< (float v)
+{
+  return Put<double> (TAG_DOUBLE, v);
+}
+LogRecord &
+LogRecord::operator<< (double v)
+{
+  return Put<double> (TAG_DOUBLE, v);
+}
+LogRecord &
+LogRecord::operator<< (char const *v)
+{
+  Separate ();
+  if (m_formatted || v == 0)
+    {
+      // a null string sets the badbit of std::clog, be as silent
+      if (v != 0)
+        {
+          BeginText () << v;
+        }
+      return *this;
+    }
+  AppendString (TAG_STRING, v, std::strlen (v));
+  return *this;
+}
+LogRecord &
+LogRecord::operator<< (char *v)
+{
+  return *this << static_cast<char const *> (v);
+}
+LogRecord &
+LogRecord::operator<< (const std::string &v)
+{
+  Separate ();
+  if (m_formatted)
+    {
+      BeginText () << v;
+      return *this;
+    }
+  AppendString (TAG_STRING, v.data (), v.size ());
+  return *this;
+}
+LogRecord &
+LogRecord::operator<< (std::string &v)
+{
+  return *this << static_cast<const std::string &> (v);
+}
+LogRecord &
+LogRecord::operator<< (std::ostream &(*manipulator)(std::ostream &))
+{
+  Separate ();
+  BeginText () << manipulator;
+  m_formatted = true;
+  return *this;
+}
+LogRecord &
+LogRecord::operator<< (std::ios_base &(*manipulator)(std::ios_base &))
+{
+  Separate ();
+  BeginText () << manipulator;
+  m_formatted = true;
+  return *this;
+}
+LogRecord &
+LogRecord::operator<< (unsigned char const *v)
+{
+  Separate ();
+  BeginText () << v;
+  EndText ();
+  return *this;
+}
+LogRecord &
+LogRecord::operator<< (signed char const *v)
+{
+  Separate ();
+  BeginText () << v;
+  EndText ();
+  return *this;
+}
+
+void
+LogRecord::Separate (void)
+{
+  if (!m_function)
+    {
+      return;
+    }
+  if (m_items != 0)
+    {
+      if (m_formatted)
+        {
+          BeginText () << ", ";
+        }
+      else
+        {
+          Append (TAG_SEPARATOR, 0, 0);
+        }
+    }
+  m_items++;
+}
+
+void
+LogRecord::Append (uint8_t tag, const void *data, uint32_t size)
+{
+  Reserve (1 + size);
+  m_data[m_size] = tag;
+  if (size != 0)
+    {
+      std::memcpy (m_data + m_size + 1, data, size);
+    }
+  m_size += 1 + size;
+}
+
+void
+LogRecord::AppendString (uint8_t tag, char const *data, uint32_t size)
+{
+  Reserve (1 + sizeof (size) + size);
+  m_data[m_size] = tag;
+  std::memcpy (m_data + m_size + 1, &size, sizeof (size));
+  std::memcpy (m_data + m_size + 1 + sizeof (size), data, size);
+  m_size += 1 + sizeof (size) + size;
+}
+
+void
+LogRecord::Reserve (uint32_t size)
+{
+  if (m_size + size <= m_capacity)
+    {
+      return;
+    }
+  uint32_t capacity = std::max (2 * m_capacity, m_size + size);
+  char *data = new char[capacity];
+  std::memcpy (data, m_data, m_size);
+  if (m_data != m_inline)
+    {
+      delete [] m_data;
+    }
+  m_data = data;
+  m_capacity = capacity;
+}
+
+std::ostream &
+LogRecord::BeginText (void)
+{
+  if (m_text == 0)
+    {
+      m_text = new std::ostringstream ();
+    }
+  return *m_text;
+}
+
+void
+LogRecord::EndText (void)
+{
+  if (m_formatted)
+    {
+      return;
+    }
+  std::ostringstream *text = static_cast<std::ostringstream *> (m_text);
+  // once the formatting state of the stream is changed, the values
+  // which follow must be formatted to be printed the same.
+  if (text->flags () != (std::ios_base::skipws | std::ios_base::dec)
+      || text->width () != 0 || text->precision () != 6 || text->fill () != ' ')
+    {
+      m_formatted = true;
+      return;
+    }
+  std::string value = text->str ();
+  AppendString (TAG_STRING, value.data (), value.size ());
+  text->str ("");
+}
 
 ParameterLogger::ParameterLogger (std::ostream &os)
   : m_itemNumber (0),
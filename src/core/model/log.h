@@ -162,6 +162,16 @@ void LogComponentDisableAll (enum LogLevel level);
 #define NS_LOG_APPEND_CONTEXT
 #endif /* NS_LOG_APPEND_CONTEXT */
 
+// The context prefixes defined by the modules write to std::clog, so
+// what the current thread writes to std::clog is captured while they
+// run for a record of the ring buffer.
+#define NS_LOG_RECORD_CONTEXT(record)                           \
+  {                                                             \
+    record.BeginContext ();                                     \
+    NS_LOG_APPEND_CONTEXT;                                      \
+    record.EndContext ();                                       \
+  }
+
 
 
 #ifdef NS3_LOG_ENABLE
@@ -218,12 +228,23 @@ void LogComponentDisableAll (enum LogLevel level);
     {                                                           \
       if (g_log.IsEnabled (level))                              \
         {                                                       \
-          NS_LOG_APPEND_TIME_PREFIX;                            \
-          NS_LOG_APPEND_NODE_PREFIX;                            \
-          NS_LOG_APPEND_CONTEXT;                                \
-          NS_LOG_APPEND_FUNC_PREFIX;                            \
-          NS_LOG_APPEND_LEVEL_PREFIX (level);                   \
-          std::clog << msg << std::endl;                        \
+          if (ns3::LogRingBufferIsEnabled ())                   \
+            {                                                   \
+              static uint32_t ns3LogSite = 0;                   \
+              ns3::LogRecord ns3LogRecord (g_log, level, __FUNCTION__, \
+                                           ns3::LogRecord::MESSAGE, &ns3LogSite); \
+              NS_LOG_RECORD_CONTEXT (ns3LogRecord);             \
+              ns3LogRecord << msg;                              \
+            }                                                   \
+          else                                                  \
+            {                                                   \
+              NS_LOG_APPEND_TIME_PREFIX;                        \
+              NS_LOG_APPEND_NODE_PREFIX;                        \
+              NS_LOG_APPEND_CONTEXT;                            \
+              NS_LOG_APPEND_FUNC_PREFIX;                        \
+              NS_LOG_APPEND_LEVEL_PREFIX (level);               \
+              std::clog << msg << std::endl;                    \
+            }                                                   \
         }                                                       \
     }                                                           \
   while (false)
@@ -277,11 +298,21 @@ void LogComponentDisableAll (enum LogLevel level);
     {                                                           \
       if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
         {                                                       \
-          NS_LOG_APPEND_TIME_PREFIX;                            \
-          NS_LOG_APPEND_NODE_PREFIX;                            \
-          NS_LOG_APPEND_CONTEXT;                                \
-          std::clog << g_log.Name () << ":"                     \
-                    << __FUNCTION__ << "()" << std::endl;       \
+          if (ns3::LogRingBufferIsEnabled ())                   \
+            {                                                   \
+              static uint32_t ns3LogSite = 0;                   \
+              ns3::LogRecord ns3LogRecord (g_log, ns3::LOG_FUNCTION, __FUNCTION__, \
+                                           ns3::LogRecord::FUNCTION_NOARGS, &ns3LogSite); \
+              NS_LOG_RECORD_CONTEXT (ns3LogRecord);             \
+            }                                                   \
+          else                                                  \
+            {                                                   \
+              NS_LOG_APPEND_TIME_PREFIX;                        \
+              NS_LOG_APPEND_NODE_PREFIX;                        \
+              NS_LOG_APPEND_CONTEXT;                            \
+              std::clog << g_log.Name () << ":"                 \
+                        << __FUNCTION__ << "()" << std::endl;   \
+            }                                                   \
         }                                                       \
     }                                                           \
   while (false)
@@ -313,13 +344,24 @@ void LogComponentDisableAll (enum LogLevel level);
     {                                                           \
       if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
         {                                                       \
-          NS_LOG_APPEND_TIME_PREFIX;                            \
-          NS_LOG_APPEND_NODE_PREFIX;                            \
-          NS_LOG_APPEND_CONTEXT;                                \
-          std::clog << g_log.Name () << ":"                     \
-                    << __FUNCTION__ << "(";                     \
-          ns3::ParameterLogger (std::clog) << parameters;      \
-          std::clog << ")" << std::endl;                        \
+          if (ns3::LogRingBufferIsEnabled ())                   \
+            {                                                   \
+              static uint32_t ns3LogSite = 0;                   \
+              ns3::LogRecord ns3LogRecord (g_log, ns3::LOG_FUNCTION, __FUNCTION__, \
+                                           ns3::LogRecord::FUNCTION, &ns3LogSite); \
+              NS_LOG_RECORD_CONTEXT (ns3LogRecord);             \
+              ns3LogRecord << parameters;                       \
+            }                                                   \
+          else                                                  \
+            {                                                   \
+              NS_LOG_APPEND_TIME_PREFIX;                        \
+              NS_LOG_APPEND_NODE_PREFIX;                        \
+              NS_LOG_APPEND_CONTEXT;                            \
+              std::clog << g_log.Name () << ":"                 \
+                        << __FUNCTION__ << "(";                 \
+              ns3::ParameterLogger (std::clog) << parameters;  \
+              std::clog << ")" << std::endl;                    \
+            }                                                   \
         }                                                       \
     }                                                           \
   while (false)
@@ -381,6 +423,71 @@ LogTimePrinter LogGetTimePrinter (void);
 void LogSetNodePrinter (LogNodePrinter);
 LogNodePrinter LogGetNodePrinter (void);
 
+typedef void (*LogStampGetter)(double *seconds, uint32_t *context);
+
+/**
+ * \param getter the function which returns the simulation time, in
+ *        seconds, and the context of the current event, recorded with
+ *        each message of the log ring buffer.
+ */
+void LogSetStampGetter (LogStampGetter getter);
+LogStampGetter LogGetStampGetter (void);
+
+/**
+ * \ingroup logging
+ * \param filename the file to map the ring buffer to
+ * \param size the size of the ring buffer, in bytes
+ *
+ * Record the messages of the enabled log components in a binary ring
+ * buffer mapped to filename, instead of formatting them on std::clog.
+ * A message is recorded as its simulation time, context, level and
+ * call site, followed by its arguments: integers, floating point
+ * numbers, pointers and strings are stored as they are, and the other
+ * types are formatted with their output operator. Once the ring buffer
+ * is full, the oldest messages are overwritten. Since the file is
+ * mapped, the messages recorded before a crash are not lost.
+ *
+ * Use ns3::LogRingBufferDump or the ns3-logdump program to print the
+ * messages in the format of std::clog.
+ *
+ * Several threads may record messages at the same time, but the ring
+ * buffer must be enabled and disabled while no other thread logs.
+ *
+ * Same as running your program with the NS_LOG_RING_BUFFER
+ * environment variable set to filename (and NS_LOG_RING_BUFFER_SIZE
+ * to size).
+ */
+void LogRingBufferEnable (char const *filename, uint32_t size = 64 << 20);
+/**
+ * \ingroup logging
+ *
+ * Stop recording the messages in the ring buffer and format them on
+ * std::clog again.
+ */
+void LogRingBufferDisable (void);
+/**
+ * \returns true if the messages are recorded in a ring buffer
+ */
+bool LogRingBufferIsEnabled (void);
+/**
+ * \returns the file of the ring buffer, or an empty string if the
+ *          ring buffer is disabled
+ */
+std::string LogRingBufferGetFilename (void);
+/**
+ * \returns the size of the ring buffer, or zero if it is disabled
+ */
+uint32_t LogRingBufferGetSize (void);
+/**
+ * \ingroup logging
+ * \param filename a file written by ns3::LogRingBufferEnable
+ * \param os the output stream
+ *
+ * Print the messages of the ring buffer, from the oldest to the
+ * newest, as they would have been printed on std::clog.
+ */
+void LogRingBufferDump (char const *filename, std::ostream &os);
+
 
 class LogComponent {
 public:
@@ -397,7 +504,7 @@ private:
   char const *m_name;
 };
 
-class ParameterLogger : public std::ostream
+class ParameterLogger
 {
   int m_itemNumber;
   std::ostream &m_os;
@@ -421,6 +528,151 @@ public:
   }
 };
 
+
+/**
+ * \ingroup logging
+ *
+ * A message being recorded in the log ring buffer by the NS_LOG
+ * macros. The arguments are encoded in a buffer, which is copied to
+ * the ring buffer when the record is destroyed.
+ */
+class LogRecord
+{
+public:
+  enum Kind {
+    MESSAGE,
+    FUNCTION,
+    FUNCTION_NOARGS
+  };
+  /**
+   * \param component the log component of the message
+   * \param level the level of the message
+   * \param function the name of the function which logs the message
+   * \param kind the macro which logs the message
+   * \param site the identifier of the call site, zero until the
+   *        site is registered by the first message.
+   */
+  LogRecord (const LogComponent &component, enum LogLevel level,
+             char const *function, enum Kind kind, uint32_t *site);
+  ~LogRecord ();
+
+  /**
+   * Capture what the current thread writes to std::clog, until
+   * EndContext is called.
+   */
+  void BeginContext (void);
+  /**
+   * Record the context prefix written by NS_LOG_APPEND_CONTEXT.
+   */
+  void EndContext (void);
+
+  LogRecord &operator<< (bool v);
+  LogRecord &operator<< (char v);
+  LogRecord &operator<< (signed char v);
+  LogRecord &operator<< (unsigned char v);
+  LogRecord &operator<< (short v);
+  LogRecord &operator<< (unsigned short v);
+  LogRecord &operator<< (int v);
+  LogRecord &operator<< (unsigned int v);
+  LogRecord &operator<< (long v);
+  LogRecord &operator<< (unsigned long v);
+  LogRecord &operator<< (long long v);
+  LogRecord &operator<< (unsigned long long v);
+  LogRecord &operator<< (float v);
+  LogRecord &operator<< (double v);
+  LogRecord &operator<< (char const *v);
+  LogRecord &operator<< (char *v);
+  LogRecord &operator<< (const std::string &v);
+  LogRecord &operator<< (std::string &v);
+  // the manipulators change the formatting of what follows, so the
+  // rest of the message is formatted when it is recorded.
+  LogRecord &operator<< (std::ostream &(*manipulator)(std::ostream &));
+  LogRecord &operator<< (std::ios_base &(*manipulator)(std::ios_base &));
+  // the output operators of std::ostream print these as strings
+  LogRecord &operator<< (unsigned char const *v);
+  LogRecord &operator<< (signed char const *v);
+
+  template <typename T>
+  LogRecord &operator<< (T *v);
+  // some output operators take a non-const reference
+  template <typename T>
+  LogRecord &operator<< (T &v);
+  template <typename T>
+  LogRecord &operator<< (const T &v);
+
+private:
+  enum Tag {
+    TAG_INT = 'i',
+    TAG_UINT = 'u',
+    TAG_DOUBLE = 'd',
+    TAG_CHAR = 'c',
+    TAG_BOOL = 'b',
+    TAG_POINTER = 'p',
+    TAG_STRING = 's',
+    TAG_SEPARATOR = ',',
+    TAG_CONTEXT = 'x'
+  };
+
+  LogRecord (const LogRecord &o);
+  LogRecord &operator= (const LogRecord &o);
+
+  template <typename S, typename T>
+  LogRecord &Put (uint8_t tag, T v);
+  void Separate (void);
+  void Append (uint8_t tag, const void *data, uint32_t size);
+  void AppendString (uint8_t tag, char const *data, uint32_t size);
+  void Reserve (uint32_t size);
+  std::ostream &BeginText (void);
+  void EndText (void);
+
+  char *m_data;
+  uint32_t m_size;
+  uint32_t m_capacity;
+  uint32_t m_items;
+  bool m_function;
+  // true once the rest of the message must be formatted, see EndText
+  bool m_formatted;
+  std::ostream *m_text;
+  // the context prefix, see BeginContext
+  std::string m_context;
+  char m_inline[240];
+};
+
+template <typename T>
+LogRecord &
+LogRecord::operator<< (T *v)
+{
+  Separate ();
+  if (m_formatted)
+    {
+      BeginText () << v;
+      return *this;
+    }
+  uint64_t value = reinterpret_cast<uintptr_t> (v);
+  Append (TAG_POINTER, &value, sizeof (value));
+  return *this;
+}
+
+template <typename T>
+LogRecord &
+LogRecord::operator<< (T &v)
+{
+  Separate ();
+  BeginText () << v;
+  EndText ();
+  return *this;
+}
+
+template <typename T>
+LogRecord &
+LogRecord::operator<< (const T &v)
+{
+  Separate ();
+  BeginText () << v;
+  EndText ();
+  return *this;
+}
+
 } // namespace ns3
 
 
@@ -98,8 +98,14 @@ MapScheduler::Remove (const Event &ev)
 {
   NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
   EventMapI i = m_list.find (ev.key);
-  NS_ASSERT (i->second == ev.impl);
+  NS_ASSERT (i != m_list.end () && i->second == ev.impl);
   m_list.erase (i);
 }
 
+bool
+MapScheduler::HasFastRemove (void) const
+{
+  return true;
+}
+
 } // namespace ns3
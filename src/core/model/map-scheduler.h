@@ -48,6 +48,7 @@ public:
   virtual Event PeekNext (void) const;
   virtual Event RemoveNext (void);
   virtual void Remove (const Event &ev);
+  virtual bool HasFastRemove (void) const;
 private:
   typedef std::map<Scheduler::EventKey, EventImpl*> EventMap;
   typedef std::map<Scheduler::EventKey, EventImpl*>::iterator EventMapI;
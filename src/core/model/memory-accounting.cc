@@ -0,0 +1,301 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "memory-accounting.h"
+#include "type-id.h"
+#include "system-mutex.h"
+#include "fatal-error.h"
+#include "assert.h"
+#include <cstdlib>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <vector>
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+
+// Note: this file does no logging, the accounting of the objects
+// created by the logging itself would recurse.
+
+namespace ns3 {
+
+namespace {
+
+struct Account
+{
+  std::string name;
+  uint32_t size;
+  int64_t count;
+  int64_t peakCount;
+  int64_t bytes;
+  int64_t peakBytes;
+};
+
+// The accounts are never deleted or moved, so that they can be updated
+// without holding the mutex, which only serializes their creation.
+const uint32_t MAX_ACCOUNTS = 8192;
+Account *g_accounts[MAX_ACCOUNTS];
+uint32_t g_nAccounts = 0;
+// one plus the account of each TypeId uid, zero if none yet
+uint32_t g_typeIdAccounts[65536];
+
+// Never deleted: the objects deleted by the static destructors may
+// need their accounts.
+SystemMutex &
+GetMutex (void)
+{
+  static SystemMutex *mutex = new SystemMutex ();
+  return *mutex;
+}
+
+std::map<std::string, uint32_t> &
+GetNames (void)
+{
+  static std::map<std::string, uint32_t> *names = new std::map<std::string, uint32_t> ();
+  return *names;
+}
+
+std::string
+Demangle (const char *mangled)
+{
+#ifdef __GNUC__
+  int status;
+  char *demangled = abi::__cxa_demangle (mangled, 0, 0, &status);
+  if (status == 0 && demangled != 0)
+    {
+      std::string name = demangled;
+      std::free (demangled);
+      return name;
+    }
+#endif
+  return mangled;
+}
+
+bool
+CompareBytes (const Account *a, const Account *b)
+{
+  return a->bytes > b->bytes;
+}
+
+} // anonymous namespace
+
+bool MemoryAccounting::g_enabled = (std::getenv ("NS_MEMORY_ACCOUNTING") != 0);
+
+void
+MemoryAccounting::Enable (void)
+{
+  g_enabled = true;
+}
+
+void
+MemoryAccounting::Disable (void)
+{
+  g_enabled = false;
+}
+
+uint32_t
+MemoryAccounting::CreateAccount (std::string name, uint32_t size)
+{
+  // called with the mutex held
+  std::map<std::string, uint32_t>::const_iterator i = GetNames ().find (name);
+  if (i != GetNames ().end ())
+    {
+      return i->second;
+    }
+  if (g_nAccounts == MAX_ACCOUNTS)
+    {
+      NS_FATAL_ERROR ("Too many memory accounts");
+    }
+  Account *account = new Account ();
+  account->name = name;
+  account->size = size;
+  account->count = 0;
+  account->peakCount = 0;
+  account->bytes = 0;
+  account->peakBytes = 0;
+  uint32_t index = g_nAccounts;
+  g_accounts[index] = account;
+  GetNames ()[name] = index;
+  // publish the account before the number of accounts
+  __sync_synchronize ();
+  g_nAccounts++;
+  return index;
+}
+
+uint32_t
+MemoryAccounting::GetAccount (std::string name)
+{
+  CriticalSection critical (GetMutex ());
+  return CreateAccount (name, 0);
+}
+
+uint32_t
+MemoryAccounting::GetAccount (const TypeId &tid, uint32_t size)
+{
+  uint16_t uid = tid.GetUid ();
+  uint32_t account = g_typeIdAccounts[uid];
+  if (account != 0)
+    {
+      return account - 1;
+    }
+  CriticalSection critical (GetMutex ());
+  account = CreateAccount (tid.GetName (), size);
+  g_typeIdAccounts[uid] = account + 1;
+  return account;
+}
+
+uint32_t
+MemoryAccounting::GetAccount (const std::type_info &type, uint32_t size)
+{
+  std::string name = Demangle (type.name ());
+  CriticalSection critical (GetMutex ());
+  return CreateAccount (name, size);
+}
+
+uint32_t
+MemoryAccounting::GetInstanceSize (uint32_t account)
+{
+  NS_ASSERT (account < g_nAccounts);
+  return g_accounts[account]->size;
+}
+
+void
+MemoryAccounting::Allocate (uint32_t account, uint32_t bytes)
+{
+  NS_ASSERT (account < g_nAccounts);
+  Account *a = g_accounts[account];
+  int64_t count = __sync_add_and_fetch (&a->count, 1);
+  int64_t total = __sync_add_and_fetch (&a->bytes, bytes);
+  if (count > a->peakCount)
+    {
+      a->peakCount = count;
+    }
+  if (total > a->peakBytes)
+    {
+      a->peakBytes = total;
+    }
+}
+
+void
+MemoryAccounting::Deallocate (uint32_t account, uint32_t bytes)
+{
+  NS_ASSERT (account < g_nAccounts);
+  Account *a = g_accounts[account];
+  int64_t count = __sync_sub_and_fetch (&a->count, 1);
+  NS_ASSERT_MSG (count >= 0, "An instance not counted in " << a->name << " was deallocated");
+  __sync_sub_and_fetch (&a->bytes, bytes);
+}
+
+uint32_t
+MemoryAccounting::GetNAccounts (void)
+{
+  return g_nAccounts;
+}
+
+uint32_t
+MemoryAccounting::LookupAccount (std::string name)
+{
+  CriticalSection critical (GetMutex ());
+  std::map<std::string, uint32_t>::const_iterator i = GetNames ().find (name);
+  if (i == GetNames ().end ())
+    {
+      return NONE;
+    }
+  return i->second;
+}
+
+std::string
+MemoryAccounting::GetName (uint32_t account)
+{
+  NS_ASSERT (account < g_nAccounts);
+  return g_accounts[account]->name;
+}
+
+uint64_t
+MemoryAccounting::GetCount (uint32_t account)
+{
+  NS_ASSERT (account < g_nAccounts);
+  return g_accounts[account]->count;
+}
+
+uint64_t
+MemoryAccounting::GetPeakCount (uint32_t account)
+{
+  NS_ASSERT (account < g_nAccounts);
+  return g_accounts[account]->peakCount;
+}
+
+uint64_t
+MemoryAccounting::GetBytes (uint32_t account)
+{
+  NS_ASSERT (account < g_nAccounts);
+  return g_accounts[account]->bytes;
+}
+
+uint64_t
+MemoryAccounting::GetPeakBytes (uint32_t account)
+{
+  NS_ASSERT (account < g_nAccounts);
+  return g_accounts[account]->peakBytes;
+}
+
+uint64_t
+MemoryAccounting::GetTotalBytes (void)
+{
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < g_nAccounts; i++)
+    {
+      total += g_accounts[i]->bytes;
+    }
+  return total;
+}
+
+void
+MemoryAccounting::ResetPeaks (void)
+{
+  for (uint32_t i = 0; i < g_nAccounts; i++)
+    {
+      g_accounts[i]->peakCount = g_accounts[i]->count;
+      g_accounts[i]->peakBytes = g_accounts[i]->bytes;
+    }
+}
+
+void
+MemoryAccounting::Print (std::ostream &os)
+{
+  std::vector<const Account *> accounts;
+  for (uint32_t i = 0; i < g_nAccounts; i++)
+    {
+      if (g_accounts[i]->peakCount > 0)
+        {
+          accounts.push_back (g_accounts[i]);
+        }
+    }
+  std::stable_sort (accounts.begin (), accounts.end (), &CompareBytes);
+  os << std::setw (12) << "bytes" << std::setw (12) << "peak bytes"
+     << std::setw (10) << "count" << std::setw (10) << "peak"
+     << "  account" << std::endl;
+  for (std::vector<const Account *>::const_iterator i = accounts.begin (); i != accounts.end (); ++i)
+    {
+      os << std::setw (12) << (*i)->bytes << std::setw (12) << (*i)->peakBytes
+         << std::setw (10) << (*i)->count << std::setw (10) << (*i)->peakCount
+         << "  " << (*i)->name << std::endl;
+    }
+  os << std::setw (12) << GetTotalBytes () << "  total" << std::endl;
+}
+
+} // namespace ns3
@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+#include <stdint.h>
+#include <string>
+#include <iosfwd>
+#include <typeinfo>
+
+namespace ns3 {
+
+class TypeId;
+
+/**
+ * \ingroup core
+ * \brief count the live instances and the bytes of the simulation objects
+ *
+ * When the accounting is enabled, each kind of object has an account
+ * which records its number of live instances and their size in bytes,
+ * and the peaks of these values:
+ *  - one account per TypeId for the Object instances, created by
+ *    CreateObject or CopyObject. The size of an instance is the size of
+ *    the class first created for the TypeId, without the memory the
+ *    object allocates itself.
+ *  - one account per class for the instances of the classes which derive
+ *    from SimpleRefCount with the default deleter, such as Packet,
+ *    created on the heap and deleted by their last Unref.
+ *  - accounts for the variable-size storage of the models, such as the
+ *    packet buffers, metadata and tags.
+ *
+ * The accounting is disabled by default, and is enabled by
+ * MemoryAccounting::Enable or by setting the NS_MEMORY_ACCOUNTING
+ * environment variable. Enable it before creating the objects to
+ * account: the objects created before are not counted, and neither are
+ * their deletions, which are ignored once their account is empty for the
+ * instances other than the Object instances. When it is disabled, the
+ * accounting costs a test per object creation and deletion.
+ *
+ * The values can be read at any time, for example from an event:
+ * \code
+ *   void
+ *   DumpMemory (void)
+ *   {
+ *     MemoryAccounting::Print (std::cout);
+ *     Simulator::Schedule (Seconds (10), &DumpMemory);
+ *   }
+ * \endcode
+ *
+ * The counters are updated atomically and may be updated by several
+ * threads; the peaks are approximate when they are.
+ */
+class MemoryAccounting
+{
+public:
+  /**
+   * Returned by LookupAccount when there is no such account
+   */
+  static const uint32_t NONE = 0xffffffff;
+
+  /**
+   * Start accounting the objects created from now on.
+   */
+  static void Enable (void);
+  /**
+   * Stop accounting. The values of the accounts are kept.
+   */
+  static void Disable (void);
+  /**
+   * \returns true if the accounting is enabled
+   */
+  static inline bool IsEnabled (void)
+  {
+    return g_enabled;
+  }
+
+  /**
+   * \param name the name of the account
+   * \returns the account, created if needed
+   */
+  static uint32_t GetAccount (std::string name);
+  /**
+   * \param tid a TypeId
+   * \param size the size of an instance of the TypeId
+   * \returns the account of the instances of the TypeId, created if
+   *          needed with the instance size
+   */
+  static uint32_t GetAccount (const TypeId &tid, uint32_t size);
+  /**
+   * \param type a class
+   * \param size the size of an instance of the class
+   * \returns the account of the instances of the class, created if
+   *          needed with the instance size
+   */
+  static uint32_t GetAccount (const std::type_info &type, uint32_t size);
+  /**
+   * \param account an account
+   * \returns the size of an instance, or zero for the accounts of
+   *          variable-size storage
+   */
+  static uint32_t GetInstanceSize (uint32_t account);
+
+  /**
+   * \param account an account
+   * \param bytes the size of the new instance
+   */
+  static void Allocate (uint32_t account, uint32_t bytes);
+  /**
+   * \param account an account
+   * \param bytes the size of the deleted instance
+   *
+   * Must be called only for the instances which were counted by
+   * Allocate: the callers record whether an instance was counted
+   * when it was created, as accounting may have been enabled since.
+   */
+  static void Deallocate (uint32_t account, uint32_t bytes);
+
+  /**
+   * \returns the number of accounts
+   */
+  static uint32_t GetNAccounts (void);
+  /**
+   * \param name the name of an account: the name of a TypeId, of a
+   *        class or of the storage of a model
+   * \returns the account, or NONE
+   */
+  static uint32_t LookupAccount (std::string name);
+  /**
+   * \param account an account
+   * \returns the name of the account
+   */
+  static std::string GetName (uint32_t account);
+  /**
+   * \param account an account
+   * \returns the number of live instances
+   */
+  static uint64_t GetCount (uint32_t account);
+  /**
+   * \param account an account
+   * \returns the largest number of live instances
+   */
+  static uint64_t GetPeakCount (uint32_t account);
+  /**
+   * \param account an account
+   * \returns the bytes of the live instances
+   */
+  static uint64_t GetBytes (uint32_t account);
+  /**
+   * \param account an account
+   * \returns the largest number of bytes of the live instances
+   */
+  static uint64_t GetPeakBytes (uint32_t account);
+  /**
+   * \returns the bytes of the live instances of all the accounts
+   */
+  static uint64_t GetTotalBytes (void);
+  /**
+   * Set the peaks of all the accounts to their current values.
+   */
+  static void ResetPeaks (void);
+  /**
+   * \param os the output stream
+   *
+   * Print the accounts which had instances, by decreasing number of
+   * bytes.
+   */
+  static void Print (std::ostream &os);
+
+private:
+  static uint32_t CreateAccount (std::string name, uint32_t size);
+
+  static bool g_enabled;
+};
+
+} // namespace ns3
+
+#endif /* MEMORY_ACCOUNTING_H */
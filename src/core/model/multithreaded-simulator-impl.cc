@@ -0,0 +1,731 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+#include "simulator.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "abort.h"
+#include "log.h"
+#include "atomic-ref-count.h"
+
+#include <algorithm>
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+// the partition of each context, set by SetPartition
+std::vector<uint32_t> g_partitionOf;
+uint32_t g_partitionCount = 1;
+// incremented each time the partitioning changes
+uint32_t g_partitionGeneration = 1;
+uint64_t g_lookahead = 0;
+// later than any event
+const uint64_t NEVER = ~static_cast<uint64_t> (0);
+} // anonymous namespace
+
+__thread MultithreadedSimulatorImpl::Partition *MultithreadedSimulatorImpl::m_current = 0;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("ThreadCount",
+                   "The number of threads which run the partitions.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_threadCount),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_partitionGeneration (0),
+    m_threadCount (1),
+    m_activeThreads (1),
+    m_nextThread (1),
+    m_currentTs (0),
+    // uids are allocated from 4.
+    // uid 0 is "invalid" events
+    // uid 1 is "now" events
+    // uid 2 is "destroy" events
+    m_uid (4),
+    m_hasRun (false),
+    m_stopTs (NEVER),
+    m_stop (false),
+    m_windowEnd (NEVER),
+    m_finished (false),
+    m_barrierCount (0),
+    m_barrierGeneration (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_main = SystemThread::Self ();
+  pthread_mutex_init (&m_barrierMutex, 0);
+  pthread_cond_init (&m_barrierCondition, 0);
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  pthread_cond_destroy (&m_barrierCondition);
+  pthread_mutex_destroy (&m_barrierMutex);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      Partition *partition = m_partitions[i];
+      while (!partition->events->IsEmpty ())
+        {
+          Scheduler::Event next = partition->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      for (uint32_t j = 0; j < partition->outbox.size (); j++)
+        {
+          for (uint32_t k = 0; k < partition->outbox[j].size (); k++)
+            {
+              partition->outbox[j][k].impl->Unref ();
+            }
+        }
+      delete partition;
+    }
+  m_partitions.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+  // the nodes are destroyed with the simulator
+  g_partitionOf.clear ();
+  g_partitionCount = 1;
+  g_partitionGeneration++;
+  g_lookahead = 0;
+}
+
+void
+MultithreadedSimulatorImpl::SetPartition (uint32_t context, uint32_t partition)
+{
+  NS_LOG_FUNCTION (context << partition);
+  if (context >= g_partitionOf.size ())
+    {
+      g_partitionOf.resize (context + 1, 0);
+    }
+  g_partitionOf[context] = partition;
+  g_partitionCount = std::max (g_partitionCount, partition + 1);
+  g_partitionGeneration++;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition (uint32_t context)
+{
+  if (context < g_partitionOf.size ())
+    {
+      return g_partitionOf[context];
+    }
+  return 0;
+}
+
+void
+MultithreadedSimulatorImpl::SetLookahead (Time lookahead)
+{
+  NS_LOG_FUNCTION (lookahead);
+  NS_ASSERT (!lookahead.IsStrictlyNegative ());
+  g_lookahead = lookahead.GetTimeStep ();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead (void)
+{
+  return TimeStep (g_lookahead);
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::CreatePartition (uint32_t index)
+{
+  Partition *partition = new Partition ();
+  partition->index = index;
+  partition->events = m_schedulerFactory.Create<Scheduler> ();
+  partition->uid = m_uid;
+  partition->currentUid = 0;
+  partition->currentTs = m_currentTs;
+  partition->currentContext = 0xffffffff;
+  partition->unscheduledEvents = 0;
+  partition->stop = false;
+  partition->stopTs = NEVER;
+  return partition;
+}
+
+void
+MultithreadedSimulatorImpl::Repartition (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_hasRun, "The partitioning cannot change once the simulation started");
+  NS_ABORT_MSG_UNLESS (SystemThread::Equals (m_main),
+                       "MultithreadedSimulatorImpl: thread-unsafe partitioning change");
+  std::vector<Partition *> partitions;
+  partitions.swap (m_partitions);
+  m_partitionGeneration = g_partitionGeneration;
+  for (uint32_t i = 0; i < g_partitionCount; i++)
+    {
+      m_partitions.push_back (CreatePartition (i));
+      m_partitions.back ()->outbox.resize (g_partitionCount);
+    }
+  // all the events were inserted by the main thread so their uids are
+  // unique and they can be moved as they are.
+  for (uint32_t i = 0; i < partitions.size (); i++)
+    {
+      Partition *old = partitions[i];
+      while (!old->events->IsEmpty ())
+        {
+          Scheduler::Event ev = old->events->RemoveNext ();
+          Partition *partition = m_partitions[GetPartition (ev.key.m_context)];
+          partition->unscheduledEvents++;
+          partition->events->Insert (ev);
+        }
+      delete old;
+    }
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetPartitionOf (uint32_t context) const
+{
+  if (m_partitionGeneration != g_partitionGeneration)
+    {
+      const_cast<MultithreadedSimulatorImpl *> (this)->Repartition ();
+    }
+  return m_partitions[GetPartition (context)];
+}
+
+uint32_t
+MultithreadedSimulatorImpl::Insert (Partition *partition, uint64_t ts, uint32_t context, EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  if (m_current == 0)
+    {
+      ev.key.m_uid = m_uid;
+      m_uid++;
+    }
+  else
+    {
+      ev.key.m_uid = partition->uid;
+      partition->uid++;
+    }
+  partition->unscheduledEvents++;
+  partition->events->Insert (ev);
+  return ev.key.m_uid;
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  m_schedulerFactory = schedulerFactory;
+  if (m_partitions.empty ())
+    {
+      Repartition ();
+      return;
+    }
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      Partition *partition = m_partitions[i];
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      while (!partition->events->IsEmpty ())
+        {
+          scheduler->Insert (partition->events->RemoveNext ());
+        }
+      partition->events = scheduler;
+    }
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop)
+    {
+      return true;
+    }
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      if (!m_partitions[i]->events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow (Partition *partition)
+{
+  m_current = partition;
+  while (!partition->stop && !partition->events->IsEmpty ()
+         && partition->events->PeekNext ().key.m_ts < m_windowEnd)
+    {
+      Scheduler::Event next = partition->events->RemoveNext ();
+
+      NS_ASSERT (next.key.m_ts >= partition->currentTs);
+      partition->unscheduledEvents--;
+
+      partition->currentTs = next.key.m_ts;
+      partition->currentContext = next.key.m_context;
+      partition->currentUid = next.key.m_uid;
+      next.impl->Invoke ();
+      next.impl->Unref ();
+    }
+  m_current = 0;
+}
+
+void
+MultithreadedSimulatorImpl::Deliver (Partition *partition)
+{
+  // the order of delivery only depends on the source partitions
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      std::vector<Scheduler::Event> &outbox = m_partitions[i]->outbox[partition->index];
+      for (uint32_t j = 0; j < outbox.size (); j++)
+        {
+          Scheduler::Event ev = outbox[j];
+          ev.key.m_uid = partition->uid;
+          partition->uid++;
+          partition->unscheduledEvents++;
+          partition->events->Insert (ev);
+        }
+      outbox.clear ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ComputeWindow (void)
+{
+  uint64_t next = NEVER;
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      Partition *partition = m_partitions[i];
+      m_stop = m_stop || partition->stop;
+      m_stopTs = std::min (m_stopTs, partition->stopTs);
+      partition->stopTs = NEVER;
+      if (!partition->events->IsEmpty ())
+        {
+          next = std::min (next, partition->events->PeekNext ().key.m_ts);
+        }
+    }
+  if (m_stop || next == NEVER || next >= m_stopTs)
+    {
+      m_finished = true;
+      return;
+    }
+  m_finished = false;
+  if (m_partitions.size () == 1 || next > NEVER - g_lookahead)
+    {
+      m_windowEnd = m_stopTs;
+    }
+  else
+    {
+      m_windowEnd = std::min (next + g_lookahead, m_stopTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Barrier (bool computeWindow)
+{
+  pthread_mutex_lock (&m_barrierMutex);
+  uint32_t generation = m_barrierGeneration;
+  m_barrierCount++;
+  if (m_barrierCount == m_activeThreads)
+    {
+      // the last thread to arrive prepares the next step
+      m_barrierCount = 0;
+      if (computeWindow)
+        {
+          ComputeWindow ();
+        }
+      m_barrierGeneration++;
+      pthread_cond_broadcast (&m_barrierCondition);
+    }
+  else
+    {
+      while (m_barrierGeneration == generation)
+        {
+          pthread_cond_wait (&m_barrierCondition, &m_barrierMutex);
+        }
+    }
+  pthread_mutex_unlock (&m_barrierMutex);
+}
+
+void
+MultithreadedSimulatorImpl::DoRunThread (uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  uint32_t nPartitions = m_partitions.size ();
+  while (true)
+    {
+      Barrier (true);
+      if (m_finished)
+        {
+          break;
+        }
+      for (uint32_t i = index; i < nPartitions; i += m_activeThreads)
+        {
+          ProcessWindow (m_partitions[i]);
+        }
+      Barrier (false);
+      for (uint32_t i = index; i < nPartitions; i += m_activeThreads)
+        {
+          Deliver (m_partitions[i]);
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DoRunWorker (void)
+{
+  DoRunThread (__sync_fetch_and_add (&m_nextThread, 1));
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Set the current threadId as the main threadId
+  m_main = SystemThread::Self ();
+  GetPartitionOf (0);
+  NS_ABORT_MSG_IF (m_partitions.size () > 1 && g_lookahead == 0,
+                   "MultithreadedSimulatorImpl needs a lookahead with several partitions");
+  m_hasRun = true;
+  m_stop = false;
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      m_partitions[i]->uid = m_uid;
+      m_partitions[i]->stop = false;
+    }
+
+  m_activeThreads = std::min<uint32_t> (m_threadCount, m_partitions.size ());
+  m_nextThread = 1;
+  m_barrierCount = 0;
+  std::vector<Ptr<SystemThread> > threads;
+  if (m_activeThreads > 1)
+    {
+      // the partitions share the objects held by the TypeId registry
+      AtomicRefCounting::Enable ();
+    }
+  for (uint32_t i = 1; i < m_activeThreads; i++)
+    {
+      Ptr<SystemThread> thread =
+        Create<SystemThread> (MakeCallback (&MultithreadedSimulatorImpl::DoRunWorker, this));
+      thread->Start ();
+      threads.push_back (thread);
+    }
+  DoRunThread (0);
+  for (uint32_t i = 0; i < threads.size (); i++)
+    {
+      threads[i]->Join ();
+    }
+  if (m_activeThreads > 1)
+    {
+      AtomicRefCounting::Disable ();
+    }
+
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      Partition *partition = m_partitions[i];
+      m_currentTs = std::max (m_currentTs, partition->currentTs);
+      m_uid = std::max (m_uid, partition->uid);
+      // If the simulator stopped naturally by lack of events, make a
+      // consistency test to check that we didn't lose any events along the way.
+      NS_ASSERT (!partition->events->IsEmpty () || partition->unscheduledEvents == 0);
+    }
+  if (!m_stop && m_stopTs != NEVER)
+    {
+      // like the stop event of the other simulators, the time reaches
+      // the stop time.
+      m_currentTs = m_stopTs;
+      m_stopTs = NEVER;
+      for (uint32_t i = 0; i < m_partitions.size (); i++)
+        {
+          m_partitions[i]->currentTs = m_currentTs;
+          m_partitions[i]->currentUid = 0;
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_current != 0)
+    {
+      m_current->stop = true;
+    }
+  else
+    {
+      m_stop = true;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &time)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep ());
+  uint64_t ts = (time + Now ()).GetTimeStep ();
+  if (m_current != 0)
+    {
+      m_current->stopTs = std::min (m_current->stopTs, ts);
+    }
+  else
+    {
+      m_stopTs = std::min (m_stopTs, ts);
+    }
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep () << event);
+  Partition *partition = m_current;
+  uint64_t ts;
+  uint32_t context;
+  if (partition == 0)
+    {
+      NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::Schedule Thread-unsafe invocation!");
+      context = 0xffffffff;
+      ts = m_currentTs;
+      partition = GetPartitionOf (context);
+    }
+  else
+    {
+      context = partition->currentContext;
+      ts = partition->currentTs;
+    }
+  NS_ASSERT (!time.IsStrictlyNegative ());
+  ts += time.GetTimeStep ();
+  uint32_t uid = Insert (partition, ts, context, event);
+  return EventId (event, ts, context, uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << time.GetTimeStep () << event);
+  Partition *current = m_current;
+  if (current == 0)
+    {
+      NS_ABORT_MSG_UNLESS (SystemThread::Equals (m_main),
+                           "MultithreadedSimulatorImpl: Simulator::ScheduleWithContext "
+                           "called by a thread which does not run the simulation");
+      Insert (GetPartitionOf (context), m_currentTs + time.GetTimeStep (), context, event);
+      return;
+    }
+  uint64_t ts = current->currentTs + time.GetTimeStep ();
+  Partition *partition = m_partitions[GetPartition (context)];
+  if (partition == current)
+    {
+      Insert (partition, ts, context, event);
+      return;
+    }
+  NS_ABORT_MSG_IF (ts < m_windowEnd, "MultithreadedSimulatorImpl: event for partition "
+                   << partition->index << " scheduled by partition " << current->index
+                   << " with a delay of " << time.GetTimeStep ()
+                   << " which is shorter than the lookahead " << g_lookahead);
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  // allocated by the destination partition on delivery
+  ev.key.m_uid = 0;
+  current->outbox[partition->index].push_back (ev);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (TimeStep (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), Now ().GetTimeStep (), 0xffffffff, 2);
+  CriticalSection cs (m_destroyEventsMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  if (m_current != 0)
+    {
+      return TimeStep (m_current->currentTs);
+    }
+  return TimeStep (m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs ()) - Now ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition *partition = GetPartitionOf (id.GetContext ());
+  NS_ABORT_MSG_IF (m_current != 0 && m_current != partition,
+                   "MultithreadedSimulatorImpl: cannot remove an event of another partition");
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  partition->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  partition->unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &ev) const
+{
+  if (ev.GetUid () == 2)
+    {
+      if (ev.PeekEventImpl () == 0
+          || ev.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (const_cast<SystemMutex &> (m_destroyEventsMutex));
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == ev)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  if (ev.PeekEventImpl () == 0)
+    {
+      return true;
+    }
+  const Partition *partition = GetPartitionOf (ev.GetContext ());
+  if (ev.GetTs () < partition->currentTs
+      || (ev.GetTs () == partition->currentTs
+          && ev.GetUid () <= partition->currentUid)
+      || ev.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  if (m_current != 0)
+    {
+      return m_current->currentContext;
+    }
+  return 0xffffffff;
+}
+
+} // namespace ns3
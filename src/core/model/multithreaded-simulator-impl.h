@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "system-thread.h"
+#include "system-mutex.h"
+#include "nstime.h"
+#include "ptr.h"
+
+#include <list>
+#include <vector>
+#include <pthread.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief a parallel simulator running on several threads of one host
+ *
+ * The contexts of the events, that is the node ids, are partitioned into
+ * logical processes with MultithreadedSimulatorImpl::SetPartition. Each
+ * partition has its own scheduler and its own clock, and the partitions
+ * are run by ThreadCount threads.
+ *
+ * The partitions are synchronized conservatively: the simulation advances
+ * by windows which start at the earliest pending event and last for the
+ * lookahead, the smallest delay of the links between two partitions
+ * (see MultithreadedSimulatorImpl::SetLookahead). An event scheduled for
+ * another partition is thus always later than the end of the current
+ * window: it is queued in a buffer owned by the sending partition and
+ * moved to the scheduler of its destination at the end of the window,
+ * once all the threads are waiting at the barrier, so that the
+ * partitions never lock each other.
+ *
+ * The events exchanged between partitions are delivered in the order of
+ * their source partition and the uids of the events are allocated per
+ * partition, so the output of a simulation only depends on the
+ * partitioning, not on the number of threads. Simulator::Stop stops the
+ * simulation at the end of the current window and Simulator::Stop (time)
+ * runs all the events strictly before the stop time; when it is called
+ * by an event, the stop time is only enforced from the next window.
+ *
+ * The models run by different partitions must not share mutable state,
+ * and Simulator::ScheduleWithContext cannot be called by threads other
+ * than the simulation threads while the simulation is running. The
+ * partitioning must be set up before the first call to Simulator::Run.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  static TypeId GetTypeId (void);
+
+  MultithreadedSimulatorImpl ();
+  ~MultithreadedSimulatorImpl ();
+
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &time);
+  virtual EventId Schedule (Time const &time, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &ev);
+  virtual void Cancel (const EventId &ev);
+  virtual bool IsExpired (const EventId &ev) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+  /**
+   * \param context a context, that is usually a node id
+   * \param partition the partition which runs the events of this context
+   *
+   * The contexts which are not assigned explicitly, including the
+   * events without context, belong to partition 0. The partitioning is
+   * kept until Simulator::Destroy.
+   */
+  static void SetPartition (uint32_t context, uint32_t partition);
+  /**
+   * \param context a context, that is usually a node id
+   * \returns the partition which runs the events of this context
+   */
+  static uint32_t GetPartition (uint32_t context);
+  /**
+   * \param lookahead the smallest delay of an event scheduled by a
+   *        partition for another partition. It must be strictly positive
+   *        when there are several partitions.
+   */
+  static void SetLookahead (Time lookahead);
+  /**
+   * \returns the current lookahead
+   */
+  static Time GetLookahead (void);
+
+private:
+  virtual void DoDispose (void);
+
+  struct Partition
+  {
+    uint32_t index;
+    Ptr<Scheduler> events;
+    uint32_t uid;
+    uint32_t currentUid;
+    uint64_t currentTs;
+    uint32_t currentContext;
+    // number of events that have been inserted but not yet scheduled,
+    // not counting the "destroy" events; this is used for validation
+    int unscheduledEvents;
+    bool stop;
+    // stop time requested by the events of this partition
+    uint64_t stopTs;
+    // events sent to each other partition during the current window
+    std::vector<std::vector<Scheduler::Event> > outbox;
+  };
+
+  Partition *CreatePartition (uint32_t index);
+  Partition *GetPartitionOf (uint32_t context) const;
+  void Repartition (void);
+  uint32_t Insert (Partition *partition, uint64_t ts, uint32_t context, EventImpl *event);
+  void ProcessWindow (Partition *partition);
+  void Deliver (Partition *partition);
+  void ComputeWindow (void);
+  void Barrier (bool computeWindow);
+  void DoRunThread (uint32_t index);
+  void DoRunWorker (void);
+
+  std::vector<Partition *> m_partitions;
+  // generation of the partitioning m_partitions was built for
+  uint32_t m_partitionGeneration;
+  ObjectFactory m_schedulerFactory;
+  uint32_t m_threadCount;
+  uint32_t m_activeThreads;
+  uint32_t m_nextThread;
+
+  typedef std::list<EventId> DestroyEvents;
+  DestroyEvents m_destroyEvents;
+  SystemMutex m_destroyEventsMutex;
+
+  // clock and uids of the simulation out of Simulator::Run
+  uint64_t m_currentTs;
+  uint32_t m_uid;
+  bool m_hasRun;
+  uint64_t m_stopTs;
+  bool m_stop;
+
+  // the current window
+  uint64_t m_windowEnd;
+  bool m_finished;
+
+  // barrier shared by the simulation threads. SystemCondition forgets
+  // the signals sent before Wait is called, so it cannot be used here.
+  pthread_mutex_t m_barrierMutex;
+  pthread_cond_t m_barrierCondition;
+  uint32_t m_barrierCount;
+  uint32_t m_barrierGeneration;
+
+  SystemThread::ThreadId m_main;
+
+  // the partition run by the calling thread, if any
+  static __thread Partition *m_current;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
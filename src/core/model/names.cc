@@ -22,6 +22,7 @@
 #include "assert.h"
 #include "abort.h"
 #include "names.h"
+#include "replication.h"
 
 namespace ns3 {
 
@@ -104,6 +105,7 @@ public:
 private:
   friend class Names;
   static NamesPriv *Get (void);
+  static void DeleteReplicationNames (void);
 
   NameNode *IsNamed (Ptr<Object>);
   bool IsDuplicateName (NameNode *node, std::string name);
@@ -112,14 +114,34 @@ private:
   std::map<Ptr<Object>, NameNode *> m_objectMap;
 };
 
+// the names of the replication run by the calling thread
+static __thread NamesPriv *g_replicationNames = 0;
+
 NamesPriv *
 NamesPriv::Get (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  if (Replication::IsActive ())
+    {
+      if (g_replicationNames == 0)
+        {
+          g_replicationNames = new NamesPriv ();
+          Replication::AtExit (MakeCallback (&NamesPriv::DeleteReplicationNames));
+        }
+      return g_replicationNames;
+    }
   static NamesPriv namesPriv;
   return &namesPriv;
 }
 
+void
+NamesPriv::DeleteReplicationNames (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  delete g_replicationNames;
+  g_replicationNames = 0;
+}
+
 NamesPriv::NamesPriv ()
 {
   NS_LOG_FUNCTION (this);
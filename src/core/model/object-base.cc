@@ -64,80 +64,82 @@ ObjectBase::NotifyConstructionCompleted (void)
 void
 ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
 {
-  // loop over the inheritance tree back to the Object base class.
+  // loop over the attributes of the whole inheritance tree, flattened
+  // by the TypeId of this object.
   NS_LOG_FUNCTION (this << &attributes);
   TypeId tid = GetInstanceTypeId ();
-  do {
-      // loop over all attributes in object type
-      NS_LOG_DEBUG ("construct tid="<<tid.GetName ()<<", params="<<tid.GetAttributeN ());
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+  uint32_t n = tid.GetAllAttributeN ();
+  NS_LOG_DEBUG ("construct tid="<<tid.GetName ()<<", params="<<n);
+#ifdef HAVE_GETENV
+  char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
+#endif /* HAVE_GETENV */
+  for (uint32_t i = 0; i < n; i++)
+    {
+      TypeId owner;
+      const struct TypeId::AttributeInformation &info = tid.GetAllAttribute (i, &owner);
+      NS_LOG_DEBUG ("try to construct \""<< owner.GetName ()<<"::"<<
+                    info.name <<"\"");
+      if (!(info.flags & TypeId::ATTR_CONSTRUCT))
+        {
+          continue;
+        }
+      bool found = false;
+      // is this attribute stored in this AttributeConstructionList instance ?
+      Ptr<AttributeValue> value = attributes.Find(info.checker);
+      if (value != 0)
         {
-          struct TypeId::AttributeInformation info = tid.GetAttribute(i);
-          NS_LOG_DEBUG ("try to construct \""<< tid.GetName ()<<"::"<<
-                        info.name <<"\"");
-          if (!(info.flags & TypeId::ATTR_CONSTRUCT))
+          // We have a matching attribute value.
+          if (DoSet (info.accessor, info.checker, *value))
             {
+              NS_LOG_DEBUG ("construct \""<< owner.GetName ()<<"::"<<
+                            info.name<<"\"");
+              found = true;
               continue;
             }
-          bool found = false;
-          // is this attribute stored in this AttributeConstructionList instance ?
-          Ptr<AttributeValue> value = attributes.Find(info.checker);
-          if (value != 0)
-            {
-              // We have a matching attribute value.
-              if (DoSet (info.accessor, info.checker, *value))
-                {
-                  NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                                info.name<<"\"");
-                  found = true;
-                  continue;
-                }
-            }              
-          if (!found)
-            {
-              // No matching attribute value so we try to look at the env var.
+        }              
+      if (!found)
+        {
+          // No matching attribute value so we try to look at the env var.
 #ifdef HAVE_GETENV
-              char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
-              if (envVar != 0)
+          if (envVar != 0)
+            {
+              std::string fullName = owner.GetName () + "::" + info.name;
+              std::string env = std::string (envVar);
+              std::string::size_type cur = 0;
+              std::string::size_type next = 0;
+              while (next != std::string::npos)
                 {
-                  std::string env = std::string (envVar);
-                  std::string::size_type cur = 0;
-                  std::string::size_type next = 0;
-                  while (next != std::string::npos)
+                  next = env.find (";", cur);
+                  std::string tmp = std::string (env, cur, next-cur);
+                  std::string::size_type equal = tmp.find ("=");
+                  if (equal != std::string::npos)
                     {
-                      next = env.find (";", cur);
-                      std::string tmp = std::string (env, cur, next-cur);
-                      std::string::size_type equal = tmp.find ("=");
-                      if (equal != std::string::npos)
+                      std::string name = tmp.substr (0, equal);
+                      std::string value = tmp.substr (equal+1, tmp.size () - equal - 1);
+                      if (name == fullName)
                         {
-                          std::string name = tmp.substr (0, equal);
-                          std::string value = tmp.substr (equal+1, tmp.size () - equal - 1);
-                          if (name == tid.GetAttributeFullName (i))
+                          if (DoSet (info.accessor, info.checker, StringValue (value)))
                             {
-                              if (DoSet (info.accessor, info.checker, StringValue (value)))
-                                {
-                                  NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                                                info.name <<"\" from env var");
-                                  found = true;
-                                  break;
-                                }
+                              NS_LOG_DEBUG ("construct \""<< owner.GetName ()<<"::"<<
+                                            info.name <<"\" from env var");
+                              found = true;
+                              break;
                             }
                         }
-                      cur = next + 1;
                     }
+                  cur = next + 1;
                 }
-#endif /* HAVE_GETENV */
-            }
-          if (!found)
-            {
-              // No matching attribute value so we try to set the default value.
-              DoSet (info.accessor, info.checker, *info.initialValue);
-              NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                            info.name <<"\" from initial value.");
             }
+#endif /* HAVE_GETENV */
+        }
+      if (!found)
+        {
+          // No matching attribute value so we try to set the default value.
+          DoSet (info.accessor, info.checker, *info.initialValue);
+          NS_LOG_DEBUG ("construct \""<< owner.GetName ()<<"::"<<
+                        info.name <<"\" from initial value.");
         }
-      tid = tid.GetParent ();
-    } while (tid != ObjectBase::GetTypeId ());
+    }
   NotifyConstructionCompleted ();
 }
 
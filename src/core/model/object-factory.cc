@@ -18,6 +18,7 @@
  * Authors: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "object-factory.h"
+#include "pointer.h"
 #include "log.h"
 #include <sstream>
 
@@ -75,7 +76,15 @@ ObjectFactory::Set (std::string name, const AttributeValue &value)
       NS_FATAL_ERROR ("Invalid value for attribute set (" << name << ") on " << m_tid.GetName ());
       return;
     }
-  m_parameters.Add (name, info.checker, value.Copy ());
+  // Store the checked value, so that a value set from a string is parsed
+  // once rather than for each object created.  A pointer set from a
+  // string describes an object to create for each object, so its string
+  // is kept.
+  if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+    {
+      v = value.Copy ();
+    }
+  m_parameters.Add (name, info.checker, v);
 }
 
 TypeId 
@@ -94,6 +103,10 @@ ObjectFactory::Create (void) const
   Object *derived = dynamic_cast<Object *> (base);
   NS_ASSERT (derived != 0);
   derived->SetTypeId (m_tid);
+  if (MemoryAccounting::IsEnabled ())
+    {
+      derived->StartAccounting (0);
+    }
   derived->Construct (m_parameters);
   Ptr<Object> object = Ptr<Object> (derived, false);
   return object;
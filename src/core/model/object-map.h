@@ -24,6 +24,7 @@
 #include "ptr.h"
 #include "attribute.h"
 #include "object-ptr-container.h"
+#include <iterator>
 
 namespace ns3 {
 
@@ -64,20 +65,24 @@ MakeObjectMapAccessor (U T::*memberVector)
     virtual Ptr<Object> DoGet (const ObjectBase *object, uint32_t i, uint32_t *index) const {
       const T *obj = static_cast<const T *> (object);
       typename U::const_iterator begin = (obj->*m_memberVector).begin ();
-      typename U::const_iterator end = (obj->*m_memberVector).end ();
-      uint32_t k = 0;
-      for (typename U::const_iterator j = begin; j != end; j++, k++)
+      typename U::const_iterator j = begin;
+      std::advance (j, i);
+      *index = (*j).first;
+      return (*j).second;
+    }
+    virtual bool DoForEachItem (const ObjectBase *object, ItemVisitor &visitor) const {
+      const T *obj = dynamic_cast<const T *> (object);
+      if (obj == 0)
         {
-          if (k == i)
-            {
-              *index = (*j).first;
-              return (*j).second;
-              break;
-            }
+          return false;
         }
-      NS_ASSERT (false);
-      // quiet compiler.
-      return 0;
+      // DoGet is linear in i on a map
+      for (typename U::const_iterator j = (obj->*m_memberVector).begin ();
+           j != (obj->*m_memberVector).end (); j++)
+        {
+          visitor.Visit ((*j).first, (*j).second);
+        }
+      return true;
     }
     U T::*m_memberVector;
   } *spec = new MemberStdContainer ();
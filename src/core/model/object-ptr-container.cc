@@ -97,6 +97,23 @@ ObjectPtrContainerAccessor::Set (ObjectBase * object, const AttributeValue & val
   NS_LOG_FUNCTION (this << object << &value);
   return false;
 }
+namespace {
+// fills an ObjectPtrContainerValue
+class CopyVisitor : public ObjectPtrContainerAccessor::ItemVisitor
+{
+public:
+  CopyVisitor (std::map<uint32_t, Ptr<Object> > *objects)
+    : m_objects (objects)
+  {}
+  virtual void Visit (uint32_t index, Ptr<Object> item)
+  {
+    m_objects->insert (m_objects->end (), std::make_pair (index, item));
+  }
+private:
+  std::map<uint32_t, Ptr<Object> > *m_objects;
+};
+} // anonymous namespace
+
 bool 
 ObjectPtrContainerAccessor::Get (const ObjectBase * object, AttributeValue &value) const
 {
@@ -107,9 +124,21 @@ ObjectPtrContainerAccessor::Get (const ObjectBase * object, AttributeValue &valu
       return false;
     }
   v->m_objects.clear ();
+  CopyVisitor visitor (&v->m_objects);
+  return DoForEachItem (object, visitor);
+}
+bool
+ObjectPtrContainerAccessor::ForEachItem (const ObjectBase *object, ItemVisitor &visitor) const
+{
+  NS_LOG_FUNCTION (this << object << &visitor);
+  return DoForEachItem (object, visitor);
+}
+bool
+ObjectPtrContainerAccessor::DoForEachItem (const ObjectBase *object, ItemVisitor &visitor) const
+{
+  NS_LOG_FUNCTION (this << object << &visitor);
   uint32_t n;
-  bool ok = DoGetN (object, &n);
-  if (!ok)
+  if (!DoGetN (object, &n))
     {
       return false;
     }
@@ -117,7 +146,7 @@ ObjectPtrContainerAccessor::Get (const ObjectBase * object, AttributeValue &valu
     {
       uint32_t index;
       Ptr<Object> o = DoGet (object, i, &index);
-      v->m_objects.insert (std::pair <uint32_t, Ptr<Object> > (index, o));
+      visitor.Visit (index, o);
     }
   return true;
 }
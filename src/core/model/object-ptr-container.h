@@ -139,9 +139,36 @@ public:
   virtual bool Get (const ObjectBase * object, AttributeValue &value) const;
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
+
+  /**
+   * \brief receives the items of a container
+   */
+  class ItemVisitor
+  {
+  public:
+    virtual ~ItemVisitor () {}
+    /**
+     * \param index the index of the item in the container
+     * \param item the item
+     */
+    virtual void Visit (uint32_t index, Ptr<Object> item) = 0;
+  };
+  /**
+   * \param object the object which holds the container
+   * \param visitor the visitor to give each item of the container to,
+   *        in the order of the container
+   * \returns false if object does not hold this container
+   *
+   * This walks the container in place, without copying all of its items
+   * in an ObjectPtrContainerValue.
+   */
+  bool ForEachItem (const ObjectBase *object, ItemVisitor &visitor) const;
 private:
   virtual bool DoGetN (const ObjectBase *object, uint32_t *n) const = 0;
   virtual Ptr<Object> DoGet (const ObjectBase *object, uint32_t i, uint32_t *index) const = 0;
+  // calls DoGet for each item, unless overriden by the accessors of the
+  // containers which are not indexed in constant time.
+  virtual bool DoForEachItem (const ObjectBase *object, ItemVisitor &visitor) const;
 };
 
 template <typename T, typename U, typename INDEX>
@@ -94,11 +94,13 @@ Object::Object ()
     m_disposed (false),
     m_initialized (false),
     m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_getObjectCount (0),
+    m_accounted (false)
 {
   NS_LOG_FUNCTION (this);
   m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
+  ClearCache (m_aggregates);
 }
 Object::~Object () 
 {
@@ -116,6 +118,13 @@ Object::~Object ()
           m_aggregates->n--;
         }
     }
+  if (m_accounted)
+    {
+      uint32_t account = MemoryAccounting::GetAccount (m_tid, 0);
+      MemoryAccounting::Deallocate (account, MemoryAccounting::GetInstanceSize (account));
+    }
+  // the cache may refer to this object
+  ClearCache (m_aggregates);
   // finally, if all objects have been removed from the list,
   // delete the aggregate list
   if (m_aggregates->n == 0)
@@ -129,10 +138,12 @@ Object::Object (const Object &o)
     m_disposed (false),
     m_initialized (false),
     m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_getObjectCount (0),
+    m_accounted (false)
 {
   m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
+  ClearCache (m_aggregates);
 }
 void
 Object::Construct (const AttributeConstructionList &attributes)
@@ -147,8 +158,15 @@ Object::DoGetObject (TypeId tid) const
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
+  Object *cached;
+  if (LookupCache (tid.GetUid (), &cached))
+    {
+      return cached;
+    }
+
   uint32_t n = m_aggregates->n;
   TypeId objectTid = Object::GetTypeId ();
+  Object *found = 0;
   for (uint32_t i = 0; i < n; i++)
     {
       Object *current = m_aggregates->buffer[i];
@@ -169,11 +187,17 @@ Object::DoGetObject (TypeId tid) const
           current->m_getObjectCount++;
           // then, update the sort
           UpdateSortedArray (m_aggregates, i);
-          // finally, return the match
-          return const_cast<Object *> (current);
+          found = current;
+          break;
         }
     }
-  return 0;
+  // finally, remember the match, or the lack of match, until the
+  // next aggregation.
+  struct Aggregates::CacheEntry &entry = 
+    m_aggregates->cache[tid.GetUid () % (sizeof (m_aggregates->cache) / sizeof (m_aggregates->cache[0]))];
+  entry.tid = tid.GetUid ();
+  entry.object = found;
+  return found;
 }
 void
 Object::Initialize (void)
@@ -238,6 +262,16 @@ Object::UpdateSortedArray (struct Aggregates *aggregates, uint32_t j) const
       j--;
     }
 }
+void
+Object::ClearCache (struct Aggregates *aggregates)
+{
+  // the uid 0 is never allocated to a TypeId
+  for (uint32_t i = 0; i < sizeof (aggregates->cache) / sizeof (aggregates->cache[0]); i++)
+    {
+      aggregates->cache[i].tid = 0;
+      aggregates->cache[i].object = 0;
+    }
+}
 void 
 Object::AggregateObject (Ptr<Object> o)
 {
@@ -260,6 +294,7 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates = 
     (struct Aggregates *)std::malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
   aggregates->n = total;
+  ClearCache (aggregates);
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0], 
@@ -329,6 +364,17 @@ Object::SetTypeId (TypeId tid)
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (Check ());
   m_tid = tid;
+  // a lookup done by the constructor may have missed this object
+  ClearCache (m_aggregates);
+}
+
+void
+Object::StartAccounting (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  uint32_t account = MemoryAccounting::GetAccount (m_tid, size);
+  MemoryAccounting::Allocate (account, MemoryAccounting::GetInstanceSize (account));
+  m_accounted = true;
 }
 
 void
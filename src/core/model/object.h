@@ -29,6 +29,7 @@
 #include "object-base.h"
 #include "attribute-construction-list.h"
 #include "simple-ref-count.h"
+#include "memory-accounting.h"
 
 
 namespace ns3 {
@@ -238,12 +239,34 @@ private:
    * chunk of memory than the struct to allow space for a larger
    * variable sized buffer whose size is indicated by the element
    * 'n'
+   *
+   * The array is preceded by a small direct-mapped cache of the
+   * results of GetObject, indexed by the uid of the TypeId looked
+   * for. A new array, with an empty cache, is allocated by each call
+   * to AggregateObject so the cache never holds stale entries.
    */
   struct Aggregates {
     uint32_t n;
+    struct CacheEntry {
+      uint16_t tid;
+      Object *object;
+    } cache[8];
     Object *buffer[1];
   };
 
+  /**
+   * \param tid the uid of the TypeId we're looking for
+   * \param object where to store the cached result
+   * \return true if the result of the lookup of tid is cached
+   */
+  inline bool LookupCache (uint16_t tid, Object **object) const;
+  /**
+   * Clear the cache of an aggregate array.
+   *
+   * \param aggregates the list of aggregated objects
+   */
+  static void ClearCache (struct Aggregates *aggregates);
+
   /**
    * Find an object of TypeId tid in the aggregates of this Object.
    *
@@ -283,6 +306,15 @@ private:
   * registered with the associated TypeId.
   */
   void Construct (const AttributeConstructionList &attributes);
+  /**
+   * \param size the size of the instance, used if the TypeId has no
+   *        memory account yet
+   *
+   * Invoked from ns3::CreateObject, ns3::CopyObject and
+   * ns3::ObjectFactory::Create only, when the memory accounting is
+   * enabled: count this object in the account of its TypeId.
+   */
+  void StartAccounting (uint32_t size);
 
   /**
    * Keep the list of aggregates in most-recently-used order
@@ -327,6 +359,11 @@ private:
    * of the array the most-frequently accessed elements.
    */
   uint32_t m_getObjectCount;
+  /**
+   * Set to true when this object is counted in the memory account
+   * of its TypeId, see MemoryAccounting.
+   */
+  bool m_accounted;
 };
 
 /**
@@ -355,19 +392,33 @@ ObjectDeleter::Delete (Object *object)
  *   The Object implementation which depends on templates
  *************************************************************************/
 
+bool
+Object::LookupCache (uint16_t tid, Object **object) const
+{
+  const struct Aggregates::CacheEntry &entry = 
+    m_aggregates->cache[tid % (sizeof (m_aggregates->cache) / sizeof (m_aggregates->cache[0]))];
+  if (entry.tid == tid)
+    {
+      *object = entry.object;
+      return true;
+    }
+  return false;
+}
+
 template <typename T>
 Ptr<T> 
 Object::GetObject () const
 {
-  // This is an optimization: if the cast works (which is likely),
-  // things will be pretty fast.
-  T *result = dynamic_cast<T *> (m_aggregates->buffer[0]);
-  if (result != 0)
+  // This is an optimization: if the same lookup was done since the
+  // last aggregation, its result is in the cache.
+  TypeId tid = T::GetTypeId ();
+  Object *cached;
+  if (LookupCache (tid.GetUid (), &cached))
     {
-      return Ptr<T> (result);
+      return Ptr<T> (static_cast<T *> (cached));
     }
-  // if the cast does not work, we try to do a full type check.
-  Ptr<Object> found = DoGetObject (T::GetTypeId ());
+  // if the lookup was not cached, we try a full type check.
+  Ptr<Object> found = DoGetObject (tid);
   if (found != 0)
     {
       return Ptr<T> (static_cast<T *> (PeekPointer (found)));
@@ -396,6 +447,10 @@ Ptr<T> CopyObject (Ptr<T> object)
 {
   Ptr<T> p = Ptr<T> (new T (*PeekPointer (object)), false);
   NS_ASSERT (p->GetInstanceTypeId () == object->GetInstanceTypeId ());
+  if (MemoryAccounting::IsEnabled ())
+    {
+      p->Object::StartAccounting (sizeof (T));
+    }
   return p;
 }
 
@@ -404,6 +459,10 @@ Ptr<T> CopyObject (Ptr<const T> object)
 {
   Ptr<T> p = Ptr<T> (new T (*PeekPointer (object)), false);
   NS_ASSERT (p->GetInstanceTypeId () == object->GetInstanceTypeId ());
+  if (MemoryAccounting::IsEnabled ())
+    {
+      p->Object::StartAccounting (sizeof (T));
+    }
   return p;
 }
 
@@ -411,6 +470,10 @@ template <typename T>
 Ptr<T> CompleteConstruct (T *p)
 {
   p->SetTypeId (T::GetTypeId ());
+  if (MemoryAccounting::IsEnabled ())
+    {
+      p->Object::StartAccounting (sizeof (T));
+    }
   p->Object::Construct (AttributeConstructionList ());
   return Ptr<T> (p, false);
 }
@@ -179,6 +179,21 @@ UniformRandomVariable::GetValue (double min, double max)
     }
   return v;
 }
+void
+UniformRandomVariable::GetValues (double min, double max, double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << min << max << values << n);
+  Peek ()->RandU01 (values, n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double v = min + values[i] * (max - min);
+      if (IsAntithetic ())
+        {
+          v = min + (max - v);
+        }
+      values[i] = v;
+    }
+}
 uint32_t 
 UniformRandomVariable::GetInteger (uint32_t min, uint32_t max)
 {
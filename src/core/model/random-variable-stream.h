@@ -223,6 +223,19 @@ public:
    */
   double GetValue (double min, double max);
 
+  /**
+   * \brief Fills an array with random doubles from the uniform distribution with the specified range.
+   * \param min Low end of the range.
+   * \param max High end of the range.
+   * \param values The array to fill.
+   * \param n The number of values to store in the array.
+   *
+   * This returns the same values as n calls to GetValue (min, max),
+   * antithetic or not, but draws them from the underlying stream in
+   * one batch.
+   */
+  void GetValues (double min, double max, double *values, uint32_t n);
+
   /**
    * \brief Returns a random unsigned integer from a uniform distribution over the interval [min,max] including both ends.
    * \param min Low end of the range.
@@ -31,9 +31,12 @@
 #include "system-mutex.h"
 #include "boolean.h"
 #include "enum.h"
+#include "type-id.h"
+#include "object-factory.h"
 
 
 #include <cmath>
+#include <algorithm>
 
 // Note:  Logging in this file is largely avoided due to the
 // number of calls that are made to these functions and the possibility
@@ -62,6 +65,11 @@ RealtimeSimulatorImpl::GetTypeId (void)
                    TimeValue (Seconds (0.1)),
                    MakeTimeAccessor (&RealtimeSimulatorImpl::m_hardLimit),
                    MakeTimeChecker ())
+    .AddAttribute ("SynchronizerType",
+                   "The type of the synchronizer which keeps the simulation in step with real time.",
+                   TypeIdValue (WallClockSynchronizer::GetTypeId ()),
+                   MakeTypeIdAccessor (&RealtimeSimulatorImpl::SetSynchronizerType),
+                   MakeTypeIdChecker ())
   ;
   return tid;
 }
@@ -85,10 +93,6 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl ()
   m_unscheduledEvents = 0;
 
   m_main = SystemThread::Self();
-
-  // Be very careful not to do anything that would cause a change or assignment
-  // of the underlying reference counts of m_synchronizer or you will be sorry.
-  m_synchronizer = CreateObject<WallClockSynchronizer> ();
 }
 
 RealtimeSimulatorImpl::~RealtimeSimulatorImpl ()
@@ -106,6 +110,11 @@ RealtimeSimulatorImpl::DoDispose (void)
       next.impl->Unref ();
     }
   m_events = 0;
+  InjectedEventQueue::Item item;
+  while (m_injected.Pop (&item))
+    {
+      item.event->Unref ();
+    }
   m_synchronizer = 0;
   SimulatorImpl::DoDispose ();
 }
@@ -202,6 +211,13 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
       { 
         CriticalSection cs (m_mutex);
         //
+        // Reset the synchronizer first so that any event injected by another
+        // thread from now on interrupts the wait below, then pick up the
+        // events injected so far.
+        //
+        m_synchronizer->SetCondition (false);
+        ProcessInjectedEvents ();
+        //
         // Since we are in realtime mode, the time to delay has got to be the 
         // difference between the current realtime and the timestamp of the next 
         // event.  Since m_currentTs is actually the timestamp of the last event we 
@@ -242,14 +258,6 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
             tsDelay = tsNext - tsNow;
           }
 
-        //
-        // We've figured out how long we need to delay in order to pace the 
-        // simulation time with the real time.  We're going to sleep, but need
-        // to work with the synchronizer to make sure we're awakened if something 
-        // external happens (like a packet is received).  This next line resets
-        // the synchronizer so that any future event will cause it to interrupt.
-        //
-        m_synchronizer->SetCondition (false);
       }
 
       //
@@ -312,6 +320,7 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
 
   { 
     CriticalSection cs (m_mutex);
+    ProcessInjectedEvents ();
 
     // 
     // We do know we're waiting for an event, so there had better be an event on the 
@@ -386,6 +395,44 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
   event->Unref ();
 }
 
+//
+// Queue an event scheduled by another thread than the simulation thread,
+// without taking m_mutex, and wake up the simulation thread if it waits.
+//
+void
+RealtimeSimulatorImpl::Inject (uint32_t context, uint64_t ts, EventImpl *event)
+{
+  InjectedEventQueue::Item item;
+  item.context = context;
+  item.timestamp = ts;
+  item.event = event;
+  m_injected.Push (item);
+  m_synchronizer->Signal ();
+}
+
+//
+// Move the events injected by other threads to the event list.  Should be
+// called with critical section locked.
+//
+void
+RealtimeSimulatorImpl::ProcessInjectedEvents (void)
+{
+  InjectedEventQueue::Item item;
+  while (m_injected.Pop (&item))
+    {
+      Scheduler::Event ev;
+      ev.impl = item.event;
+      // the realtime clock read by the other thread may lag behind the
+      // last event if it was computed just before it ran.
+      ev.key.m_ts = std::max (item.timestamp, m_currentTs);
+      ev.key.m_context = item.context;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+    }
+}
+
 bool 
 RealtimeSimulatorImpl::IsFinished (void) const
 {
@@ -434,6 +481,8 @@ RealtimeSimulatorImpl::Run (void)
       bool process = false;
       {
         CriticalSection cs (m_mutex);
+        m_synchronizer->SetCondition (false);
+        ProcessInjectedEvents ();
 
         if (!m_events->IsEmpty ())
           {
@@ -536,23 +585,19 @@ RealtimeSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time,
 {
   NS_LOG_FUNCTION (this << context << time << impl);
 
+  if (!SystemThread::Equals (m_main))
+    {
+      //
+      // If the simulator is running, we're pacing and have a meaningful 
+      // realtime clock.  If we're not, then m_currentTs is where we stopped.
+      // 
+      uint64_t ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs;
+      Inject (context, ts + time.GetTimeStep (), impl);
+      return;
+    }
   {
     CriticalSection cs (m_mutex);
-    uint64_t ts;
-
-    if (SystemThread::Equals (m_main))
-      {
-        ts = m_currentTs + time.GetTimeStep ();
-      }
-    else
-      {
-        //
-        // If the simulator is running, we're pacing and have a meaningful 
-        // realtime clock.  If we're not, then m_currentTs is where we stopped.
-        // 
-        ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs;
-        ts += time.GetTimeStep ();
-      }
+    uint64_t ts = m_currentTs + time.GetTimeStep ();
 
     NS_ASSERT_MSG (ts >= m_currentTs, "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
     Scheduler::Event ev;
@@ -602,14 +647,20 @@ RealtimeSimulatorImpl::ScheduleRealtimeWithContext (uint32_t context, Time const
 {
   NS_LOG_FUNCTION (this << context << time << impl);
 
+  uint64_t ts = m_synchronizer->GetCurrentRealtime () + time.GetTimeStep ();
+  if (!SystemThread::Equals (m_main))
+    {
+      Inject (context, ts, impl);
+      return;
+    }
   {
     CriticalSection cs (m_mutex);
 
-    uint64_t ts = m_synchronizer->GetCurrentRealtime () + time.GetTimeStep ();
     NS_ASSERT_MSG (ts >= m_currentTs, "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
     Scheduler::Event ev;
     ev.impl = impl;
     ev.key.m_ts = ts;
+    ev.key.m_context = context;
     ev.key.m_uid = m_uid;
     m_uid++;
     m_unscheduledEvents++;
@@ -629,6 +680,12 @@ void
 RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext (uint32_t context, EventImpl *impl)
 {
   NS_LOG_FUNCTION (this << context << impl);
+  if (!SystemThread::Equals (m_main))
+    {
+      uint64_t ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs;
+      Inject (context, ts, impl);
+      return;
+    }
   {
     CriticalSection cs (m_mutex);
 
@@ -841,4 +898,24 @@ RealtimeSimulatorImpl::GetHardLimit (void) const
   return m_hardLimit;
 }
 
+void
+RealtimeSimulatorImpl::SetSynchronizerType (TypeId tid)
+{
+  NS_LOG_FUNCTION (this << tid);
+  NS_ASSERT_MSG (!m_running, "RealtimeSimulatorImpl::SetSynchronizerType(): Simulator is running");
+  // Be very careful not to do anything else that would cause a change or
+  // assignment of the underlying reference counts of m_synchronizer or
+  // you will be sorry: other threads use it without locking m_mutex.
+  ObjectFactory factory;
+  factory.SetTypeId (tid);
+  m_synchronizer = factory.Create<Synchronizer> ();
+}
+
+Ptr<Synchronizer>
+RealtimeSimulatorImpl::GetSynchronizer (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_synchronizer;
+}
+
 } // namespace ns3
@@ -30,6 +30,7 @@
 #include "assert.h"
 #include "log.h"
 #include "system-mutex.h"
+#include "injected-event-queue.h"
 
 #include <list>
 
@@ -86,11 +87,26 @@ public:
   void SetHardLimit (Time limit);
   Time GetHardLimit (void) const;
 
+  /**
+   * \param tid the type of the synchronizer to use, a subclass of
+   *        ns3::Synchronizer
+   *
+   * Must not be called while the simulator is running.
+   */
+  void SetSynchronizerType (TypeId tid);
+  /**
+   * \returns the synchronizer used by this simulator, for example to
+   *          connect to its trace sources.
+   */
+  Ptr<Synchronizer> GetSynchronizer (void) const;
+
 private:
   bool Running (void) const;
   bool Realtime (void) const;
   uint64_t NextTs (void) const;
   void ProcessOneEvent (void);
+  void ProcessInjectedEvents (void);
+  void Inject (uint32_t context, uint64_t ts, EventImpl *event);
   virtual void DoDispose (void);
 
   typedef std::list<EventId> DestroyEvents;
@@ -108,6 +124,9 @@ private:
 
   mutable SystemMutex m_mutex;
 
+  // events scheduled by other threads, with an absolute timestamp
+  InjectedEventQueue m_injected;
+
   Ptr<Synchronizer> m_synchronizer;
 
   /**
@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "replication.h"
+#include "rng-seed-manager.h"
+#include "assert.h"
+#include "log.h"
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("Replication");
+
+namespace ns3 {
+
+namespace {
+__thread bool g_active = false;
+__thread std::vector<Callback<void> > *g_atExit = 0;
+
+void
+ResetCounter (uint64_t *counter)
+{
+  *counter = 0;
+}
+} // anonymous namespace
+
+void
+Replication::Enter (uint64_t run)
+{
+  NS_LOG_FUNCTION (run);
+  NS_ASSERT_MSG (!g_active, "The thread already runs a replication");
+  uint32_t seed = RngSeedManager::GetSeed ();
+  g_active = true;
+  RngSeedManager::SetSeed (seed);
+  RngSeedManager::SetRun (run);
+  RngSeedManager::ResetNextStreamIndex ();
+}
+
+void
+Replication::Exit (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  NS_ASSERT_MSG (g_active, "The thread does not run a replication");
+  if (g_atExit != 0)
+    {
+      // the callbacks may register new ones
+      while (!g_atExit->empty ())
+        {
+          Callback<void> cb = g_atExit->back ();
+          g_atExit->pop_back ();
+          cb ();
+        }
+      delete g_atExit;
+      g_atExit = 0;
+    }
+  g_active = false;
+}
+
+bool
+Replication::IsActive (void)
+{
+  return g_active;
+}
+
+void
+Replication::AtExit (const Callback<void> &cb)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  NS_ASSERT_MSG (g_active, "The thread does not run a replication");
+  if (g_atExit == 0)
+    {
+      g_atExit = new std::vector<Callback<void> > ();
+    }
+  g_atExit->push_back (cb);
+}
+
+void
+Replication::ResetAtExit (uint64_t *counter)
+{
+  NS_LOG_FUNCTION (counter);
+  AtExit (MakeBoundCallback (&ResetCounter, counter));
+}
+
+} // namespace ns3
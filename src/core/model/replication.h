@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include "callback.h"
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * \brief the state of the simulation replications run by threads
+ *
+ * A thread which enters a replication gets its own simulation: the
+ * Simulator, the Config root namespace, Names, the SimulationSingleton
+ * instances, the seed, run and stream index of RngSeedManager and, in
+ * the other modules, the node and channel lists, the packet uids and
+ * the address allocators are private to the thread until it exits the
+ * replication. The other threads, and the replications which run
+ * concurrently, see their own state.
+ *
+ * The process-wide state which stays shared must not be modified while
+ * replications run: the TypeId registry and the attribute defaults
+ * (Config::SetDefault), the GlobalValue instances other than RngSeed
+ * and RngRun, and the log components.
+ * AtomicRefCounting must be enabled while several replications run
+ * concurrently, since they share the objects held by the TypeId
+ * registry.
+ *
+ * See ReplicationRunner, in the stats module, which runs several
+ * replications on a pool of threads.
+ */
+class Replication
+{
+public:
+  /**
+   * \param run the run number, see RngSeedManager::SetRun
+   *
+   * Start a replication in the calling thread. The seed of the
+   * replication is the process-wide seed.
+   */
+  static void Enter (uint64_t run);
+  /**
+   * End the replication of the calling thread, invoking the callbacks
+   * registered by AtExit in the reverse order of their registration.
+   * Simulator::Destroy must have been called.
+   */
+  static void Exit (void);
+  /**
+   * \returns true if the calling thread runs a replication
+   */
+  static bool IsActive (void);
+  /**
+   * \param cb a callback to invoke when the calling thread exits its
+   *        replication
+   *
+   * For the state which lives longer than the simulation, and is thus
+   * not released by Simulator::Destroy.
+   */
+  static void AtExit (const Callback<void> &cb);
+  /**
+   * \param counter a thread-local counter of the calling thread
+   *
+   * Set the counter to zero when the calling thread exits its
+   * replication, so that the next replication run by the thread starts
+   * from zero too. Call it when the counter is first used, that is when
+   * it is still zero.
+   */
+  static void ResetAtExit (uint64_t *counter);
+};
+
+} // namespace ns3
+
+#endif /* REPLICATION_H */
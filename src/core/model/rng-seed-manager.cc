@@ -4,6 +4,7 @@
 #include "integer.h"
 #include "config.h"
 #include "log.h"
+#include "replication.h"
 
 NS_LOG_COMPONENT_DEFINE ("RngSeedManager");
 
@@ -19,10 +20,19 @@ static ns3::GlobalValue g_rngRun ("RngRun",
                                   ns3::IntegerValue (1),
                                   ns3::MakeIntegerChecker<int64_t> ());
 
+// the state of the replication run by the calling thread, see Replication
+static __thread uint32_t g_replicationSeed = 0;
+static __thread uint64_t g_replicationRun = 0;
+static __thread uint64_t g_replicationNextStreamIndex = 0;
+
 
 uint32_t RngSeedManager::GetSeed (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  if (Replication::IsActive ())
+    {
+      return g_replicationSeed;
+    }
   IntegerValue seedValue;
   g_rngSeed.GetValue (seedValue);
   return seedValue.Get ();
@@ -31,18 +41,32 @@ void
 RngSeedManager::SetSeed (uint32_t seed)
 {
   NS_LOG_FUNCTION (seed);
+  if (Replication::IsActive ())
+    {
+      g_replicationSeed = seed;
+      return;
+    }
   Config::SetGlobal ("RngSeed", IntegerValue(seed));
 }
 
 void RngSeedManager::SetRun (uint64_t run)
 {
   NS_LOG_FUNCTION (run);
+  if (Replication::IsActive ())
+    {
+      g_replicationRun = run;
+      return;
+    }
   Config::SetGlobal ("RngRun", IntegerValue (run));
 }
 
 uint64_t RngSeedManager::GetRun ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  if (Replication::IsActive ())
+    {
+      return g_replicationRun;
+    }
   IntegerValue value;
   g_rngRun.GetValue (value);
   int run = value.Get();
@@ -52,9 +76,19 @@ uint64_t RngSeedManager::GetRun ()
 uint64_t RngSeedManager::GetNextStreamIndex (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  if (Replication::IsActive ())
+    {
+      return g_replicationNextStreamIndex++;
+    }
   uint64_t next = g_nextStreamIndex;
   g_nextStreamIndex++;
   return next;
 }
 
+void RngSeedManager::ResetNextStreamIndex (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_replicationNextStreamIndex = 0;
+}
+
 } // namespace ns3
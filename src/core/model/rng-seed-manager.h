@@ -62,6 +62,13 @@ public:
 
   static uint64_t GetNextStreamIndex(void);
 
+private:
+  friend class Replication;
+  /**
+   * Start the stream indices of the replication of the calling thread
+   * from zero.
+   */
+  static void ResetNextStreamIndex (void);
 };
 
 // for compatibility
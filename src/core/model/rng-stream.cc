@@ -39,6 +39,8 @@ typedef double Matrix[3][3];
 const double m1   =       4294967087.0;
 const double m2   =       4294944443.0;
 const double norm =       1.0 / (m1 + 1.0);
+const double m1inv =      1.0 / m1;
+const double m2inv =      1.0 / m2;
 const double a12  =       1403580.0;
 const double a13n =       810728.0;
 const double a21  =       527612.0;
@@ -257,37 +259,63 @@ void PowerOfTwoMatrix (int n, Matrix a1p, Matrix a2p)
 
 namespace ns3 {
 //-------------------------------------------------------------------------
-// Generate the next random number.
+// Generate the next n random numbers.
 //
-double RngStream::RandU01 ()
+void RngStream::Generate (double *u, uint32_t n)
 {
-  int32_t k;
-  double p1, p2, u;
-
-  /* Component 1 */
-  p1 = a12 * m_currentState[1] - a13n * m_currentState[0];
-  k = static_cast<int32_t> (p1 / m1);
-  p1 -= k * m1;
-  if (p1 < 0.0)
+  // Keep the state in locals so that it stays in registers, and reduce
+  // modulo m1 and m2 with a multiplication by the inverse instead of a
+  // division. All the intermediate values are integers smaller than
+  // 2^53, so they are exact: the quotient may be off by one, but the
+  // corrections below then give exactly the same residue, hence the
+  // same sequence as RngStream::RandU01 always produced. The
+  // corrections are computed without branches since their outcome
+  // is random.
+  double s10 = m_currentState[0], s11 = m_currentState[1], s12 = m_currentState[2];
+  double s20 = m_currentState[3], s21 = m_currentState[4], s22 = m_currentState[5];
+  for (uint32_t i = 0; i < n; i++)
     {
-      p1 += m1;
+      int32_t k;
+      double p1, p2;
+
+      /* Component 1 */
+      p1 = a12 * s11 - a13n * s10;
+      k = static_cast<int32_t> (p1 * m1inv);
+      p1 -= k * m1;
+      p1 += m1 * (p1 < 0.0);
+      p1 -= m1 * (p1 >= m1);
+      s10 = s11; s11 = s12; s12 = p1;
+
+      /* Component 2 */
+      p2 = a21 * s22 - a23n * s20;
+      k = static_cast<int32_t> (p2 * m2inv);
+      p2 -= k * m2;
+      p2 += m2 * (p2 < 0.0);
+      p2 -= m2 * (p2 >= m2);
+      s20 = s21; s21 = s22; s22 = p2;
+
+      /* Combination */
+      u[i] = (p1 - p2 + m1 * (p1 <= p2)) * norm;
     }
-  m_currentState[0] = m_currentState[1]; m_currentState[1] = m_currentState[2]; m_currentState[2] = p1;
+  m_currentState[0] = s10; m_currentState[1] = s11; m_currentState[2] = s12;
+  m_currentState[3] = s20; m_currentState[4] = s21; m_currentState[5] = s22;
+}
 
-  /* Component 2 */
-  p2 = a21 * m_currentState[5] - a23n * m_currentState[3];
-  k = static_cast<int32_t> (p2 / m2);
-  p2 -= k * m2;
-  if (p2 < 0.0)
+void RngStream::Refill (void)
+{
+  Generate (m_buffer, BUFFER_SIZE);
+  m_next = 0;
+}
+
+void RngStream::RandU01 (double *u, uint32_t n)
+{
+  // hand out the numbers generated in advance first
+  while (n > 0 && m_next < BUFFER_SIZE)
     {
-      p2 += m2;
+      *u++ = m_buffer[m_next++];
+      n--;
     }
-  m_currentState[3] = m_currentState[4]; m_currentState[4] = m_currentState[5]; m_currentState[5] = p2;
-
-  /* Combination */
-  u = ((p1 > p2) ? (p1 - p2) * norm : (p1 - p2 + m1) * norm);
-
-  return u;
+  Generate (u, n);
 }
 
 RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
@@ -302,6 +330,7 @@ RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
     }
   AdvanceNthBy (stream, 127, m_currentState);
   AdvanceNthBy (substream, 76, m_currentState);
+  m_next = BUFFER_SIZE;
 }
 
 RngStream::RngStream(const RngStream& r)
@@ -310,6 +339,11 @@ RngStream::RngStream(const RngStream& r)
     {
       m_currentState[i] = r.m_currentState[i];
     }
+  for (int i = 0; i < BUFFER_SIZE; ++i)
+    {
+      m_buffer[i] = r.m_buffer[i];
+    }
+  m_next = r.m_next;
 }
 
 void 
@@ -43,15 +43,45 @@ public:
   /**
    * Generate the next random number for this stream.
    * Uniformly distributed between 0 and 1.
+   *
+   * The numbers are generated by blocks of RngStream::BUFFER_SIZE and
+   * handed out one by one: the sequence is the same as if each of
+   * them was generated on demand.
    */
   double RandU01 (void);
+  /**
+   * Generate the next n random numbers of this stream.
+   *
+   * \param u the array to fill
+   * \param n the number of random numbers to store in u
+   *
+   * This is equivalent to n calls to RandU01 (void), only cheaper.
+   */
+  void RandU01 (double *u, uint32_t n);
 
 private:
   void AdvanceNthBy (uint64_t nth, int by, double state[6]);
+  void Generate (double *u, uint32_t n);
+  void Refill (void);
+
+  enum { BUFFER_SIZE = 8 };
 
   double m_currentState[6];
+  // numbers generated in advance and the index of the next one
+  double m_buffer[BUFFER_SIZE];
+  uint32_t m_next;
 };
 
+inline double
+RngStream::RandU01 (void)
+{
+  if (m_next == BUFFER_SIZE)
+    {
+      Refill ();
+    }
+  return m_buffer[m_next++];
+}
+
 } // namespace ns3
 
 #endif
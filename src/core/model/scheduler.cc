@@ -42,4 +42,10 @@ Scheduler::GetTypeId (void)
   return tid;
 }
 
+bool
+Scheduler::HasFastRemove (void) const
+{
+  return false;
+}
+
 } // namespace ns3
@@ -101,6 +101,16 @@ public:
    * This methods cannot be invoked if the list is empty.
    */
   virtual void Remove (const Event &ev) = 0;
+  /**
+   * \returns true if Remove takes about as long as Insert, false if
+   *          it must search the event list.
+   *
+   * The simulator removes the cancelled events from the event list
+   * right away when this returns true, and leaves them in the list
+   * until they come up otherwise. The default implementation returns
+   * false.
+   */
+  virtual bool HasFastRemove (void) const;
 };
 
 /* Note the invariants which this function must provide:
@@ -24,12 +24,61 @@
 
 #include "empty.h"
 #include "default-deleter.h"
+#include "memory-accounting.h"
 #include "assert.h"
 #include <stdint.h>
 #include <limits>
 
 namespace ns3 {
 
+/**
+ * \internal
+ * The memory accounting of the instances of SimpleRefCount: done for the
+ * classes deleted by the default deleter only, the Object instances are
+ * accounted per TypeId.
+ */
+template <typename T, typename DELETER>
+struct SimpleRefCountAccounting
+{
+  static bool Allocate (void)
+  {
+    return false;
+  }
+  static void Deallocate (void)
+  {}
+};
+
+/**
+ * \internal
+ * The memory accounting of the classes deleted by the default deleter.
+ */
+template <typename T>
+struct SimpleRefCountAccounting<T, DefaultDeleter<T> >
+{
+  static uint32_t GetAccount (void)
+  {
+    static uint32_t account = MemoryAccounting::GetAccount (typeid (T), sizeof (T));
+    return account;
+  }
+  /**
+   * \returns true if the new instance was counted, in which case
+   *          Deallocate must be called when it is destroyed.
+   */
+  static bool Allocate (void)
+  {
+    if (!MemoryAccounting::IsEnabled ())
+      {
+        return false;
+      }
+    MemoryAccounting::Allocate (GetAccount (), sizeof (T));
+    return true;
+  }
+  static void Deallocate (void)
+  {
+    MemoryAccounting::Deallocate (GetAccount (), sizeof (T));
+  }
+};
+
 /**
  * \ingroup ptr
  * \brief A template-based reference counting class
@@ -68,14 +117,29 @@ public:
    * Constructor
    */
   SimpleRefCount ()
-    : m_count (1)
-  {}
+    : m_count (1),
+      m_accounted (SimpleRefCountAccounting<T, DELETER>::Allocate ())
+  {
+  }
   /**
    * Copy constructor
    */
   SimpleRefCount (const SimpleRefCount &o)
-    : m_count (1)
-  {}
+    : m_count (1),
+      m_accounted (SimpleRefCountAccounting<T, DELETER>::Allocate ())
+  {
+  }
+  /**
+   * Destructor: whether the instance is deleted by Unref or lives
+   * on the stack, it leaves the memory accounts here.
+   */
+  ~SimpleRefCount ()
+  {
+    if (m_accounted)
+      {
+        SimpleRefCountAccounting<T, DELETER>::Deallocate ();
+      }
+  }
   /**
    * Assignment
    */
@@ -126,6 +190,9 @@ private:
   // Note we make this mutable so that the const methods can still
   // change it.
   mutable uint32_t m_count;
+  // true if the instance was counted by MemoryAccounting when it was
+  // created: only those are subtracted when they are destroyed.
+  bool m_accounted;
 };
 
 } // namespace ns3
@@ -28,6 +28,8 @@ namespace ns3 {
  * by the simulation lifetime. That it, the underlying
  * type will be automatically deleted upon a users' call
  * to Simulator::Destroy.
+ *
+ * Each replication (see Replication) has its own instance.
  */
 template <typename T>
 class SimulationSingleton
@@ -49,6 +51,7 @@ private:
 
 
 #include "simulator.h"
+#include "replication.h"
 
 namespace ns3 {
 
@@ -65,12 +68,15 @@ T **
 SimulationSingleton<T>::GetObject (void)
 {
   static T *pobject = 0;
-  if (pobject == 0)
+  // the instance of the replication run by the calling thread
+  static __thread T *replicationObject = 0;
+  T **ppobject = Replication::IsActive () ? &replicationObject : &pobject;
+  if (*ppobject == 0)
     {
-      pobject = new T ();
+      *ppobject = new T ();
       Simulator::ScheduleDestroy (&SimulationSingleton<T>::DeleteObject);
     }
-  return &pobject;
+  return ppobject;
 }
 
 template <typename T>
@@ -0,0 +1,334 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator-profiler.h"
+#include "event-impl.h"
+#include "log.h"
+
+#include <time.h>
+#include <sys/time.h>
+#include <cstdlib>
+#include <typeinfo>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("SimulatorProfiler");
+
+namespace ns3 {
+
+namespace {
+
+/**
+ * A scheduler which forwards all the operations to another
+ * scheduler and records their cost in a SimulatorProfiler.
+ */
+class ProfilingScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  ProfilingScheduler (Ptr<Scheduler> scheduler, SimulatorProfiler *profiler);
+  Ptr<Scheduler> GetScheduler (void) const;
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+  virtual bool HasFastRemove (void) const;
+
+private:
+  Ptr<Scheduler> m_scheduler;
+  SimulatorProfiler *m_profiler;
+};
+
+TypeId
+ProfilingScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ProfilingScheduler")
+    .SetParent<Scheduler> ()
+  ;
+  return tid;
+}
+
+ProfilingScheduler::ProfilingScheduler (Ptr<Scheduler> scheduler, SimulatorProfiler *profiler)
+  : m_scheduler (scheduler),
+    m_profiler (profiler)
+{
+}
+Ptr<Scheduler>
+ProfilingScheduler::GetScheduler (void) const
+{
+  return m_scheduler;
+}
+void
+ProfilingScheduler::Insert (const Event &ev)
+{
+  uint64_t start = SimulatorProfiler::GetTime ();
+  m_scheduler->Insert (ev);
+  m_profiler->RecordInsert (SimulatorProfiler::GetTime () - start);
+}
+bool
+ProfilingScheduler::IsEmpty (void) const
+{
+  return m_scheduler->IsEmpty ();
+}
+Scheduler::Event
+ProfilingScheduler::PeekNext (void) const
+{
+  return m_scheduler->PeekNext ();
+}
+Scheduler::Event
+ProfilingScheduler::RemoveNext (void)
+{
+  uint64_t start = SimulatorProfiler::GetTime ();
+  Event ev = m_scheduler->RemoveNext ();
+  m_profiler->RecordRemove (SimulatorProfiler::GetTime () - start);
+  return ev;
+}
+void
+ProfilingScheduler::Remove (const Event &ev)
+{
+  uint64_t start = SimulatorProfiler::GetTime ();
+  m_scheduler->Remove (ev);
+  m_profiler->RecordRemove (SimulatorProfiler::GetTime () - start);
+}
+bool
+ProfilingScheduler::HasFastRemove (void) const
+{
+  return m_scheduler->HasFastRemove ();
+}
+
+} // anonymous namespace
+
+SimulatorProfiler::Stats::Stats ()
+  : count (0),
+    ns (0)
+{
+}
+
+SimulatorProfiler::SimulatorProfiler ()
+  : m_lastType (0),
+    m_lastStats (0),
+    m_start (GetTime ())
+{
+  NS_LOG_FUNCTION (this);
+}
+SimulatorProfiler::~SimulatorProfiler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+SimulatorProfiler::GetTime (void)
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+  struct timeval tv;
+  gettimeofday (&tv, 0);
+  return tv.tv_sec * 1000000000ULL + tv.tv_usec * 1000ULL;
+#endif
+}
+
+Ptr<Scheduler>
+SimulatorProfiler::Wrap (Ptr<Scheduler> scheduler)
+{
+  NS_LOG_FUNCTION (this << scheduler);
+  return CreateObject<ProfilingScheduler> (scheduler, this);
+}
+
+Ptr<Scheduler>
+SimulatorProfiler::Unwrap (Ptr<Scheduler> scheduler)
+{
+  NS_LOG_FUNCTION (scheduler);
+  Ptr<ProfilingScheduler> profiling = DynamicCast<ProfilingScheduler> (scheduler);
+  NS_ASSERT (profiling != 0);
+  return profiling->GetScheduler ();
+}
+
+void
+SimulatorProfiler::RecordEvent (const EventImpl *event, uint32_t context, uint64_t ns)
+{
+  // type_info::name is unique per type within a module, so the
+  // pointer is a cheap key; the names are merged by the report.
+  const char *type = typeid (*event).name ();
+  if (type != m_lastType)
+    {
+      m_lastType = type;
+      m_lastStats = &m_types[type];
+    }
+  m_lastStats->count++;
+  m_lastStats->ns += ns;
+  struct Stats *stats = &m_noContext;
+  if (context != 0xffffffff)
+    {
+      if (context >= m_contexts.size ())
+        {
+          m_contexts.resize (context + 1);
+        }
+      stats = &m_contexts[context];
+    }
+  stats->count++;
+  stats->ns += ns;
+}
+
+void
+SimulatorProfiler::RecordQueueDepth (uint32_t depth)
+{
+  uint32_t bucket = 0;
+  for (uint64_t i = depth + 1; i > 1; i >>= 1)
+    {
+      bucket++;
+    }
+  if (bucket >= m_depths.size ())
+    {
+      m_depths.resize (bucket + 1, 0);
+    }
+  m_depths[bucket]++;
+}
+
+void
+SimulatorProfiler::RecordInsert (uint64_t ns)
+{
+  m_insert.count++;
+  m_insert.ns += ns;
+}
+
+void
+SimulatorProfiler::RecordRemove (uint64_t ns)
+{
+  m_remove.count++;
+  m_remove.ns += ns;
+}
+
+std::string
+SimulatorProfiler::GetTypeName (const char *mangled)
+{
+#ifdef __GNUC__
+  int status;
+  char *demangled = abi::__cxa_demangle (mangled, 0, 0, &status);
+  if (status == 0 && demangled != 0)
+    {
+      std::string name = demangled;
+      std::free (demangled);
+      return name;
+    }
+#endif
+  return mangled;
+}
+
+void
+SimulatorProfiler::PrintStats (std::ostream &os, const struct Stats &stats, const std::string &name)
+{
+  os << std::setw (12) << stats.count
+     << std::setw (14) << std::fixed << std::setprecision (3) << stats.ns / 1e6
+     << std::setw (12) << std::setprecision (0) << (stats.count == 0 ? 0.0 : double (stats.ns) / stats.count)
+     << "  " << name << std::endl;
+}
+
+namespace {
+bool
+MoreTime (const std::pair<uint64_t, std::string> &a, const std::pair<uint64_t, std::string> &b)
+{
+  return a.first > b.first;
+}
+} // anonymous namespace
+
+void
+SimulatorProfiler::Report (std::ostream &os, uint32_t maxLines) const
+{
+  NS_LOG_FUNCTION (this << &os << maxLines);
+  std::ios_base::fmtflags flags = os.flags ();
+  std::streamsize precision = os.precision ();
+
+  // merge the types with the same name
+  std::map<std::string, struct Stats> types;
+  struct Stats total;
+  for (TypeStats::const_iterator i = m_types.begin (); i != m_types.end (); ++i)
+    {
+      struct Stats &stats = types[GetTypeName (i->first)];
+      stats.count += i->second.count;
+      stats.ns += i->second.ns;
+      total.count += i->second.count;
+      total.ns += i->second.ns;
+    }
+
+  os << "Simulator profile: " << total.count << " events in "
+     << std::fixed << std::setprecision (3) << (GetTime () - m_start) / 1e9
+     << " s of wall-clock time, " << total.ns / 1e9 << " s running events" << std::endl;
+  os << std::setw (12) << "count" << std::setw (14) << "total (ms)"
+     << std::setw (12) << "mean (ns)" << "  what" << std::endl;
+  PrintStats (os, m_insert, "scheduler insert");
+  PrintStats (os, m_remove, "scheduler remove");
+
+  os << "Event types:" << std::endl;
+  std::vector<std::pair<uint64_t, std::string> > order;
+  for (std::map<std::string, struct Stats>::const_iterator i = types.begin (); i != types.end (); ++i)
+    {
+      order.push_back (std::make_pair (i->second.ns, i->first));
+    }
+  std::sort (order.begin (), order.end (), &MoreTime);
+  for (uint32_t i = 0; i < order.size () && i < maxLines; i++)
+    {
+      PrintStats (os, types[order[i].second], order[i].second);
+    }
+
+  os << "Contexts:" << std::endl;
+  std::vector<std::pair<uint64_t, uint32_t> > contexts;
+  for (uint32_t i = 0; i < m_contexts.size (); i++)
+    {
+      if (m_contexts[i].count != 0)
+        {
+          contexts.push_back (std::make_pair (m_contexts[i].ns, i));
+        }
+    }
+  std::sort (contexts.begin (), contexts.end ());
+  std::reverse (contexts.begin (), contexts.end ());
+  if (m_noContext.count != 0)
+    {
+      PrintStats (os, m_noContext, "no context");
+    }
+  for (uint32_t i = 0; i < contexts.size () && i < maxLines; i++)
+    {
+      std::ostringstream oss;
+      oss << "context " << contexts[i].second;
+      PrintStats (os, m_contexts[contexts[i].second], oss.str ());
+    }
+
+  os << "Pending events:" << std::endl;
+  for (uint32_t i = 0; i < m_depths.size (); i++)
+    {
+      if (m_depths[i] == 0)
+        {
+          continue;
+        }
+      std::ostringstream oss;
+      oss << "[" << (1ULL << i) - 1 << ", " << (2ULL << i) - 1 << ")";
+      os << std::setw (24) << oss.str () << std::setw (12) << m_depths[i] << std::endl;
+    }
+
+  os.flags (flags);
+  os.precision (precision);
+}
+
+} // namespace ns3
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SIMULATOR_PROFILER_H
+#define SIMULATOR_PROFILER_H
+
+#include "scheduler.h"
+#include "ptr.h"
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+#include <string>
+#include <ostream>
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ * \brief wall-clock profile of the events run by a simulator
+ *
+ * The profiler records, for each type of event and for each context,
+ * the number of events run and the wall-clock time spent running
+ * them. The type of an event is the dynamic type of its EventImpl,
+ * that is the MakeEvent template instantiation which created it,
+ * which names the class and the signature of the function called by
+ * the event. The profiler also records the cost of the operations of
+ * the scheduler, through the scheduler returned by
+ * SimulatorProfiler::Wrap, and a histogram of the number of pending
+ * events.
+ *
+ * See the Profile attribute of ns3::DefaultSimulatorImpl.
+ */
+class SimulatorProfiler
+{
+public:
+  SimulatorProfiler ();
+  ~SimulatorProfiler ();
+
+  /**
+   * \returns the value of a monotonic wall clock, in nanoseconds
+   */
+  static uint64_t GetTime (void);
+
+  /**
+   * \param scheduler a scheduler
+   * \returns a scheduler which forwards all the operations to
+   *          scheduler and records their cost in this profiler.
+   *
+   * The returned scheduler must not outlive this profiler.
+   */
+  Ptr<Scheduler> Wrap (Ptr<Scheduler> scheduler);
+  /**
+   * \param scheduler a scheduler returned by SimulatorProfiler::Wrap
+   * \returns the scheduler wrapped by scheduler
+   */
+  static Ptr<Scheduler> Unwrap (Ptr<Scheduler> scheduler);
+
+  /**
+   * \param event the event which was run
+   * \param context the context of the event
+   * \param ns the wall-clock time spent running the event
+   */
+  void RecordEvent (const EventImpl *event, uint32_t context, uint64_t ns);
+  /**
+   * \param depth the number of pending events
+   */
+  void RecordQueueDepth (uint32_t depth);
+  /**
+   * \param ns the wall-clock time spent inserting an event in the scheduler
+   */
+  void RecordInsert (uint64_t ns);
+  /**
+   * \param ns the wall-clock time spent removing an event from the scheduler
+   */
+  void RecordRemove (uint64_t ns);
+
+  /**
+   * \param os the output stream
+   * \param maxLines the largest number of event types and of contexts
+   *        to print, the most expensive first
+   */
+  void Report (std::ostream &os, uint32_t maxLines = 30) const;
+
+private:
+  struct Stats
+  {
+    Stats ();
+    uint64_t count;
+    uint64_t ns;
+  };
+  typedef std::map<const char *, struct Stats> TypeStats;
+
+  static std::string GetTypeName (const char *mangled);
+  static void PrintStats (std::ostream &os, const struct Stats &stats, const std::string &name);
+
+  TypeStats m_types;
+  // the stats of the last type looked up, since the events of the
+  // same type often follow each other
+  const char *m_lastType;
+  struct Stats *m_lastStats;
+  std::vector<struct Stats> m_contexts;
+  struct Stats m_noContext;
+  struct Stats m_insert;
+  struct Stats m_remove;
+  // m_depths[i] counts the events run while the number of pending
+  // events was in [2^i - 1, 2^(i+1) - 1)
+  std::vector<uint64_t> m_depths;
+  uint64_t m_start;
+};
+
+} // namespace ns3
+
+#endif /* SIMULATOR_PROFILER_H */
@@ -23,6 +23,7 @@
 #include "scheduler.h"
 #include "map-scheduler.h"
 #include "event-impl.h"
+#include "replication.h"
 
 #include "ptr.h"
 #include "string.h"
@@ -74,10 +75,19 @@ NodePrinter (std::ostream &os)
     }
 }
 
+static void
+StampGetter (double *seconds, uint32_t *context)
+{
+  *seconds = Simulator::Now ().GetSeconds ();
+  *context = Simulator::GetContext ();
+}
+
 static SimulatorImpl **PeekImpl (void)
 {
   static SimulatorImpl *impl = 0;
-  return &impl;
+  // the simulator of the replication run by the calling thread
+  static __thread SimulatorImpl *replicationImpl = 0;
+  return Replication::IsActive () ? &replicationImpl : &impl;
 }
 
 static SimulatorImpl * GetImpl (void)
@@ -111,8 +121,15 @@ static SimulatorImpl * GetImpl (void)
 // Simulator::Now which would call Simulator::GetImpl, and, thus, get us 
 // in an infinite recursion until the stack explodes.
 //
-      LogSetTimePrinter (&TimePrinter);
-      LogSetNodePrinter (&NodePrinter);
+// The printers are process-wide: the replications leave them to the
+// main simulation.
+//
+      if (!Replication::IsActive ())
+        {
+          LogSetTimePrinter (&TimePrinter);
+          LogSetNodePrinter (&NodePrinter);
+          LogSetStampGetter (&StampGetter);
+        }
     }
   return *pimpl;
 }
@@ -132,8 +149,12 @@ Simulator::Destroy (void)
    * legal), Simulator::GetImpl will trigger again an infinite recursion until
    * the stack explodes.
    */
-  LogSetTimePrinter (0);
-  LogSetNodePrinter (0);
+  if (!Replication::IsActive ())
+    {
+      LogSetTimePrinter (0);
+      LogSetNodePrinter (0);
+      LogSetStampGetter (0);
+    }
   (*pimpl)->Destroy ();
   (*pimpl)->Unref ();
   *pimpl = 0;
@@ -341,6 +362,7 @@ Simulator::SetImplementation (Ptr<SimulatorImpl> impl)
 //
   LogSetTimePrinter (&TimePrinter);
   LogSetNodePrinter (&NodePrinter);
+  LogSetStampGetter (&StampGetter);
 }
 Ptr<SimulatorImpl>
 Simulator::GetImplementation (void)
@@ -50,6 +50,11 @@ public:
             typename T4, typename T5, typename T6>
   void SetArgs (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6);
 
+  /**
+   * \returns a new instance which calls the same function with the
+   *          same arguments
+   */
+  virtual TimerImpl *Copy (void) const = 0;
   virtual EventId Schedule (const Time &delay) = 0;
   virtual void Invoke (void) = 0;
 };
@@ -113,6 +118,10 @@ MakeTimerImpl (IntToType<0>, FN fn)
       : m_fn (fn)
     {
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplZero (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn);
@@ -144,6 +153,10 @@ MakeTimerImpl (IntToType<1>, FN fn)
     {
       m_a1 = a1;
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplOne (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn, m_a1);
@@ -180,6 +193,10 @@ MakeTimerImpl (IntToType<2>, FN fn)
       m_a1 = a1;
       m_a2 = a2;
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplTwo (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn, m_a1, m_a2);
@@ -221,6 +238,10 @@ MakeTimerImpl (IntToType<3>, FN fn)
       m_a2 = a2;
       m_a3 = a3;
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplThree (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn, m_a1, m_a2, m_a3);
@@ -267,6 +288,10 @@ MakeTimerImpl (IntToType<4>, FN fn)
       m_a3 = a3;
       m_a4 = a4;
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplFour (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn, m_a1, m_a2, m_a3, m_a4);
@@ -318,6 +343,10 @@ MakeTimerImpl (IntToType<5>, FN fn)
       m_a4 = a4;
       m_a5 = a5;
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplFive (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn, m_a1, m_a2, m_a3, m_a4, m_a5);
@@ -374,6 +403,10 @@ MakeTimerImpl (IntToType<6>, FN fn)
       m_a5 = a5;
       m_a6 = a6;
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new FnTimerImplSix (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn, m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
@@ -426,6 +459,10 @@ MakeTimerImpl (IntToType<0>, MEM_PTR memPtr, OBJ_PTR objPtr)
         m_objPtr (objPtr)
     {
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplZero (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr);
@@ -459,6 +496,10 @@ MakeTimerImpl (IntToType<1>, MEM_PTR memPtr, OBJ_PTR objPtr)
     {
       m_a1 = a1;
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplOne (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1);
@@ -497,6 +538,10 @@ MakeTimerImpl (IntToType<2>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a1 = a1;
       m_a2 = a2;
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplTwo (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2);
@@ -540,6 +585,10 @@ MakeTimerImpl (IntToType<3>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a2 = a2;
       m_a3 = a3;
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplThree (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3);
@@ -588,6 +637,10 @@ MakeTimerImpl (IntToType<4>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a3 = a3;
       m_a4 = a4;
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplFour (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4);
@@ -641,6 +694,10 @@ MakeTimerImpl (IntToType<5>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a4 = a4;
       m_a5 = a5;
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplFive (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4, m_a5);
@@ -699,6 +756,10 @@ MakeTimerImpl (IntToType<6>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a5 = a5;
       m_a6 = a6;
     }
+    virtual TimerImpl *Copy (void) const
+    {
+      return new MemFnTimerImplSix (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
@@ -0,0 +1,370 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "timer-wheel.h"
+#include "timer.h"
+#include "simulator.h"
+#include "simulation-singleton.h"
+#include "global-value.h"
+#include "system-mutex.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("TimerWheel");
+
+namespace ns3 {
+
+static GlobalValue g_timerWheelResolution = GlobalValue ("TimerWheelResolution",
+                                                         "The duration of the slots of the lowest level of the timer wheels",
+                                                         TimeValue (MilliSeconds (1)),
+                                                         MakeTimeChecker (TimeStep (1)));
+
+namespace {
+
+/**
+ * The wheels of the contexts of a simulation.  The wheels are never
+ * moved, so that they can be looked up without holding the mutex, which
+ * only serializes their creation by the threads of a multithreaded
+ * simulation.
+ */
+class TimerWheels
+{
+public:
+  TimerWheels ();
+  ~TimerWheels ();
+  TimerWheel *Get (uint32_t context);
+
+private:
+  enum
+  {
+    CHUNK_BITS = 8,
+    CHUNK_SIZE = 1 << CHUNK_BITS,
+    CHUNKS = 4096
+  };
+  // the wheel of a context is in the chunk of context + 1, so that the
+  // wheel of Simulator::NO_CONTEXT comes first
+  TimerWheel **m_chunks[CHUNKS];
+  int64_t m_resolution;
+  SystemMutex m_mutex;
+};
+
+TimerWheels::TimerWheels ()
+{
+  for (uint32_t i = 0; i < CHUNKS; i++)
+    {
+      m_chunks[i] = 0;
+    }
+  TimeValue resolution;
+  g_timerWheelResolution.GetValue (resolution);
+  m_resolution = std::max<int64_t> (resolution.Get ().GetTimeStep (), 1);
+}
+
+TimerWheels::~TimerWheels ()
+{
+  for (uint32_t i = 0; i < CHUNKS; i++)
+    {
+      if (m_chunks[i] == 0)
+        {
+          continue;
+        }
+      for (uint32_t j = 0; j < CHUNK_SIZE; j++)
+        {
+          delete m_chunks[i][j];
+        }
+      delete [] m_chunks[i];
+    }
+}
+
+TimerWheel *
+TimerWheels::Get (uint32_t context)
+{
+  uint32_t index = context + 1;
+  uint32_t chunk = index >> CHUNK_BITS;
+  if (chunk >= CHUNKS)
+    {
+      return 0;
+    }
+  TimerWheel **wheels = m_chunks[chunk];
+  if (wheels != 0 && wheels[index & (CHUNK_SIZE - 1)] != 0)
+    {
+      return wheels[index & (CHUNK_SIZE - 1)];
+    }
+  CriticalSection critical (m_mutex);
+  if (m_chunks[chunk] == 0)
+    {
+      wheels = new TimerWheel *[CHUNK_SIZE];
+      std::fill (wheels, wheels + CHUNK_SIZE, (TimerWheel *)0);
+      // publish the chunk after its initialization
+      __sync_synchronize ();
+      m_chunks[chunk] = wheels;
+    }
+  wheels = m_chunks[chunk];
+  if (wheels[index & (CHUNK_SIZE - 1)] == 0)
+    {
+      TimerWheel *wheel = new TimerWheel (m_resolution);
+      __sync_synchronize ();
+      wheels[index & (CHUNK_SIZE - 1)] = wheel;
+    }
+  return wheels[index & (CHUNK_SIZE - 1)];
+}
+
+} // anonymous namespace
+
+TimerWheel::Link::Link ()
+  : prev (0),
+    next (0),
+    wheel (0),
+    slot (0),
+    expire (0)
+{
+}
+
+TimerWheel::TimerWheel (int64_t resolution)
+  : m_resolution (resolution),
+    m_current (0),
+    m_nTimers (0),
+    m_tickDue (-1)
+{
+  NS_LOG_FUNCTION (this << resolution);
+  std::fill (m_slots, m_slots + LEVELS * SLOTS, (Timer *)0);
+  std::fill (m_occupied, m_occupied + LEVELS, 0);
+}
+
+TimerWheel::~TimerWheel ()
+{
+  NS_LOG_FUNCTION (this);
+  // the timers which outlive the simulation are left expired
+  for (uint32_t i = 0; i < LEVELS * SLOTS; i++)
+    {
+      Timer *timer = m_slots[i];
+      while (timer != 0)
+        {
+          Timer *next = timer->m_link.next;
+          timer->m_link = TimerWheel::Link ();
+          timer = next;
+        }
+    }
+}
+
+TimerWheel *
+TimerWheel::GetWheel (void)
+{
+  return SimulationSingleton<TimerWheels>::Get ()->Get (Simulator::GetContext ());
+}
+
+bool
+TimerWheel::Insert (Timer *timer, const Time &delay)
+{
+  NS_LOG_FUNCTION (timer << delay);
+  NS_ASSERT (!IsLinked (timer));
+  TimerWheel *wheel = GetWheel ();
+  if (wheel == 0)
+    {
+      return false;
+    }
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  int64_t due;
+  if (!wheel->DoInsert (timer, now + delay.GetTimeStep (), now, &due))
+    {
+      return false;
+    }
+  if (wheel->m_tickDue < 0 || due < wheel->m_tickDue)
+    {
+      wheel->ScheduleTick (due, now);
+    }
+  return true;
+}
+
+void
+TimerWheel::Remove (Timer *timer)
+{
+  if (timer->m_link.wheel != 0)
+    {
+      timer->m_link.wheel->RemoveFromSlot (timer);
+    }
+}
+
+bool
+TimerWheel::IsLinked (const Timer *timer)
+{
+  return timer->m_link.wheel != 0;
+}
+
+Time
+TimerWheel::GetDelayLeft (const Timer *timer)
+{
+  NS_ASSERT (IsLinked (timer));
+  return TimeStep (timer->m_link.expire - Simulator::Now ().GetTimeStep ());
+}
+
+uint32_t
+TimerWheel::GetNTimers (void)
+{
+  TimerWheel *wheel = GetWheel ();
+  return (wheel == 0) ? 0 : wheel->m_nTimers;
+}
+
+bool
+TimerWheel::DoInsert (Timer *timer, int64_t expire, int64_t now, int64_t *due)
+{
+  int64_t slot = expire / m_resolution;
+  int64_t current = now / m_resolution;
+  if (slot <= current)
+    {
+      return false;
+    }
+  if (m_nTimers == 0)
+    {
+      m_current = current;
+    }
+  // the timer goes in the level of the highest digit of its slot number
+  // which differs from the current slot number: the slots of the levels
+  // below it come up first.
+  uint64_t diff = slot ^ m_current;
+  uint32_t level = (63 - __builtin_clzll (diff)) / SLOT_BITS;
+  if (level >= LEVELS)
+    {
+      return false;
+    }
+  uint32_t shift = level * SLOT_BITS;
+  timer->m_link.expire = expire;
+  AddToSlot (timer, level * SLOTS + ((slot >> shift) & (SLOTS - 1)));
+  *due = (slot >> shift) << shift;
+  return true;
+}
+
+void
+TimerWheel::AddToSlot (Timer *timer, uint32_t slot)
+{
+  TimerWheel::Link &link = timer->m_link;
+  link.wheel = this;
+  link.slot = slot;
+  link.prev = 0;
+  link.next = m_slots[slot];
+  if (link.next != 0)
+    {
+      link.next->m_link.prev = timer;
+    }
+  m_slots[slot] = timer;
+  m_occupied[slot / SLOTS] |= (1 << (slot % SLOTS));
+  m_nTimers++;
+}
+
+void
+TimerWheel::RemoveFromSlot (Timer *timer)
+{
+  TimerWheel::Link &link = timer->m_link;
+  if (link.prev != 0)
+    {
+      link.prev->m_link.next = link.next;
+    }
+  else
+    {
+      m_slots[link.slot] = link.next;
+      if (link.next == 0)
+        {
+          m_occupied[link.slot / SLOTS] &= ~(1 << (link.slot % SLOTS));
+        }
+    }
+  if (link.next != 0)
+    {
+      link.next->m_link.prev = link.prev;
+    }
+  link.wheel = 0;
+  link.prev = 0;
+  link.next = 0;
+  m_nTimers--;
+}
+
+bool
+TimerWheel::GetNextSlot (uint32_t *slot, int64_t *due) const
+{
+  // the occupied slots of a level come up after the current slot of the
+  // level, and before the occupied slots of the levels above
+  for (uint32_t level = 0; level < LEVELS; level++)
+    {
+      uint32_t shift = level * SLOT_BITS;
+      uint32_t digit = (m_current >> shift) & (SLOTS - 1);
+      uint32_t first = (level == 0) ? digit : digit + 1;
+      uint32_t occupied = m_occupied[level] & ~((1U << first) - 1);
+      if (occupied != 0)
+        {
+          uint32_t index = __builtin_ctz (occupied);
+          uint32_t upper = shift + SLOT_BITS;
+          *slot = level * SLOTS + index;
+          *due = ((m_current >> upper) << upper) | ((int64_t)index << shift);
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+TimerWheel::ScheduleTick (int64_t due, int64_t now)
+{
+  NS_LOG_FUNCTION (this << due);
+  m_tick.Cancel ();
+  m_tickDue = due;
+  m_tick = Simulator::Schedule (TimeStep (std::max<int64_t> (due * m_resolution - now, 0)),
+                                &TimerWheel::Tick, this);
+}
+
+void
+TimerWheel::Tick (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_tickDue = -1;
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  int64_t current = now / m_resolution;
+  uint32_t slot;
+  int64_t due;
+  while (GetNextSlot (&slot, &due))
+    {
+      if (due > current)
+        {
+          ScheduleTick (due, now);
+          return;
+        }
+      m_current = due;
+      Timer *timer = m_slots[slot];
+      m_slots[slot] = 0;
+      m_occupied[slot / SLOTS] &= ~(1 << (slot % SLOTS));
+      while (timer != 0)
+        {
+          Timer *next = timer->m_link.next;
+          int64_t expire = timer->m_link.expire;
+          timer->m_link = TimerWheel::Link ();
+          m_nTimers--;
+          int64_t ignored;
+          if (!DoInsert (timer, expire, now, &ignored))
+            {
+              timer->m_link.expire = expire;
+              Expire (timer, now);
+            }
+          timer = next;
+        }
+    }
+}
+
+void
+TimerWheel::Expire (Timer *timer, int64_t now)
+{
+  // the slot of the timer came up: it expires in the event list, at its
+  // exact expiration time
+  timer->m_event = timer->m_impl->Schedule (TimeStep (std::max<int64_t> (timer->m_link.expire - now, 0)));
+}
+
+} // namespace ns3
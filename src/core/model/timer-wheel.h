@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "nstime.h"
+#include "event-id.h"
+#include <stdint.h>
+
+namespace ns3 {
+
+class Timer;
+
+/**
+ * \ingroup core
+ *
+ * \brief a hierarchical timing wheel which holds the Timers of a context
+ *        until they are about to expire
+ *
+ * The Timers which use the Timer::SCHEDULE_WHEEL policy are not
+ * scheduled in the simulator event list: they are linked in the slot of
+ * the wheel of the current context which covers their expiration time,
+ * so that scheduling, cancelling and rescheduling them takes a constant
+ * time.  The wheel itself schedules a single event, at the start of its
+ * earliest occupied slot.  When a slot of the lowest level comes up, its
+ * Timers are scheduled in the event list at their exact expiration
+ * time; when a slot of a higher level comes up, its Timers are spread
+ * over the slots of the lower levels.  The Timers which are cancelled
+ * before their slot comes up never reach the event list.
+ *
+ * The slots of the lowest level last the resolution set by the
+ * "TimerWheelResolution" global value, and each level covers 16 slots of
+ * the level below.  The Timers which expire before the end of the
+ * current slot, or beyond the range of the wheel (2^24 slots), are
+ * scheduled directly in the event list.
+ *
+ * The wheels are deleted by Simulator::Destroy.  This class is only
+ * used by the Timer class.
+ */
+class TimerWheel
+{
+public:
+  /**
+   * \brief the link of a Timer in a slot of a wheel
+   */
+  struct Link
+  {
+    Link ();
+    /// the previous Timer of the slot
+    Timer *prev;
+    /// the next Timer of the slot
+    Timer *next;
+    /// the wheel of the slot, zero if the Timer is not linked
+    TimerWheel *wheel;
+    /// the slot, level * 16 + index
+    uint32_t slot;
+    /// the expiration time, in time steps
+    int64_t expire;
+  };
+
+  /**
+   * \param timer the Timer to link in the wheel of the current context
+   * \param delay the delay after which the timer expires
+   * \returns false if the timer must be scheduled in the event list
+   *          instead.
+   */
+  static bool Insert (Timer *timer, const Time &delay);
+  /**
+   * \param timer the Timer to unlink from its wheel, if linked
+   */
+  static void Remove (Timer *timer);
+  /**
+   * \param timer a Timer
+   * \returns true if the timer is linked in a wheel
+   */
+  static bool IsLinked (const Timer *timer);
+  /**
+   * \param timer a Timer linked in a wheel
+   * \returns the time left until the timer expires
+   */
+  static Time GetDelayLeft (const Timer *timer);
+  /**
+   * \returns the number of Timers linked in the wheel of the current
+   *          context.
+   */
+  static uint32_t GetNTimers (void);
+
+  /**
+   * \param resolution the duration of a slot of the lowest level, in
+   *        time steps
+   */
+  TimerWheel (int64_t resolution);
+  ~TimerWheel ();
+
+private:
+  enum
+  {
+    SLOT_BITS = 4,
+    SLOTS = 1 << SLOT_BITS,
+    LEVELS = 6
+  };
+
+  bool DoInsert (Timer *timer, int64_t expire, int64_t now, int64_t *due);
+  void AddToSlot (Timer *timer, uint32_t slot);
+  void RemoveFromSlot (Timer *timer);
+  bool GetNextSlot (uint32_t *slot, int64_t *due) const;
+  void ScheduleTick (int64_t due, int64_t now);
+  void Tick (void);
+  static void Expire (Timer *timer, int64_t now);
+  static TimerWheel *GetWheel (void);
+
+  /// the first Timer of each slot
+  Timer *m_slots[LEVELS * SLOTS];
+  /// the occupied slots of each level
+  uint16_t m_occupied[LEVELS];
+  /// the duration of a slot of the lowest level, in time steps
+  int64_t m_resolution;
+  /// the current slot number of the lowest level
+  int64_t m_current;
+  /// the number of linked Timers
+  uint32_t m_nTimers;
+  /// the event of the next tick
+  EventId m_tick;
+  /// the slot number of the next tick
+  int64_t m_tickDue;
+};
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
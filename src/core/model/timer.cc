@@ -44,27 +44,74 @@ Timer::Timer (enum DestroyPolicy destroyPolicy)
   NS_LOG_FUNCTION (this << destroyPolicy);
 }
 
+Timer::Timer (enum DestroyPolicy destroyPolicy, enum SchedulePolicy schedulePolicy)
+  : m_flags (destroyPolicy | schedulePolicy),
+    m_delay (FemtoSeconds (0)),
+    m_event (),
+    m_impl (0)
+{
+  NS_LOG_FUNCTION (this << destroyPolicy << schedulePolicy);
+}
+
+Timer::Timer (const Timer &o)
+  : m_flags (o.m_flags),
+    m_delay (o.m_delay),
+    m_event (o.m_event),
+    m_impl (o.m_impl == 0 ? 0 : o.m_impl->Copy ()),
+    m_delayLeft (o.m_delayLeft)
+{
+  NS_LOG_FUNCTION (this << &o);
+  // the link belongs to the timer held in the wheel
+}
+
+Timer &
+Timer::operator = (const Timer &o)
+{
+  NS_LOG_FUNCTION (this << &o);
+  if (this != &o)
+    {
+      TimerWheel::Remove (this);
+      m_flags = o.m_flags;
+      m_delay = o.m_delay;
+      m_event = o.m_event;
+      delete m_impl;
+      m_impl = o.m_impl == 0 ? 0 : o.m_impl->Copy ();
+      m_delayLeft = o.m_delayLeft;
+    }
+  return *this;
+}
+
 Timer::~Timer ()
 {
   NS_LOG_FUNCTION (this);
   if (m_flags & CHECK_ON_DESTROY)
     {
-      if (m_event.IsRunning ())
+      if (m_event.IsRunning () || TimerWheel::IsLinked (this))
         {
           NS_FATAL_ERROR ("Event is still running while destroying.");
         }
     }
   else if (m_flags & CANCEL_ON_DESTROY)
     {
+      TimerWheel::Remove (this);
       m_event.Cancel ();
     }
   else if (m_flags & REMOVE_ON_DESTROY)
     {
+      TimerWheel::Remove (this);
       Simulator::Remove (m_event);
     }
   delete m_impl;
 }
 
+void
+Timer::SetSchedulePolicy (enum SchedulePolicy schedulePolicy)
+{
+  NS_LOG_FUNCTION (this << schedulePolicy);
+  NS_ASSERT (!IsRunning ());
+  m_flags = (m_flags & ~SCHEDULE_WHEEL) | schedulePolicy;
+}
+
 void
 Timer::SetDelay (const Time &time)
 {
@@ -84,6 +131,10 @@ Timer::GetDelayLeft (void) const
   switch (GetState ())
     {
     case Timer::RUNNING:
+      if (TimerWheel::IsLinked (this))
+        {
+          return TimerWheel::GetDelayLeft (this);
+        }
       return Simulator::GetDelayLeft (m_event);
       break;
     case Timer::EXPIRED:
@@ -103,25 +154,27 @@ void
 Timer::Cancel (void)
 {
   NS_LOG_FUNCTION (this);
+  TimerWheel::Remove (this);
   Simulator::Cancel (m_event);
 }
 void
 Timer::Remove (void)
 {
   NS_LOG_FUNCTION (this);
+  TimerWheel::Remove (this);
   Simulator::Remove (m_event);
 }
 bool
 Timer::IsExpired (void) const
 {
   NS_LOG_FUNCTION (this);
-  return !IsSuspended () && m_event.IsExpired ();
+  return !IsSuspended () && !TimerWheel::IsLinked (this) && m_event.IsExpired ();
 }
 bool
 Timer::IsRunning (void) const
 {
   NS_LOG_FUNCTION (this);
-  return !IsSuspended () && m_event.IsRunning ();
+  return !IsSuspended () && (TimerWheel::IsLinked (this) || m_event.IsRunning ());
 }
 bool
 Timer::IsSuspended (void) const
@@ -160,10 +213,20 @@ Timer::Schedule (Time delay)
 {
   NS_LOG_FUNCTION (this << delay);
   NS_ASSERT (m_impl != 0);
-  if (m_event.IsRunning ())
+  if (m_event.IsRunning () || TimerWheel::IsLinked (this))
     {
       NS_FATAL_ERROR ("Event is still running while re-scheduling.");
     }
+  DoSchedule (delay);
+}
+
+void
+Timer::DoSchedule (const Time &delay)
+{
+  if ((m_flags & SCHEDULE_WHEEL) && TimerWheel::Insert (this, delay))
+    {
+      return;
+    }
   m_event = m_impl->Schedule (delay);
 }
 
@@ -172,8 +235,16 @@ Timer::Suspend (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (IsRunning ());
-  m_delayLeft = Simulator::GetDelayLeft (m_event);
-  Simulator::Remove (m_event);
+  if (TimerWheel::IsLinked (this))
+    {
+      m_delayLeft = TimerWheel::GetDelayLeft (this);
+      TimerWheel::Remove (this);
+    }
+  else
+    {
+      m_delayLeft = Simulator::GetDelayLeft (m_event);
+      Simulator::Remove (m_event);
+    }
   m_flags |= TIMER_SUSPENDED;
 }
 
@@ -182,7 +253,7 @@ Timer::Resume (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_flags & TIMER_SUSPENDED);
-  m_event = m_impl->Schedule (m_delayLeft);
+  DoSchedule (m_delayLeft);
   m_flags &= ~TIMER_SUSPENDED;
 }
 
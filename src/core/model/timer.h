@@ -24,6 +24,7 @@
 #include "nstime.h"
 #include "event-id.h"
 #include "int-to-type.h"
+#include "timer-wheel.h"
 
 namespace ns3 {
 
@@ -41,6 +42,11 @@ class TimerImpl;
  * A timer can also be used to enforce a set of predefined event lifetime
  * management policies. These policies are specified at construction time
  * and cannot be changed after.
+ *
+ * A timer which is rescheduled much more often than it expires, such as
+ * a retransmission timeout, can use the SCHEDULE_WHEEL policy: it is
+ * then held in a TimerWheel until it is about to expire, so that
+ * scheduling and cancelling it does not touch the simulator event list.
  */
 class Timer
 {
@@ -67,6 +73,23 @@ public:
      */
     CHECK_ON_DESTROY = (1 << 5)
   };
+  /**
+   * The policy to use to schedule the expiration of the timer.
+   */
+  enum SchedulePolicy
+  {
+    /**
+     * This policy schedules the expiration of the timer in the simulator
+     * event list.
+     */
+    SCHEDULE_EVENT = 0,
+    /**
+     * This policy holds the timer in the TimerWheel of the current
+     * context until it is about to expire.  The timer still expires at
+     * the exact time for which it was scheduled.
+     */
+    SCHEDULE_WHEEL = (1 << 6)
+  };
   enum State
   {
     RUNNING,
@@ -82,8 +105,35 @@ public:
    * \param destroyPolicy the event lifetime management policies to use for destroy events
    */
   Timer (enum DestroyPolicy destroyPolicy);
+  /**
+   * \param destroyPolicy the event lifetime management policies to use for destroy events
+   * \param schedulePolicy the policy to use to schedule the expiration of the timer
+   */
+  Timer (enum DestroyPolicy destroyPolicy, enum SchedulePolicy schedulePolicy);
+  /**
+   * \param o the timer to copy
+   *
+   * The copy has its own copy of the function and of the arguments
+   * of \p o. The copy of a timer held in a TimerWheel is not running.
+   */
+  Timer (const Timer &o);
+  /**
+   * \param o the timer to copy
+   * \returns this timer
+   *
+   * This timer leaves the TimerWheel it is held in, then copies \p o
+   * as the copy constructor does.
+   */
+  Timer & operator = (const Timer &o);
   ~Timer ();
 
+  /**
+   * \param schedulePolicy the policy to use to schedule the expiration of the timer
+   *
+   * The policy cannot be changed while the timer is running.
+   */
+  void SetSchedulePolicy (enum SchedulePolicy schedulePolicy);
+
   /**
    * \param fn the function
    *
@@ -230,6 +280,10 @@ public:
   void Resume (void);
 
 private:
+  friend class TimerWheel;
+
+  void DoSchedule (const Time &delay);
+
   enum
   {
     TIMER_SUSPENDED = (1 << 7)
@@ -240,6 +294,7 @@ private:
   EventId m_event;
   TimerImpl *m_impl;
   Time m_delayLeft;
+  TimerWheel::Link m_link;
 };
 
 } // namespace ns3
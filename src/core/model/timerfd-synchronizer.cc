@@ -0,0 +1,328 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "timerfd-synchronizer.h"
+#include "log.h"
+#include "fatal-error.h"
+#include "trace-source-accessor.h"
+
+#include <sys/timerfd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <time.h>
+#include <cerrno>
+#include <cstring>
+
+NS_LOG_COMPONENT_DEFINE ("TimerfdSynchronizer");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (TimerfdSynchronizer);
+
+TypeId
+TimerfdSynchronizer::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TimerfdSynchronizer")
+    .SetParent<Synchronizer> ()
+    .AddConstructor<TimerfdSynchronizer> ()
+    .AddAttribute ("SpinWindow",
+                   "How long before the time of an event to wake up and busy-wait for it.",
+                   TimeValue (MicroSeconds (50)),
+                   MakeTimeAccessor (&TimerfdSynchronizer::m_spinWindow),
+                   MakeTimeChecker (Time (0)))
+    .AddTraceSource ("Lateness",
+                     "How late the wait for an event ended.",
+                     MakeTraceSourceAccessor (&TimerfdSynchronizer::m_latenessTrace))
+  ;
+  return tid;
+}
+
+TimerfdSynchronizer::TimerfdSynchronizer ()
+  : m_condition (false),
+    m_nsEventStart (0),
+    m_maxLateness (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_epollFd = epoll_create1 (EPOLL_CLOEXEC);
+  if (m_epollFd == -1)
+    {
+      NS_FATAL_ERROR ("epoll_create1() failed: " << std::strerror (errno));
+    }
+  m_timerFd = timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (m_timerFd == -1)
+    {
+      NS_FATAL_ERROR ("timerfd_create() failed: " << std::strerror (errno));
+    }
+  m_eventFd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_eventFd == -1)
+    {
+      NS_FATAL_ERROR ("eventfd() failed: " << std::strerror (errno));
+    }
+  int fds[2] = { m_timerFd, m_eventFd };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      struct epoll_event ev;
+      std::memset (&ev, 0, sizeof (ev));
+      ev.events = EPOLLIN;
+      ev.data.fd = fds[i];
+      if (epoll_ctl (m_epollFd, EPOLL_CTL_ADD, fds[i], &ev) == -1)
+        {
+          NS_FATAL_ERROR ("epoll_ctl() failed: " << std::strerror (errno));
+        }
+    }
+}
+
+TimerfdSynchronizer::~TimerfdSynchronizer ()
+{
+  NS_LOG_FUNCTION (this);
+  close (m_eventFd);
+  close (m_timerFd);
+  close (m_epollFd);
+}
+
+std::vector<uint64_t>
+TimerfdSynchronizer::GetLatenessHistogram (void) const
+{
+  return m_lateness;
+}
+
+Time
+TimerfdSynchronizer::GetMaxLateness (void) const
+{
+  return NanoSeconds (m_maxLateness);
+}
+
+void
+TimerfdSynchronizer::ResetLateness (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_lateness.clear ();
+  m_maxLateness = 0;
+}
+
+bool
+TimerfdSynchronizer::DoRealtime (void)
+{
+  NS_LOG_FUNCTION (this);
+  return true;
+}
+
+uint64_t
+TimerfdSynchronizer::DoGetCurrentRealtime (void)
+{
+  NS_LOG_FUNCTION (this);
+  return GetNormalizedRealtime ();
+}
+
+void
+TimerfdSynchronizer::DoSetOrigin (uint64_t ns)
+{
+  NS_LOG_FUNCTION (this << ns);
+  // as in WallClockSynchronizer, the normalized real time starts at
+  // zero when the simulator starts running.
+  m_realtimeOriginNano = GetRealtime ();
+  NS_LOG_INFO ("origin = " << m_realtimeOriginNano);
+}
+
+int64_t
+TimerfdSynchronizer::DoGetDrift (uint64_t ns)
+{
+  NS_LOG_FUNCTION (this << ns);
+  uint64_t nsNow = GetNormalizedRealtime ();
+  if (nsNow > ns)
+    {
+      return (int64_t)(nsNow - ns);
+    }
+  else
+    {
+      return -(int64_t)(ns - nsNow);
+    }
+}
+
+bool
+TimerfdSynchronizer::DoSynchronize (uint64_t nsCurrent, uint64_t nsDelay)
+{
+  NS_LOG_FUNCTION (this << nsCurrent << nsDelay);
+  // Unlike in WallClockSynchronizer, there is no drift to correct:
+  // the deadline is absolute, so the time spent since nsCurrent was
+  // read is naturally accounted for.
+  uint64_t nsTarget = nsCurrent + nsDelay;
+  uint64_t spin = m_spinWindow.GetNanoSeconds ();
+  if (nsDelay > spin && GetNormalizedRealtime () + spin < nsTarget)
+    {
+      if (!SleepWait (nsTarget - spin))
+        {
+          NS_LOG_INFO ("SleepWait interrupted");
+          return false;
+        }
+    }
+  if (!SpinWait (nsTarget))
+    {
+      NS_LOG_INFO ("SpinWait interrupted");
+      return false;
+    }
+  RecordLateness (GetNormalizedRealtime () - nsTarget);
+  return true;
+}
+
+void
+TimerfdSynchronizer::DoSignal (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_condition = true;
+  uint64_t one = 1;
+  if (write (m_eventFd, &one, sizeof (one)) != sizeof (one) && errno != EAGAIN)
+    {
+      NS_FATAL_ERROR ("write() failed: " << std::strerror (errno));
+    }
+}
+
+void
+TimerfdSynchronizer::DoSetCondition (bool cond)
+{
+  NS_LOG_FUNCTION (this << cond);
+  if (!cond)
+    {
+      // Drain the eventfd before clearing the flag: a Signal which
+      // happens in between leaves the eventfd readable, which at
+      // worst wakes up the next wait for nothing.
+      uint64_t count;
+      while (read (m_eventFd, &count, sizeof (count)) == sizeof (count))
+        {
+        }
+    }
+  m_condition = cond;
+}
+
+void
+TimerfdSynchronizer::DoEventStart (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_nsEventStart = GetNormalizedRealtime ();
+}
+
+uint64_t
+TimerfdSynchronizer::DoEventEnd (void)
+{
+  NS_LOG_FUNCTION (this);
+  return GetNormalizedRealtime () - m_nsEventStart;
+}
+
+bool
+TimerfdSynchronizer::SleepWait (uint64_t ns)
+{
+  NS_LOG_FUNCTION (this << ns);
+  uint64_t deadline = m_realtimeOriginNano + ns;
+  struct itimerspec its;
+  std::memset (&its, 0, sizeof (its));
+  its.it_value.tv_sec = deadline / 1000000000ULL;
+  its.it_value.tv_nsec = deadline % 1000000000ULL;
+  if (timerfd_settime (m_timerFd, TFD_TIMER_ABSTIME, &its, 0) == -1)
+    {
+      NS_FATAL_ERROR ("timerfd_settime() failed: " << std::strerror (errno));
+    }
+
+  for (;;)
+    {
+      // A Signal which happens after this test also makes the eventfd
+      // readable, so epoll_wait cannot miss it.
+      if (m_condition)
+        {
+          return false;
+        }
+      struct epoll_event events[2];
+      int n = epoll_wait (m_epollFd, events, 2, -1);
+      if (n == -1)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+          NS_FATAL_ERROR ("epoll_wait() failed: " << std::strerror (errno));
+        }
+      bool expired = false;
+      for (int i = 0; i < n; i++)
+        {
+          if (events[i].data.fd == m_eventFd)
+            {
+              return false;
+            }
+          uint64_t count;
+          if (read (m_timerFd, &count, sizeof (count)) == sizeof (count))
+            {
+              expired = true;
+            }
+        }
+      if (expired)
+        {
+          return true;
+        }
+    }
+}
+
+bool
+TimerfdSynchronizer::SpinWait (uint64_t ns)
+{
+  NS_LOG_FUNCTION (this << ns);
+  for (;;)
+    {
+      if (GetNormalizedRealtime () >= ns)
+        {
+          return true;
+        }
+      if (m_condition)
+        {
+          return false;
+        }
+    }
+}
+
+void
+TimerfdSynchronizer::RecordLateness (uint64_t ns)
+{
+  uint32_t bucket = 0;
+  for (uint64_t i = ns + 1; i > 1; i >>= 1)
+    {
+      bucket++;
+    }
+  if (bucket >= m_lateness.size ())
+    {
+      m_lateness.resize (bucket + 1, 0);
+    }
+  m_lateness[bucket]++;
+  if (ns > m_maxLateness)
+    {
+      m_maxLateness = ns;
+    }
+  m_latenessTrace (NanoSeconds (ns));
+}
+
+uint64_t
+TimerfdSynchronizer::GetRealtime (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+uint64_t
+TimerfdSynchronizer::GetNormalizedRealtime (void)
+{
+  return GetRealtime () - m_realtimeOriginNano;
+}
+
+} // namespace ns3
@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIMERFD_SYNCHRONIZER_H
+#define TIMERFD_SYNCHRONIZER_H
+
+#include "synchronizer.h"
+#include "nstime.h"
+#include "traced-callback.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief a low-jitter synchronizer based on the Linux timerfd and epoll
+ *
+ * The WallClockSynchronizer sleeps on a condition variable for whole
+ * jiffies and busy-waits for the rest of the delay, which costs a lot
+ * of CPU time when the events are a few milliseconds apart and makes
+ * the lateness depend on the resolution of gettimeofday.  This
+ * synchronizer instead arms a timerfd with an absolute
+ * CLOCK_MONOTONIC deadline, SpinWindow before the time of the next
+ * event, sleeps in epoll_wait until the timer expires, and spins only
+ * for the last SpinWindow.  Signal writes to an eventfd watched by the
+ * same epoll set, so the events injected by other threads, such as the
+ * packets received by an emulated device, wake the simulator
+ * immediately.
+ *
+ * The lateness of each event, that is the difference between the real
+ * time at which the wait ended and the real time at which the event
+ * was due, is reported by the Lateness trace source and accumulated in
+ * a histogram.
+ *
+ * Enable this synchronizer with:
+ * \code
+ *   Config::SetDefault ("ns3::RealtimeSimulatorImpl::SynchronizerType",
+ *                       StringValue ("ns3::TimerfdSynchronizer"));
+ * \endcode
+ */
+class TimerfdSynchronizer : public Synchronizer
+{
+public:
+  static TypeId GetTypeId (void);
+
+  TimerfdSynchronizer ();
+  virtual ~TimerfdSynchronizer ();
+
+  /**
+   * \returns the lateness histogram: element i counts the waits which
+   *          ended between 2^i - 1 and 2^(i+1) - 1 nanoseconds late.
+   */
+  std::vector<uint64_t> GetLatenessHistogram (void) const;
+  /**
+   * \returns the largest lateness recorded
+   */
+  Time GetMaxLateness (void) const;
+  /**
+   * Forget the lateness recorded so far.
+   */
+  void ResetLateness (void);
+
+protected:
+  virtual bool DoRealtime (void);
+  virtual uint64_t DoGetCurrentRealtime (void);
+  virtual void DoSetOrigin (uint64_t ns);
+  virtual int64_t DoGetDrift (uint64_t ns);
+  virtual bool DoSynchronize (uint64_t nsCurrent, uint64_t nsDelay);
+  virtual void DoSignal (void);
+  virtual void DoSetCondition (bool cond);
+  virtual void DoEventStart (void);
+  virtual uint64_t DoEventEnd (void);
+
+private:
+  /**
+   * \param ns the normalized real time to sleep until
+   * \returns true if the timer expired, false if Signal was called
+   */
+  bool SleepWait (uint64_t ns);
+  /**
+   * \param ns the normalized real time to spin until
+   * \returns true if the time was reached, false if Signal was called
+   */
+  bool SpinWait (uint64_t ns);
+  void RecordLateness (uint64_t ns);
+
+  static uint64_t GetRealtime (void);
+  uint64_t GetNormalizedRealtime (void);
+
+  int m_epollFd;
+  int m_timerFd;
+  int m_eventFd;
+  // set by other threads, so that SpinWait does not need a system call
+  volatile bool m_condition;
+  Time m_spinWindow;
+  uint64_t m_nsEventStart;
+
+  std::vector<uint64_t> m_lateness;
+  uint64_t m_maxLateness;
+  TracedCallback<Time> m_latenessTrace;
+};
+
+} // namespace ns3
+
+#endif /* TIMERFD_SYNCHRONIZER_H */
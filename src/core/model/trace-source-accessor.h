@@ -24,6 +24,7 @@
 #include "callback.h"
 #include "ptr.h"
 #include "simple-ref-count.h"
+#include "atomic-ref-count.h"
 
 namespace ns3 {
 
@@ -37,7 +38,7 @@ class ObjectBase;
  * This class abstracts the kind of trace source to which we want to connect
  * and provides services to Connect and Disconnect a sink to a trace source.
  */
-class TraceSourceAccessor : public SimpleRefCount<TraceSourceAccessor>
+class TraceSourceAccessor : public AtomicRefCount<TraceSourceAccessor>
 {
 public:
   TraceSourceAccessor ();
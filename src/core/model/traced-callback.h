@@ -21,8 +21,10 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <vector>
+#include <algorithm>
 #include "callback.h"
+#include "assert.h"
 
 namespace ns3 {
 
@@ -35,6 +37,18 @@ namespace ns3 {
  * it forwards calls to a chain of ns3::Callback. TracedCallback::Connect adds a ns3::Callback
  * at the end of the chain of callbacks. TracedCallback::Disconnect removes a ns3::Callback from
  * the chain of callbacks.
+ *
+ * The first callbacks of the chain are stored inline, in the
+ * TracedCallback itself, and the others in a vector allocated only when
+ * there are more callbacks, so that connecting a trace source to a
+ * single sink does not allocate memory and firing it does not walk a
+ * list.
+ *
+ * A callback may connect or disconnect sinks while the TracedCallback
+ * fires: the sinks connected are called in the same call, and the sinks
+ * disconnected are not called anymore, but they are only removed from
+ * the chain once the call returns so that the other sinks are still
+ * called.
  */
 template<typename T1 = empty, typename T2 = empty, 
          typename T3 = empty, typename T4 = empty,
@@ -44,6 +58,9 @@ class TracedCallback
 {
 public:
   TracedCallback ();
+  TracedCallback (const TracedCallback &o);
+  TracedCallback &operator = (const TracedCallback &o);
+  ~TracedCallback ();
   /**
    * \param callback callback to add to chain of callbacks
    *
@@ -78,6 +95,12 @@ public:
    * of the TracedCallback::Connect method.
    */
   void Disconnect (const CallbackBase & callback, std::string path);
+  /**
+   * \returns true if no callback is connected to this TracedCallback.
+   *
+   * Lets a trace source skip computing its arguments when nobody listens.
+   */
+  bool IsEmpty (void) const;
   void operator() (void) const;
   void operator() (T1 a1) const;
   void operator() (T1 a1, T2 a2) const;
@@ -89,8 +112,26 @@ public:
   void operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const;
 
 private:
-  typedef std::list<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
-  CallbackList m_callbackList;
+  typedef Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> SinkCallback;
+  typedef std::vector<SinkCallback> CallbackList;
+  enum {
+    N_INLINE = 2
+  };
+  void Append (const SinkCallback &callback);
+  bool IsRemoved (uint32_t position) const;
+  void EndCall (void) const;
+  void Compact (void);
+
+  // the first callbacks of the chain: a null callback marks the end of
+  // the chain.
+  SinkCallback m_inline[N_INLINE];
+  // the callbacks after the inline ones, or zero.
+  CallbackList *m_more;
+  // the number of calls in progress
+  mutable uint32_t m_calls;
+  // the positions in the chain of the callbacks disconnected during a
+  // call, or zero.
+  std::vector<uint32_t> *m_removed;
 };
 
 } // namespace ns3
@@ -104,9 +145,88 @@ template<typename T1, typename T2,
          typename T5, typename T6,
          typename T7, typename T8>
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback ()
-  : m_callbackList () 
+  : m_more (0),
+    m_calls (0),
+    m_removed (0)
 {
 }
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback (const TracedCallback &o)
+  : m_more (0),
+    m_calls (0),
+    m_removed (0)
+{
+  *this = o;
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8> &
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator = (const TracedCallback &o)
+{
+  if (this != &o)
+    {
+      NS_ASSERT_MSG (m_calls == 0, "TracedCallback assigned while it is called");
+      for (uint32_t i = 0; i < N_INLINE; i++)
+        {
+          m_inline[i] = o.m_inline[i];
+        }
+      delete m_more;
+      m_more = 0;
+      if (o.m_more != 0)
+        {
+          m_more = new CallbackList (*o.m_more);
+        }
+      // the callbacks of o disconnected during a call of o
+      if (o.m_removed != 0)
+        {
+          m_removed = new std::vector<uint32_t> (*o.m_removed);
+          Compact ();
+        }
+    }
+  return *this;
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::~TracedCallback ()
+{
+  delete m_more;
+  m_more = 0;
+  delete m_removed;
+  m_removed = 0;
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Append (const SinkCallback &callback)
+{
+  if (callback.IsNull ())
+    {
+      // a null callback would end the chain: there is nothing to call anyway.
+      return;
+    }
+  for (uint32_t i = 0; i < N_INLINE; i++)
+    {
+      if (m_inline[i].IsNull ())
+        {
+          m_inline[i] = callback;
+          return;
+        }
+    }
+  if (m_more == 0)
+    {
+      m_more = new CallbackList ();
+    }
+  m_more->push_back (callback);
+}
 template<typename T1, typename T2,
          typename T3, typename T4,
          typename T5, typename T6,
@@ -116,7 +236,7 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::ConnectWithoutContext (const CallbackBa
 {
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   cb.Assign (callback);
-  m_callbackList.push_back (cb);
+  Append (cb);
 }
 template<typename T1, typename T2,
          typename T3, typename T4,
@@ -128,7 +248,7 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Connect (const CallbackBase & callback,
   Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   cb.Assign (callback);
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
-  m_callbackList.push_back (realCb);
+  Append (realCb);
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -137,19 +257,109 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::DisconnectWithoutContext (const CallbackBase & callback)
 {
-  for (typename CallbackList::iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); /* empty */)
+  if (m_calls > 0)
     {
-      if ((*i).IsEqual (callback))
+      // the positions of the callbacks must not change while they are
+      // called: only mark the matching callbacks and remove them when
+      // the call returns.
+      uint32_t n = N_INLINE + (m_more != 0 ? m_more->size () : 0);
+      for (uint32_t i = 0; i < n; i++)
         {
-          i = m_callbackList.erase (i);
+          const SinkCallback &cb = i < N_INLINE ? m_inline[i] : (*m_more)[i - N_INLINE];
+          if (!cb.IsNull () && cb.IsEqual (callback) && !IsRemoved (i))
+            {
+              if (m_removed == 0)
+                {
+                  m_removed = new std::vector<uint32_t> ();
+                }
+              m_removed->push_back (i);
+            }
         }
-      else
+      return;
+    }
+  // rebuild the chain without the matching callbacks, keeping the
+  // order of the others.
+  CallbackList chain;
+  for (uint32_t i = 0; i < N_INLINE && !m_inline[i].IsNull (); i++)
+    {
+      chain.push_back (m_inline[i]);
+      m_inline[i] = SinkCallback ();
+    }
+  if (m_more != 0)
+    {
+      chain.insert (chain.end (), m_more->begin (), m_more->end ());
+      delete m_more;
+      m_more = 0;
+    }
+  for (typename CallbackList::const_iterator i = chain.begin (); i != chain.end (); i++)
+    {
+      if (!(*i).IsEqual (callback))
         {
-          i++;
+          Append (*i);
         }
     }
 }
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+bool
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::IsRemoved (uint32_t position) const
+{
+  return m_removed != 0
+         && std::find (m_removed->begin (), m_removed->end (), position) != m_removed->end ();
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::EndCall (void) const
+{
+  m_calls--;
+  if (m_calls == 0 && m_removed != 0)
+    {
+      // the chain is only changed by the callbacks, which got a
+      // non-const TracedCallback to connect and disconnect sinks.
+      const_cast<TracedCallback *> (this)->Compact ();
+    }
+}
+template<typename T1, typename T2,
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Compact (void)
+{
+  // rebuild the chain without the callbacks disconnected during a call
+  CallbackList chain;
+  for (uint32_t i = 0; i < N_INLINE && !m_inline[i].IsNull (); i++)
+    {
+      if (!IsRemoved (i))
+        {
+          chain.push_back (m_inline[i]);
+        }
+      m_inline[i] = SinkCallback ();
+    }
+  if (m_more != 0)
+    {
+      for (uint32_t i = 0; i < m_more->size (); i++)
+        {
+          if (!IsRemoved (N_INLINE + i))
+            {
+              chain.push_back ((*m_more)[i]);
+            }
+        }
+      delete m_more;
+      m_more = 0;
+    }
+  delete m_removed;
+  m_removed = 0;
+  for (typename CallbackList::const_iterator i = chain.begin (); i != chain.end (); i++)
+    {
+      Append (*i);
+    }
+}
 template<typename T1, typename T2, 
          typename T3, typename T4,
          typename T5, typename T6,
@@ -162,6 +372,15 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Disconnect (const CallbackBase & callba
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
   DisconnectWithoutContext (realCb);
 }
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+bool
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::IsEmpty (void) const
+{
+  return m_inline[0].IsNull ();
+}
 template<typename T1, typename T2, 
          typename T3, typename T4,
          typename T5, typename T6,
@@ -169,11 +388,27 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (void) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_inline[0].IsNull ())
     {
-      (*i)();
+      return;
     }
+  m_calls++;
+  for (uint32_t i = 0; i < N_INLINE && !m_inline[i].IsNull (); i++)
+    {
+      if (m_removed == 0 || !IsRemoved (i))
+        {
+          m_inline[i] ();
+        }
+    }
+  // a callback may connect sinks: m_more may be created or reallocated.
+  for (uint32_t i = 0; m_more != 0 && i < m_more->size (); i++)
+    {
+      if (m_removed == 0 || !IsRemoved (N_INLINE + i))
+        {
+          (*m_more)[i] ();
+        }
+    }
+  EndCall ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -182,11 +417,27 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_inline[0].IsNull ())
+    {
+      return;
+    }
+  m_calls++;
+  for (uint32_t i = 0; i < N_INLINE && !m_inline[i].IsNull (); i++)
     {
-      (*i)(a1);
+      if (m_removed == 0 || !IsRemoved (i))
+        {
+          m_inline[i] (a1);
+        }
     }
+  // a callback may connect sinks: m_more may be created or reallocated.
+  for (uint32_t i = 0; m_more != 0 && i < m_more->size (); i++)
+    {
+      if (m_removed == 0 || !IsRemoved (N_INLINE + i))
+        {
+          (*m_more)[i] (a1);
+        }
+    }
+  EndCall ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -195,11 +446,27 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_inline[0].IsNull ())
+    {
+      return;
+    }
+  m_calls++;
+  for (uint32_t i = 0; i < N_INLINE && !m_inline[i].IsNull (); i++)
+    {
+      if (m_removed == 0 || !IsRemoved (i))
+        {
+          m_inline[i] (a1, a2);
+        }
+    }
+  // a callback may connect sinks: m_more may be created or reallocated.
+  for (uint32_t i = 0; m_more != 0 && i < m_more->size (); i++)
     {
-      (*i)(a1, a2);
+      if (m_removed == 0 || !IsRemoved (N_INLINE + i))
+        {
+          (*m_more)[i] (a1, a2);
+        }
     }
+  EndCall ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -208,11 +475,27 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_inline[0].IsNull ())
+    {
+      return;
+    }
+  m_calls++;
+  for (uint32_t i = 0; i < N_INLINE && !m_inline[i].IsNull (); i++)
+    {
+      if (m_removed == 0 || !IsRemoved (i))
+        {
+          m_inline[i] (a1, a2, a3);
+        }
+    }
+  // a callback may connect sinks: m_more may be created or reallocated.
+  for (uint32_t i = 0; m_more != 0 && i < m_more->size (); i++)
     {
-      (*i)(a1, a2, a3);
+      if (m_removed == 0 || !IsRemoved (N_INLINE + i))
+        {
+          (*m_more)[i] (a1, a2, a3);
+        }
     }
+  EndCall ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -221,11 +504,27 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_inline[0].IsNull ())
     {
-      (*i)(a1, a2, a3, a4);
+      return;
     }
+  m_calls++;
+  for (uint32_t i = 0; i < N_INLINE && !m_inline[i].IsNull (); i++)
+    {
+      if (m_removed == 0 || !IsRemoved (i))
+        {
+          m_inline[i] (a1, a2, a3, a4);
+        }
+    }
+  // a callback may connect sinks: m_more may be created or reallocated.
+  for (uint32_t i = 0; m_more != 0 && i < m_more->size (); i++)
+    {
+      if (m_removed == 0 || !IsRemoved (N_INLINE + i))
+        {
+          (*m_more)[i] (a1, a2, a3, a4);
+        }
+    }
+  EndCall ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -234,11 +533,27 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_inline[0].IsNull ())
+    {
+      return;
+    }
+  m_calls++;
+  for (uint32_t i = 0; i < N_INLINE && !m_inline[i].IsNull (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5);
+      if (m_removed == 0 || !IsRemoved (i))
+        {
+          m_inline[i] (a1, a2, a3, a4, a5);
+        }
+    }
+  // a callback may connect sinks: m_more may be created or reallocated.
+  for (uint32_t i = 0; m_more != 0 && i < m_more->size (); i++)
+    {
+      if (m_removed == 0 || !IsRemoved (N_INLINE + i))
+        {
+          (*m_more)[i] (a1, a2, a3, a4, a5);
+        }
     }
+  EndCall ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -247,11 +562,27 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_inline[0].IsNull ())
+    {
+      return;
+    }
+  m_calls++;
+  for (uint32_t i = 0; i < N_INLINE && !m_inline[i].IsNull (); i++)
+    {
+      if (m_removed == 0 || !IsRemoved (i))
+        {
+          m_inline[i] (a1, a2, a3, a4, a5, a6);
+        }
+    }
+  // a callback may connect sinks: m_more may be created or reallocated.
+  for (uint32_t i = 0; m_more != 0 && i < m_more->size (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6);
+      if (m_removed == 0 || !IsRemoved (N_INLINE + i))
+        {
+          (*m_more)[i] (a1, a2, a3, a4, a5, a6);
+        }
     }
+  EndCall ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -260,11 +591,27 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_inline[0].IsNull ())
+    {
+      return;
+    }
+  m_calls++;
+  for (uint32_t i = 0; i < N_INLINE && !m_inline[i].IsNull (); i++)
+    {
+      if (m_removed == 0 || !IsRemoved (i))
+        {
+          m_inline[i] (a1, a2, a3, a4, a5, a6, a7);
+        }
+    }
+  // a callback may connect sinks: m_more may be created or reallocated.
+  for (uint32_t i = 0; m_more != 0 && i < m_more->size (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7);
+      if (m_removed == 0 || !IsRemoved (N_INLINE + i))
+        {
+          (*m_more)[i] (a1, a2, a3, a4, a5, a6, a7);
+        }
     }
+  EndCall ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -273,11 +620,27 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_inline[0].IsNull ())
+    {
+      return;
+    }
+  m_calls++;
+  for (uint32_t i = 0; i < N_INLINE && !m_inline[i].IsNull (); i++)
+    {
+      if (m_removed == 0 || !IsRemoved (i))
+        {
+          m_inline[i] (a1, a2, a3, a4, a5, a6, a7, a8);
+        }
+    }
+  // a callback may connect sinks: m_more may be created or reallocated.
+  for (uint32_t i = 0; m_more != 0 && i < m_more->size (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7, a8);
+      if (m_removed == 0 || !IsRemoved (N_INLINE + i))
+        {
+          (*m_more)[i] (a1, a2, a3, a4, a5, a6, a7, a8);
+        }
     }
+  EndCall ();
 }
 
 } // namespace ns3
@@ -25,6 +25,7 @@
 
 #include <map>
 #include <vector>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
@@ -86,6 +87,7 @@ public:
   bool HasConstructor (uint16_t uid) const;
   uint32_t GetRegisteredN (void) const;
   uint16_t GetRegistered (uint32_t i) const;
+  uint32_t GetTablesGeneration (void) const;
   void AddAttribute (uint16_t uid, 
                      std::string name,
                      std::string help, 
@@ -105,8 +107,39 @@ public:
   uint32_t GetTraceSourceN (uint16_t uid) const;
   struct TypeId::TraceSourceInformation GetTraceSource(uint16_t uid, uint32_t i) const;
   bool MustHideFromDocumentation (uint16_t uid) const;
+  uint32_t GetAllAttributeN (uint16_t uid);
+  const struct TypeId::AttributeInformation &GetAllAttribute (uint16_t uid, uint32_t i, uint16_t *owner);
+  bool LookupAttributeByName (uint16_t uid, std::string name, struct TypeId::AttributeInformation *info);
+  Ptr<const TraceSourceAccessor> LookupTraceSourceByName (uint16_t uid, std::string name);
 
 private:
+  /**
+   * The attributes and the trace sources of a TypeId and of all its
+   * parents, from the TypeId up to the root, indexed by the hash of
+   * their names.
+   */
+  struct Table {
+    struct Attribute {
+      struct TypeId::AttributeInformation info;
+      // the TypeId which declared the attribute and its index there
+      uint16_t owner;
+      uint32_t index;
+    };
+    typedef std::vector<std::pair<uint32_t, uint32_t> > Index;
+    std::vector<struct Attribute> attributes;
+    std::vector<struct TypeId::TraceSourceInformation> traceSources;
+    // pairs of a hash and of a position in the vectors above, sorted
+    // so that the first match of a name is the one of the most derived
+    // TypeId.
+    Index attributeIndex;
+    Index traceSourceIndex;
+  };
+  struct Table *GetTable (uint16_t uid);
+  struct Table *BuildTable (uint16_t uid) const;
+  void ClearTables (uint16_t uid);
+  static uint32_t HashName (const std::string &name);
+  static Table::Index::const_iterator FindHash (const Table::Index &index, uint32_t hash);
+
   bool HasTraceSource (uint16_t uid, std::string name);
   bool HasAttribute (uint16_t uid, std::string name);
   static TypeId::hash_t Hasher (const std::string name);
@@ -121,12 +154,16 @@ private:
     bool mustHideFromDocumentation;
     std::vector<struct TypeId::AttributeInformation> attributes;
     std::vector<struct TypeId::TraceSourceInformation> traceSources;
+    // built on first use by GetTable
+    struct Table *table;
   };
   typedef std::vector<struct IidInformation>::const_iterator Iterator;
 
   struct IidManager::IidInformation *LookupInformation (uint16_t uid) const;
 
   std::vector<struct IidInformation> m_information;
+  // incremented each time ClearTables drops tables
+  uint32_t m_tablesGeneration;
 
   typedef std::map<std::string, uint16_t> namemap_t;
   namemap_t m_namemap;
@@ -141,6 +178,7 @@ private:
 };
 
 IidManager::IidManager ()
+  : m_tablesGeneration (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -214,6 +252,7 @@ IidManager::AllocateUid (std::string name)
   information.groupName = "";
   information.hasConstructor = false;
   information.mustHideFromDocumentation = false;
+  information.table = 0;
   m_information.push_back (information);
   uint32_t uid = m_information.size ();
   NS_ASSERT (uid <= 0xffff);
@@ -239,6 +278,7 @@ IidManager::SetParent (uint16_t uid, uint16_t parent)
   NS_ASSERT (parent <= m_information.size ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
+  ClearTables (uid);
 }
 void 
 IidManager::SetGroupName (uint16_t uid, std::string groupName)
@@ -350,6 +390,12 @@ IidManager::GetRegisteredN (void) const
   NS_LOG_FUNCTION (this);
   return m_information.size ();
 }
+uint32_t
+IidManager::GetTablesGeneration (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_tablesGeneration;
+}
 uint16_t 
 IidManager::GetRegistered (uint32_t i) const
 {
@@ -410,6 +456,7 @@ IidManager::AddAttribute (uint16_t uid,
   info.accessor = accessor;
   info.checker = checker;
   information->attributes.push_back (info);
+  ClearTables (uid);
 }
 void 
 IidManager::SetAttributeInitialValue(uint16_t uid,
@@ -420,6 +467,24 @@ IidManager::SetAttributeInitialValue(uint16_t uid,
   struct IidInformation *information = LookupInformation (uid);
   NS_ASSERT (i < information->attributes.size ());
   information->attributes[i].initialValue = initialValue;
+  // update the copies held by the tables
+  for (std::vector<struct IidInformation>::iterator j = m_information.begin ();
+       j != m_information.end (); ++j)
+    {
+      if (j->table == 0)
+        {
+          continue;
+        }
+      std::vector<struct Table::Attribute> &attributes = j->table->attributes;
+      for (std::vector<struct Table::Attribute>::iterator k = attributes.begin ();
+           k != attributes.end (); ++k)
+        {
+          if (k->owner == uid && k->index == i)
+            {
+              k->info.initialValue = initialValue;
+            }
+        }
+    }
 }
 
 
@@ -486,6 +551,7 @@ IidManager::AddTraceSource (uint16_t uid,
   source.help = help;
   source.accessor = accessor;
   information->traceSources.push_back (source);
+  ClearTables (uid);
 }
 uint32_t 
 IidManager::GetTraceSourceN (uint16_t uid) const
@@ -510,6 +576,172 @@ IidManager::MustHideFromDocumentation (uint16_t uid) const
   return information->mustHideFromDocumentation;
 }
 
+uint32_t
+IidManager::HashName (const std::string &name)
+{
+  // FNV-1a: this is much cheaper than the Hasher used for the TypeId
+  // names and, unlike it, has no state, so it can be used by several
+  // threads at once.
+  uint32_t hash = 2166136261U;
+  for (std::string::const_iterator i = name.begin (); i != name.end (); ++i)
+    {
+      hash ^= static_cast<uint8_t> (*i);
+      hash *= 16777619U;
+    }
+  return hash;
+}
+
+IidManager::Table::Index::const_iterator
+IidManager::FindHash (const Table::Index &index, uint32_t hash)
+{
+  return std::lower_bound (index.begin (), index.end (), std::make_pair (hash, 0U));
+}
+
+struct IidManager::Table *
+IidManager::BuildTable (uint16_t uid) const
+{
+  NS_LOG_FUNCTION (this << uid);
+  struct Table *table = new Table ();
+  uint16_t current = uid;
+  while (true)
+    {
+      struct IidInformation *information = LookupInformation (current);
+      for (uint32_t i = 0; i < information->attributes.size (); i++)
+        {
+          struct Table::Attribute attribute;
+          attribute.info = information->attributes[i];
+          attribute.owner = current;
+          attribute.index = i;
+          table->attributeIndex.push_back (std::make_pair (HashName (attribute.info.name),
+                                                           table->attributes.size ()));
+          table->attributes.push_back (attribute);
+        }
+      for (uint32_t i = 0; i < information->traceSources.size (); i++)
+        {
+          table->traceSourceIndex.push_back (std::make_pair (HashName (information->traceSources[i].name),
+                                                             table->traceSources.size ()));
+          table->traceSources.push_back (information->traceSources[i]);
+        }
+      if (information->parent == current || information->parent == 0)
+        {
+          // top of inheritance tree
+          break;
+        }
+      current = information->parent;
+    }
+  std::sort (table->attributeIndex.begin (), table->attributeIndex.end ());
+  std::sort (table->traceSourceIndex.begin (), table->traceSourceIndex.end ());
+  return table;
+}
+
+struct IidManager::Table *
+IidManager::GetTable (uint16_t uid)
+{
+  struct IidInformation *information = LookupInformation (uid);
+  struct Table *table = information->table;
+  if (table != 0)
+    {
+      return table;
+    }
+  // The objects of a simulation may be created by several threads:
+  // the first thread to build the table publishes it, the others
+  // drop their copy.
+  table = BuildTable (uid);
+  if (!__sync_bool_compare_and_swap (&information->table, (struct Table *)0, table))
+    {
+      delete table;
+      table = information->table;
+    }
+  return table;
+}
+
+void
+IidManager::ClearTables (uint16_t uid)
+{
+  NS_LOG_FUNCTION (this << uid);
+  // drop the tables of uid and of all the TypeIds derived from it.
+  m_tablesGeneration++;
+  for (uint32_t i = 0; i < m_information.size (); i++)
+    {
+      struct IidInformation *information = &m_information[i];
+      if (information->table == 0)
+        {
+          continue;
+        }
+      uint16_t current = i + 1;
+      while (true)
+        {
+          if (current == uid)
+            {
+              delete information->table;
+              information->table = 0;
+              break;
+            }
+          uint16_t parent = LookupInformation (current)->parent;
+          if (parent == current || parent == 0)
+            {
+              break;
+            }
+          current = parent;
+        }
+    }
+}
+
+uint32_t
+IidManager::GetAllAttributeN (uint16_t uid)
+{
+  NS_LOG_FUNCTION (this << uid);
+  return GetTable (uid)->attributes.size ();
+}
+
+const struct TypeId::AttributeInformation &
+IidManager::GetAllAttribute (uint16_t uid, uint32_t i, uint16_t *owner)
+{
+  NS_LOG_FUNCTION (this << uid << i << owner);
+  struct Table *table = GetTable (uid);
+  NS_ASSERT (i < table->attributes.size ());
+  *owner = table->attributes[i].owner;
+  return table->attributes[i].info;
+}
+
+bool
+IidManager::LookupAttributeByName (uint16_t uid, std::string name,
+                                   struct TypeId::AttributeInformation *info)
+{
+  NS_LOG_FUNCTION (this << uid << name << info);
+  struct Table *table = GetTable (uid);
+  uint32_t hash = HashName (name);
+  for (Table::Index::const_iterator i = FindHash (table->attributeIndex, hash);
+       i != table->attributeIndex.end () && i->first == hash; ++i)
+    {
+      const struct TypeId::AttributeInformation &candidate = table->attributes[i->second].info;
+      if (candidate.name == name)
+        {
+          *info = candidate;
+          return true;
+        }
+    }
+  return false;
+}
+
+Ptr<const TraceSourceAccessor>
+IidManager::LookupTraceSourceByName (uint16_t uid, std::string name)
+{
+  NS_LOG_FUNCTION (this << uid << name);
+  struct Table *table = GetTable (uid);
+  uint32_t hash = HashName (name);
+  for (Table::Index::const_iterator i = FindHash (table->traceSourceIndex, hash);
+       i != table->traceSourceIndex.end () && i->first == hash; ++i)
+    {
+      const struct TypeId::TraceSourceInformation &candidate = table->traceSources[i->second];
+      if (candidate.name == name)
+        {
+          return candidate.accessor;
+        }
+    }
+  return 0;
+}
+
 } // namespace ns3
 
 namespace ns3 {
@@ -578,6 +810,12 @@ TypeId::GetRegisteredN (void)
   NS_LOG_FUNCTION_NOARGS ();
   return Singleton<IidManager>::Get ()->GetRegisteredN ();
 }
+uint32_t
+TypeId::GetTablesGeneration (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return Singleton<IidManager>::Get ()->GetTablesGeneration ();
+}
 TypeId 
 TypeId::GetRegistered (uint32_t i)
 {
@@ -589,22 +827,7 @@ bool
 TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInformation *info) const
 {
   NS_LOG_FUNCTION (this << name << info);
-  TypeId tid;
-  TypeId nextTid = *this;
-  do {
-      tid = nextTid;
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
-        {
-          struct TypeId::AttributeInformation tmp = tid.GetAttribute(i);
-          if (tmp.name == name)
-            {
-              *info = tmp;
-              return true;
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return false;
+  return Singleton<IidManager>::Get ()->LookupAttributeByName (m_tid, name, info);
 }
 
 TypeId 
@@ -755,6 +978,22 @@ TypeId::GetAttributeFullName (uint32_t i) const
   struct TypeId::AttributeInformation info = GetAttribute(i);
   return GetName () + "::" + info.name;
 }
+uint32_t
+TypeId::GetAllAttributeN (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return Singleton<IidManager>::Get ()->GetAllAttributeN (m_tid);
+}
+const struct TypeId::AttributeInformation &
+TypeId::GetAllAttribute (uint32_t i, TypeId *owner) const
+{
+  NS_LOG_FUNCTION (this << i << owner);
+  uint16_t uid;
+  const struct TypeId::AttributeInformation &info = 
+    Singleton<IidManager>::Get ()->GetAllAttribute (m_tid, i, &uid);
+  *owner = TypeId (uid);
+  return info;
+}
 
 uint32_t 
 TypeId::GetTraceSourceN (void) const
@@ -792,21 +1031,7 @@ Ptr<const TraceSourceAccessor>
 TypeId::LookupTraceSourceByName (std::string name) const
 {
   NS_LOG_FUNCTION (this << name);
-  TypeId tid;
-  TypeId nextTid = *this;
-  do {
-      tid = nextTid;
-      for (uint32_t i = 0; i < tid.GetTraceSourceN (); i++)
-        {
-          struct TypeId::TraceSourceInformation info = tid.GetTraceSource (i);
-          if (info.name == name)
-            {
-              return info.accessor;
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return 0;
+  return Singleton<IidManager>::Get ()->LookupTraceSourceByName (m_tid, name);
 }
 
 uint16_t 
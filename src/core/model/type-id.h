@@ -26,6 +26,7 @@
 #include "attribute-helper.h"
 #include "callback.h"
 #include "hash.h"
+#include "memory-accounting.h"
 #include <string>
 #include <stdint.h>
 
@@ -114,6 +115,12 @@ public:
    * \returns the number of TypeId instances registered.
    */
   static uint32_t GetRegisteredN (void);
+  /**
+   * \returns a number which changes each time the attributes or the
+   *          trace sources of a registered TypeId change, so that the
+   *          data derived from them can be cached.
+   */
+  static uint32_t GetTablesGeneration (void);
   /**
    * \param i index
    * \returns the TypeId instance whose index is i.
@@ -188,6 +195,25 @@ public:
    *          index is i.
    */
   std::string GetAttributeFullName (uint32_t i) const;
+  /**
+   * \returns the number of attributes associated to this TypeId
+   *          and to all its parents.
+   */
+  uint32_t GetAllAttributeN (void) const;
+  /**
+   * \param i index into the attributes of this TypeId and of all its
+   *        parents: the attributes of this TypeId come first, then
+   *        those of its parent, and so on up to the root TypeId.
+   * \param owner a pointer to the TypeId instance where the TypeId
+   *        which declared the attribute should be stored.
+   * \returns the information associated to the attribute whose index
+   *          is i.
+   *
+   * Unlike GetAttribute, this method does not copy the information:
+   * the reference stays valid until an attribute or a trace source
+   * is added to this TypeId or to one of its parents.
+   */
+  const struct TypeId::AttributeInformation &GetAllAttribute (uint32_t i, TypeId *owner) const;
 
   /**
    * \returns a callback which can be used to instanciate an object
@@ -311,6 +337,9 @@ public:
    * \param info a pointer to the TypeId::AttributeInformation data structure
    *        where the result value of this method will be stored.
    * \returns true if the requested attribute could be found, false otherwise.
+   *
+   * The attributes of this TypeId and of its parents are looked up in
+   * a hash table built on the first lookup.
    */
   bool LookupAttributeByName (std::string name, struct AttributeInformation *info) const;
   /**
@@ -425,6 +454,8 @@ TypeId::AddConstructor (void)
   };
   Callback<ObjectBase *> cb = MakeCallback (&Maker::Create);
   DoAddConstructor (cb);
+  // record the instance size for the objects created by ObjectFactory
+  MemoryAccounting::GetAccount (*this, sizeof (T));
   return *this;
 }
 
@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "warm-start.h"
+#include "log.h"
+#include "fatal-error.h"
+#include "ns3/core-config.h"
+#include <iostream>
+#include <sstream>
+#include <set>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("WarmStart");
+
+namespace ns3 {
+
+const uint32_t WarmStart::WARMUP;
+
+namespace {
+uint32_t g_replica = WarmStart::WARMUP;
+uint32_t g_failedReplicas = 0;
+} // anonymous namespace
+
+#ifdef HAVE_SYS_WAIT_H
+static void
+StartReplica (uint32_t replica)
+{
+  NS_LOG_FUNCTION (replica);
+  g_replica = replica;
+  g_failedReplicas = 0;
+  if (LogRingBufferIsEnabled ())
+    {
+      // the mapping is shared with the warm-up process
+      std::ostringstream filename;
+      filename << LogRingBufferGetFilename () << "-" << replica;
+      LogRingBufferEnable (filename.str ().c_str (), LogRingBufferGetSize ());
+    }
+}
+
+/**
+ * Wait for one of the replicas to exit.
+ * \param running the replicas running, updated
+ */
+static void
+WaitReplica (std::set<pid_t> &running)
+{
+  int status;
+  pid_t pid = waitpid (-1, &status, 0);
+  if (pid == -1)
+    {
+      if (errno == EINTR)
+        {
+          return;
+        }
+      NS_FATAL_ERROR ("waitpid() failed: " << std::strerror (errno));
+    }
+  if (running.erase (pid) == 0)
+    {
+      // not one of ours
+      return;
+    }
+  if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+    {
+      NS_LOG_WARN ("replica process " << pid << " failed, status=" << status);
+      g_failedReplicas++;
+    }
+}
+#endif /* HAVE_SYS_WAIT_H */
+
+bool
+WarmStart::Fork (uint32_t replicas, uint32_t jobs)
+{
+  NS_LOG_FUNCTION (replicas << jobs);
+#ifdef HAVE_SYS_WAIT_H
+  if (jobs == 0)
+    {
+      long cpus = sysconf (_SC_NPROCESSORS_ONLN);
+      jobs = cpus > 0 ? cpus : 1;
+    }
+  g_failedReplicas = 0;
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::clog.flush ();
+  std::fflush (0);
+
+  std::set<pid_t> running;
+  for (uint32_t replica = 0; replica < replicas; replica++)
+    {
+      while (running.size () >= jobs)
+        {
+          WaitReplica (running);
+        }
+      pid_t pid = fork ();
+      if (pid == -1)
+        {
+          NS_FATAL_ERROR ("fork() failed: " << std::strerror (errno));
+        }
+      if (pid == 0)
+        {
+          StartReplica (replica);
+          return true;
+        }
+      NS_LOG_INFO ("replica " << replica << " is process " << pid);
+      running.insert (pid);
+    }
+  while (!running.empty ())
+    {
+      WaitReplica (running);
+    }
+  return false;
+#else
+  NS_FATAL_ERROR ("WarmStart::Fork needs fork and waitpid");
+  return false;
+#endif
+}
+
+uint32_t
+WarmStart::GetReplica (void)
+{
+  return g_replica;
+}
+
+uint32_t
+WarmStart::GetFailedReplicas (void)
+{
+  return g_failedReplicas;
+}
+
+} // namespace ns3
@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WARM_START_H
+#define WARM_START_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * \brief fork a warmed-up simulation into several measurement runs
+ *
+ * Many experiments run the same long warm-up (routing convergence,
+ * filling the queues, reaching the steady state of TCP) before each
+ * short measurement.  Fork snapshots the whole state of the simulation
+ * at the current time, that is the event queue, the nodes and their
+ * attributes, the packets in flight and the states of the random
+ * number streams, by forking the process: each replica continues the
+ * simulation from that state, while the warm-up process waits for the
+ * replicas to exit.
+ *
+ * \code
+ *   void
+ *   StartMeasurement (void)
+ *   {
+ *     if (!WarmStart::Fork (100, 8))
+ *       {
+ *         // the warm-up process, once the 100 replicas exited
+ *         Simulator::Stop ();
+ *         return;
+ *       }
+ *     uint32_t replica = WarmStart::GetReplica ();
+ *     Config::Set ("/NodeList/0/DeviceList/0/TxQueue/$ns3::DropTailQueue/MaxPackets",
+ *                  UintegerValue (10 + replica));
+ *     RngSeedManager::SetRun (replica + 1);
+ *     ...
+ *   }
+ *
+ *   Simulator::Schedule (Seconds (100), &StartMeasurement);
+ *   Simulator::Run ();
+ *   if (WarmStart::GetReplica () != WarmStart::WARMUP)
+ *     {
+ *       // save the results of the replica
+ *     }
+ *   Simulator::Destroy ();
+ * \endcode
+ *
+ * The replicas inherit the random number streams as they were at the
+ * fork, so they all draw the same numbers unless the parameters they
+ * vary change the course of the simulation.  Streams created after a
+ * call to RngSeedManager::SetRun in a replica are independent from one
+ * replica to the other.
+ *
+ * The output files opened during the warm-up, such as pcap traces, are
+ * shared by the replicas: open the per-replica outputs in the
+ * replicas.  If the log ring buffer is enabled, each replica records
+ * its messages in the ring buffer file of the warm-up process suffixed
+ * with "-<replica>".
+ *
+ * Fork must not be called while other threads run, that is neither
+ * with the real-time nor with the distributed simulator.
+ */
+class WarmStart
+{
+public:
+  /**
+   * The value of GetReplica in the warm-up process.
+   */
+  static const uint32_t WARMUP = 0xffffffff;
+
+  /**
+   * \param replicas the number of replicas to fork
+   * \param jobs the maximum number of replicas which run at the same
+   *        time, or zero for the number of processors
+   * \returns true in the replicas, false in the warm-up process once
+   *          all the replicas exited
+   *
+   * May be called from an event, or between two calls to
+   * Simulator::Run.  The standard output streams are flushed before
+   * forking, so that the replicas do not print the buffered output of
+   * the warm-up again.
+   */
+  static bool Fork (uint32_t replicas, uint32_t jobs = 1);
+  /**
+   * \returns the index of the current replica, between zero and the
+   *          number of replicas minus one, or WARMUP if the current
+   *          process is not a replica.
+   */
+  static uint32_t GetReplica (void);
+  /**
+   * \returns the number of replicas of the last call to Fork which
+   *          did not exit with a zero status.
+   */
+  static uint32_t GetFailedReplicas (void);
+};
+
+} // namespace ns3
+
+#endif /* WARM_START_H */
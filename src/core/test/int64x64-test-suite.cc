@@ -1,5 +1,6 @@
 #include "ns3/int64x64.h"
 #include "ns3/test.h"
+#include <string>
 
 using namespace ns3;
 
@@ -324,6 +325,60 @@ Int64x64InvertTestCase::DoRun (void)
 }
 
 
+class Int64x64IntegerTestCase : public TestCase
+{
+public:
+  Int64x64IntegerTestCase ();
+  virtual void DoRun (void);
+  void Check (int64x64_t value, int64x64_t expected, std::string operation);
+};
+
+Int64x64IntegerTestCase::Int64x64IntegerTestCase ()
+  : TestCase ("Check the products and quotients with integer operands")
+{
+}
+
+void
+Int64x64IntegerTestCase::Check (int64x64_t value, int64x64_t expected, std::string operation)
+{
+  NS_TEST_EXPECT_MSG_EQ ((value == expected), true,
+                         "Wrong result for " << operation << ": " << value << " instead of " << expected);
+}
+
+void
+Int64x64IntegerTestCase::DoRun (void)
+{
+  const uint64_t half = 0x8000000000000000ULL;
+  const uint64_t quarter = 0x4000000000000000ULL;
+
+  Check (V (7) * V (6), V (42), "7 * 6");
+  Check (V (-7) * V (6), V (-42), "-7 * 6");
+  Check (V (3) * int64x64_t (0.5), int64x64_t (1, half), "3 * 0.5");
+  Check (int64x64_t (0.5) * V (3), int64x64_t (1, half), "0.5 * 3");
+  Check (V (-3) * int64x64_t (2.25), -int64x64_t (6, quarter + half), "-3 * 2.25");
+  Check (V (1000000000) * int64x64_t (0.25), V (250000000), "1000000000 * 0.25");
+
+  Check (V (42) / V (6), V (7), "42 / 6");
+  Check (V (7) / V (2), int64x64_t (3, half), "7 / 2");
+  Check (V (-7) / V (2), -int64x64_t (3, half), "-7 / 2");
+  Check (V (7) / V (-4), -int64x64_t (1, quarter + half), "7 / -4");
+  Check (int64x64_t (3.5) / V (2), int64x64_t (1, quarter + half), "3.5 / 2");
+  Check (V (3) / int64x64_t (0.25), V (12), "3 / 0.25");
+  Check (V (1000000000000LL) / V (1000), V (1000000000), "1000000000000 / 1000");
+
+#if !defined (INT64X64_USE_DOUBLE)
+  // the truncated quotients are those of the general case
+  Check (V (1) / V (3), int64x64_t (0, 0x5555555555555555ULL), "1 / 3");
+  Check (V (2) / V (3), int64x64_t (0, 0xaaaaaaaaaaaaaaaaULL), "2 / 3");
+  Check (int64x64_t (0, 1) / V (3), V (0), "2^-64 / 3");
+  Check (V (3) * int64x64_t (0, 1), int64x64_t (0, 3), "3 * 2^-64");
+  int64x64_t ns = V (2234567891LL);
+  ns.MulByInvert (int64x64_t::Invert (1000000000));
+  NS_TEST_EXPECT_MSG_EQ (ns.GetHigh (), 2, "Wrong conversion of an integer");
+  NS_TEST_EXPECT_MSG_EQ ((ns.GetLow () > quarter - quarter / 16 && ns.GetLow () < quarter), true,
+                         "Wrong conversion of an integer");
+#endif
+}
 
 static class Int64x64128TestSuite : public TestSuite
 {
@@ -339,5 +394,6 @@ public:
     AddTestCase (new Int64x64Bug863TestCase (), TestCase::QUICK);
     AddTestCase (new Int64x64CompareTestCase (), TestCase::QUICK);
     AddTestCase (new Int64x64InvertTestCase (), TestCase::QUICK);
+    AddTestCase (new Int64x64IntegerTestCase (), TestCase::QUICK);
   }
 } g_int64x64TestSuite;
@@ -0,0 +1,312 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// The log macros are compiled out of optimized builds: enable them in
+// this file, whatever the build.
+#ifndef NS3_LOG_ENABLE
+#define NS3_LOG_ENABLE
+#endif
+
+#define NS_LOG_APPEND_CONTEXT std::clog << "[context=" << m_id << "] ";
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("LogRingBufferTest");
+
+using namespace ns3;
+
+// ===========================================================================
+// The dump of the ring buffer must match what std::clog would print
+// ===========================================================================
+class LogRingBufferFormatTestCase : public TestCase
+{
+public:
+  LogRingBufferFormatTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Log (void);
+  std::string Run (void);
+
+  uint32_t m_id;
+  std::string m_filename;
+};
+
+LogRingBufferFormatTestCase::LogRingBufferFormatTestCase ()
+  : TestCase ("Check that the messages of the log ring buffer are dumped as std::clog prints them"),
+    m_id (12)
+{
+}
+
+void
+LogRingBufferFormatTestCase::Log (void)
+{
+  NS_LOG_FUNCTION (this << 42 << "string" << 1.5 << -7);
+  NS_LOG_FUNCTION_NOARGS ();
+  NS_LOG_INFO ("int " << -3 << " unsigned " << 7u << " char " << 'c' << " bool " << true
+                      << " double " << 0.1 << " uint8_t " << uint8_t (65) << " int64_t " << int64_t (-1));
+  NS_LOG_DEBUG ("hex " << std::hex << 255 << std::dec << " after " << 16);
+  NS_LOG_LOGIC ("time " << Seconds (1.5) << " string " << std::string ("s") << " after " << 3);
+  NS_LOG_WARN ("width [" << std::setw (6) << 12 << "] fill " << 4);
+  NS_LOG_ERROR ("");
+}
+
+std::string
+LogRingBufferFormatTestCase::Run (void)
+{
+  std::ostringstream os;
+  std::streambuf *clog = std::clog.rdbuf (os.rdbuf ());
+  // outside of a simulation, then in an event
+  Log ();
+  Simulator::ScheduleWithContext (3, Seconds (1.25), &LogRingBufferFormatTestCase::Log, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  std::clog.rdbuf (clog);
+  return os.str ();
+}
+
+void
+LogRingBufferFormatTestCase::DoRun (void)
+{
+  m_filename = CreateTempDirFilename ("log-ring-buffer.bin");
+  LogComponentEnable ("LogRingBufferTest", LOG_LEVEL_ALL);
+  std::string plain = Run ();
+  LogComponentEnable ("LogRingBufferTest", LOG_PREFIX_ALL);
+  std::string prefixed = Run ();
+
+  LogComponentDisable ("LogRingBufferTest", LOG_PREFIX_ALL);
+  LogRingBufferEnable (m_filename.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (LogRingBufferIsEnabled (), true, "Ring buffer not enabled");
+  NS_TEST_ASSERT_MSG_EQ (Run (), "", "Messages printed on std::clog");
+  LogComponentEnable ("LogRingBufferTest", LOG_PREFIX_ALL);
+  Run ();
+  LogRingBufferDisable ();
+
+  std::ostringstream dump;
+  LogRingBufferDump (m_filename.c_str (), dump);
+  NS_TEST_EXPECT_MSG_EQ (dump.str (), plain + prefixed, "Dump differs from std::clog");
+}
+
+void
+LogRingBufferFormatTestCase::DoTeardown (void)
+{
+  LogRingBufferDisable ();
+  LogComponentDisable ("LogRingBufferTest", (enum LogLevel)(LOG_ALL | LOG_PREFIX_ALL));
+}
+
+// ===========================================================================
+// The oldest messages are overwritten when the ring buffer is full
+// ===========================================================================
+class LogRingBufferWrapTestCase : public TestCase
+{
+public:
+  LogRingBufferWrapTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  uint32_t m_id;
+};
+
+LogRingBufferWrapTestCase::LogRingBufferWrapTestCase ()
+  : TestCase ("Check that the log ring buffer keeps the newest messages"),
+    m_id (0)
+{
+}
+
+void
+LogRingBufferWrapTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("log-ring-buffer-wrap.bin");
+  LogComponentEnable ("LogRingBufferTest", LOG_INFO);
+  LogRingBufferEnable (filename.c_str (), 4096);
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      // messages of varying sizes, so that the end of the ring is padded
+      NS_LOG_INFO ("message " << i << std::string (i % 37, '.'));
+    }
+  LogRingBufferDisable ();
+
+  std::ostringstream dump;
+  LogRingBufferDump (filename.c_str (), dump);
+  std::istringstream lines (dump.str ());
+  std::vector<std::string> messages;
+  std::string line;
+  while (std::getline (lines, line))
+    {
+      messages.push_back (line);
+    }
+  NS_TEST_ASSERT_MSG_GT (messages.size (), 10, "Too few messages kept");
+  NS_TEST_ASSERT_MSG_LT (messages.size (), 1000, "The ring buffer did not wrap around");
+  uint32_t first = 1000 - messages.size ();
+  for (uint32_t i = 0; i < messages.size (); i++)
+    {
+      std::ostringstream expected;
+      expected << "[context=0] message " << first + i << std::string ((first + i) % 37, '.');
+      NS_TEST_ASSERT_MSG_EQ (messages[i], expected.str (), "Wrong message " << i);
+    }
+}
+
+void
+LogRingBufferWrapTestCase::DoTeardown (void)
+{
+  LogRingBufferDisable ();
+  LogComponentDisable ("LogRingBufferTest", (enum LogLevel)(LOG_ALL | LOG_PREFIX_ALL));
+}
+
+#ifdef HAVE_PTHREAD_H
+// ===========================================================================
+// Several threads record their messages at the same time
+// ===========================================================================
+class LogRingBufferThreadsTestCase : public TestCase
+{
+public:
+  LogRingBufferThreadsTestCase ();
+
+private:
+  class Writer
+  {
+public:
+    void Log (void);
+    uint32_t m_id;
+  };
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  std::vector<std::string> Run (uint32_t size);
+};
+
+void
+LogRingBufferThreadsTestCase::Writer::Log (void)
+{
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      NS_LOG_INFO ("message " << i << std::string (i % 37, '.'));
+    }
+}
+
+LogRingBufferThreadsTestCase::LogRingBufferThreadsTestCase ()
+  : TestCase ("Check that several threads can record in the log ring buffer at the same time")
+{
+}
+
+std::vector<std::string>
+LogRingBufferThreadsTestCase::Run (uint32_t size)
+{
+  std::string filename = CreateTempDirFilename ("log-ring-buffer-threads.bin");
+  LogRingBufferEnable (filename.c_str (), size);
+  std::vector<Writer> writers (4);
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < writers.size (); i++)
+    {
+      writers[i].m_id = i;
+      threads.push_back (Create<SystemThread> (MakeCallback (&Writer::Log, &writers[i])));
+    }
+  for (uint32_t i = 0; i < threads.size (); i++)
+    {
+      threads[i]->Start ();
+    }
+  for (uint32_t i = 0; i < threads.size (); i++)
+    {
+      threads[i]->Join ();
+    }
+  LogRingBufferDisable ();
+
+  std::ostringstream dump;
+  LogRingBufferDump (filename.c_str (), dump);
+  std::istringstream lines (dump.str ());
+  std::vector<std::string> messages;
+  std::string line;
+  while (std::getline (lines, line))
+    {
+      messages.push_back (line);
+    }
+  return messages;
+}
+
+void
+LogRingBufferThreadsTestCase::DoRun (void)
+{
+  LogComponentEnable ("LogRingBufferTest", LOG_INFO);
+  // large enough for all the messages, then small enough to wrap around
+  // many times
+  uint32_t sizes[] = { 4 << 20, 16 << 10 };
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      std::vector<std::string> messages = Run (sizes[k]);
+      if (k == 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ (messages.size (), 4 * 2000, "Messages lost");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_GT (messages.size (), 10, "Too few messages kept");
+        }
+      std::vector<int32_t> last (4, -1);
+      for (uint32_t i = 0; i < messages.size (); i++)
+        {
+          uint32_t id, n;
+          char c;
+          std::istringstream is (messages[i]);
+          is.ignore (9) >> id >> c;
+          is.ignore (9) >> n;
+          std::ostringstream expected;
+          expected << "[context=" << id << "] message " << n << std::string (n % 37, '.');
+          NS_TEST_ASSERT_MSG_EQ (messages[i], expected.str (), "Corrupted message " << i);
+          NS_TEST_ASSERT_MSG_LT (id, 4, "Corrupted message " << i);
+          NS_TEST_ASSERT_MSG_GT ((int32_t)n, last[id], "Messages of thread " << id << " out of order");
+          last[id] = n;
+        }
+    }
+}
+
+void
+LogRingBufferThreadsTestCase::DoTeardown (void)
+{
+  LogRingBufferDisable ();
+  LogComponentDisable ("LogRingBufferTest", (enum LogLevel)(LOG_ALL | LOG_PREFIX_ALL));
+}
+#endif /* HAVE_PTHREAD_H */
+
+class LogRingBufferTestSuite : public TestSuite
+{
+public:
+  LogRingBufferTestSuite ();
+};
+
+LogRingBufferTestSuite::LogRingBufferTestSuite ()
+  : TestSuite ("log-ring-buffer", UNIT)
+{
+  AddTestCase (new LogRingBufferFormatTestCase, TestCase::QUICK);
+  AddTestCase (new LogRingBufferWrapTestCase, TestCase::QUICK);
+#ifdef HAVE_PTHREAD_H
+  AddTestCase (new LogRingBufferThreadsTestCase, TestCase::QUICK);
+#endif
+}
+
+static LogRingBufferTestSuite logRingBufferTestSuite;
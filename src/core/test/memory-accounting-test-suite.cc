@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/memory-accounting.h"
+#include "ns3/object.h"
+#include "ns3/object-factory.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/ptr.h"
+#include <sstream>
+#include <string>
+
+using namespace ns3;
+
+namespace {
+
+class AccountedObject : public Object
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::AccountedObject")
+      .SetParent<Object> ()
+      .AddConstructor<AccountedObject> ()
+    ;
+    return tid;
+  }
+private:
+  uint8_t m_data[100];
+};
+
+class AccountedRefCount : public SimpleRefCount<AccountedRefCount>
+{
+private:
+  uint8_t m_data[50];
+};
+
+} // anonymous namespace
+
+// ===========================================================================
+// The accounts follow the creation and deletion of the instances
+// ===========================================================================
+class MemoryAccountingTestCase : public TestCase
+{
+public:
+  MemoryAccountingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void CheckObjects (void);
+  void CheckRefCounts (void);
+  void CheckPrint (void);
+
+  bool m_wasEnabled;
+};
+
+MemoryAccountingTestCase::MemoryAccountingTestCase ()
+  : TestCase ("Check the counts and bytes of the Object and SimpleRefCount accounts")
+{
+}
+
+void
+MemoryAccountingTestCase::CheckObjects (void)
+{
+  Ptr<AccountedObject> a = CreateObject<AccountedObject> ();
+  uint32_t account = MemoryAccounting::LookupAccount ("ns3::AccountedObject");
+  NS_TEST_ASSERT_MSG_NE (account, MemoryAccounting::NONE, "No account for the TypeId");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetName (account), "ns3::AccountedObject", "Wrong account name");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetInstanceSize (account), sizeof (AccountedObject), "Wrong instance size");
+  MemoryAccounting::ResetPeaks ();
+  uint64_t count = MemoryAccounting::GetCount (account);
+  uint64_t bytes = MemoryAccounting::GetBytes (account);
+
+  Ptr<AccountedObject> b = CreateObject<AccountedObject> ();
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::AccountedObject");
+  Ptr<Object> c = factory.Create ();
+  Ptr<AccountedObject> d = CopyObject (b);
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetCount (account), count + 3, "Wrong count after the creations");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetBytes (account), bytes + 3 * sizeof (AccountedObject), "Wrong bytes after the creations");
+
+  b = 0;
+  c = 0;
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetCount (account), count + 1, "Wrong count after the deletions");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetBytes (account), bytes + sizeof (AccountedObject), "Wrong bytes after the deletions");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetPeakCount (account), count + 3, "Wrong peak count");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetPeakBytes (account), bytes + 3 * sizeof (AccountedObject), "Wrong peak bytes");
+
+  MemoryAccounting::ResetPeaks ();
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetPeakCount (account), count + 1, "Wrong peak count after the reset");
+  a = 0;
+  d = 0;
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetCount (account), count - 1, "Wrong final count");
+}
+
+void
+MemoryAccountingTestCase::CheckRefCounts (void)
+{
+  // created before the accounting starts, and deleted last
+  MemoryAccounting::Disable ();
+  Ptr<AccountedRefCount> before = Create<AccountedRefCount> ();
+  MemoryAccounting::Enable ();
+
+  Ptr<AccountedRefCount> a = Create<AccountedRefCount> ();
+  uint32_t account = MemoryAccounting::LookupAccount ("(anonymous namespace)::AccountedRefCount");
+  NS_TEST_ASSERT_MSG_NE (account, MemoryAccounting::NONE, "No account for the class");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetCount (account), 1, "Wrong count after the creation");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetBytes (account), sizeof (AccountedRefCount), "Wrong bytes after the creation");
+  Ptr<AccountedRefCount> b = Ptr<AccountedRefCount> (new AccountedRefCount (*a), false);
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetCount (account), 2, "Wrong count after the copy");
+  Ptr<AccountedRefCount> c = b;
+  a = 0;
+  b = 0;
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetCount (account), 1, "Wrong count with a reference left");
+  before = 0;
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetCount (account), 1, "The deletion of an instance not counted was counted");
+  c = 0;
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetCount (account), 0, "Wrong count after the deletions");
+  {
+    AccountedRefCount onStack;
+    NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetCount (account), 1, "Instance on the stack not counted");
+  }
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetCount (account), 0, "Instance on the stack not subtracted");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetBytes (account), 0, "Wrong bytes after the deletions");
+  NS_TEST_EXPECT_MSG_EQ (MemoryAccounting::GetPeakCount (account), 2, "Wrong peak count");
+}
+
+void
+MemoryAccountingTestCase::CheckPrint (void)
+{
+  Ptr<AccountedObject> a = CreateObject<AccountedObject> ();
+  std::ostringstream os;
+  MemoryAccounting::Print (os);
+  NS_TEST_EXPECT_MSG_NE (os.str ().find ("ns3::AccountedObject"), std::string::npos, "The account is not printed");
+  NS_TEST_EXPECT_MSG_NE (os.str ().find ("total"), std::string::npos, "The total is not printed");
+}
+
+void
+MemoryAccountingTestCase::DoRun (void)
+{
+  m_wasEnabled = MemoryAccounting::IsEnabled ();
+  MemoryAccounting::Enable ();
+  CheckObjects ();
+  CheckRefCounts ();
+  CheckPrint ();
+}
+
+void
+MemoryAccountingTestCase::DoTeardown (void)
+{
+  if (!m_wasEnabled)
+    {
+      MemoryAccounting::Disable ();
+    }
+}
+
+class MemoryAccountingTestSuite : public TestSuite
+{
+public:
+  MemoryAccountingTestSuite ();
+};
+
+MemoryAccountingTestSuite::MemoryAccountingTestSuite ()
+  : TestSuite ("memory-accounting", UNIT)
+{
+  AddTestCase (new MemoryAccountingTestCase, TestCase::QUICK);
+}
+
+static MemoryAccountingTestSuite memoryAccountingTestSuite;
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
+#include <utility>
+
+using namespace ns3;
+
+/*
+ * A set of contexts exchanging events: each context handles an event by
+ * recording it, then schedules either a local event or, from time to
+ * time, an event for another context with a delay longer than the
+ * lookahead. The records of a run with the multithreaded simulator must
+ * be the same whatever the number of threads.
+ */
+class MultithreadedSimulatorTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorTestCase ();
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+private:
+  typedef std::vector<std::vector<std::pair<uint64_t, uint32_t> > > Records;
+  void Handle (uint32_t context, uint32_t value);
+  Records RunOnce (std::string simulatorType, uint32_t nThreads, uint32_t nPartitions);
+
+  static const uint32_t N_CONTEXTS = 16;
+  Records m_records;
+  std::vector<uint32_t> m_state;
+};
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase ()
+  : TestCase ("Check that the multithreaded simulator is deterministic")
+{
+}
+
+void
+MultithreadedSimulatorTestCase::Handle (uint32_t context, uint32_t value)
+{
+  // only touch the state of the context which runs the event
+  NS_ASSERT (Simulator::GetContext () == context);
+  m_records[context].push_back (std::make_pair (Simulator::Now ().GetTimeStep (), value));
+  uint32_t state = m_state[context] * 1103515245 + 12345 + value;
+  m_state[context] = state;
+  uint32_t r = (state >> 8) & 0xffff;
+  if (r % 4 == 0)
+    {
+      uint32_t target = (r / 4) % N_CONTEXTS;
+      Simulator::ScheduleWithContext (target, MicroSeconds (10) + NanoSeconds (r % 5000),
+                                      &MultithreadedSimulatorTestCase::Handle, this, target, r);
+    }
+  else
+    {
+      Simulator::Schedule (NanoSeconds (1 + r % 2000), &MultithreadedSimulatorTestCase::Handle,
+                           this, context, r);
+    }
+}
+
+MultithreadedSimulatorTestCase::Records
+MultithreadedSimulatorTestCase::RunOnce (std::string simulatorType, uint32_t nThreads, uint32_t nPartitions)
+{
+  Simulator::Destroy ();
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (simulatorType));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (nThreads));
+  for (uint32_t i = 0; i < N_CONTEXTS; i++)
+    {
+      MultithreadedSimulatorImpl::SetPartition (i, i % nPartitions);
+    }
+  MultithreadedSimulatorImpl::SetLookahead (MicroSeconds (10));
+
+  m_records = Records (N_CONTEXTS);
+  m_state = std::vector<uint32_t> (N_CONTEXTS, 0);
+  for (uint32_t i = 0; i < N_CONTEXTS; i++)
+    {
+      Simulator::ScheduleWithContext (i, NanoSeconds (i), &MultithreadedSimulatorTestCase::Handle,
+                                      this, i, i);
+    }
+  Simulator::Stop (MilliSeconds (10));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), MilliSeconds (10), "Simulation did not stop at the stop time");
+  Simulator::Destroy ();
+  return m_records;
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun (void)
+{
+  Records reference = RunOnce ("ns3::DefaultSimulatorImpl", 1, 1);
+  uint32_t total = 0;
+  for (uint32_t i = 0; i < N_CONTEXTS; i++)
+    {
+      total += reference[i].size ();
+    }
+  NS_TEST_ASSERT_MSG_GT (total, 10000, "Too few events to be meaningful");
+
+  // the events with the same timestamp may run in a different order with
+  // another partitioning, so each run is compared with the run on a
+  // single thread with the same partitioning.
+  uint32_t runs[][2] = { { 1, 1 }, { 1, 4 }, { 2, 4 }, { 4, 4 }, { 1, 16 }, { 3, 16 } };
+  for (uint32_t i = 0; i < sizeof (runs) / sizeof (runs[0]); i++)
+    {
+      Records records = RunOnce ("ns3::MultithreadedSimulatorImpl", runs[i][0], runs[i][1]);
+      if (runs[i][0] == 1 && runs[i][1] != 1)
+        {
+          reference = records;
+          continue;
+        }
+      for (uint32_t j = 0; j < N_CONTEXTS; j++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (records[j].size (), reference[j].size (),
+                                 "Wrong number of events for context " << j << " with "
+                                 << runs[i][0] << " threads and " << runs[i][1] << " partitions");
+          for (uint32_t k = 0; k < records[j].size (); k++)
+            {
+              NS_TEST_ASSERT_MSG_EQ (records[j][k].first, reference[j][k].first,
+                                     "Wrong event time for context " << j);
+              NS_TEST_ASSERT_MSG_EQ (records[j][k].second, reference[j][k].second,
+                                     "Wrong event for context " << j);
+            }
+        }
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (1));
+}
+
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ()
+    : TestSuite ("multithreaded-simulator")
+  {
+    AddTestCase (new MultithreadedSimulatorTestCase (), TestCase::QUICK);
+  }
+} g_multithreadedSimulatorTestSuite;
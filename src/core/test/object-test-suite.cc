@@ -333,6 +333,27 @@ AggregateObjectTestCase::DoRun (void)
 
   baseA = baseB->GetObject<BaseA> ();
   NS_TEST_ASSERT_MSG_NE (baseA, 0, "Unable to GetObject on released object");
+
+  //
+  // The results of GetObject are cached: make sure that a failed lookup
+  // is forgotten once the object is aggregated, that repeated lookups
+  // return the same objects and that the lookups of the base and derived
+  // types are not mixed up.
+  //
+  Ptr<DerivedA> derivedA = CreateObject<DerivedA> ();
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<DerivedB> (), 0, "Unexpected DerivedB aggregate");
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<BaseB> (), 0, "Unexpected BaseB aggregate");
+  Ptr<DerivedB> derivedB = CreateObject<DerivedB> ();
+  NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<DerivedA> (), 0, "Unexpected DerivedA aggregate");
+  derivedA->AggregateObject (derivedB);
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<DerivedB> (), derivedB, "Stale GetObject<DerivedB> result");
+      NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<BaseB> (), derivedB, "Stale GetObject<BaseB> result");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<DerivedA> (), derivedA, "Stale GetObject<DerivedA> result");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (), derivedA, "Stale GetObject<BaseA> result");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<Object> (DerivedB::GetTypeId ()), derivedB, "Stale GetObject (tid) result");
+    }
 }
 
 // ===========================================================================
@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/rng-stream.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/boolean.h"
+#include <vector>
+#include <algorithm>
+
+using namespace ns3;
+
+// ===========================================================================
+// The numbers of a stream must not depend on how they are drawn
+// ===========================================================================
+class RngStreamSequenceTestCase : public TestCase
+{
+public:
+  RngStreamSequenceTestCase ();
+  virtual ~RngStreamSequenceTestCase ();
+
+private:
+  virtual void DoRun (void);
+  static double Step (double state[6]);
+};
+
+RngStreamSequenceTestCase::RngStreamSequenceTestCase ()
+  : TestCase ("Check that batches and buffering do not change the sequence of a stream")
+{
+}
+
+RngStreamSequenceTestCase::~RngStreamSequenceTestCase ()
+{
+}
+
+// One step of MRG32k3a, as published by L'Ecuyer
+double
+RngStreamSequenceTestCase::Step (double state[6])
+{
+  const double m1 = 4294967087.0;
+  const double m2 = 4294944443.0;
+  const double norm = 1.0 / (m1 + 1.0);
+  int32_t k;
+  double p1 = 1403580.0 * state[1] - 810728.0 * state[0];
+  k = static_cast<int32_t> (p1 / m1);
+  p1 -= k * m1;
+  if (p1 < 0.0)
+    {
+      p1 += m1;
+    }
+  state[0] = state[1]; state[1] = state[2]; state[2] = p1;
+  double p2 = 527612.0 * state[5] - 1370589.0 * state[3];
+  k = static_cast<int32_t> (p2 / m2);
+  p2 -= k * m2;
+  if (p2 < 0.0)
+    {
+      p2 += m2;
+    }
+  state[3] = state[4]; state[4] = state[5]; state[5] = p2;
+  return ((p1 > p2) ? (p1 - p2) * norm : (p1 - p2 + m1) * norm);
+}
+
+void
+RngStreamSequenceTestCase::DoRun (void)
+{
+  const uint32_t n = 100000;
+
+  // stream 0 and substream 0 start from the seed itself
+  double state[6] = { 12345, 12345, 12345, 12345, 12345, 12345 };
+  std::vector<double> reference;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      reference.push_back (Step (state));
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (reference[0], 0.1270111220, 1e-10, "Wrong first number of MRG32k3a");
+
+  RngStream single (12345, 0, 0);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (single.RandU01 (), reference[i], "Wrong number " << i);
+    }
+
+  // mix batches of all sizes with single draws and copies
+  RngStream mixed (12345, 0, 0);
+  std::vector<double> batch (n);
+  uint32_t i = 0;
+  uint32_t size = 0;
+  while (i < n)
+    {
+      uint32_t count = std::min (size, n - i);
+      mixed.RandU01 (&batch[i], count);
+      i += count;
+      if (i < n)
+        {
+          batch[i] = mixed.RandU01 ();
+          i++;
+        }
+      if (size % 3 == 0)
+        {
+          mixed = RngStream (mixed);
+        }
+      size++;
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (batch[i], reference[i], "Wrong number " << i << " in a batch");
+    }
+}
+
+// ===========================================================================
+// UniformRandomVariable::GetValues must match GetValue
+// ===========================================================================
+class UniformGetValuesTestCase : public TestCase
+{
+public:
+  UniformGetValuesTestCase ();
+  virtual ~UniformGetValuesTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+UniformGetValuesTestCase::UniformGetValuesTestCase ()
+  : TestCase ("Check that UniformRandomVariable::GetValues returns the values of GetValue")
+{
+}
+
+UniformGetValuesTestCase::~UniformGetValuesTestCase ()
+{
+}
+
+void
+UniformGetValuesTestCase::DoRun (void)
+{
+  for (uint32_t antithetic = 0; antithetic < 2; antithetic++)
+    {
+      Ptr<UniformRandomVariable> one = CreateObject<UniformRandomVariable> ();
+      Ptr<UniformRandomVariable> batch = CreateObject<UniformRandomVariable> ();
+      one->SetStream (7);
+      batch->SetStream (7);
+      one->SetAttribute ("Antithetic", BooleanValue (antithetic));
+      batch->SetAttribute ("Antithetic", BooleanValue (antithetic));
+
+      double values[100];
+      one->GetValue (2.0, 5.0);
+      batch->GetValues (2.0, 5.0, values, 1);
+      batch->GetValues (2.0, 5.0, values, 100);
+      for (uint32_t i = 0; i < 100; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (values[i], one->GetValue (2.0, 5.0), "Wrong value " << i);
+        }
+    }
+}
+
+class RngStreamTestSuite : public TestSuite
+{
+public:
+  RngStreamTestSuite ();
+};
+
+RngStreamTestSuite::RngStreamTestSuite ()
+  : TestSuite ("rng-stream", UNIT)
+{
+  AddTestCase (new RngStreamSequenceTestCase, TestCase::QUICK);
+  AddTestCase (new UniformGetValuesTestCase, TestCase::QUICK);
+}
+
+static RngStreamTestSuite rngStreamTestSuite;
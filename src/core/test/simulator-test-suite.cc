@@ -19,10 +19,19 @@
  */
 #include "ns3/test.h"
 #include "ns3/simulator.h"
+#include "ns3/default-simulator-impl.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include <vector>
+#include <set>
+#include <fstream>
+#include <sstream>
 
 using namespace ns3;
 
@@ -459,6 +468,287 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/*
+ * Drive a scheduler directly with a large, random mix of insertions,
+ * removals and dequeues, many of them with identical timestamps, and
+ * check that events come out in the same order as from a MapScheduler.
+ */
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+private:
+  uint32_t Random (void);
+  ObjectFactory m_schedulerFactory;
+  uint32_t m_seed;
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check event ordering of " + schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory),
+    m_seed (1)
+{
+}
+
+uint32_t
+SchedulerOrderTestCase::Random (void)
+{
+  m_seed = m_seed * 1103515245 + 12345;
+  return (m_seed >> 8) & 0xffffff;
+}
+
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  Ptr<Scheduler> reference = CreateObject<MapScheduler> ();
+  std::vector<Scheduler::Event> pending;
+  std::set<uint32_t> dequeued;
+  uint64_t now = 0;
+  uint32_t uid = 0;
+  for (uint32_t step = 0; step < 200000; step++)
+    {
+      uint32_t action = Random () % 10;
+      if (action < 5 || reference->IsEmpty ())
+        {
+          Scheduler::Event ev;
+          ev.impl = 0;
+          // a mix of far, near and simultaneous events
+          uint32_t kind = Random () % 3;
+          uint64_t delay = kind == 0 ? Random () : (kind == 1 ? Random () % 100 : 0);
+          ev.key.m_ts = now + delay;
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          scheduler->Insert (ev);
+          reference->Insert (ev);
+          pending.push_back (ev);
+        }
+      else if (action < 6)
+        {
+          // remove a random event which may still be pending
+          uint32_t i = Random () % pending.size ();
+          Scheduler::Event ev = pending[i];
+          pending[i] = pending.back ();
+          pending.pop_back ();
+          if (dequeued.find (ev.key.m_uid) == dequeued.end ())
+            {
+              reference->Remove (ev);
+              scheduler->Remove (ev);
+            }
+        }
+      else
+        {
+          Scheduler::Event expected = reference->RemoveNext ();
+          Scheduler::Event next = scheduler->PeekNext ();
+          NS_TEST_ASSERT_MSG_EQ (next.key.m_uid, expected.key.m_uid, "Wrong next event at step " << step);
+          Scheduler::Event got = scheduler->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (got.key.m_uid, expected.key.m_uid, "Wrong event removed at step " << step);
+          NS_TEST_ASSERT_MSG_EQ (got.key.m_ts, expected.key.m_ts, "Wrong timestamp at step " << step);
+          dequeued.insert (got.key.m_uid);
+          now = got.key.m_ts;
+        }
+    }
+  while (!reference->IsEmpty ())
+    {
+      Scheduler::Event expected = reference->RemoveNext ();
+      Scheduler::Event got = scheduler->RemoveNext ();
+      NS_TEST_ASSERT_MSG_EQ (got.key.m_uid, expected.key.m_uid, "Wrong event while draining");
+    }
+  NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), true, "Scheduler should be empty");
+}
+
+class SimulatorProfileTestCase : public TestCase
+{
+public:
+  SimulatorProfileTestCase ();
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Handler (void);
+  static void Function (uint32_t a);
+};
+
+SimulatorProfileTestCase::SimulatorProfileTestCase ()
+  : TestCase ("Check the profile of the events")
+{
+}
+
+void
+SimulatorProfileTestCase::Handler (void)
+{
+}
+
+void
+SimulatorProfileTestCase::Function (uint32_t a)
+{
+}
+
+void
+SimulatorProfileTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("simulator-profile.txt");
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::Profile", BooleanValue (true));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileFile", StringValue (filename));
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Simulator::Schedule (NanoSeconds (i), &SimulatorProfileTestCase::Handler, this);
+      Simulator::ScheduleWithContext (7, NanoSeconds (i), &SimulatorProfileTestCase::Function, i);
+    }
+  EventId cancelled = Simulator::Schedule (Seconds (1), &SimulatorProfileTestCase::Handler, this);
+  Simulator::Remove (cancelled);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::ifstream is (filename.c_str ());
+  std::ostringstream oss;
+  oss << is.rdbuf ();
+  std::string report = oss.str ();
+  NS_TEST_ASSERT_MSG_EQ ((report.find ("Simulator profile: 200 events") != std::string::npos), true,
+                         "Wrong number of events in the profile:\n" << report);
+  NS_TEST_ASSERT_MSG_EQ ((report.find ("SimulatorProfileTestCase") != std::string::npos), true,
+                         "Event type missing from the profile:\n" << report);
+  NS_TEST_ASSERT_MSG_EQ ((report.find ("         100") != std::string::npos), true,
+                         "Event counts missing from the profile:\n" << report);
+  NS_TEST_ASSERT_MSG_EQ ((report.find ("context 7") != std::string::npos), true,
+                         "Context missing from the profile:\n" << report);
+  NS_TEST_ASSERT_MSG_EQ ((report.find ("scheduler insert") != std::string::npos), true,
+                         "Scheduler cost missing from the profile:\n" << report);
+}
+
+void
+SimulatorProfileTestCase::DoTeardown (void)
+{
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::Profile", BooleanValue (false));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileFile", StringValue (""));
+}
+
+class CancelledEventsTestCase : public TestCase
+{
+public:
+  CancelledEventsTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Handler (uint32_t i);
+  uint32_t m_count;
+  uint32_t m_last;
+  bool m_cancelledRan;
+  ObjectFactory m_schedulerFactory;
+};
+
+CancelledEventsTestCase::CancelledEventsTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that cancelled events are removed or compacted with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+CancelledEventsTestCase::Handler (uint32_t i)
+{
+  if (i % 8 != 0 || (m_count != 0 && i <= m_last))
+    {
+      m_cancelledRan = true;
+    }
+  m_last = i;
+  m_count++;
+}
+
+void
+CancelledEventsTestCase::DoRun (void)
+{
+  m_count = 0;
+  m_last = 0;
+  m_cancelledRan = false;
+  Simulator::Destroy ();
+  Simulator::SetScheduler (m_schedulerFactory);
+  Ptr<DefaultSimulatorImpl> impl = DynamicCast<DefaultSimulatorImpl> (Simulator::GetImplementation ());
+  NS_TEST_ASSERT_MSG_EQ ((impl != 0), true, "Not the default simulator");
+  bool fastRemove = m_schedulerFactory.Create<Scheduler> ()->HasFastRemove ();
+
+  std::vector<EventId> events;
+  for (uint32_t i = 0; i < 4000; i++)
+    {
+      events.push_back (Simulator::Schedule (MicroSeconds (i), &CancelledEventsTestCase::Handler, this, i));
+    }
+  for (uint32_t i = 0; i < 4000; i++)
+    {
+      if (i % 8 != 0)
+        {
+          events[i].Cancel ();
+          NS_TEST_ASSERT_MSG_EQ (events[i].IsExpired (), true, "Cancelled event not expired");
+        }
+    }
+  // cancelling twice does not count
+  events[1].Cancel ();
+
+  DefaultSimulatorImpl::CancelStats stats = impl->GetCancelStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.cancelled, 3500, "Wrong number of cancelled events");
+  if (fastRemove)
+    {
+      NS_TEST_ASSERT_MSG_EQ (stats.removed, 3500, "Cancelled events not removed");
+      NS_TEST_ASSERT_MSG_EQ (stats.dead, 0, "Cancelled events left in the event list");
+      NS_TEST_ASSERT_MSG_EQ (stats.compactions, 0, "Unexpected compaction");
+    }
+  else
+    {
+      // the event list is compacted once the 3001st event is cancelled
+      NS_TEST_ASSERT_MSG_EQ (stats.removed, 0, "Unexpected removal");
+      NS_TEST_ASSERT_MSG_EQ (stats.compactions, 1, "Event list not compacted");
+      NS_TEST_ASSERT_MSG_EQ (stats.compacted, 3001, "Wrong number of compacted events");
+      NS_TEST_ASSERT_MSG_EQ (stats.dead, 499, "Wrong number of dead events");
+    }
+
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_count, 500, "Wrong number of events run");
+  NS_TEST_ASSERT_MSG_EQ (m_cancelledRan, false, "Cancelled event run, or events out of order");
+  NS_TEST_ASSERT_MSG_EQ (impl->GetCancelStats ().dead, 0, "Dead events not accounted for");
+  Simulator::Destroy ();
+}
+
+class StaleEventIdTestCase : public TestCase
+{
+public:
+  StaleEventIdTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Handler (void);
+  uint32_t m_count;
+  ObjectFactory m_schedulerFactory;
+};
+
+StaleEventIdTestCase::StaleEventIdTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that an EventId kept across Simulator::Destroy is expired with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+StaleEventIdTestCase::Handler (void)
+{
+  m_count++;
+}
+
+void
+StaleEventIdTestCase::DoRun (void)
+{
+  m_count = 0;
+  Simulator::Destroy ();
+  Simulator::SetScheduler (m_schedulerFactory);
+  EventId stale = Simulator::Schedule (Seconds (10), &StaleEventIdTestCase::Handler, this);
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (stale.IsExpired (), true, "Event left over by Simulator::Destroy not expired");
+
+  // the same time and uid as the stale event
+  Simulator::SetScheduler (m_schedulerFactory);
+  EventId live = Simulator::Schedule (Seconds (10), &StaleEventIdTestCase::Handler, this);
+  stale.Cancel ();
+  Simulator::Remove (stale);
+  NS_TEST_ASSERT_MSG_EQ (live.IsExpired (), false, "Cancelling a stale EventId cancelled another event");
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_count, 1, "Event not run");
+  Simulator::Destroy ();
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +765,19 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorProfileTestCase (), TestCase::QUICK);
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new CancelledEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (HeapScheduler::GetTypeId ());
+    AddTestCase (new CancelledEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CalendarScheduler::GetTypeId ());
+    AddTestCase (new CancelledEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new CancelledEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new StaleEventIdTestCase (factory), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
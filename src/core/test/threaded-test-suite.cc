@@ -26,10 +26,13 @@
 #include "ns3/config.h"
 #include "ns3/string.h"
 #include "ns3/system-thread.h"
+#include "ns3/injected-event-queue.h"
+#include "ns3/callback.h"
 
 #include <ctime>
 #include <list>
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -225,6 +228,76 @@ ThreadedSimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_a, m_d, "Bad scheduling");
 }
 
+/*
+ * Several threads push into a small InjectedEventQueue, so that it
+ * overflows, while the test thread pops: all the items must be received
+ * once and the items of each producer must be received in order.
+ */
+class InjectedEventQueueTestCase : public TestCase
+{
+public:
+  InjectedEventQueueTestCase ();
+private:
+  virtual void DoRun (void);
+  static void Produce (std::pair<InjectedEventQueueTestCase *, uint32_t> producer);
+
+  static const uint32_t N_PRODUCERS = 4;
+  static const uint32_t N_ITEMS = 100000;
+  InjectedEventQueue m_queue;
+};
+
+InjectedEventQueueTestCase::InjectedEventQueueTestCase ()
+  : TestCase ("Check the queue of the events injected by other threads"),
+    m_queue (64)
+{
+}
+
+void
+InjectedEventQueueTestCase::Produce (std::pair<InjectedEventQueueTestCase *, uint32_t> producer)
+{
+  for (uint32_t i = 0; i < N_ITEMS; i++)
+    {
+      InjectedEventQueue::Item item;
+      item.context = producer.second;
+      item.timestamp = i;
+      item.event = 0;
+      producer.first->m_queue.Push (item);
+    }
+}
+
+void
+InjectedEventQueueTestCase::DoRun (void)
+{
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < N_PRODUCERS; i++)
+    {
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&InjectedEventQueueTestCase::Produce, std::make_pair (this, i))));
+    }
+  for (uint32_t i = 0; i < N_PRODUCERS; i++)
+    {
+      threads[i]->Start ();
+    }
+  std::vector<uint64_t> next (N_PRODUCERS, 0);
+  uint32_t received = 0;
+  while (received < N_PRODUCERS * N_ITEMS)
+    {
+      InjectedEventQueue::Item item;
+      if (!m_queue.Pop (&item))
+        {
+          continue;
+        }
+      NS_TEST_ASSERT_MSG_LT (item.context, N_PRODUCERS, "Corrupted item");
+      NS_TEST_ASSERT_MSG_EQ (item.timestamp, next[item.context], "Item out of order for producer " << item.context);
+      next[item.context]++;
+      received++;
+    }
+  for (uint32_t i = 0; i < N_PRODUCERS; i++)
+    {
+      threads[i]->Join ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_queue.IsEmpty (), true, "Unexpected item");
+}
+
 class ThreadedSimulatorTestSuite : public TestSuite
 {
 public:
@@ -241,7 +314,8 @@ public:
       "ns3::ListScheduler",
       "ns3::HeapScheduler",
       "ns3::MapScheduler",
-      "ns3::CalendarScheduler"
+      "ns3::CalendarScheduler",
+      "ns3::LadderScheduler"
     };
     unsigned int threadcounts[] = {
       0,
@@ -250,6 +324,8 @@ public:
       20
     };
     ObjectFactory factory;
+
+    AddTestCase (new InjectedEventQueueTestCase (), TestCase::QUICK);
     
     for (unsigned int i=0; i < (sizeof(simulatorTypes) / sizeof(simulatorTypes[0])); ++i) 
       {
@@ -21,6 +21,8 @@
 #include "ns3/test.h"
 #include "ns3/simulator.h"
 #include "ns3/nstime.h"
+#include "ns3/timer-wheel.h"
+#include <vector>
 
 namespace {
 void bari (int)
@@ -208,6 +210,198 @@ TimerTemplateTestCase::DoTeardown (void)
   Simulator::Destroy ();
 }
 
+class TimerWheelTestCase : public TestCase
+{
+public:
+  TimerWheelTestCase ();
+  virtual void DoRun (void);
+
+private:
+  enum
+  {
+    N_TIMERS = 6
+  };
+  void Expire (uint32_t i);
+  void Rearm (void);
+  void CheckSuspend (void);
+  void StartInContext (void);
+
+  Timer m_timers[N_TIMERS];
+  Time m_delays[N_TIMERS];
+  std::vector<Time> m_expired[N_TIMERS];
+  uint32_t m_context;
+  Timer m_rearmed;
+  uint32_t m_nRearms;
+  Time m_lastRearm;
+  Timer m_suspended;
+};
+
+TimerWheelTestCase::TimerWheelTestCase ()
+  : TestCase ("Check the timers held in a timer wheel")
+{
+}
+
+void
+TimerWheelTestCase::Expire (uint32_t i)
+{
+  m_expired[i].push_back (Simulator::Now ());
+  if (i == 0)
+    {
+      m_context = Simulator::GetContext ();
+    }
+}
+
+void
+TimerWheelTestCase::Rearm (void)
+{
+  // rescheduled every millisecond, before it can expire
+  m_rearmed.Cancel ();
+  m_rearmed.Schedule ();
+  m_lastRearm = Simulator::Now ();
+  // the rearmed and suspended timers share the wheel of the context
+  NS_TEST_EXPECT_MSG_EQ (TimerWheel::GetNTimers (), 2, "Wrong number of timers in the wheel");
+  if (++m_nRearms < 1000)
+    {
+      Simulator::Schedule (MicroSeconds (1000), &TimerWheelTestCase::Rearm, this);
+    }
+}
+
+void
+TimerWheelTestCase::CheckSuspend (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_suspended.GetDelayLeft (), MilliSeconds (4000) + MicroSeconds (17), "Wrong delay left");
+  m_suspended.Suspend ();
+  NS_TEST_EXPECT_MSG_EQ (m_suspended.IsSuspended (), true, "Timer not suspended");
+  NS_TEST_EXPECT_MSG_EQ (m_suspended.GetDelayLeft (), MilliSeconds (4000) + MicroSeconds (17), "Wrong delay left while suspended");
+  m_suspended.Resume ();
+  NS_TEST_EXPECT_MSG_EQ (m_suspended.IsRunning (), true, "Timer not resumed");
+  NS_TEST_EXPECT_MSG_EQ (m_suspended.GetDelayLeft (), MilliSeconds (4000) + MicroSeconds (17), "Wrong delay left after the resume");
+}
+
+void
+TimerWheelTestCase::StartInContext (void)
+{
+  for (uint32_t i = 0; i < N_TIMERS; i++)
+    {
+      m_timers[i].SetSchedulePolicy (Timer::SCHEDULE_WHEEL);
+      m_timers[i].SetFunction (&TimerWheelTestCase::Expire, this);
+      m_timers[i].SetArguments (i);
+      m_timers[i].Schedule (m_delays[i]);
+      NS_TEST_EXPECT_MSG_EQ (m_timers[i].IsRunning (), true, "Timer not running");
+      NS_TEST_EXPECT_MSG_EQ (m_timers[i].GetDelayLeft (), m_delays[i], "Wrong delay left");
+    }
+  // cancelled before its slot comes up
+  m_timers[5].Cancel ();
+  NS_TEST_EXPECT_MSG_EQ (m_timers[5].IsExpired (), true, "Cancelled timer not expired");
+}
+
+void
+TimerWheelTestCase::DoRun (void)
+{
+  m_delays[0] = MicroSeconds (300);
+  m_delays[1] = MicroSeconds (3700);
+  m_delays[2] = MilliSeconds (250) + NanoSeconds (1);
+  m_delays[3] = Seconds (17.123456);
+  m_delays[4] = Seconds (6 * 3600);
+  m_delays[5] = MilliSeconds (20);
+  for (uint32_t i = 0; i < N_TIMERS; i++)
+    {
+      m_timers[i] = Timer (Timer::CANCEL_ON_DESTROY);
+    }
+  m_context = 0;
+  Simulator::ScheduleWithContext (7, MilliSeconds (1500), &TimerWheelTestCase::StartInContext, this);
+
+  m_rearmed = Timer (Timer::CANCEL_ON_DESTROY, Timer::SCHEDULE_WHEEL);
+  m_rearmed.SetFunction (&TimerWheelTestCase::Expire, this);
+  m_rearmed.SetArguments ((uint32_t)N_TIMERS - 1);
+  m_rearmed.SetDelay (MilliSeconds (200));
+  m_nRearms = 0;
+  Simulator::Schedule (MicroSeconds (10), &TimerWheelTestCase::Rearm, this);
+
+  m_suspended = Timer (Timer::CANCEL_ON_DESTROY, Timer::SCHEDULE_WHEEL);
+  m_suspended.SetFunction (&TimerWheelTestCase::Expire, this);
+  m_suspended.SetArguments ((uint32_t)N_TIMERS - 1);
+  m_suspended.Schedule (MilliSeconds (5000) + MicroSeconds (17));
+  Simulator::Schedule (Seconds (1), &TimerWheelTestCase::CheckSuspend, this);
+  Simulator::Run ();
+
+  for (uint32_t i = 0; i < N_TIMERS - 1; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_expired[i].size (), 1, "Timer " << i << " did not expire once");
+      NS_TEST_EXPECT_MSG_EQ (m_expired[i][0], MilliSeconds (1500) + m_delays[i], "Timer " << i << " expired at the wrong time");
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_context, 7, "Timer expired in the wrong context");
+  // the rearmed and suspended timers
+  NS_TEST_ASSERT_MSG_EQ (m_expired[N_TIMERS - 1].size (), 2, "The rearmed and suspended timers did not expire once");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[N_TIMERS - 1][0], m_lastRearm + MilliSeconds (200), "The rearmed timer expired at the wrong time");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[N_TIMERS - 1][1], MilliSeconds (5000) + MicroSeconds (17), "The suspended timer expired at the wrong time");
+  Simulator::Destroy ();
+}
+
+class TimerCopyTestCase : public TestCase
+{
+public:
+  TimerCopyTestCase ();
+  virtual void DoRun (void);
+
+private:
+  void Expire (uint32_t i);
+
+  std::vector<uint32_t> m_expired;
+  std::vector<Time> m_times;
+};
+
+TimerCopyTestCase::TimerCopyTestCase ()
+  : TestCase ("Check the copies of a timer")
+{
+}
+
+void
+TimerCopyTestCase::Expire (uint32_t i)
+{
+  m_expired.push_back (i);
+  m_times.push_back (Simulator::Now ());
+}
+
+void
+TimerCopyTestCase::DoRun (void)
+{
+  Timer a (Timer::CANCEL_ON_DESTROY);
+  a.SetFunction (&TimerCopyTestCase::Expire, this);
+  a.SetArguments ((uint32_t)1);
+  // the copy has its own arguments
+  Timer b (a);
+  b.SetArguments ((uint32_t)2);
+  a.Schedule (Seconds (1));
+  b.Schedule (Seconds (2));
+
+  Timer wheel (Timer::CANCEL_ON_DESTROY, Timer::SCHEDULE_WHEEL);
+  wheel.SetFunction (&TimerCopyTestCase::Expire, this);
+  wheel.SetArguments ((uint32_t)3);
+  wheel.Schedule (Seconds (3));
+  Timer assigned (Timer::CANCEL_ON_DESTROY, Timer::SCHEDULE_WHEEL);
+  assigned.SetFunction (&TimerCopyTestCase::Expire, this);
+  assigned.SetArguments ((uint32_t)4);
+  assigned.Schedule (Seconds (4));
+  // leaves the wheel, and is not running as a copy of a timer held in it
+  assigned = wheel;
+  NS_TEST_EXPECT_MSG_EQ (assigned.IsRunning (), false, "Copy of a timer held in the wheel is running");
+  NS_TEST_EXPECT_MSG_EQ (wheel.IsRunning (), true, "Copied timer not running");
+  assigned.SetArguments ((uint32_t)5);
+  assigned.Schedule (Seconds (5));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_expired.size (), 4, "Wrong number of expirations");
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_expired[i], i + 1, "Wrong arguments for expiration " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_times[i], Seconds (i + 1), "Wrong time for expiration " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_expired[3], 5, "Wrong arguments for the assigned timer");
+  NS_TEST_EXPECT_MSG_EQ (m_times[3], Seconds (5), "Wrong time for the assigned timer");
+  Simulator::Destroy ();
+}
+
 static class TimerTestSuite : public TestSuite
 {
 public:
@@ -216,5 +410,7 @@ public:
   {
     AddTestCase (new TimerStateTestCase (), TestCase::QUICK);
     AddTestCase (new TimerTemplateTestCase (), TestCase::QUICK);
+    AddTestCase (new TimerWheelTestCase (), TestCase::QUICK);
+    AddTestCase (new TimerCopyTestCase (), TestCase::QUICK);
   }
 } g_timerTestSuite;
@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/realtime-simulator-impl.h"
+#include "ns3/timerfd-synchronizer.h"
+#include "ns3/system-thread.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/callback.h"
+
+#include <time.h>
+
+using namespace ns3;
+
+// ===========================================================================
+// Events run on time and their lateness is recorded
+// ===========================================================================
+class TimerfdSynchronizerEventsTestCase : public TestCase
+{
+public:
+  TimerfdSynchronizerEventsTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Event (Time due);
+  void Lateness (Time lateness);
+
+  uint32_t m_events;
+  uint32_t m_lateness;
+  Time m_maxDrift;
+};
+
+TimerfdSynchronizerEventsTestCase::TimerfdSynchronizerEventsTestCase ()
+  : TestCase ("Check that the timerfd synchronizer runs the events on time")
+{
+}
+
+void
+TimerfdSynchronizerEventsTestCase::Event (Time due)
+{
+  m_events++;
+  Time drift = Simulator::GetImplementation ()->GetObject<RealtimeSimulatorImpl> ()->RealtimeNow () - due;
+  if (drift > m_maxDrift)
+    {
+      m_maxDrift = drift;
+    }
+}
+
+void
+TimerfdSynchronizerEventsTestCase::Lateness (Time lateness)
+{
+  m_lateness++;
+}
+
+void
+TimerfdSynchronizerEventsTestCase::DoRun (void)
+{
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+  Ptr<RealtimeSimulatorImpl> impl = Simulator::GetImplementation ()->GetObject<RealtimeSimulatorImpl> ();
+  NS_TEST_ASSERT_MSG_NE (impl, 0, "Not a RealtimeSimulatorImpl");
+  impl->SetSynchronizerType (TimerfdSynchronizer::GetTypeId ());
+  Ptr<TimerfdSynchronizer> synchronizer = impl->GetSynchronizer ()->GetObject<TimerfdSynchronizer> ();
+  NS_TEST_ASSERT_MSG_NE (synchronizer, 0, "Not a TimerfdSynchronizer");
+  synchronizer->TraceConnectWithoutContext ("Lateness", MakeCallback (&TimerfdSynchronizerEventsTestCase::Lateness, this));
+
+  m_events = 0;
+  m_lateness = 0;
+  m_maxDrift = Time (0);
+  for (uint32_t i = 1; i <= 20; i++)
+    {
+      Simulator::Schedule (MilliSeconds (i), &TimerfdSynchronizerEventsTestCase::Event, this, MilliSeconds (i));
+    }
+  // the real-time simulator waits for other threads when it runs out of events
+  Simulator::Stop (MilliSeconds (20));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_events, 20, "Missing events");
+  // one wait per event, the Stop event included
+  NS_TEST_EXPECT_MSG_EQ (m_lateness, 21, "One wait per event expected");
+  uint64_t recorded = 0;
+  std::vector<uint64_t> histogram = synchronizer->GetLatenessHistogram ();
+  for (uint32_t i = 0; i < histogram.size (); i++)
+    {
+      recorded += histogram[i];
+    }
+  NS_TEST_EXPECT_MSG_EQ (recorded, m_lateness, "Wrong lateness histogram");
+  NS_TEST_EXPECT_MSG_EQ ((synchronizer->GetMaxLateness () <= m_maxDrift), true, "Lateness larger than the drift of an event");
+  // loose enough for a loaded machine
+  NS_TEST_EXPECT_MSG_LT (m_maxDrift, MilliSeconds (100), "Events far too late");
+}
+
+void
+TimerfdSynchronizerEventsTestCase::DoTeardown (void)
+{
+  Simulator::Destroy ();
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+// ===========================================================================
+// An event scheduled by another thread wakes the simulator up
+// ===========================================================================
+class TimerfdSynchronizerSignalTestCase : public TestCase
+{
+public:
+  TimerfdSynchronizerSignalTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Inject (void);
+  void Injected (void);
+  void Late (void);
+
+  Time m_injected;
+  bool m_late;
+};
+
+TimerfdSynchronizerSignalTestCase::TimerfdSynchronizerSignalTestCase ()
+  : TestCase ("Check that the timerfd synchronizer wakes up for the events of other threads")
+{
+}
+
+void
+TimerfdSynchronizerSignalTestCase::Inject (void)
+{
+  struct timespec ts;
+  ts.tv_sec = 0;
+  ts.tv_nsec = 20000000;
+  nanosleep (&ts, NULL);
+  Simulator::ScheduleWithContext (0, Time (0), &TimerfdSynchronizerSignalTestCase::Injected, this);
+}
+
+void
+TimerfdSynchronizerSignalTestCase::Injected (void)
+{
+  m_injected = Simulator::GetImplementation ()->GetObject<RealtimeSimulatorImpl> ()->RealtimeNow ();
+  Simulator::Stop ();
+}
+
+void
+TimerfdSynchronizerSignalTestCase::Late (void)
+{
+  m_late = true;
+}
+
+void
+TimerfdSynchronizerSignalTestCase::DoRun (void)
+{
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+  Ptr<RealtimeSimulatorImpl> impl = Simulator::GetImplementation ()->GetObject<RealtimeSimulatorImpl> ();
+  NS_TEST_ASSERT_MSG_NE (impl, 0, "Not a RealtimeSimulatorImpl");
+  impl->SetSynchronizerType (TimerfdSynchronizer::GetTypeId ());
+
+  m_injected = Time (0);
+  m_late = false;
+  Simulator::Schedule (Seconds (2), &TimerfdSynchronizerSignalTestCase::Late, this);
+  Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&TimerfdSynchronizerSignalTestCase::Inject, this));
+  thread->Start ();
+  Simulator::Run ();
+  thread->Join ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_late, false, "The simulator slept through the injected event");
+  NS_TEST_EXPECT_MSG_GT (m_injected, MilliSeconds (10), "Injected event run too early");
+  NS_TEST_EXPECT_MSG_LT (m_injected, MilliSeconds (500), "Injected event run too late");
+}
+
+void
+TimerfdSynchronizerSignalTestCase::DoTeardown (void)
+{
+  Simulator::Destroy ();
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+class TimerfdSynchronizerTestSuite : public TestSuite
+{
+public:
+  TimerfdSynchronizerTestSuite ();
+};
+
+TimerfdSynchronizerTestSuite::TimerfdSynchronizerTestSuite ()
+  : TestSuite ("timerfd-synchronizer", UNIT)
+{
+  AddTestCase (new TimerfdSynchronizerEventsTestCase, TestCase::QUICK);
+  AddTestCase (new TimerfdSynchronizerSignalTestCase, TestCase::QUICK);
+}
+
+static TimerfdSynchronizerTestSuite timerfdSynchronizerTestSuite;
@@ -18,6 +18,8 @@
 
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
+#include <vector>
+#include <map>
 
 using namespace ns3;
 
@@ -108,6 +110,187 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+/*
+ * Connect more sinks than a TracedCallback stores inline and check that
+ * they are called in the order of connection, also after some of them
+ * are disconnected and after the TracedCallback is copied.
+ */
+class ManySinksTracedCallbackTestCase : public TestCase
+{
+public:
+  ManySinksTracedCallbackTestCase ();
+  virtual ~ManySinksTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  static void Sink (std::vector<uint32_t> *calls, uint32_t sink, uint32_t value);
+  bool Check (TracedCallback<uint32_t> &trace, uint32_t n, const uint32_t expected[]);
+
+  std::vector<uint32_t> m_calls;
+};
+
+ManySinksTracedCallbackTestCase::ManySinksTracedCallbackTestCase ()
+  : TestCase ("Check TracedCallback with many sinks")
+{
+}
+
+void
+ManySinksTracedCallbackTestCase::Sink (std::vector<uint32_t> *calls, uint32_t sink, uint32_t value)
+{
+  calls->push_back (sink);
+}
+
+bool
+ManySinksTracedCallbackTestCase::Check (TracedCallback<uint32_t> &trace, uint32_t n, const uint32_t expected[])
+{
+  m_calls.clear ();
+  trace (0);
+  return m_calls == std::vector<uint32_t> (expected, expected + n);
+}
+
+void
+ManySinksTracedCallbackTestCase::DoRun (void)
+{
+  TracedCallback<uint32_t> trace;
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "New TracedCallback is not empty");
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      trace.ConnectWithoutContext (MakeBoundCallback (&ManySinksTracedCallbackTestCase::Sink, &m_calls, i));
+    }
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), false, "TracedCallback unexpectedly empty");
+  // connect sink 2 a second time
+  trace.ConnectWithoutContext (MakeBoundCallback (&ManySinksTracedCallbackTestCase::Sink, &m_calls, 2));
+  uint32_t all[] = { 0, 1, 2, 3, 4, 5, 2 };
+  NS_TEST_ASSERT_MSG_EQ (Check (trace, 7, all), true, "Wrong calls with seven sinks");
+
+  // all the connections of a sink are removed
+  trace.DisconnectWithoutContext (MakeBoundCallback (&ManySinksTracedCallbackTestCase::Sink, &m_calls, 2));
+  uint32_t noTwo[] = { 0, 1, 3, 4, 5 };
+  NS_TEST_ASSERT_MSG_EQ (Check (trace, 5, noTwo), true, "Wrong calls after disconnecting sink 2");
+
+  trace.DisconnectWithoutContext (MakeBoundCallback (&ManySinksTracedCallbackTestCase::Sink, &m_calls, 0));
+  trace.ConnectWithoutContext (MakeBoundCallback (&ManySinksTracedCallbackTestCase::Sink, &m_calls, 6));
+  uint32_t noZero[] = { 1, 3, 4, 5, 6 };
+  NS_TEST_ASSERT_MSG_EQ (Check (trace, 5, noZero), true, "Wrong calls after disconnecting sink 0");
+
+  TracedCallback<uint32_t> copy = trace;
+  trace.DisconnectWithoutContext (MakeBoundCallback (&ManySinksTracedCallbackTestCase::Sink, &m_calls, 5));
+  NS_TEST_ASSERT_MSG_EQ (Check (copy, 5, noZero), true, "Wrong calls on a copy");
+  uint32_t noFive[] = { 1, 3, 4, 6 };
+  NS_TEST_ASSERT_MSG_EQ (Check (trace, 4, noFive), true, "Wrong calls after disconnecting sink 5");
+
+  uint32_t sinks[] = { 1, 3, 4, 6 };
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      trace.DisconnectWithoutContext (MakeBoundCallback (&ManySinksTracedCallbackTestCase::Sink, &m_calls, sinks[i]));
+    }
+  NS_TEST_ASSERT_MSG_EQ (trace.IsEmpty (), true, "TracedCallback not empty after disconnecting all sinks");
+  NS_TEST_ASSERT_MSG_EQ (Check (trace, 0, sinks), true, "Unexpected calls");
+}
+
+/*
+ * Let the sinks connect and disconnect sinks while the TracedCallback
+ * calls them, and check that the other sinks are still called.
+ */
+class ChangeWhileCallingTracedCallbackTestCase : public TestCase
+{
+public:
+  ChangeWhileCallingTracedCallbackTestCase ();
+  virtual ~ChangeWhileCallingTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  static void Sink (ChangeWhileCallingTracedCallbackTestCase *test, uint32_t sink, uint32_t value);
+  Callback<void, uint32_t> MakeSink (uint32_t sink);
+  bool Check (uint32_t n, const uint32_t expected[]);
+
+  TracedCallback<uint32_t> m_trace;
+  std::vector<uint32_t> m_calls;
+  // the sink disconnected and the sink connected by each sink, if any
+  std::map<uint32_t, uint32_t> m_disconnect;
+  std::map<uint32_t, uint32_t> m_connect;
+};
+
+ChangeWhileCallingTracedCallbackTestCase::ChangeWhileCallingTracedCallbackTestCase ()
+  : TestCase ("Check TracedCallback with sinks changed while it is called")
+{
+}
+
+void
+ChangeWhileCallingTracedCallbackTestCase::Sink (ChangeWhileCallingTracedCallbackTestCase *test,
+                                                uint32_t sink, uint32_t value)
+{
+  test->m_calls.push_back (sink);
+  std::map<uint32_t, uint32_t>::iterator i = test->m_disconnect.find (sink);
+  if (i != test->m_disconnect.end ())
+    {
+      test->m_trace.DisconnectWithoutContext (test->MakeSink (i->second));
+    }
+  i = test->m_connect.find (sink);
+  if (i != test->m_connect.end ())
+    {
+      test->m_trace.ConnectWithoutContext (test->MakeSink (i->second));
+    }
+}
+
+Callback<void, uint32_t>
+ChangeWhileCallingTracedCallbackTestCase::MakeSink (uint32_t sink)
+{
+  return MakeBoundCallback (&ChangeWhileCallingTracedCallbackTestCase::Sink, this, sink);
+}
+
+bool
+ChangeWhileCallingTracedCallbackTestCase::Check (uint32_t n, const uint32_t expected[])
+{
+  m_calls.clear ();
+  m_trace (0);
+  return m_calls == std::vector<uint32_t> (expected, expected + n);
+}
+
+void
+ChangeWhileCallingTracedCallbackTestCase::DoRun (void)
+{
+  // three sinks, the second one disconnects the first one
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      m_trace.ConnectWithoutContext (MakeSink (i));
+    }
+  m_disconnect[1] = 0;
+  uint32_t all[] = { 0, 1, 2 };
+  NS_TEST_ASSERT_MSG_EQ (Check (3, all), true, "Sink 2 not called after sink 1 disconnected sink 0");
+  uint32_t noZero[] = { 1, 2 };
+  NS_TEST_ASSERT_MSG_EQ (Check (2, noZero), true, "Sink 0 not disconnected");
+
+  // more sinks than stored inline: sink 3 disconnects itself and sink 5,
+  // which is not called anymore, and connects sink 6, which is.
+  for (uint32_t i = 3; i < 6; i++)
+    {
+      m_trace.ConnectWithoutContext (MakeSink (i));
+    }
+  m_disconnect.clear ();
+  m_disconnect[3] = 3;
+  m_connect[3] = 6;
+  m_disconnect[4] = 5;
+  uint32_t changed[] = { 1, 2, 3, 4, 6 };
+  NS_TEST_ASSERT_MSG_EQ (Check (5, changed), true, "Wrong calls while the sinks change");
+  m_disconnect.clear ();
+  m_connect.clear ();
+  uint32_t after[] = { 1, 2, 4, 6 };
+  NS_TEST_ASSERT_MSG_EQ (Check (4, after), true, "Wrong calls after the sinks changed");
+
+  // a sink disconnects an earlier sink and connects a new one
+  m_disconnect[2] = 1;
+  m_connect[2] = 7;
+  uint32_t seven[] = { 1, 2, 4, 6, 7 };
+  NS_TEST_ASSERT_MSG_EQ (Check (5, seven), true, "Wrong calls while disconnecting sink 1");
+  m_disconnect.clear ();
+  m_connect.clear ();
+  uint32_t last[] = { 2, 4, 6, 7 };
+  NS_TEST_ASSERT_MSG_EQ (Check (4, last), true, "Wrong calls after disconnecting sink 1");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -118,6 +301,8 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ManySinksTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ChangeWhileCallingTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
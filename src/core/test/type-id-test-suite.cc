@@ -188,6 +188,97 @@ CollisionTestCase::DoRun (void)
 }
   
   
+//----------------------------
+//
+// Test the lookup of the attributes and trace sources by name
+
+class AttributeLookupTestCase : public TestCase
+{
+public:
+  AttributeLookupTestCase ();
+  virtual ~AttributeLookupTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+AttributeLookupTestCase::AttributeLookupTestCase ()
+  : TestCase ("Check the lookup of attributes and trace sources by name")
+{
+}
+
+AttributeLookupTestCase::~AttributeLookupTestCase ()
+{
+}
+
+void
+AttributeLookupTestCase::DoRun (void)
+{
+  for (uint32_t i = 0; i < TypeId::GetRegisteredN (); i++)
+    {
+      TypeId tid = TypeId::GetRegistered (i);
+      // walk the parents as the lookups used to do
+      uint32_t n = 0;
+      TypeId current = tid;
+      while (true)
+        {
+          for (uint32_t j = 0; j < current.GetAttributeN (); j++, n++)
+            {
+              struct TypeId::AttributeInformation expected = current.GetAttribute (j);
+              struct TypeId::AttributeInformation info;
+              NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName (expected.name, &info), true,
+                                     "Attribute " << expected.name << " not found in " << tid);
+              NS_TEST_ASSERT_MSG_EQ (info.accessor, expected.accessor,
+                                     "Wrong attribute " << expected.name << " in " << tid);
+              TypeId owner;
+              const struct TypeId::AttributeInformation &all = tid.GetAllAttribute (n, &owner);
+              NS_TEST_ASSERT_MSG_EQ (owner, current, "Wrong owner of attribute " << n << " in " << tid);
+              NS_TEST_ASSERT_MSG_EQ (all.name, expected.name, "Wrong attribute " << n << " in " << tid);
+            }
+          for (uint32_t j = 0; j < current.GetTraceSourceN (); j++)
+            {
+              struct TypeId::TraceSourceInformation expected = current.GetTraceSource (j);
+              NS_TEST_ASSERT_MSG_EQ (tid.LookupTraceSourceByName (expected.name), expected.accessor,
+                                     "Wrong trace source " << expected.name << " in " << tid);
+            }
+          // the types registered by CollisionTestCase have no parent
+          if (current.GetParent () == current || current.GetParent ().GetUid () == 0)
+            {
+              break;
+            }
+          current = current.GetParent ();
+        }
+      NS_TEST_ASSERT_MSG_EQ (tid.GetAllAttributeN (), n, "Wrong number of attributes in " << tid);
+      struct TypeId::AttributeInformation info;
+      NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("NoSuchAttribute", &info), false,
+                             "Found a missing attribute in " << tid);
+      NS_TEST_ASSERT_MSG_EQ ((tid.LookupTraceSourceByName ("NoSuchTraceSource") == 0), true,
+                             "Found a missing trace source in " << tid);
+    }
+
+  // a new initial value is seen through the flattened tables of the
+  // derived TypeIds.
+  for (uint32_t i = 0; i < TypeId::GetRegisteredN (); i++)
+    {
+      TypeId tid = TypeId::GetRegistered (i);
+      if (tid.GetAttributeN () == 0)
+        {
+          continue;
+        }
+      TypeId owner;
+      const struct TypeId::AttributeInformation &all = tid.GetAllAttribute (0, &owner);
+      Ptr<const AttributeValue> initialValue = all.initialValue;
+      Ptr<const AttributeValue> value = all.originalInitialValue->Copy ();
+      tid.SetAttributeInitialValue (0, value);
+      NS_TEST_ASSERT_MSG_EQ (tid.GetAllAttribute (0, &owner).initialValue, value,
+                             "Initial value not updated in " << tid);
+      struct TypeId::AttributeInformation info;
+      tid.LookupAttributeByName (all.name, &info);
+      NS_TEST_ASSERT_MSG_EQ (info.initialValue, value, "Initial value not updated in " << tid);
+      tid.SetAttributeInitialValue (0, initialValue);
+      break;
+    }
+}
+
 //----------------------------
 //
 // Performance test
@@ -298,6 +389,7 @@ TypeIdTestSuite::TypeIdTestSuite ()
   // as chained.
   AddTestCase (new UniqueTypeIdTestCase, QUICK);
   AddTestCase (new CollisionTestCase, QUICK);
+  AddTestCase (new AttributeLookupTestCase, QUICK);
 }
 
 static TypeIdTestSuite g_TypeIdTestSuite;  
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/warm-start.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace ns3;
+
+// ===========================================================================
+// The replicas continue the simulation from the state at the fork
+// ===========================================================================
+class WarmStartForkTestCase : public TestCase
+{
+public:
+  WarmStartForkTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Tick (void);
+  void StartMeasurement (void);
+
+  static const uint32_t REPLICAS = 4;
+
+  uint32_t m_ticks;
+  uint32_t m_step;
+  uint32_t m_ticksAtFork;
+  Ptr<UniformRandomVariable> m_random;
+  std::vector<std::string> m_filenames;
+};
+
+WarmStartForkTestCase::WarmStartForkTestCase ()
+  : TestCase ("Check that the replicas continue the warmed-up simulation")
+{
+}
+
+void
+WarmStartForkTestCase::Tick (void)
+{
+  m_ticks += m_step;
+  Simulator::Schedule (Seconds (1), &WarmStartForkTestCase::Tick, this);
+}
+
+void
+WarmStartForkTestCase::StartMeasurement (void)
+{
+  m_ticksAtFork = m_ticks;
+  if (!WarmStart::Fork (REPLICAS, 2))
+    {
+      Simulator::Stop ();
+      return;
+    }
+  // each replica measures with its own parameter
+  m_step = WarmStart::GetReplica () + 1;
+  Simulator::Stop (Seconds (10));
+}
+
+void
+WarmStartForkTestCase::DoRun (void)
+{
+  m_ticks = 0;
+  m_step = 1;
+  m_ticksAtFork = 0;
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (7);
+  for (uint32_t i = 0; i < REPLICAS; i++)
+    {
+      std::ostringstream filename;
+      filename << "replica-" << i;
+      m_filenames.push_back (CreateTempDirFilename (filename.str ()));
+    }
+  Simulator::Schedule (Seconds (0.5), &WarmStartForkTestCase::Tick, this);
+  Simulator::Schedule (Seconds (100), &WarmStartForkTestCase::StartMeasurement, this);
+  Simulator::Run ();
+
+  uint32_t replica = WarmStart::GetReplica ();
+  if (replica != WarmStart::WARMUP)
+    {
+      // A replica reports its results and leaves the test runner to the
+      // warm-up process.
+      std::ofstream results (m_filenames[replica].c_str ());
+      results << Simulator::Now ().GetSeconds () << " " << m_ticksAtFork << " "
+              << m_ticks << " " << m_random->GetInteger (0, 1000000) << std::endl;
+      results.close ();
+      _exit (replica == REPLICAS - 1 ? 3 : 0);
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), Seconds (100), "The warm-up process did not stop at the fork");
+  NS_TEST_EXPECT_MSG_EQ (m_ticksAtFork, 100, "Wrong number of ticks during the warm-up");
+  NS_TEST_EXPECT_MSG_EQ (WarmStart::GetFailedReplicas (), 1, "The failed replica was not counted");
+  uint32_t expectedRandom = m_random->GetInteger (0, 1000000);
+  for (uint32_t i = 0; i < REPLICAS; i++)
+    {
+      std::ifstream results (m_filenames[i].c_str ());
+      NS_TEST_ASSERT_MSG_EQ (results.good (), true, "No results for replica " << i);
+      double now;
+      uint32_t ticksAtFork;
+      uint32_t ticks;
+      uint32_t random;
+      results >> now >> ticksAtFork >> ticks >> random;
+      NS_TEST_EXPECT_MSG_EQ (now, 110, "Replica " << i << " stopped at the wrong time");
+      NS_TEST_EXPECT_MSG_EQ (ticksAtFork, 100, "Replica " << i << " did not start from the warm-up");
+      NS_TEST_EXPECT_MSG_EQ (ticks, 100 + 10 * (i + 1), "Replica " << i << " did not measure with its parameter");
+      NS_TEST_EXPECT_MSG_EQ (random, expectedRandom, "Replica " << i << " did not inherit the random stream");
+    }
+}
+
+void
+WarmStartForkTestCase::DoTeardown (void)
+{
+  m_random = 0;
+  Simulator::Destroy ();
+}
+
+class WarmStartTestSuite : public TestSuite
+{
+public:
+  WarmStartTestSuite ();
+};
+
+WarmStartTestSuite::WarmStartTestSuite ()
+  : TestSuite ("warm-start", UNIT)
+{
+  AddTestCase (new WarmStartForkTestCase, TestCase::QUICK);
+}
+
+static WarmStartTestSuite warmStartTestSuite;
@@ -329,6 +329,8 @@ WifiRadioEnergyModel::SetWifiRadioState (const WifiPhy::State state)
 // -------------------------------------------------------------------------- //
 
 WifiRadioEnergyModelPhyListener::WifiRadioEnergyModelPhyListener ()
+  : m_switchToIdleTime (Seconds (0)),
+    m_lastState (WifiPhy::IDLE)
 {
   NS_LOG_FUNCTION (this);
   m_changeStateCallback.Nullify ();
@@ -355,7 +357,7 @@ WifiRadioEnergyModelPhyListener::NotifyRxStart (Time duration)
     {
       NS_FATAL_ERROR ("WifiRadioEnergyModelPhyListener:Change state callback not set!");
     }
-  m_changeStateCallback (WifiPhy::RX);
+  ChangeState (WifiPhy::RX);
   m_switchToIdleEvent.Cancel ();
 }
 
@@ -367,7 +369,7 @@ WifiRadioEnergyModelPhyListener::NotifyRxEndOk (void)
     {
       NS_FATAL_ERROR ("WifiRadioEnergyModelPhyListener:Change state callback not set!");
     }
-  m_changeStateCallback (WifiPhy::IDLE);
+  ChangeState (WifiPhy::IDLE);
 }
 
 void
@@ -378,7 +380,7 @@ WifiRadioEnergyModelPhyListener::NotifyRxEndError (void)
     {
       NS_FATAL_ERROR ("WifiRadioEnergyModelPhyListener:Change state callback not set!");
     }
-  m_changeStateCallback (WifiPhy::IDLE);
+  ChangeState (WifiPhy::IDLE);
 }
 
 void
@@ -389,10 +391,9 @@ WifiRadioEnergyModelPhyListener::NotifyTxStart (Time duration)
     {
       NS_FATAL_ERROR ("WifiRadioEnergyModelPhyListener:Change state callback not set!");
     }
-  m_changeStateCallback (WifiPhy::TX);
+  ChangeState (WifiPhy::TX);
   // schedule changing state back to IDLE after TX duration
-  m_switchToIdleEvent.Cancel ();
-  m_switchToIdleEvent = Simulator::Schedule (duration, &WifiRadioEnergyModelPhyListener::SwitchToIdle, this);
+  ScheduleSwitchToIdle (duration);
 }
 
 void
@@ -403,10 +404,9 @@ WifiRadioEnergyModelPhyListener::NotifyMaybeCcaBusyStart (Time duration)
     {
       NS_FATAL_ERROR ("WifiRadioEnergyModelPhyListener:Change state callback not set!");
     }
-  m_changeStateCallback (WifiPhy::CCA_BUSY);
+  ChangeState (WifiPhy::CCA_BUSY);
   // schedule changing state back to IDLE after CCA_BUSY duration
-  m_switchToIdleEvent.Cancel ();
-  m_switchToIdleEvent = Simulator::Schedule (duration, &WifiRadioEnergyModelPhyListener::SwitchToIdle, this);
+  ScheduleSwitchToIdle (duration);
 }
 
 void
@@ -417,10 +417,9 @@ WifiRadioEnergyModelPhyListener::NotifySwitchingStart (Time duration)
     {
       NS_FATAL_ERROR ("WifiRadioEnergyModelPhyListener:Change state callback not set!");
     }
-  m_changeStateCallback (WifiPhy::SWITCHING);
+  ChangeState (WifiPhy::SWITCHING);
   // schedule changing state back to IDLE after CCA_BUSY duration
-  m_switchToIdleEvent.Cancel ();
-  m_switchToIdleEvent = Simulator::Schedule (duration, &WifiRadioEnergyModelPhyListener::SwitchToIdle, this);
+  ScheduleSwitchToIdle (duration);
 }
 
 /*
@@ -435,7 +434,40 @@ WifiRadioEnergyModelPhyListener::SwitchToIdle (void)
     {
       NS_FATAL_ERROR ("WifiRadioEnergyModelPhyListener:Change state callback not set!");
     }
-  m_changeStateCallback (WifiPhy::IDLE);
+  Time now = Simulator::Now ();
+  if (now < m_switchToIdleTime)
+    {
+      // the busy period was extended after this event was scheduled
+      m_switchToIdleEvent = Simulator::Schedule (m_switchToIdleTime - now,
+                                                 &WifiRadioEnergyModelPhyListener::SwitchToIdle, this);
+      return;
+    }
+  ChangeState (WifiPhy::IDLE);
+}
+
+void
+WifiRadioEnergyModelPhyListener::ChangeState (WifiPhy::State state)
+{
+  if (state == m_lastState)
+    {
+      return;
+    }
+  m_lastState = state;
+  m_changeStateCallback (state);
+}
+
+void
+WifiRadioEnergyModelPhyListener::ScheduleSwitchToIdle (Time duration)
+{
+  m_switchToIdleTime = Simulator::Now () + duration;
+  if (m_switchToIdleEvent.IsRunning ()
+      && m_switchToIdleEvent.GetTs () <= static_cast<uint64_t> (m_switchToIdleTime.GetTimeStep ()))
+    {
+      // SwitchToIdle will re-arm itself when it expires
+      return;
+    }
+  m_switchToIdleEvent.Cancel ();
+  m_switchToIdleEvent = Simulator::Schedule (duration, &WifiRadioEnergyModelPhyListener::SwitchToIdle, this);
 }
 
 } // namespace ns3
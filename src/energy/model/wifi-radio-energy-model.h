@@ -106,6 +106,23 @@ private:
    * A helper function that makes scheduling m_changeStateCallback possible.
    */
   void SwitchToIdle (void);
+  /**
+   * Report <i>state</i> to the energy model, unless it is already the
+   * state last reported: splitting an interval spent in one state does
+   * not change the energy consumed, only the cost of the update.
+   *
+   * \param state the new radio state
+   */
+  void ChangeState (WifiPhy::State state);
+  /**
+   * Arrange for the radio to be reported IDLE after <i>duration</i>.
+   * A pending switch that would fire earlier is kept and re-armed when
+   * it expires, so that back-to-back CCA busy notifications do not
+   * cancel and reschedule an event each time.
+   *
+   * \param duration time until the radio becomes idle
+   */
+  void ScheduleSwitchToIdle (Time duration);
 
 private:
   /**
@@ -115,6 +132,8 @@ private:
   DeviceEnergyModel::ChangeStateCallback m_changeStateCallback;
 
   EventId m_switchToIdleEvent;
+  Time m_switchToIdleTime;
+  WifiPhy::State m_lastState;
 };
 
 // -------------------------------------------------------------------------- //
@@ -158,12 +158,18 @@
 #include "ns3/config.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
+#include "ns3/pointer.h"
 #include "ns3/net-device.h"
 #include "ns3/callback.h"
 #include "ns3/node.h"
 #include "ns3/node-list.h"
 #include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/multithreaded-simulator-impl.h"
+#endif
 #include "ns3/arp-l3-protocol.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-socket-factory-impl.h"
 #include "internet-stack-helper.h"
 #include "ns3/ipv4-global-routing.h"
 #include "ns3/ipv4-list-routing-helper.h"
@@ -236,8 +242,8 @@ InternetStackHelper::InternetStackHelper ()
     m_ipv4Enabled (true),
     m_ipv6Enabled (true),
     m_ipv4ArpJitterEnabled (true),
-    m_ipv6NsRsJitterEnabled (true)
-
+    m_ipv6NsRsJitterEnabled (true),
+    m_leanNode (false)
 {
   Initialize ();
 }
@@ -274,6 +280,7 @@ InternetStackHelper::InternetStackHelper (const InternetStackHelper &o)
   m_tcpFactory = o.m_tcpFactory;
   m_ipv4ArpJitterEnabled = o.m_ipv4ArpJitterEnabled;
   m_ipv6NsRsJitterEnabled = o.m_ipv6NsRsJitterEnabled;
+  m_leanNode = o.m_leanNode;
 }
 
 InternetStackHelper &
@@ -299,6 +306,9 @@ InternetStackHelper::Reset (void)
   m_ipv6Enabled = true;
   m_ipv4ArpJitterEnabled = true;
   m_ipv6NsRsJitterEnabled = true;
+  m_leanNode = false;
+  m_arpJitter = 0;
+  m_nsRsJitter = 0;
   Initialize ();
 }
 
@@ -337,6 +347,11 @@ void InternetStackHelper::SetIpv6NsRsJitter (bool enable)
   m_ipv6NsRsJitterEnabled = enable;
 }
 
+void InternetStackHelper::SetLeanNode (bool enable)
+{
+  m_leanNode = enable;
+}
+
 int64_t
 InternetStackHelper::AssignStreams (NodeContainer c, int64_t stream)
 {
@@ -419,6 +434,44 @@ InternetStackHelper::CreateAndAggregateObjectFromTypeId (Ptr<Node> node, const s
   node->AggregateObject (protocol);
 }
 
+/**
+ * Share a random variable attribute between objects: the first object
+ * keeps its own random variable, which the next ones use.
+ *
+ * \param object the object
+ * \param name the name of the random variable attribute
+ * \param shared the shared random variable, 0 before the first object
+ */
+static void
+ShareRandomVariable (Ptr<Object> object, std::string name, Ptr<RandomVariableStream> &shared)
+{
+  if (shared == 0)
+    {
+      PointerValue value;
+      object->GetAttribute (name, value);
+      shared = value.Get<RandomVariableStream> ();
+    }
+  else
+    {
+      object->SetAttribute (name, PointerValue (shared));
+    }
+}
+
+/**
+ * \returns true if the simulation runs on ns3::MultithreadedSimulatorImpl,
+ *          whose partitions draw from the random variables of their nodes
+ *          at the same time: a random variable cannot be shared there.
+ */
+static bool
+IsMultithreaded (void)
+{
+#ifdef HAVE_PTHREAD_H
+  return DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ()) != 0;
+#else
+  return false;
+#endif
+}
+
 void
 InternetStackHelper::Install (Ptr<Node> node) const
 {
@@ -440,6 +493,10 @@ InternetStackHelper::Install (Ptr<Node> node) const
           NS_ASSERT (arp);
           arp->SetAttribute ("RequestJitter", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
         }
+      if (m_leanNode && !IsMultithreaded ())
+        {
+          ShareRandomVariable (node->GetObject<ArpL3Protocol> (), "RequestJitter", m_arpJitter);
+        }
       // Set routing
       Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
       Ptr<Ipv4RoutingProtocol> ipv4Routing = m_routing->Create (node);
@@ -464,20 +521,39 @@ InternetStackHelper::Install (Ptr<Node> node) const
           NS_ASSERT (icmpv6l4);
           icmpv6l4->SetAttribute ("SolicitationJitter", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
         }
+      if (m_leanNode && !IsMultithreaded ())
+        {
+          ShareRandomVariable (node->GetObject<Icmpv6L4Protocol> (), "SolicitationJitter", m_nsRsJitter);
+        }
       // Set routing
       Ptr<Ipv6> ipv6 = node->GetObject<Ipv6> ();
       Ptr<Ipv6RoutingProtocol> ipv6Routing = m_routingv6->Create (node);
       ipv6->SetRoutingProtocol (ipv6Routing);
 
-      /* register IPv6 extensions and options */
-      ipv6->RegisterExtensions ();
-      ipv6->RegisterOptions ();
+      /* register IPv6 extensions and options, on first use for a lean node */
+      if (!m_leanNode)
+        {
+          ipv6->RegisterExtensions ();
+          ipv6->RegisterOptions ();
+        }
     }
 
   if (m_ipv4Enabled || m_ipv6Enabled)
     {
       CreateAndAggregateObjectFromTypeId (node, "ns3::UdpL4Protocol");
-      node->AggregateObject (m_tcpFactory.Create<Object> ());
+      TypeId tcpTid = m_tcpFactory.GetTypeId ();
+      if (m_leanNode
+          && (tcpTid == TcpL4Protocol::GetTypeId () || tcpTid.IsChildOf (TcpL4Protocol::GetTypeId ())))
+        {
+          // the first socket creates the protocol
+          Ptr<TcpSocketFactoryImpl> tcpFactory = CreateObject<TcpSocketFactoryImpl> ();
+          tcpFactory->SetTcpFactory (m_tcpFactory);
+          node->AggregateObject (tcpFactory);
+        }
+      else
+        {
+          node->AggregateObject (m_tcpFactory.Create<Object> ());
+        }
       Ptr<PacketSocketFactory> factory = CreateObject<PacketSocketFactory> ();
       node->AggregateObject (factory);
     }
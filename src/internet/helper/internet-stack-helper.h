@@ -26,6 +26,7 @@
 #include "ns3/packet.h"
 #include "ns3/ptr.h"
 #include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "internet-trace-helper.h"
@@ -190,6 +191,30 @@ public:
    */
   void SetIpv6NsRsJitter (bool enable);
 
+  /**
+   * \brief Enable/disable the lean node profile.
+   *
+   * The lean node profile reduces the memory of the nodes which do not
+   * use all the protocols, for the very large topologies:
+   *  - the TCP protocol of a node is created by its first TCP socket,
+   *    when the TCP factory creates a ns3::TcpL4Protocol. The TCP
+   *    segments received before are dropped;
+   *  - the IPv6 extensions and options of a node are registered by the
+   *    first packet which carries an extension header;
+   *  - the nodes installed by this helper share the random variables of
+   *    the ARP request jitter and of the NS and RS jitter.
+   *
+   * The objects created on first use are not in the Config namespace
+   * before, and their random variable streams are not assigned by
+   * AssignStreams. Under ns3::MultithreadedSimulatorImpl, the nodes keep
+   * their own jitter random variables, as nodes of different partitions
+   * would otherwise draw from the same one from different threads: the
+   * simulator implementation must be chosen before Install is called.
+   *
+   * \param enable enable state
+   */
+  void SetLeanNode (bool enable);
+
   /**
   * Assign a fixed random variable stream number to the random variables
   * used by this model.  Return the number of streams (possibly zero) that
@@ -325,6 +350,21 @@ private:
    * \brief IPv6 IPv6 NS and RS Jitter state (enabled/disabled) ?
    */
   bool m_ipv6NsRsJitterEnabled;
+
+  /**
+   * \brief lean node profile state (enabled/disabled) ?
+   */
+  bool m_leanNode;
+
+  /**
+   * \brief ARP request jitter shared by the lean nodes.
+   */
+  mutable Ptr<RandomVariableStream> m_arpJitter;
+
+  /**
+   * \brief NS and RS jitter shared by the lean nodes.
+   */
+  mutable Ptr<RandomVariableStream> m_nsRsJitter;
 };
 
 } // namespace ns3
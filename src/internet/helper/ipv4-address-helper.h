@@ -175,7 +175,32 @@ public:
  */
   Ipv4InterfaceContainer Assign (const NetDeviceContainer &c);
 
+/**
+ * @brief Assign IP addresses to the net devices specified in the container,
+ * with a new network for each group of consecutive net devices.
+ *
+ * The net devices of the container are taken by groups of devicesPerNetwork
+ * net devices.  Each group is assigned addresses as Assign would, then
+ * NewNetwork is called, so that the next group gets the next network.  With
+ * a devicesPerNetwork of 2, this assigns one network to each link of the
+ * container returned by PointToPointHelper::InstallLinks in a single call.
+ *
+ * @param c The NetDeviceContainer holding the collection of net devices we
+ * are asked to assign Ipv4 addresses to.
+ * @param devicesPerNetwork The number of net devices in each network.
+ *
+ * @returns The interfaces of the net devices, in the order of the container.
+ * @see Assign
+ * @see NewNetwork
+ */
+  Ipv4InterfaceContainer AssignNetworks (const NetDeviceContainer &c, uint32_t devicesPerNetwork);
+
 private:
+  /**
+   * @internal
+   */
+  void AssignDevice (Ptr<NetDevice> device, Ipv4InterfaceContainer &interfaces);
+
   /**
    * @internal
    */
@@ -20,6 +20,7 @@
 
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/replication.h"
 #include "ns3/simulation-singleton.h"
 #include "global-route-manager.h"
 #include "global-route-manager-impl.h"
@@ -63,6 +64,16 @@ GlobalRouteManager::AllocateRouterId (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   static uint32_t routerId = 0;
+  if (Replication::IsActive ())
+    {
+      // the routers of the replication run by the calling thread
+      static __thread uint64_t replicationRouterId = 0;
+      if (replicationRouterId == 0)
+        {
+          Replication::ResetAtExit (&replicationRouterId);
+        }
+      return replicationRouterId++;
+    }
   return routerId++;
 }
 
@@ -16,7 +16,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
-#include <list>
+#include <map>
 #include "ns3/abort.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
@@ -65,14 +65,9 @@ public:
 
   NetworkState m_netTable[N_BITS];
 
-  class Entry
-  {
-public:
-    uint32_t addrLow;
-    uint32_t addrHigh;
-  };
-
-  std::list<Entry> m_entries;
+  // the allocated blocks of addresses, from the lowest to the highest
+  // address of each block
+  std::map<uint32_t, uint32_t> m_entries;
   bool m_test;
 };
 
@@ -254,18 +249,24 @@ Ipv4AddressGeneratorImpl::AddAllocated (const Ipv4Address address)
   uint32_t addr = address.Get ();
 
   NS_ABORT_MSG_UNLESS (addr, "Ipv4AddressGeneratorImpl::Add(): Allocating the broadcast address is not a good idea"); 
- 
-  std::list<Entry>::iterator i;
 
-  for (i = m_entries.begin (); i != m_entries.end (); ++i)
+//
+// The blocks are sorted by their lowest address, so the only blocks which
+// can contain or be extended to include the new address are the first block
+// starting above it and the block just before that one.
+//
+  std::map<uint32_t, uint32_t>::iterator next = m_entries.upper_bound (addr);
+  if (next != m_entries.begin ())
     {
-      NS_LOG_LOGIC ("examine entry: " << Ipv4Address ((*i).addrLow) << 
-                    " to " << Ipv4Address ((*i).addrHigh));
+      std::map<uint32_t, uint32_t>::iterator i = next;
+      --i;
+      NS_LOG_LOGIC ("examine entry: " << Ipv4Address (i->first) << 
+                    " to " << Ipv4Address (i->second));
 //
 // First things first.  Is there an address collision -- that is, does the
 // new address fall in a previously allocated block of addresses.
 //
-      if (addr >= (*i).addrLow && addr <= (*i).addrHigh)
+      if (addr <= i->second)
         {
           NS_LOG_LOGIC ("Ipv4AddressGeneratorImpl::Add(): Address Collision: " << Ipv4Address (addr)); 
           if (!m_test) 
@@ -275,62 +276,36 @@ Ipv4AddressGeneratorImpl::AddAllocated (const Ipv4Address address)
           return false;
         }
 //
-// If the new address is less than the lowest address in the current block,
-// and can't be merged into to the current block, then insert it as a new
-// block before the current block.
-//
-      if (addr < (*i).addrLow - 1)
-        {
-          break;
-        }
+// If the new address fits at the end of the block, extend the block by one
+// address, and merge it with the next block if the gap between them is now
+// closed.
 //
-// If the new address fits at the end of the block, look ahead to the next 
-// block and make sure it's not a collision there.  If we won't overlap, then
-// just extend the current block by one address.  We expect that completely
-// filled network ranges will be a fairly rare occurrence, so we don't worry
-// about collapsing address range blocks.
-// 
-      if (addr == (*i).addrHigh + 1)
+      if (addr == i->second + 1)
         {
-          std::list<Entry>::iterator j = i;
-          ++j;
-
-          if (j != m_entries.end ())
+          NS_LOG_LOGIC ("New addrHigh = " << Ipv4Address (addr));
+          i->second = addr;
+          if (next != m_entries.end () && next->first == addr + 1)
             {
-              if (addr == (*j).addrLow)
-                {
-                  NS_LOG_LOGIC ("Ipv4AddressGeneratorImpl::Add(): "
-                                "Address Collision: " << Ipv4Address (addr));
-                  if (!m_test)
-                    {
-                      NS_FATAL_ERROR ("Ipv4AddressGeneratorImpl::Add(): Address Collision: " << Ipv4Address (addr));
-                    }
-                  return false;
-                }
+              i->second = next->second;
+              m_entries.erase (next);
             }
-
-          NS_LOG_LOGIC ("New addrHigh = " << Ipv4Address (addr));
-          (*i).addrHigh = addr;
           return true;
         }
+    }
 //
-// If we get here, we know that the next lower block of addresses couldn't 
-// have been extended to include this new address since the code immediately 
-// above would have been executed and that next lower block extended upward.
-// So we know it's safe to extend the current block down to includ the new
-// address.
+// If the new address fits at the beginning of the next block, extend that
+// block down to include the new address.
 //
-      if (addr == (*i).addrLow - 1)
-        {
-          NS_LOG_LOGIC ("New addrLow = " << Ipv4Address (addr));
-          (*i).addrLow = addr;
-          return true;
-        }
+  if (next != m_entries.end () && next->first == addr + 1)
+    {
+      NS_LOG_LOGIC ("New addrLow = " << Ipv4Address (addr));
+      uint32_t addrHigh = next->second;
+      m_entries.erase (next++);
+      m_entries.insert (next, std::make_pair (addr, addrHigh));
+      return true;
     }
 
-  Entry entry;
-  entry.addrLow = entry.addrHigh = addr;
-  m_entries.insert (i, entry);
+  m_entries.insert (next, std::make_pair (addr, addr));
   return true;
 }
 
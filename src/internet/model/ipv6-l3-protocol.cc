@@ -828,14 +828,13 @@ void Ipv6L3Protocol::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16
       socket->ForwardUp (packet, hdr, device);
     }
 
-  Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux> ();
   Ptr<Ipv6Extension> ipv6Extension = 0;
   uint8_t nextHeader = hdr.GetNextHeader ();
   bool isDropped = false;
 
   if (nextHeader == Ipv6Header::IPV6_EXT_HOP_BY_HOP)
     {
-      ipv6Extension = ipv6ExtensionDemux->GetExtension (nextHeader);
+      ipv6Extension = GetExtension (nextHeader);
 
       if (ipv6Extension)
         {
@@ -913,12 +912,10 @@ void Ipv6L3Protocol::SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6
           return;
         }
 
-      Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux> ();
-
       packet->AddHeader (ipHeader);
 
       // To get specific method GetFragments from Ipv6ExtensionFragmentation
-      Ipv6ExtensionFragment *ipv6Fragment = dynamic_cast<Ipv6ExtensionFragment *> (PeekPointer (ipv6ExtensionDemux->GetExtension (Ipv6Header::IPV6_EXT_FRAGMENTATION)));
+      Ipv6ExtensionFragment *ipv6Fragment = dynamic_cast<Ipv6ExtensionFragment *> (PeekPointer (GetExtension (Ipv6Header::IPV6_EXT_FRAGMENTATION)));
       NS_ASSERT (ipv6Fragment != 0);
       ipv6Fragment->GetFragments (packet, targetMtu, fragments);
     }
@@ -1103,7 +1100,6 @@ void Ipv6L3Protocol::LocalDeliver (Ptr<const Packet> packet, Ipv6Header const& i
   NS_LOG_FUNCTION (this << packet << ip << iif);
   Ptr<Packet> p = packet->Copy ();
   Ptr<IpL4Protocol> protocol = 0;
-  Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux> ();
   Ptr<Ipv6Extension> ipv6Extension = 0;
   Ipv6Address src = ip.GetSourceAddress ();
   Ipv6Address dst = ip.GetDestinationAddress ();
@@ -1128,7 +1124,7 @@ void Ipv6L3Protocol::LocalDeliver (Ptr<const Packet> packet, Ipv6Header const& i
   do
     {
       /* it return 0 for non-extension (i.e. layer 4 protocol) */
-      ipv6Extension = ipv6ExtensionDemux->GetExtension (nextHeader);
+      ipv6Extension = GetExtension (nextHeader);
 
       if (ipv6Extension)
         {
@@ -1199,6 +1195,32 @@ void Ipv6L3Protocol::LocalDeliver (Ptr<const Packet> packet, Ipv6Header const& i
   while (ipv6Extension);
 }
 
+Ptr<Ipv6Extension> Ipv6L3Protocol::GetExtension (uint8_t nextHeader)
+{
+  Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux> ();
+  if (ipv6ExtensionDemux == 0)
+    {
+      switch (nextHeader)
+        {
+        case Ipv6Header::IPV6_EXT_HOP_BY_HOP:
+        case Ipv6Header::IPV6_EXT_ROUTING:
+        case Ipv6Header::IPV6_EXT_FRAGMENTATION:
+        case Ipv6Header::IPV6_EXT_DESTINATION:
+          NS_LOG_LOGIC ("Register the extensions and the options on first use");
+          RegisterExtensions ();
+          if (m_node->GetObject<Ipv6OptionDemux> () == 0)
+            {
+              RegisterOptions ();
+            }
+          ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux> ();
+          break;
+        default:
+          return 0;
+        }
+    }
+  return ipv6ExtensionDemux->GetExtension (nextHeader);
+}
+
 void Ipv6L3Protocol::RouteInputError (Ptr<const Packet> p, const Ipv6Header& ipHeader, Socket::SocketErrno sockErrno)
 {
   NS_LOG_FUNCTION (this << p << ipHeader << sockErrno);
@@ -41,6 +41,7 @@ class Ipv6MulticastRoute;
 class Ipv6RawSocketImpl;
 class Icmpv6L4Protocol;
 class Ipv6AutoconfiguredPrefix;
+class Ipv6Extension;
 
 /**
  * \class Ipv6L3Protocol
@@ -408,6 +409,17 @@ private:
    */
   Ipv6L3Protocol (const Ipv6L3Protocol& o);
 
+  /**
+   * \brief Get the extension of a next header value.
+   *
+   * The extensions and the options of a stack installed without them
+   * (see InternetStackHelper::SetLeanNode) are registered by the first
+   * packet which carries an extension header.
+   * \param nextHeader the next header value
+   * \return the extension, or 0 if the next header is not an extension
+   */
+  Ptr<Ipv6Extension> GetExtension (uint8_t nextHeader);
+
   /**
    * \brief Copy constructor.
    * \param o object to copy
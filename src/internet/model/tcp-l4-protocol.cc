@@ -121,9 +121,18 @@ TcpL4Protocol::NotifyNewAggregate ()
       if ((node != 0) && (ipv4 != 0 || ipv6 != 0))
         {
           this->SetNode (node);
-          Ptr<TcpSocketFactoryImpl> tcpFactory = CreateObject<TcpSocketFactoryImpl> ();
-          tcpFactory->SetTcp (this);
-          node->AggregateObject (tcpFactory);
+          // the factory of a lean node exists before its protocol
+          Ptr<TcpSocketFactoryImpl> tcpFactory = node->GetObject<TcpSocketFactoryImpl> ();
+          if (tcpFactory == 0)
+            {
+              tcpFactory = CreateObject<TcpSocketFactoryImpl> ();
+              tcpFactory->SetTcp (this);
+              node->AggregateObject (tcpFactory);
+            }
+          else
+            {
+              tcpFactory->SetTcp (this);
+            }
         }
     }
 
@@ -39,6 +39,7 @@
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/trace-source-accessor.h"
 #include "tcp-socket-base.h"
 #include "tcp-l4-protocol.h"
@@ -83,6 +84,14 @@ TcpSocketBase::GetTypeId (void)
                    CallbackValue (),
                    MakeCallbackAccessor (&TcpSocketBase::m_icmpCallback6),
                    MakeCallbackChecker ())                   
+    .AddAttribute ("TimerWheel",
+                   "Hold the retransmission and delayed ACK timers, which are rescheduled much more often "
+                   "than they expire, in a timer wheel rather than in the simulator event list. "
+                   "The events of the timer wheel change the event and packet uids of a simulation.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::SetTimerWheel,
+                                        &TcpSocketBase::GetTimerWheel),
+                   MakeBooleanChecker ())
     .AddTraceSource ("RTO",
                      "Retransmission timeout",
                      MakeTraceSourceAccessor (&TcpSocketBase::m_rto))
@@ -106,7 +115,11 @@ TcpSocketBase::GetTypeId (void)
 }
 
 TcpSocketBase::TcpSocketBase (void)
-  : m_dupAckCount (0),
+  : m_retxTimer (Timer::CANCEL_ON_DESTROY),
+    m_retxFlags (0),
+    m_delAckTimer (Timer::CANCEL_ON_DESTROY),
+    m_timerWheel (false),
+    m_dupAckCount (0),
     m_delAckCount (0),
     m_endPoint (0),
     m_endPoint6 (0),
@@ -130,11 +143,16 @@ TcpSocketBase::TcpSocketBase (void)
     m_rWnd (0)
 {
   NS_LOG_FUNCTION (this);
+  SetupTimers ();
 }
 
 TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
   : TcpSocket (sock),
     //copy object::m_tid and socket::callbacks
+    m_retxTimer (Timer::CANCEL_ON_DESTROY),
+    m_retxFlags (0),
+    m_delAckTimer (Timer::CANCEL_ON_DESTROY),
+    m_timerWheel (sock.m_timerWheel),
     m_dupAckCount (sock.m_dupAckCount),
     m_delAckCount (0),
     m_delAckMaxCount (sock.m_delAckMaxCount),
@@ -166,6 +184,7 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_LOGIC ("Invoked the copy constructor");
+  SetupTimers ();
   // Copy the rtt estimator if it is set
   if (sock.m_rtt)
     {
@@ -1176,7 +1195,7 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       NS_LOG_INFO ("SYN_SENT -> ESTABLISHED");
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      m_retxTimer.Cancel ();
       m_delAckCount = m_delAckMaxCount;
       ReceivedData (packet, tcpHeader);
       Simulator::ScheduleNow (&TcpSocketBase::ConnectionSucceeded, this);
@@ -1198,7 +1217,7 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       NS_LOG_INFO ("SYN_SENT -> ESTABLISHED");
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      m_retxTimer.Cancel ();
       m_rxBuffer.SetNextRxSequence (tcpHeader.GetSequenceNumber () + SequenceNumber32 (1));
       m_highTxMark = ++m_nextTxSequence;
       m_txBuffer.SetHeadSequence (m_nextTxSequence);
@@ -1239,7 +1258,7 @@ TcpSocketBase::ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
       NS_LOG_INFO ("SYN_RCVD -> ESTABLISHED");
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      m_retxTimer.Cancel ();
       m_highTxMark = ++m_nextTxSequence;
       m_txBuffer.SetHeadSequence (m_nextTxSequence);
       if (m_endPoint)
@@ -1273,7 +1292,7 @@ TcpSocketBase::ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
       if (tcpHeader.GetSequenceNumber () == m_rxBuffer.NextRxSequence ())
         { // In-sequence FIN before connection complete. Set up connection and close.
           m_connected = true;
-          m_retxEvent.Cancel ();
+          m_retxTimer.Cancel ();
           m_highTxMark = ++m_nextTxSequence;
           m_txBuffer.SetHeadSequence (m_nextTxSequence);
           if (m_endPoint)
@@ -1541,7 +1560,7 @@ TcpSocketBase::Destroy (void)
         }
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -1562,7 +1581,7 @@ TcpSocketBase::Destroy6 (void)
         }
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -1669,15 +1688,16 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
     }
   if (flags & TcpHeader::ACK)
     { // If sending an ACK, cancel the delay ACK as well
-      m_delAckEvent.Cancel ();
+      m_delAckTimer.Cancel ();
       m_delAckCount = 0;
     }
-  if (m_retxEvent.IsExpired () && (hasSyn || hasFin) && !isAck )
+  if (m_retxTimer.IsExpired () && (hasSyn || hasFin) && !isAck )
     { // Retransmit SYN / SYN+ACK / FIN / FIN+ACK to guard against lost
       NS_LOG_LOGIC ("Schedule retransmission timeout at time "
                     << Simulator::Now ().GetSeconds () << " to expire at time "
                     << (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
+      m_retxFlags = flags;
+      m_retxTimer.Schedule (m_rto);
     }
 }
 
@@ -1910,13 +1930,14 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
     }
   header.SetWindowSize (AdvertisedWindowSize ());
   AddOptions (header);
-  if (m_retxEvent.IsExpired () )
+  if (m_retxTimer.IsExpired () )
     { // Schedule retransmit
       m_rto = m_rtt->RetransmitTimeout ();
       NS_LOG_LOGIC (this << " SendDataPacket Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds () );
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      m_retxFlags = 0;
+      m_retxTimer.Schedule (m_rto);
       //      if (!m_connected)
       //        std::cout << m_rtt->RetransmitTimeout().GetSeconds() << std::endl;
     }
@@ -2055,15 +2076,14 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
     { // In-sequence packet: ACK if delayed ack count allows
       if (++m_delAckCount >= m_delAckMaxCount)
         {
-          m_delAckEvent.Cancel ();
+          m_delAckTimer.Cancel ();
           m_delAckCount = 0;
           SendEmptyPacket (TcpHeader::ACK);
         }
-      else if (m_delAckEvent.IsExpired ())
+      else if (m_delAckTimer.IsExpired ())
         {
-          m_delAckEvent = Simulator::Schedule (m_delAckTimeout,
-                                               &TcpSocketBase::DelAckTimeout, this);
-          NS_LOG_LOGIC (this << " scheduled delayed ACK at " << (Simulator::Now () + Simulator::GetDelayLeft (m_delAckEvent)).GetSeconds ());
+          m_delAckTimer.Schedule (m_delAckTimeout);
+          NS_LOG_LOGIC (this << " scheduled delayed ACK at " << (Simulator::Now () + m_delAckTimer.GetDelayLeft ()).GetSeconds ());
         }
     }
   // Notify app to receive if necessary
@@ -2117,21 +2137,22 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack)
   if (m_state != SYN_RCVD)
     { // Set RTO unless the ACK is received in SYN_RCVD state
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
+      m_retxTimer.Cancel ();
       // On recieving a "New" ack we restart retransmission timer .. RFC 2988
       m_rto = m_rtt->RetransmitTimeout ();
       NS_LOG_LOGIC (this << " Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      m_retxFlags = 0;
+      m_retxTimer.Schedule (m_rto);
     }
   if (m_rWnd.Get () == 0 && m_persistEvent.IsExpired ())
     { // Zero window: Enter persist state to send 1 byte to probe
       NS_LOG_LOGIC (this << "Enter zerowindow persist state");
       NS_LOG_LOGIC (this << "Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
+      m_retxTimer.Cancel ();
       NS_LOG_LOGIC ("Schedule persist timeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_persistTimeout).GetSeconds ());
@@ -2153,8 +2174,8 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack)
   if (m_txBuffer.Size () == 0 && m_state != FIN_WAIT_1 && m_state != CLOSING)
     { // No retransmit timer if no data to retransmit
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
+      m_retxTimer.Cancel ();
     }
   // Try to send more data
   SendPendingData (m_connected);
@@ -2190,6 +2211,19 @@ TcpSocketBase::ReTxTimeout ()
   Retransmit ();
 }
 
+void
+TcpSocketBase::RetxTimerExpire (void)
+{
+  if (m_retxFlags != 0)
+    {
+      SendEmptyPacket (m_retxFlags);
+    }
+  else
+    {
+      ReTxTimeout ();
+    }
+}
+
 void
 TcpSocketBase::DelAckTimeout (void)
 {
@@ -2308,12 +2342,20 @@ TcpSocketBase::DoRetransmit ()
 
 }
 
+void
+TcpSocketBase::SetupTimers (void)
+{
+  m_retxTimer.SetFunction (&TcpSocketBase::RetxTimerExpire, this);
+  m_delAckTimer.SetFunction (&TcpSocketBase::DelAckTimeout, this);
+  SetTimerWheel (m_timerWheel);
+}
+
 void
 TcpSocketBase::CancelAllTimers ()
 {
-  m_retxEvent.Cancel ();
+  m_retxTimer.Cancel ();
   m_persistEvent.Cancel ();
-  m_delAckEvent.Cancel ();
+  m_delAckTimer.Cancel ();
   m_lastAckEvent.Cancel ();
   m_timewaitEvent.Cancel ();
 }
@@ -2394,6 +2436,22 @@ TcpSocketBase::GetConnCount (void) const
   return m_cnRetries;
 }
 
+void
+TcpSocketBase::SetTimerWheel (bool timerWheel)
+{
+  NS_LOG_FUNCTION (this << timerWheel);
+  m_timerWheel = timerWheel;
+  Timer::SchedulePolicy policy = timerWheel ? Timer::SCHEDULE_WHEEL : Timer::SCHEDULE_EVENT;
+  m_retxTimer.SetSchedulePolicy (policy);
+  m_delAckTimer.SetSchedulePolicy (policy);
+}
+
+bool
+TcpSocketBase::GetTimerWheel (void) const
+{
+  return m_timerWheel;
+}
+
 void
 TcpSocketBase::SetDelAckTimeout (Time timeout)
 {
@@ -32,6 +32,7 @@
 #include "ns3/ipv4-interface.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/event-id.h"
+#include "ns3/timer.h"
 #include "tcp-tx-buffer.h"
 #include "tcp-rx-buffer.h"
 #include "rtt-estimator.h"
@@ -125,6 +126,8 @@ protected:
   virtual Time     GetPersistTimeout (void) const;
   virtual bool     SetAllowBroadcast (bool allowBroadcast);
   virtual bool     GetAllowBroadcast (void) const;
+  void             SetTimerWheel (bool timerWheel);
+  bool             GetTimerWheel (void) const;
 
   // Helper functions: Connection set up
   int SetupCallback (void);        // Common part of the two Bind(), i.e. set callback and remembering local addr:port
@@ -156,6 +159,8 @@ protected:
   void PeerClose (Ptr<Packet>, const TcpHeader&); // Received a FIN from peer, notify rx buffer
   void DoPeerClose (void); // FIN is in sequence, notify app and respond with a FIN
   void CancelAllTimers (void); // Cancel all timer when endpoint is deleted
+  void SetupTimers (void); // Bind the retransmission and delayed ACK timers
+  void RetxTimerExpire (void); // Retransmit the SYN / FIN in m_retxFlags, or call ReTxTimeout()
   void TimeWait (void);  // Move from CLOSING or FIN_WAIT_2 to TIME_WAIT state
 
   // State transition functions
@@ -192,9 +197,11 @@ protected:
 
 protected:
   // Counters and events
-  EventId           m_retxEvent;       //< Retransmission event
+  Timer             m_retxTimer;       //< Retransmission timer
+  uint8_t           m_retxFlags;       //< Flags of the SYN / FIN to retransmit, zero for data
   EventId           m_lastAckEvent;    //< Last ACK timeout event
-  EventId           m_delAckEvent;     //< Delayed ACK timeout event
+  Timer             m_delAckTimer;     //< Delayed ACK timer
+  bool              m_timerWheel;      //< Hold the retransmission and delayed ACK timers in a timer wheel
   EventId           m_persistEvent;    //< Persist event: Send 1 byte to probe for a non-zero Rx window
   EventId           m_timewaitEvent;   //< TIME_WAIT expiration event: Move this socket to CLOSED state
   uint32_t          m_dupAckCount;     //< Dupack counter
@@ -20,6 +20,7 @@
 #include "tcp-socket-factory-impl.h"
 #include "tcp-l4-protocol.h"
 #include "ns3/socket.h"
+#include "ns3/node.h"
 #include "ns3/assert.h"
 
 namespace ns3 {
@@ -39,9 +40,23 @@ TcpSocketFactoryImpl::SetTcp (Ptr<TcpL4Protocol> tcp)
   m_tcp = tcp;
 }
 
+void
+TcpSocketFactoryImpl::SetTcpFactory (const ObjectFactory &factory)
+{
+  m_tcpFactory = factory;
+}
+
 Ptr<Socket>
 TcpSocketFactoryImpl::CreateSocket (void)
 {
+  if (m_tcp == 0)
+    {
+      // the protocol sets itself with SetTcp once aggregated to the node
+      Ptr<Node> node = GetObject<Node> ();
+      NS_ASSERT (node != 0);
+      node->AggregateObject (m_tcpFactory.Create<Object> ());
+      NS_ASSERT (m_tcp != 0);
+    }
   return m_tcp->CreateSocket ();
 }
 
@@ -21,6 +21,7 @@
 #define TCP_SOCKET_FACTORY_IMPL_H
 
 #include "ns3/tcp-socket-factory.h"
+#include "ns3/object-factory.h"
 #include "ns3/ptr.h"
 
 namespace ns3 {
@@ -47,6 +48,16 @@ public:
   virtual ~TcpSocketFactoryImpl ();
 
   void SetTcp (Ptr<TcpL4Protocol> tcp);
+  /**
+   * \brief Create the TCP protocol of the node on the first socket creation
+   *
+   * The factory is aggregated to a node without TCP protocol: its first
+   * CreateSocket creates the protocol with the given factory and
+   * aggregates it to the node (see InternetStackHelper::SetLeanNode).
+   *
+   * \param factory the factory of a TcpL4Protocol
+   */
+  void SetTcpFactory (const ObjectFactory &factory);
 
   virtual Ptr<Socket> CreateSocket (void);
 
@@ -54,6 +65,7 @@ protected:
   virtual void DoDispose (void);
 private:
   Ptr<TcpL4Protocol> m_tcp;
+  ObjectFactory m_tcpFactory;
 };
 
 } // namespace ns3
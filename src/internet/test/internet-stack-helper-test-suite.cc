@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/mac48-address.h"
+#include "ns3/socket.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/arp-l3-protocol.h"
+#include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/ipv6-extension-demux.h"
+#include <limits>
+#include <sstream>
+
+using namespace ns3;
+
+// ===========================================================================
+// The protocols of the lean nodes are created on first use
+// ===========================================================================
+class LeanNodeTestCase : public TestCase
+{
+public:
+  LeanNodeTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void SetupDevices (void);
+  void Connect (void);
+  void Accept (Ptr<Socket> socket, const Address &from);
+  void SendDatagram (void);
+  void ReceiveDatagram (Ptr<Socket> socket);
+
+  NodeContainer m_nodes;
+  uint32_t m_accepted;
+  uint32_t m_received;
+};
+
+LeanNodeTestCase::LeanNodeTestCase ()
+  : TestCase ("Check that the TCP protocol and the IPv6 extensions of the lean nodes are created on first use")
+{
+}
+
+void
+LeanNodeTestCase::SetupDevices (void)
+{
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetMtu (1000);
+      device->SetChannel (channel);
+      m_nodes.Get (i)->AddDevice (device);
+
+      std::ostringstream ipv4Address, ipv6Address;
+      ipv4Address << "10.0.0." << i + 1;
+      ipv6Address << "2001::" << i + 1;
+      Ptr<Ipv4> ipv4 = m_nodes.Get (i)->GetObject<Ipv4> ();
+      uint32_t interface = ipv4->AddInterface (device);
+      ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (ipv4Address.str ().c_str ()), Ipv4Mask ("255.255.255.0")));
+      ipv4->SetUp (interface);
+      Ptr<Ipv6> ipv6 = m_nodes.Get (i)->GetObject<Ipv6> ();
+      interface = ipv6->AddInterface (device);
+      ipv6->AddAddress (interface, Ipv6InterfaceAddress (Ipv6Address (ipv6Address.str ().c_str ()), Ipv6Prefix (64)));
+      ipv6->SetUp (interface);
+    }
+}
+
+void
+LeanNodeTestCase::Accept (Ptr<Socket> socket, const Address &from)
+{
+  m_accepted++;
+}
+
+void
+LeanNodeTestCase::Connect (void)
+{
+  Ptr<Socket> socket = Socket::CreateSocket (m_nodes.Get (1), TcpSocketFactory::GetTypeId ());
+  socket->Connect (InetSocketAddress (Ipv4Address ("10.0.0.1"), 80));
+}
+
+void
+LeanNodeTestCase::SendDatagram (void)
+{
+  Ptr<Socket> socket = Socket::CreateSocket (m_nodes.Get (1), UdpSocketFactory::GetTypeId ());
+  socket->Connect (Inet6SocketAddress (Ipv6Address ("2001::1"), 9));
+  // fragmented by the device MTU
+  socket->Send (Create<Packet> (2000));
+}
+
+void
+LeanNodeTestCase::ReceiveDatagram (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet = socket->Recv (std::numeric_limits<uint32_t>::max (), 0);
+  m_received = packet->GetSize ();
+}
+
+void
+LeanNodeTestCase::DoRun (void)
+{
+  m_accepted = 0;
+  m_received = 0;
+
+  // a default node has all its protocols
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper helper;
+  helper.Install (node);
+  NS_TEST_EXPECT_MSG_EQ ((node->GetObject<TcpL4Protocol> () != 0), true, "No TCP on a default node");
+  NS_TEST_EXPECT_MSG_EQ ((node->GetObject<Ipv6ExtensionDemux> () != 0), true, "No IPv6 extensions on a default node");
+
+  m_nodes.Create (2);
+  InternetStackHelper leanHelper;
+  leanHelper.SetLeanNode (true);
+  leanHelper.Install (m_nodes);
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<Node> lean = m_nodes.Get (i);
+      NS_TEST_EXPECT_MSG_EQ ((lean->GetObject<TcpL4Protocol> () == 0), true, "TCP created before its first socket");
+      NS_TEST_EXPECT_MSG_EQ ((lean->GetObject<TcpSocketFactory> () != 0), true, "No TCP socket factory");
+      NS_TEST_EXPECT_MSG_EQ ((lean->GetObject<Ipv6ExtensionDemux> () == 0), true, "IPv6 extensions registered before use");
+      NS_TEST_EXPECT_MSG_EQ ((lean->GetObject<Object> (TypeId::LookupByName ("ns3::Ipv6OptionDemux")) == 0), true, "IPv6 options registered before use");
+    }
+  PointerValue first, second;
+  m_nodes.Get (0)->GetObject<ArpL3Protocol> ()->GetAttribute ("RequestJitter", first);
+  m_nodes.Get (1)->GetObject<ArpL3Protocol> ()->GetAttribute ("RequestJitter", second);
+  NS_TEST_EXPECT_MSG_EQ (first.Get<RandomVariableStream> (), second.Get<RandomVariableStream> (), "ARP jitter not shared");
+  m_nodes.Get (0)->GetObject<Icmpv6L4Protocol> ()->GetAttribute ("SolicitationJitter", first);
+  m_nodes.Get (1)->GetObject<Icmpv6L4Protocol> ()->GetAttribute ("SolicitationJitter", second);
+  NS_TEST_EXPECT_MSG_EQ (first.Get<RandomVariableStream> (), second.Get<RandomVariableStream> (), "NS and RS jitter not shared");
+
+  SetupDevices ();
+
+  // the listening socket creates the TCP of the server only
+  Ptr<Socket> server = Socket::CreateSocket (m_nodes.Get (0), TcpSocketFactory::GetTypeId ());
+  server->Bind (InetSocketAddress (Ipv4Address::GetAny (), 80));
+  server->Listen ();
+  server->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                             MakeCallback (&LeanNodeTestCase::Accept, this));
+  Ptr<TcpL4Protocol> tcp = m_nodes.Get (0)->GetObject<TcpL4Protocol> ();
+  NS_TEST_EXPECT_MSG_EQ ((tcp != 0), true, "TCP not created by the first socket");
+  NS_TEST_EXPECT_MSG_EQ ((m_nodes.Get (1)->GetObject<TcpL4Protocol> () == 0), true, "TCP created on the wrong node");
+  Socket::CreateSocket (m_nodes.Get (0), TcpSocketFactory::GetTypeId ());
+  NS_TEST_EXPECT_MSG_EQ (m_nodes.Get (0)->GetObject<TcpL4Protocol> (), tcp, "TCP created again by the second socket");
+
+  Ptr<Socket> sink = Socket::CreateSocket (m_nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  sink->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 9));
+  sink->SetRecvCallback (MakeCallback (&LeanNodeTestCase::ReceiveDatagram, this));
+
+  Simulator::Schedule (Seconds (1), &LeanNodeTestCase::Connect, this);
+  Simulator::Schedule (Seconds (2), &LeanNodeTestCase::SendDatagram, this);
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_accepted, 1, "The TCP connection between lean nodes failed");
+  NS_TEST_EXPECT_MSG_EQ ((m_nodes.Get (1)->GetObject<TcpL4Protocol> () != 0), true, "TCP not created by the client socket");
+  NS_TEST_EXPECT_MSG_EQ (m_received, 2000, "The fragmented datagram between lean nodes was lost");
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((m_nodes.Get (i)->GetObject<Ipv6ExtensionDemux> () != 0), true, "IPv6 extensions not registered by the fragmentation");
+    }
+  Simulator::Destroy ();
+}
+
+class InternetStackHelperTestSuite : public TestSuite
+{
+public:
+  InternetStackHelperTestSuite ();
+};
+
+InternetStackHelperTestSuite::InternetStackHelperTestSuite ()
+  : TestSuite ("internet-stack-helper", UNIT)
+{
+  AddTestCase (new LeanNodeTestCase, TestCase::QUICK);
+}
+
+static InternetStackHelperTestSuite internetStackHelperTestSuite;
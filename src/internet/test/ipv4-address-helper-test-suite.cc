@@ -20,6 +20,10 @@
 #include "ns3/ipv4-address-generator.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/mac48-address.h"
+#include "ns3/internet-stack-helper.h"
 
 using namespace ns3;
 
@@ -254,6 +258,57 @@ IpAddressHelperTestCasev4::DoTeardown (void)
   Simulator::Destroy ();
 }
 
+class AssignNetworksHelperTestCase : public TestCase
+{
+public:
+  AssignNetworksHelperTestCase ();
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+};
+
+AssignNetworksHelperTestCase::AssignNetworksHelperTestCase ()
+  : TestCase ("Make sure that AssignNetworks assigns a new network to each group of devices.")
+{
+}
+
+void
+AssignNetworksHelperTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (6);
+  InternetStackHelper stack;
+  stack.SetIpv6StackInstall (false);
+  stack.Install (nodes);
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      nodes.Get (i)->AddDevice (device);
+      devices.Add (device);
+    }
+
+  Ipv4AddressHelper h;
+  h.SetBase ("10.1.0.0", "255.255.255.252");
+  Ipv4InterfaceContainer interfaces = h.AssignNetworks (devices, 2);
+  NS_TEST_ASSERT_MSG_EQ (interfaces.GetN (), 6, "501");
+  NS_TEST_EXPECT_MSG_EQ (interfaces.GetAddress (0), Ipv4Address ("10.1.0.1"), "502");
+  NS_TEST_EXPECT_MSG_EQ (interfaces.GetAddress (1), Ipv4Address ("10.1.0.2"), "503");
+  NS_TEST_EXPECT_MSG_EQ (interfaces.GetAddress (2), Ipv4Address ("10.1.0.5"), "504");
+  NS_TEST_EXPECT_MSG_EQ (interfaces.GetAddress (3), Ipv4Address ("10.1.0.6"), "505");
+  NS_TEST_EXPECT_MSG_EQ (interfaces.GetAddress (4), Ipv4Address ("10.1.0.9"), "506");
+  NS_TEST_EXPECT_MSG_EQ (interfaces.GetAddress (5), Ipv4Address ("10.1.0.10"), "507");
+  // the helper moved to the network after the last group
+  NS_TEST_EXPECT_MSG_EQ (h.NewAddress (), Ipv4Address ("10.1.0.13"), "508");
+}
+
+void
+AssignNetworksHelperTestCase::DoTeardown (void)
+{
+  Ipv4AddressGenerator::Reset ();
+  Simulator::Destroy ();
+}
 
 static class Ipv4AddressHelperTestSuite : public TestSuite
 {
@@ -265,5 +320,6 @@ public:
     AddTestCase (new AddressAllocatorHelperTestCase (), TestCase::QUICK);
     AddTestCase (new ResetAllocatorHelperTestCase (), TestCase::QUICK);
     AddTestCase (new IpAddressHelperTestCasev4 (), TestCase::QUICK);
+    AddTestCase (new AssignNetworksHelperTestCase (), TestCase::QUICK);
   }
 } g_ipv4AddressHelperTestSuite;
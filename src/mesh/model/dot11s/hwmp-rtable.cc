@@ -26,6 +26,8 @@
 
 #include "hwmp-rtable.h"
 
+#include <algorithm>
+
 namespace ns3 {
 namespace dot11s {
 
@@ -57,19 +59,12 @@ void
 HwmpRtable::AddReactivePath (Mac48Address destination, Mac48Address retransmitter, uint32_t interface,
                              uint32_t metric, Time lifetime, uint32_t seqnum)
 {
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
-  if (i == m_routes.end ())
-    {
-      ReactiveRoute newroute;
-      m_routes[destination] = newroute;
-    }
-  i = m_routes.find (destination);
-  NS_ASSERT (i != m_routes.end ());
-  i->second.retransmitter = retransmitter;
-  i->second.interface = interface;
-  i->second.metric = metric;
-  i->second.whenExpire = Simulator::Now () + lifetime;
-  i->second.seqnum = seqnum;
+  ReactiveRoute &route = m_routes[destination];
+  route.retransmitter = retransmitter;
+  route.interface = interface;
+  route.metric = metric;
+  route.whenExpire = Simulator::Now () + lifetime;
+  route.seqnum = seqnum;
 }
 void
 HwmpRtable::AddProactivePath (uint32_t metric, Mac48Address root, Mac48Address retransmitter,
@@ -90,7 +85,7 @@ HwmpRtable::AddPrecursor (Mac48Address destination, uint32_t precursorInterface,
   precursor.interface = precursorInterface;
   precursor.address = precursorAddress;
   precursor.whenExpire = Simulator::Now () + lifetime;
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
+  ReactiveRoutes::iterator i = m_routes.find (destination);
   if (i != m_routes.end ())
     {
       bool should_add = true;
@@ -132,31 +127,29 @@ HwmpRtable::DeleteProactivePath (Mac48Address root)
 void
 HwmpRtable::DeleteReactivePath (Mac48Address destination)
 {
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
-  if (i != m_routes.end ())
-    {
-      m_routes.erase (i);
-    }
+  m_routes.erase (destination);
 }
 HwmpRtable::LookupResult
 HwmpRtable::LookupReactive (Mac48Address destination)
 {
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
+  ReactiveRoutes::const_iterator i = m_routes.find (destination);
   if (i == m_routes.end ())
     {
       return LookupResult ();
     }
-  if ((i->second.whenExpire < Simulator::Now ()) && (i->second.whenExpire != Seconds (0)))
+  Time now = Simulator::Now ();
+  if ((i->second.whenExpire < now) && (i->second.whenExpire != Seconds (0)))
     {
       NS_LOG_DEBUG ("Reactive route has expired, sorry.");
       return LookupResult ();
     }
-  return LookupReactiveExpired (destination);
+  return LookupResult (i->second.retransmitter, i->second.interface, i->second.metric, i->second.seqnum,
+                       i->second.whenExpire - now);
 }
 HwmpRtable::LookupResult
 HwmpRtable::LookupReactiveExpired (Mac48Address destination)
 {
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
+  ReactiveRoutes::const_iterator i = m_routes.find (destination);
   if (i == m_routes.end ())
     {
       return LookupResult ();
@@ -180,12 +173,17 @@ HwmpRtable::LookupProactiveExpired ()
   return LookupResult (m_root.retransmitter, m_root.interface, m_root.metric, m_root.seqnum,
                        m_root.whenExpire - Simulator::Now ());
 }
+static bool
+CompareFailedDestination (const HwmpProtocol::FailedDestination &a, const HwmpProtocol::FailedDestination &b)
+{
+  return a.destination < b.destination;
+}
 std::vector<HwmpProtocol::FailedDestination>
 HwmpRtable::GetUnreachableDestinations (Mac48Address peerAddress)
 {
   HwmpProtocol::FailedDestination dst;
   std::vector<HwmpProtocol::FailedDestination> retval;
-  for (std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.begin (); i != m_routes.end (); i++)
+  for (ReactiveRoutes::iterator i = m_routes.begin (); i != m_routes.end (); i++)
     {
       if (i->second.retransmitter == peerAddress)
         {
@@ -195,6 +193,9 @@ HwmpRtable::GetUnreachableDestinations (Mac48Address peerAddress)
           retval.push_back (dst);
         }
     }
+  // Hash order is not deterministic across platforms: keep the
+  // destinations of the PERR sorted by address.
+  std::sort (retval.begin (), retval.end (), CompareFailedDestination);
   //Lookup a path to root
   if (m_root.retransmitter == peerAddress)
     {
@@ -209,13 +210,14 @@ HwmpRtable::GetPrecursors (Mac48Address destination)
 {
   //We suppose that no duplicates here can be
   PrecursorList retval;
-  std::map<Mac48Address, ReactiveRoute>::iterator route = m_routes.find (destination);
+  ReactiveRoutes::const_iterator route = m_routes.find (destination);
   if (route != m_routes.end ())
     {
+      Time now = Simulator::Now ();
       for (std::vector<Precursor>::const_iterator i = route->second.precursors.begin ();
            i != route->second.precursors.end (); i++)
         {
-          if (i->whenExpire > Simulator::Now ())
+          if (i->whenExpire > now)
             {
               retval.push_back (std::make_pair (i->interface, i->address));
             }
@@ -61,7 +61,7 @@ void
 FlameRtable::AddPath (const Mac48Address destination, const Mac48Address retransmitter,
                       const uint32_t interface, const uint8_t cost, const uint16_t seqnum)
 {
-  std::map<Mac48Address, Route>::iterator i = m_routes.find (destination);
+  Routes::iterator i = m_routes.find (destination);
   if (i == m_routes.end ())
     {
       Route newroute;
@@ -83,7 +83,7 @@ FlameRtable::AddPath (const Mac48Address destination, const Mac48Address retrans
 FlameRtable::LookupResult
 FlameRtable::Lookup (Mac48Address destination)
 {
-  std::map<Mac48Address, Route>::iterator i = m_routes.find (destination);
+  Routes::iterator i = m_routes.find (destination);
   if (i == m_routes.end ())
     {
       return LookupResult ();
@@ -21,10 +21,10 @@
 #ifndef FLAME_RTABLE_H
 #define FLAME_RTABLE_H
 
-#include <map>
 #include "ns3/nstime.h"
 #include "ns3/object.h"
 #include "ns3/mac48-address.h"
+#include "ns3/sgi-hashmap.h"
 
 namespace ns3 {
   //namespace flame {
@@ -97,8 +97,9 @@ private:
   };
   /// Lifetime parameter
   Time m_lifetime;
-  /// List of routes
-  std::map<Mac48Address, Route>  m_routes;
+  /// List of routes, hashed by destination
+  typedef sgi::hash_map<Mac48Address, Route, Mac48AddressHash> Routes;
+  Routes m_routes;
 };
 
   //} // namespace flame
@@ -92,6 +92,10 @@ NodeContainer::Get (uint32_t i) const
 void 
 NodeContainer::Create (uint32_t n)
 {
+  if (m_nodes.empty ())
+    {
+      m_nodes.reserve (n);
+    }
   for (uint32_t i = 0; i < n; i++)
     {
       m_nodes.push_back (CreateObject<Node> ());
@@ -100,6 +104,10 @@ NodeContainer::Create (uint32_t n)
 void 
 NodeContainer::Create (uint32_t n, uint32_t systemId)
 {
+  if (m_nodes.empty ())
+    {
+      m_nodes.reserve (n);
+    }
   for (uint32_t i = 0; i < n; i++)
     {
       m_nodes.push_back (CreateObject<Node> (systemId));
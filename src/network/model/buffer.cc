@@ -20,6 +20,8 @@
 #include "buffer.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/memory-accounting.h"
+#include "ns3/replication.h"
 
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
@@ -45,6 +47,15 @@ static struct Zeroes
 
 namespace ns3 {
 
+/**
+ * \returns the memory account of the buffer data
+ */
+static uint32_t
+GetDataAccount (void)
+{
+  static uint32_t account = MemoryAccounting::GetAccount ("ns3::Buffer::Data");
+  return account;
+}
 
 uint32_t Buffer::g_recommendedStart = 0;
 #ifdef BUFFER_FREE_LIST
@@ -75,6 +86,25 @@ uint32_t Buffer::g_maxSize = 0;
 Buffer::FreeList *Buffer::g_freeList = 0;
 struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
 
+// the free list is only used by the thread which loaded the library,
+// out of the replications: the other threads, like the simulation
+// threads of MultithreadedSimulatorImpl, allocate and release their buffers
+// directly, so that no lock is needed.
+static __thread bool g_freeListOwner = false;
+static struct FreeListOwner
+{
+  FreeListOwner ()
+  {
+    g_freeListOwner = true;
+  }
+} g_freeListOwnerInit;
+
+static bool
+UseFreeList (void)
+{
+  return g_freeListOwner && !Replication::IsActive ();
+}
+
 Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
 {
   NS_LOG_FUNCTION (this);
@@ -95,6 +125,11 @@ Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
+  if (!UseFreeList ())
+    {
+      Buffer::Deallocate (data);
+      return;
+    }
   NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
   g_maxSize = std::max (g_maxSize, data->m_size);
   /* feed into free list */
@@ -115,6 +150,10 @@ Buffer::Data *
 Buffer::Create (uint32_t dataSize)
 {
   NS_LOG_FUNCTION (dataSize);
+  if (!UseFreeList ())
+    {
+      return Buffer::Allocate (dataSize);
+    }
   /* try to find a buffer correctly sized. */
   if (IS_UNINITIALIZED (g_freeList))
     {
@@ -169,6 +208,11 @@ Buffer::Allocate (uint32_t reqSize)
   struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
   data->m_size = reqSize;
   data->m_count = 1;
+  data->m_accounted = MemoryAccounting::IsEnabled ();
+  if (data->m_accounted)
+    {
+      MemoryAccounting::Allocate (GetDataAccount (), size);
+    }
   return data;
 }
 
@@ -177,6 +221,10 @@ Buffer::Deallocate (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
+  if (data->m_accounted)
+    {
+      MemoryAccounting::Deallocate (GetDataAccount (), data->m_size - 1 + sizeof (struct Buffer::Data));
+    }
   uint8_t *buf = reinterpret_cast<uint8_t *> (data);
   delete [] buf;
 }
@@ -561,6 +561,10 @@ private:
      * end of the area in which user bytes were written.
      */
     uint32_t m_dirtyEnd;
+    /* true if this instance was counted by MemoryAccounting when
+     * it was allocated, so that only those are subtracted when freed.
+     */
+    bool m_accounted;
     /* The real data buffer holds _at least_ one byte.
      * Its real size is stored in the m_size field.
      */
@@ -19,6 +19,8 @@
  */
 #include "byte-tag-list.h"
 #include "ns3/log.h"
+#include "ns3/memory-accounting.h"
+#include "ns3/replication.h"
 #include <vector>
 #include <cstring>
 
@@ -37,6 +39,36 @@ struct ByteTagListData {
   uint8_t data[4];
 };
 
+/**
+ * Count a new tag buffer in its memory account, see MemoryAccounting.
+ *
+ * \param data the new tag buffer
+ */
+static void
+AccountAllocate (struct ByteTagListData *data)
+{
+  static uint32_t account = MemoryAccounting::GetAccount ("ns3::ByteTagListData");
+  if (MemoryAccounting::IsEnabled ())
+    {
+      MemoryAccounting::Allocate (account, data->size + sizeof (struct ByteTagListData) - 4);
+    }
+}
+
+/**
+ * Remove a tag buffer about to be deleted from its memory account.
+ *
+ * \param data the tag buffer
+ */
+static void
+AccountDeallocate (struct ByteTagListData *data)
+{
+  static uint32_t account = MemoryAccounting::GetAccount ("ns3::ByteTagListData");
+  if (MemoryAccounting::IsEnabled ())
+    {
+      MemoryAccounting::Deallocate (account, data->size + sizeof (struct ByteTagListData) - 4);
+    }
+}
+
 #ifdef USE_FREE_LIST
 static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
 {
@@ -45,6 +77,25 @@ public:
 } g_freeList;
 static uint32_t g_maxSize = 0;
 
+// the free list is only used by the thread which loaded the library,
+// out of the replications: the other threads, like the simulation
+// threads of MultithreadedSimulatorImpl, allocate and release their tags
+// directly, so that no lock is needed.
+static __thread bool g_freeListOwner = false;
+static struct FreeListOwner
+{
+  FreeListOwner ()
+  {
+    g_freeListOwner = true;
+  }
+} g_freeListOwnerInit;
+
+static bool
+UseFreeList (void)
+{
+  return g_freeListOwner && !Replication::IsActive ();
+}
+
 ByteTagListDataFreeList::~ByteTagListDataFreeList ()
 {
   NS_LOG_FUNCTION (this);
@@ -344,6 +395,16 @@ struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  if (!UseFreeList ())
+    {
+      uint8_t *buffer = new uint8_t [size + sizeof (struct ByteTagListData) - 4];
+      struct ByteTagListData *data = (struct ByteTagListData *)buffer;
+      data->count = 1;
+      data->size = size;
+      data->dirty = 0;
+      AccountAllocate (data);
+      return data;
+    }
   while (!g_freeList.empty ())
     {
       struct ByteTagListData *data = g_freeList.back ();
@@ -355,6 +416,7 @@ ByteTagList::Allocate (uint32_t size)
           data->dirty = 0;
           return data;
         }
+      AccountDeallocate (data);
       uint8_t *buffer = (uint8_t *)data;
       delete [] buffer;
     }
@@ -363,6 +425,7 @@ ByteTagList::Allocate (uint32_t size)
   data->count = 1;
   data->size = size;
   data->dirty = 0;
+  AccountAllocate (data);
   return data;
 }
 
@@ -374,6 +437,17 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
     {
       return;
     }
+  if (!UseFreeList ())
+    {
+      data->count--;
+      if (data->count == 0)
+        {
+          AccountDeallocate (data);
+          uint8_t *buffer = (uint8_t *)data;
+          delete [] buffer;
+        }
+      return;
+    }
   g_maxSize = std::max (g_maxSize, data->size);
   data->count--;
   if (data->count == 0)
@@ -381,6 +455,7 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
       if (g_freeList.size () > FREE_LIST_SIZE ||
           data->size < g_maxSize)
         {
+          AccountDeallocate (data);
           uint8_t *buffer = (uint8_t *)data;
           delete [] buffer;
         }
@@ -402,6 +477,7 @@ ByteTagList::Allocate (uint32_t size)
   data->count = 1;
   data->size = size;
   data->dirty = 0;
+  AccountAllocate (data);
   return data;
 }
 
@@ -416,6 +492,7 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
   data->count--;
   if (data->count == 0)
     {
+      AccountDeallocate (data);
       uint8_t *buffer = (uint8_t *)data;
       delete [] buffer;
     }
@@ -19,6 +19,7 @@
 #include "ns3/simulator.h"
 #include "ns3/object-vector.h"
 #include "ns3/config.h"
+#include "ns3/replication.h"
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include "channel-list.h"
@@ -49,7 +50,7 @@ public:
   static Ptr<ChannelListPriv> Get (void);
 
 private:
-  static Ptr<ChannelListPriv> *DoGet (void);
+  static ChannelListPriv **DoGet (void);
   static void Delete (void);
   virtual void DoDispose (void);
   std::vector<Ptr<Channel> > m_channels;
@@ -77,26 +78,30 @@ ChannelListPriv::Get (void)
   return *DoGet ();
 }
 
-Ptr<ChannelListPriv> *
+ChannelListPriv **
 ChannelListPriv::DoGet (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static Ptr<ChannelListPriv> ptr = 0;
-  if (ptr == 0)
+  static ChannelListPriv *list = 0;
+  // the channels of the replication run by the calling thread
+  static __thread ChannelListPriv *replicationList = 0;
+  ChannelListPriv **plist = Replication::IsActive () ? &replicationList : &list;
+  if (*plist == 0)
     {
-      ptr = CreateObject<ChannelListPriv> ();
-      Config::RegisterRootNamespaceObject (ptr);
+      *plist = GetPointer (CreateObject<ChannelListPriv> ());
+      Config::RegisterRootNamespaceObject (*plist);
       Simulator::ScheduleDestroy (&ChannelListPriv::Delete);
     }
-  return &ptr;
+  return plist;
 }
-
 void 
 ChannelListPriv::Delete (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  Config::UnregisterRootNamespaceObject (Get ());
-  (*DoGet ()) = 0;
+  ChannelListPriv **plist = DoGet ();
+  Config::UnregisterRootNamespaceObject (*plist);
+  (*plist)->Unref ();
+  *plist = 0;
 }
 
 ChannelListPriv::ChannelListPriv ()
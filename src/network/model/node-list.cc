@@ -22,6 +22,7 @@
 #include "ns3/simulator.h"
 #include "ns3/object-vector.h"
 #include "ns3/config.h"
+#include "ns3/replication.h"
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include "node-list.h"
@@ -51,7 +52,7 @@ public:
 
 private:
   virtual void DoDispose (void);
-  static Ptr<NodeListPriv> *DoGet (void);
+  static NodeListPriv **DoGet (void);
   static void Delete (void);
   std::vector<Ptr<Node> > m_nodes;
 };
@@ -77,25 +78,30 @@ NodeListPriv::Get (void)
   NS_LOG_FUNCTION_NOARGS ();
   return *DoGet ();
 }
-Ptr<NodeListPriv> *
+NodeListPriv **
 NodeListPriv::DoGet (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static Ptr<NodeListPriv> ptr = 0;
-  if (ptr == 0)
+  static NodeListPriv *list = 0;
+  // the nodes of the replication run by the calling thread
+  static __thread NodeListPriv *replicationList = 0;
+  NodeListPriv **plist = Replication::IsActive () ? &replicationList : &list;
+  if (*plist == 0)
     {
-      ptr = CreateObject<NodeListPriv> ();
-      Config::RegisterRootNamespaceObject (ptr);
+      *plist = GetPointer (CreateObject<NodeListPriv> ());
+      Config::RegisterRootNamespaceObject (*plist);
       Simulator::ScheduleDestroy (&NodeListPriv::Delete);
     }
-  return &ptr;
+  return plist;
 }
 void 
 NodeListPriv::Delete (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  Config::UnregisterRootNamespaceObject (Get ());
-  (*DoGet ()) = 0;
+  NodeListPriv **plist = DoGet ();
+  Config::UnregisterRootNamespaceObject (*plist);
+  (*plist)->Unref ();
+  *plist = 0;
 }
 
 
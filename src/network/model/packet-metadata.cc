@@ -22,6 +22,8 @@
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/memory-accounting.h"
+#include "ns3/replication.h"
 #include "packet-metadata.h"
 #include "buffer.h"
 #include "header.h"
@@ -38,6 +40,40 @@ uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
 PacketMetadata::DataFreeList PacketMetadata::m_freeList;
 
+/**
+ * \returns the memory account of the metadata
+ */
+static uint32_t
+GetDataAccount (void)
+{
+  static uint32_t account = MemoryAccounting::GetAccount ("ns3::PacketMetadata::Data");
+  return account;
+}
+
+// the chunk uids of the replications run by the calling thread: they
+// only need to differ from one header to the next, so they are not
+// reset from one replication to the next.
+static __thread uint16_t g_replicationChunkUid = 0;
+
+// the free list is only used by the thread which loaded the library,
+// out of the replications: the other threads, like the simulation
+// threads of MultithreadedSimulatorImpl, allocate and release their metadata
+// directly, so that no lock is needed.
+static __thread bool g_freeListOwner = false;
+static struct FreeListOwner
+{
+  FreeListOwner ()
+  {
+    g_freeListOwner = true;
+  }
+} g_freeListOwnerInit;
+
+static bool
+UseFreeList (void)
+{
+  return g_freeListOwner && !Replication::IsActive ();
+}
+
 PacketMetadata::DataFreeList::~DataFreeList ()
 {
   NS_LOG_FUNCTION (this);
@@ -582,6 +618,10 @@ struct PacketMetadata::Data *
 PacketMetadata::Create (uint32_t size)
 {
   NS_LOG_FUNCTION (size);
+  if (!UseFreeList ())
+    {
+      return PacketMetadata::Allocate (size);
+    }
   NS_LOG_LOGIC ("create size="<<size<<", max="<<m_maxSize);
   if (size > m_maxSize)
     {
@@ -613,6 +653,11 @@ PacketMetadata::Recycle (struct PacketMetadata::Data *data)
       PacketMetadata::Deallocate (data);
       return;
     } 
+  if (!UseFreeList ())
+    {
+      PacketMetadata::Deallocate (data);
+      return;
+    }
   NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<m_freeList.size ());
   NS_ASSERT (data->m_count == 0);
   if (m_freeList.size () > 1000 ||
@@ -626,6 +671,16 @@ PacketMetadata::Recycle (struct PacketMetadata::Data *data)
     }
 }
 
+uint16_t
+PacketMetadata::AllocateChunkUid (void)
+{
+  if (Replication::IsActive ())
+    {
+      return g_replicationChunkUid++;
+    }
+  return __sync_fetch_and_add (&m_chunkUid, 1);
+}
+
 struct PacketMetadata::Data *
 PacketMetadata::Allocate (uint32_t n)
 {
@@ -641,12 +696,20 @@ PacketMetadata::Allocate (uint32_t n)
   data->m_size = n;
   data->m_count = 1;
   data->m_dirtyEnd = 0;
+  if (MemoryAccounting::IsEnabled ())
+    {
+      MemoryAccounting::Allocate (GetDataAccount (), size);
+    }
   return data;
 }
 void 
 PacketMetadata::Deallocate (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
+  if (MemoryAccounting::IsEnabled ())
+    {
+      MemoryAccounting::Deallocate (GetDataAccount (), sizeof (struct Data) + data->m_size - PACKET_METADATA_DATA_M_DATA_SIZE);
+    }
   uint8_t *buf = (uint8_t *)data;
   delete [] buf;
 }
@@ -686,8 +749,7 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
   item.prev = 0xffff;
   item.typeUid = uid;
   item.size = size;
-  item.chunkUid = m_chunkUid;
-  m_chunkUid++;
+  item.chunkUid = AllocateChunkUid ();
   uint16_t written = AddSmall (&item);
   UpdateHead (written);
 }
@@ -755,8 +817,7 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
   item.prev = m_tail;
   item.typeUid = uid;
   item.size = size;
-  item.chunkUid = m_chunkUid;
-  m_chunkUid++;
+  item.chunkUid = AllocateChunkUid ();
   uint16_t written = AddSmall (&item);
   UpdateTail (written);
   NS_ASSERT (IsStateOk ());
@@ -334,6 +334,7 @@ public:
   static void Recycle (struct PacketMetadata::Data *data);
   static struct PacketMetadata::Data *Allocate (uint32_t n);
   static void Deallocate (struct PacketMetadata::Data *data);
+  static uint16_t AllocateChunkUid (void);
 
   static DataFreeList m_freeList;
   static bool m_enable;
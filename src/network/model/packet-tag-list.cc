@@ -28,12 +28,44 @@
 #include "tag.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/memory-accounting.h"
 #include <cstring>
+#include <new>
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
 namespace ns3 {
 
+/**
+ * \returns the memory account of the packet tags
+ */
+static uint32_t
+GetDataAccount (void)
+{
+  static uint32_t account = MemoryAccounting::GetAccount ("ns3::PacketTagList::TagData");
+  return account;
+}
+
+void *
+PacketTagList::TagData::operator new (size_t size)
+{
+  if (MemoryAccounting::IsEnabled ())
+    {
+      MemoryAccounting::Allocate (GetDataAccount (), size);
+    }
+  return ::operator new (size);
+}
+
+void
+PacketTagList::TagData::operator delete (void *p, size_t size)
+{
+  if (MemoryAccounting::IsEnabled ())
+    {
+      MemoryAccounting::Deallocate (GetDataAccount (), size);
+    }
+  ::operator delete (p);
+}
+
 bool
 PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 {
@@ -26,6 +26,7 @@
 */
 
 #include <stdint.h>
+#include <cstddef>
 #include <ostream>
 #include "ns3/type-id.h"
 
@@ -165,6 +166,22 @@ public:
     struct TagData * next;   /**< Pointer to next in list */
     TypeId tid;               /**< Type of the tag serialized into #data */
     uint32_t count;           /**< Number of incoming links */
+
+    /**
+     * Allocate a TagData, counted in its memory account when the
+     * memory accounting is enabled, see MemoryAccounting.
+     *
+     * \param [in] size The size of a TagData.
+     * \returns The new storage.
+     */
+    static void * operator new (size_t size);
+    /**
+     * Free a TagData.
+     *
+     * \param [in] p The storage to free.
+     * \param [in] size The size of a TagData.
+     */
+    static void operator delete (void *p, size_t size);
   };  /* struct TagData */
 
   /**
@@ -21,6 +21,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/replication.h"
 #include <string>
 #include <cstdarg>
 
@@ -30,6 +31,25 @@ namespace ns3 {
 
 uint32_t Packet::m_globalUid = 0;
 
+// the uids of the replication run by the calling thread
+static __thread uint64_t g_replicationUid = 0;
+
+uint32_t
+Packet::AllocateUid (void)
+{
+  if (Replication::IsActive ())
+    {
+      if (g_replicationUid == 0)
+        {
+          Replication::ResetAtExit (&g_replicationUid);
+        }
+      return g_replicationUid++;
+    }
+  // the simulation threads of MultithreadedSimulatorImpl create packets
+  // concurrently
+  return __sync_fetch_and_add (&m_globalUid, 1);
+}
+
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
 {
@@ -137,10 +157,9 @@ Packet::Packet ()
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | AllocateUid (), 0),
     m_nixVector (0)
 {
-  m_globalUid++;
 }
 
 Packet::Packet (const Packet &o)
@@ -179,10 +198,9 @@ Packet::Packet (uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | AllocateUid (), size),
     m_nixVector (0)
 {
-  m_globalUid++;
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
@@ -205,10 +223,9 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | AllocateUid (), size),
     m_nixVector (0)
 {
-  m_globalUid++;
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
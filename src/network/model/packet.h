@@ -592,6 +592,11 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector;
 
+  /**
+   * \returns the next uid, in the simulation of the calling thread
+   */
+  static uint32_t AllocateUid (void);
+
   static uint32_t m_globalUid;
 };
 
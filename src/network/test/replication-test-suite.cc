@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/replication.h"
+#include "ns3/system-thread.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/packet.h"
+#include "ns3/mac48-address.h"
+#include "ns3/names.h"
+#include "ns3/config.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Each replication has its own nodes, packet uids and addresses
+// ===========================================================================
+class ReplicationNetworkTestCase : public TestCase
+{
+public:
+  ReplicationNetworkTestCase ();
+
+private:
+  struct Result
+  {
+    uint32_t nodes;
+    uint32_t lastNodeId;
+    uint32_t configNodes;
+    Mac48Address address;
+    uint64_t uid;
+    bool named;
+    Time now;
+  };
+
+  virtual void DoRun (void);
+  void Replicate (uint32_t i);
+  void FirstThread (void);
+  void SecondThread (void);
+
+  Result m_results[4];
+};
+
+ReplicationNetworkTestCase::ReplicationNetworkTestCase ()
+  : TestCase ("Check that the replications do not share their nodes, packets and addresses")
+{
+}
+
+void
+ReplicationNetworkTestCase::Replicate (uint32_t i)
+{
+  Replication::Enter (i + 1);
+  Result &result = m_results[i];
+  Ptr<Node> node;
+  for (uint32_t j = 0; j < 3 + i; j++)
+    {
+      node = CreateObject<Node> ();
+    }
+  Names::Add ("replicated", node);
+  result.nodes = NodeList::GetNNodes ();
+  result.lastNodeId = node->GetId ();
+  result.configNodes = Config::LookupMatches ("/NodeList/*").GetN ();
+  result.address = Mac48Address::Allocate ();
+  result.uid = Create<Packet> ()->GetUid ();
+  result.named = Names::Find<Node> ("replicated") == node;
+  Simulator::Stop (Seconds (i));
+  Simulator::Run ();
+  result.now = Simulator::Now ();
+  Simulator::Destroy ();
+  Replication::Exit ();
+}
+
+// two replications in a row in each thread: the second one starts from
+// scratch too
+void
+ReplicationNetworkTestCase::FirstThread (void)
+{
+  Replicate (0);
+  Replicate (2);
+}
+
+void
+ReplicationNetworkTestCase::SecondThread (void)
+{
+  Replicate (1);
+  Replicate (3);
+}
+
+void
+ReplicationNetworkTestCase::DoRun (void)
+{
+  uint32_t nodes = NodeList::GetNNodes ();
+  Ptr<SystemThread> threads[2];
+  threads[0] = Create<SystemThread> (MakeCallback (&ReplicationNetworkTestCase::FirstThread, this));
+  threads[1] = Create<SystemThread> (MakeCallback (&ReplicationNetworkTestCase::SecondThread, this));
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      threads[i]->Start ();
+    }
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      threads[i]->Join ();
+    }
+
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      const Result &result = m_results[i];
+      NS_TEST_EXPECT_MSG_EQ (result.nodes, 3 + i, "Replication " << i << " sees the nodes of the others");
+      NS_TEST_EXPECT_MSG_EQ (result.lastNodeId, 2 + i, "Wrong node id in replication " << i);
+      NS_TEST_EXPECT_MSG_EQ (result.configNodes, 3 + i, "Wrong config namespace in replication " << i);
+      NS_TEST_EXPECT_MSG_EQ (result.address, Mac48Address ("00:00:00:00:00:01"), "Wrong address in replication " << i);
+      NS_TEST_EXPECT_MSG_EQ (result.uid, 0, "Wrong packet uid in replication " << i);
+      NS_TEST_EXPECT_MSG_EQ (result.named, true, "Wrong name in replication " << i);
+      NS_TEST_EXPECT_MSG_EQ (result.now, Seconds (i), "Wrong simulation time in replication " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (NodeList::GetNNodes (), nodes, "The replications changed the nodes of the process");
+  NS_TEST_EXPECT_MSG_EQ ((Names::Find<Node> ("replicated") == 0), true, "The replications changed the names of the process");
+}
+
+class ReplicationNetworkTestSuite : public TestSuite
+{
+public:
+  ReplicationNetworkTestSuite ();
+};
+
+ReplicationNetworkTestSuite::ReplicationNetworkTestSuite ()
+  : TestSuite ("replication-network", UNIT)
+{
+  AddTestCase (new ReplicationNetworkTestCase, TestCase::QUICK);
+}
+
+static ReplicationNetworkTestSuite replicationNetworkTestSuite;
@@ -19,6 +19,7 @@
  */
 #include "flow-id-tag.h"
 #include "ns3/log.h"
+#include "ns3/replication.h"
 
 NS_LOG_COMPONENT_DEFINE ("FlowIdTag");
 
@@ -95,6 +96,16 @@ FlowIdTag::AllocateFlowId (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   static uint32_t nextFlowId = 1;
+  if (Replication::IsActive ())
+    {
+      // the flows of the replication run by the calling thread
+      static __thread uint64_t replicationFlowId = 0;
+      if (replicationFlowId == 0)
+        {
+          Replication::ResetAtExit (&replicationFlowId);
+        }
+      return ++replicationFlowId;
+    }
   uint32_t flowId = nextFlowId;
   nextFlowId++;
   return flowId;
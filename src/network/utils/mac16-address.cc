@@ -22,6 +22,7 @@
 #include "ns3/address.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/replication.h"
 #include <iomanip>
 #include <iostream>
 #include <cstring>
@@ -135,8 +136,22 @@ Mac16Address
 Mac16Address::Allocate (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static uint64_t id = 0;
-  id++;
+  static uint64_t globalId = 0;
+  // the addresses of the replication run by the calling thread
+  static __thread uint64_t replicationId = 0;
+  uint64_t id;
+  if (Replication::IsActive ())
+    {
+      if (replicationId == 0)
+        {
+          Replication::ResetAtExit (&replicationId);
+        }
+      id = ++replicationId;
+    }
+  else
+    {
+      id = ++globalId;
+    }
   Mac16Address address;
   address.m_address[0] = (id >> 8) & 0xff;
   address.m_address[1] = (id >> 0) & 0xff;
@@ -21,6 +21,7 @@
 #include "ns3/address.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/replication.h"
 #include <iomanip>
 #include <iostream>
 #include <cstring>
@@ -130,8 +131,22 @@ Mac48Address
 Mac48Address::Allocate (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static uint64_t id = 0;
-  id++;
+  static uint64_t globalId = 0;
+  // the addresses of the replication run by the calling thread
+  static __thread uint64_t replicationId = 0;
+  uint64_t id;
+  if (Replication::IsActive ())
+    {
+      if (replicationId == 0)
+        {
+          Replication::ResetAtExit (&replicationId);
+        }
+      id = ++replicationId;
+    }
+  else
+    {
+      id = ++globalId;
+    }
   Mac48Address address;
   address.m_address[0] = (id >> 40) & 0xff;
   address.m_address[1] = (id >> 32) & 0xff;
@@ -270,6 +285,18 @@ AsInt (std::string v)
   return retval;
 }
 
+size_t Mac48AddressHash::operator() (Mac48Address const &x) const
+{
+  uint8_t buffer[6];
+  x.CopyTo (buffer);
+  size_t hash = 0;
+  for (uint8_t i = 0; i < 6; ++i)
+    {
+      hash = hash * 31 + buffer[i];
+    }
+  return hash;
+}
+
 std::istream& operator>> (std::istream& is, Mac48Address & address)
 {
   std::string v;
@@ -21,6 +21,7 @@
 #include "ns3/address.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/replication.h"
 #include <iomanip>
 #include <iostream>
 #include <cstring>
@@ -132,8 +133,22 @@ Mac64Address
 Mac64Address::Allocate (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static uint64_t id = 0;
-  id++;
+  static uint64_t globalId = 0;
+  // the addresses of the replication run by the calling thread
+  static __thread uint64_t replicationId = 0;
+  uint64_t id;
+  if (Replication::IsActive ())
+    {
+      if (replicationId == 0)
+        {
+          Replication::ResetAtExit (&replicationId);
+        }
+      id = ++replicationId;
+    }
+  else
+    {
+      id = ++globalId;
+    }
   Mac64Address address;
   address.m_address[0] = (id >> 56) & 0xff;
   address.m_address[1] = (id >> 48) & 0xff;
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-partition-helper.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/simulator.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+#include <set>
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedPartitionHelper");
+
+namespace ns3 {
+
+void
+MultithreadedPartitionHelper::Assign (Ptr<Node> node, uint32_t partition) const
+{
+  NS_LOG_FUNCTION (this << node << partition);
+  MultithreadedSimulatorImpl::SetPartition (node->GetId (), partition);
+}
+
+void
+MultithreadedPartitionHelper::Assign (NodeContainer c, uint32_t partition) const
+{
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Assign (*i, partition);
+    }
+}
+
+void
+MultithreadedPartitionHelper::AssignBlocks (NodeContainer c, uint32_t nPartitions) const
+{
+  NS_LOG_FUNCTION (this << nPartitions);
+  NS_ASSERT (nPartitions > 0);
+  uint32_t n = c.GetN ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Assign (c.Get (i), static_cast<uint64_t> (i) * nPartitions / n);
+    }
+}
+
+Time
+MultithreadedPartitionHelper::ComputeLookahead (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Time lookahead = Simulator::GetMaximumSimulationTime ();
+  std::set<uint32_t> channels;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      for (uint32_t j = 0; j < node->GetNDevices (); j++)
+        {
+          Ptr<Channel> channel = node->GetDevice (j)->GetChannel ();
+          if (channel == 0 || !channels.insert (channel->GetId ()).second)
+            {
+              continue;
+            }
+          uint32_t partition = MultithreadedSimulatorImpl::GetPartition (node->GetId ());
+          bool crossing = false;
+          for (uint32_t k = 0; k < channel->GetNDevices (); k++)
+            {
+              Ptr<Node> peer = channel->GetDevice (k)->GetNode ();
+              if (MultithreadedSimulatorImpl::GetPartition (peer->GetId ()) != partition)
+                {
+                  crossing = true;
+                  break;
+                }
+            }
+          if (!crossing)
+            {
+              continue;
+            }
+          if (DynamicCast<PointToPointChannel> (channel) == 0)
+            {
+              NS_FATAL_ERROR ("Channel " << channel->GetInstanceTypeId ().GetName ()
+                              << " connects two partitions but is not a point-to-point channel");
+            }
+          TimeValue delay;
+          channel->GetAttribute ("Delay", delay);
+          if (!delay.Get ().IsStrictlyPositive ())
+            {
+              NS_FATAL_ERROR ("Channel " << channel->GetId ()
+                              << " connects two partitions with a null delay");
+            }
+          lookahead = Min (lookahead, delay.Get ());
+        }
+    }
+  NS_LOG_LOGIC ("lookahead " << lookahead);
+  return lookahead;
+}
+
+void
+MultithreadedPartitionHelper::Install (void) const
+{
+  NS_LOG_FUNCTION (this);
+  MultithreadedSimulatorImpl::SetLookahead (ComputeLookahead ());
+}
+
+} // namespace ns3
@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_PARTITION_HELPER_H
+#define MULTITHREADED_PARTITION_HELPER_H
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \brief Partition the nodes of a topology for ns3::MultithreadedSimulatorImpl.
+ *
+ * The nodes are assigned to partitions, then Install computes the
+ * lookahead of the simulation from the links which connect different
+ * partitions. Such links must be point-to-point links, the only channels
+ * which hand their packets over to another partition safely (see
+ * PointToPointChannel): the other channels must only connect nodes of
+ * the same partition.
+ */
+class MultithreadedPartitionHelper
+{
+public:
+  /**
+   * \param node the node to assign
+   * \param partition the partition which runs the events of the node
+   */
+  void Assign (Ptr<Node> node, uint32_t partition) const;
+  /**
+   * \param c the nodes to assign
+   * \param partition the partition which runs the events of these nodes
+   */
+  void Assign (NodeContainer c, uint32_t partition) const;
+  /**
+   * \param c the nodes to assign
+   * \param nPartitions the number of partitions
+   *
+   * Split the nodes in nPartitions blocks of consecutive nodes of the
+   * container, which keeps neighbours in the same partition for the
+   * topologies built row by row.
+   */
+  void AssignBlocks (NodeContainer c, uint32_t nPartitions) const;
+  /**
+   * \returns the smallest delay of the channels between two nodes of
+   *          different partitions
+   *
+   * This is fatal if such a channel is not a PointToPointChannel or has
+   * a null delay.
+   */
+  Time ComputeLookahead (void) const;
+  /**
+   * Set the lookahead of the simulator from ComputeLookahead. This must
+   * be called once the topology is built and before Simulator::Run.
+   */
+  void Install (void) const;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_PARTITION_HELPER_H */
@@ -225,7 +225,25 @@ NetDeviceContainer
 PointToPointHelper::Install (Ptr<Node> a, Ptr<Node> b)
 {
   NetDeviceContainer container;
+  InstallLink (a, b, container);
+  return container;
+}
 
+NetDeviceContainer 
+PointToPointHelper::InstallLinks (const NodeContainer &a, const NodeContainer &b)
+{
+  NS_ASSERT (a.GetN () == b.GetN ());
+  NetDeviceContainer container;
+  for (uint32_t i = 0; i < a.GetN (); i++)
+    {
+      InstallLink (a.Get (i), b.Get (i), container);
+    }
+  return container;
+}
+
+void
+PointToPointHelper::InstallLink (Ptr<Node> a, Ptr<Node> b, NetDeviceContainer &container)
+{
   Ptr<PointToPointNetDevice> devA = m_deviceFactory.Create<PointToPointNetDevice> ();
   devA->SetAddress (Mac48Address::Allocate ());
   a->AddDevice (devA);
@@ -270,8 +288,6 @@ PointToPointHelper::Install (Ptr<Node> a, Ptr<Node> b)
   devB->Attach (channel);
   container.Add (devA);
   container.Add (devB);
-
-  return container;
 }
 
 NetDeviceContainer 
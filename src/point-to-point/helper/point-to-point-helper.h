@@ -146,7 +146,28 @@ public:
    */
   NetDeviceContainer Install (std::string aNode, std::string bNode);
 
+  /**
+   * \param a the first node of each link
+   * \param b the second node of each link
+   * \returns the devices of the links, the devices of a.Get (i) and
+   *          b.Get (i) being at the indexes 2 * i and 2 * i + 1
+   *
+   * Create one link between a.Get (i) and b.Get (i) for each i, as
+   * Install (a.Get (i), b.Get (i)) would, to build a large topology
+   * without creating a NodeContainer and a NetDeviceContainer per link.
+   */
+  NetDeviceContainer InstallLinks (const NodeContainer &a, const NodeContainer &b);
+
 private:
+  /**
+   * \param a first node
+   * \param b second node
+   * \param container the container to add the devices of the link to
+   *
+   * Create the devices and the channel of a link between a and b.
+   */
+  void InstallLink (Ptr<Node> a, Ptr<Node> b, NetDeviceContainer &container);
+
   /**
    * \brief Enable pcap output the indicated net device.
    *
@@ -22,6 +22,11 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/multithreaded-simulator-impl.h"
+#endif
 
 NS_LOG_COMPONENT_DEFINE ("PointToPointChannel");
 
@@ -76,6 +81,14 @@ PointToPointChannel::Attach (Ptr<PointToPointNetDevice> device)
       m_link[1].m_dst = m_link[0].m_src;
       m_link[0].m_state = IDLE;
       m_link[1].m_state = IDLE;
+      for (uint32_t i = 0; i < N_DEVICES; i++)
+        {
+          Ptr<Node> node = m_link[i].m_dst->GetNode ();
+          if (node != 0)
+            {
+              m_link[i].m_dstNode = node->GetId ();
+            }
+        }
     }
 }
 
@@ -92,13 +105,38 @@ PointToPointChannel::TransmitStart (
   NS_ASSERT (m_link[1].m_state != INITIALIZING);
 
   uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+  Link &link = m_link[wire];
+  if (link.m_dstNode == NO_NODE)
+    {
+      // the device was attached to the channel before being added to its node
+      link.m_dstNode = link.m_dst->GetNode ()->GetId ();
+    }
+
+#ifdef HAVE_PTHREAD_H
+  if (MultithreadedSimulatorImpl::GetPartition (Simulator::GetContext ())
+      != MultithreadedSimulatorImpl::GetPartition (link.m_dstNode))
+    {
+      // The destination runs on another thread: neither the packet,
+      // whose buffers are shared by its copies, nor the reference count
+      // of the destination device may be touched by both threads.
+      uint32_t size = p->GetSerializedSize ();
+      uint8_t *buffer = new uint8_t [size];
+      p->Serialize (buffer, size);
+      Ptr<Packet> copy = Create<Packet> (buffer, size, true);
+      delete [] buffer;
+      Simulator::ScheduleWithContext (link.m_dstNode, txTime + m_delay,
+                                      &PointToPointNetDevice::Receive,
+                                      PeekPointer (link.m_dst), copy);
+      return true;
+    }
+#endif /* HAVE_PTHREAD_H */
 
-  Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
+  Simulator::ScheduleWithContext (link.m_dstNode,
                                   txTime + m_delay, &PointToPointNetDevice::Receive,
-                                  m_link[wire].m_dst, p);
+                                  link.m_dst, p);
 
   // Call the tx anim callback on the net device
-  m_txrxPointToPoint (p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
+  m_txrxPointToPoint (p, src, link.m_dst, txTime, txTime + m_delay);
   return true;
 }
 
@@ -43,6 +43,13 @@ class Packet;
  * There are two "wires" in the channel.  The first device connected gets the
  * [0] wire to transmit on.  The second device gets the [1] wire.  There is a
  * state (IDLE, TRANSMITTING) associated with each wire.
+ *
+ * When the two devices belong to different partitions of
+ * MultithreadedSimulatorImpl, which may run on different threads, the
+ * receiving device gets a copy of the packet which shares no data with the
+ * packet sent, made through Packet::Serialize. As with the distributed
+ * simulator, the tags of the packet are not carried over such a link and
+ * the TxRxPointToPoint trace source is not fired.
  */
 class PointToPointChannel : public Channel 
 {
@@ -124,6 +131,8 @@ protected:
 private:
   // Each point to point link has exactly two net devices
   static const int N_DEVICES = 2;
+  // the destination device is not on a node yet
+  static const uint32_t NO_NODE = 0xffffffff;
 
   Time          m_delay;
   int32_t       m_nDevices;
@@ -155,10 +164,13 @@ private:
   class Link
   {
 public:
-    Link() : m_state (INITIALIZING), m_src (0), m_dst (0) {}
+    Link() : m_state (INITIALIZING), m_src (0), m_dst (0), m_dstNode (NO_NODE) {}
     WireState                  m_state;
     Ptr<PointToPointNetDevice> m_src;
     Ptr<PointToPointNetDevice> m_dst;
+    // the id of the node of m_dst, so that the other partitions do not
+    // need to reference it
+    uint32_t                   m_dstNode;
   };
 
   Link    m_link[N_DEVICES];
@@ -3,6 +3,19 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/data-rate.h"
+#include "ns3/string.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/multithreaded-partition-helper.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+#include <algorithm>
+#include <vector>
+#endif
 
 using namespace ns3;
 
@@ -56,6 +69,218 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 //-----------------------------------------------------------------------------
+class PointToPointInstallLinksTest : public TestCase
+{
+public:
+  PointToPointInstallLinksTest ();
+
+  virtual void DoRun (void);
+};
+
+PointToPointInstallLinksTest::PointToPointInstallLinksTest ()
+  : TestCase ("PointToPointHelper::InstallLinks")
+{
+}
+
+void
+PointToPointInstallLinksTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  // a triangle
+  NodeContainer from (nodes.Get (0), nodes.Get (1), nodes.Get (2));
+  NodeContainer to (nodes.Get (1), nodes.Get (2), nodes.Get (0));
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  NetDeviceContainer devices = p2p.InstallLinks (from, to);
+
+  NS_TEST_ASSERT_MSG_EQ (devices.GetN (), 6, "Wrong number of devices");
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (nodes.Get (i)->GetNDevices (), 2, "Wrong number of devices on a node");
+      Ptr<NetDevice> devA = devices.Get (2 * i);
+      Ptr<NetDevice> devB = devices.Get (2 * i + 1);
+      NS_TEST_EXPECT_MSG_EQ (devA->GetNode (), from.Get (i), "Wrong node of the first device of a link");
+      NS_TEST_EXPECT_MSG_EQ (devB->GetNode (), to.Get (i), "Wrong node of the second device of a link");
+      NS_TEST_EXPECT_MSG_EQ (devA->GetChannel (), devB->GetChannel (), "The devices of a link are not connected");
+      DataRateValue rate;
+      devB->GetAttribute ("DataRate", rate);
+      NS_TEST_EXPECT_MSG_EQ (rate.Get (), DataRate ("5Mbps"), "The device attribute was not set");
+    }
+
+  Simulator::Destroy ();
+}
+//-----------------------------------------------------------------------------
+#ifdef HAVE_PTHREAD_H
+/*
+ * A ring of nodes which forward packets around the ring, each node in
+ * its own partition of MultithreadedSimulatorImpl. The packets received
+ * by each node must be the same as with the default simulator, whatever
+ * the number of threads.
+ */
+class PointToPointPartitionTest : public TestCase
+{
+public:
+  PointToPointPartitionTest ();
+
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+private:
+  // time, hops, size and origin of a received packet
+  struct Record
+  {
+    uint64_t ts;
+    uint32_t hops;
+    uint32_t size;
+    uint32_t origin;
+    bool operator < (const Record &o) const
+    {
+      if (ts != o.ts)
+        {
+          return ts < o.ts;
+        }
+      return origin < o.origin || (origin == o.origin && hops < o.hops);
+    }
+    bool operator != (const Record &o) const
+    {
+      return ts != o.ts || hops != o.hops || size != o.size || origin != o.origin;
+    }
+  };
+  typedef std::vector<std::vector<Record> > Records;
+
+  void Send (Ptr<NetDevice> device, uint32_t hops, uint32_t origin);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+  Records RunOnce (std::string simulatorType, uint32_t nThreads, uint32_t nPartitions);
+
+  static const uint32_t N_NODES = 8;
+  static const uint32_t N_HOPS = 40;
+  uint32_t m_firstNode;
+  Records m_records;
+};
+
+PointToPointPartitionTest::PointToPointPartitionTest ()
+  : TestCase ("Check the point-to-point links between the partitions of the multithreaded simulator")
+{
+}
+
+void
+PointToPointPartitionTest::Send (Ptr<NetDevice> device, uint32_t hops, uint32_t origin)
+{
+  uint8_t data[8] = { static_cast<uint8_t> (hops), static_cast<uint8_t> (origin) };
+  uint32_t size = 8 + (37 * hops + 101 * origin) % 1400;
+  Ptr<Packet> p = Create<Packet> (data, 8);
+  p->AddAtEnd (Create<Packet> (size - 8));
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointPartitionTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p,
+                                    uint16_t protocol, const Address &from)
+{
+  uint8_t data[8];
+  p->CopyData (data, 8);
+  Record record;
+  record.ts = Simulator::Now ().GetTimeStep ();
+  record.hops = data[0];
+  record.size = p->GetSize ();
+  record.origin = data[1];
+  Ptr<Node> node = device->GetNode ();
+  m_records[node->GetId () - m_firstNode].push_back (record);
+  if (record.hops < N_HOPS)
+    {
+      // forward the packet on the other link of the node
+      Send (node->GetDevice (1 - device->GetIfIndex ()), record.hops + 1, record.origin);
+    }
+  return true;
+}
+
+PointToPointPartitionTest::Records
+PointToPointPartitionTest::RunOnce (std::string simulatorType, uint32_t nThreads, uint32_t nPartitions)
+{
+  Simulator::Destroy ();
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (simulatorType));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (nThreads));
+
+  NodeContainer nodes;
+  nodes.Create (N_NODES);
+  m_firstNode = nodes.Get (0)->GetId ();
+  NodeContainer from;
+  NodeContainer to;
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      from.Add (nodes.Get (i));
+      to.Add (nodes.Get ((i + 1) % N_NODES));
+    }
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer devices = p2p.InstallLinks (from, to);
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      devices.Get (i)->SetReceiveCallback (MakeCallback (&PointToPointPartitionTest::Receive, this));
+    }
+
+  MultithreadedPartitionHelper partitions;
+  partitions.AssignBlocks (nodes, nPartitions);
+  partitions.Install ();
+
+  m_records = Records (N_NODES);
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      for (uint32_t j = 0; j < 2; j++)
+        {
+          Simulator::ScheduleWithContext (nodes.Get (i)->GetId (), MicroSeconds (10 * i),
+                                          &PointToPointPartitionTest::Send, this,
+                                          nodes.Get (i)->GetDevice (j), 0, i);
+        }
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      std::sort (m_records[i].begin (), m_records[i].end ());
+    }
+  return m_records;
+}
+
+void
+PointToPointPartitionTest::DoRun (void)
+{
+  Records reference = RunOnce ("ns3::DefaultSimulatorImpl", 1, 1);
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (reference[i].size (), 2 * (N_HOPS + 1), "Wrong number of packets received");
+    }
+
+  uint32_t runs[][2] = { { 1, 4 }, { 2, 4 }, { 4, 4 }, { 3, 8 }, { 8, 8 } };
+  for (uint32_t i = 0; i < sizeof (runs) / sizeof (runs[0]); i++)
+    {
+      Records records = RunOnce ("ns3::MultithreadedSimulatorImpl", runs[i][0], runs[i][1]);
+      for (uint32_t j = 0; j < N_NODES; j++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (records[j].size (), reference[j].size (),
+                                 "Wrong number of packets for node " << j << " with "
+                                 << runs[i][0] << " threads and " << runs[i][1] << " partitions");
+          for (uint32_t k = 0; k < records[j].size (); k++)
+            {
+              NS_TEST_ASSERT_MSG_EQ ((records[j][k] != reference[j][k]), false,
+                                     "Wrong packet received by node " << j << " with "
+                                     << runs[i][0] << " threads and " << runs[i][1] << " partitions");
+            }
+        }
+    }
+}
+
+void
+PointToPointPartitionTest::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (1));
+}
+#endif /* HAVE_PTHREAD_H */
+//-----------------------------------------------------------------------------
 class PointToPointTestSuite : public TestSuite
 {
 public:
@@ -66,6 +291,10 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointInstallLinksTest, TestCase::QUICK);
+#ifdef HAVE_PTHREAD_H
+  AddTestCase (new PointToPointPartitionTest, TestCase::QUICK);
+#endif
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite;
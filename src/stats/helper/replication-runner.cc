@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "replication-runner.h"
+#include "ns3/replication.h"
+#include "ns3/atomic-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/system-thread.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include <sstream>
+#include <unistd.h>
+
+NS_LOG_COMPONENT_DEFINE ("ReplicationRunner");
+
+namespace ns3 {
+
+ReplicationRunner::ReplicationRunner ()
+  : m_threads (1),
+    m_firstRun (0),
+    m_next (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ReplicationRunner::SetThreads (uint32_t threads)
+{
+  NS_LOG_FUNCTION (this << threads);
+  m_threads = threads;
+}
+
+void
+ReplicationRunner::DescribeExperiment (std::string experiment, std::string strategy,
+                                       std::string input, std::string description)
+{
+  NS_LOG_FUNCTION (this << experiment << strategy << input << description);
+  m_experiment = experiment;
+  m_strategy = strategy;
+  m_input = input;
+  m_description = description;
+}
+
+void
+ReplicationRunner::Run (ReplicationCallback replication, uint64_t firstRun, uint32_t replications)
+{
+  NS_LOG_FUNCTION (this << firstRun << replications);
+  NS_ASSERT_MSG (!Replication::IsActive (), "Cannot run replications from a replication");
+  m_replication = replication;
+  m_firstRun = firstRun;
+  m_collectors.clear ();
+  m_collectors.resize (replications);
+  if (replications == 0)
+    {
+      return;
+    }
+
+  // The first replication runs alone, in the calling thread: the models
+  // create some process-wide state on their first use.
+  m_next = 1;
+  RunReplication (0);
+
+  uint32_t threads = m_threads;
+  if (threads == 0)
+    {
+      long cpus = sysconf (_SC_NPROCESSORS_ONLN);
+      threads = cpus > 0 ? cpus : 1;
+    }
+  if (threads > replications - 1)
+    {
+      threads = replications - 1;
+    }
+  // the replications share the attribute accessors, checkers and
+  // callbacks of the TypeId registry
+  AtomicRefCounting::Enable ();
+  std::vector<Ptr<SystemThread> > workers;
+  for (uint32_t i = 0; i < threads; i++)
+    {
+      Ptr<SystemThread> worker = Create<SystemThread> (MakeCallback (&ReplicationRunner::Worker, this));
+      worker->Start ();
+      workers.push_back (worker);
+    }
+  for (uint32_t i = 0; i < workers.size (); i++)
+    {
+      workers[i]->Join ();
+    }
+  AtomicRefCounting::Disable ();
+  m_replication = ReplicationCallback ();
+}
+
+uint32_t
+ReplicationRunner::GetN (void) const
+{
+  return m_collectors.size ();
+}
+
+Ptr<DataCollector>
+ReplicationRunner::Get (uint32_t i) const
+{
+  NS_ASSERT (i < m_collectors.size ());
+  return m_collectors[i];
+}
+
+void
+ReplicationRunner::Output (DataOutputInterface &output)
+{
+  NS_LOG_FUNCTION (this << &output);
+  for (uint32_t i = 0; i < m_collectors.size (); i++)
+    {
+      output.Output (*m_collectors[i]);
+    }
+}
+
+void
+ReplicationRunner::Worker (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (;;)
+    {
+      uint32_t i = __sync_fetch_and_add (&m_next, 1);
+      if (i >= m_collectors.size ())
+        {
+          return;
+        }
+      RunReplication (i);
+    }
+}
+
+void
+ReplicationRunner::RunReplication (uint32_t i)
+{
+  uint64_t run = m_firstRun + i;
+  NS_LOG_FUNCTION (this << i << run);
+  Replication::Enter (run);
+  Ptr<DataCollector> collector = CreateObject<DataCollector> ();
+  std::ostringstream label;
+  label << run;
+  collector->DescribeRun (m_experiment, m_strategy, m_input, label.str (), m_description);
+  m_replication (collector);
+  Simulator::Destroy ();
+  Replication::Exit ();
+  // each replication has its own slot in the vector
+  m_collectors[i] = collector;
+}
+
+} // namespace ns3
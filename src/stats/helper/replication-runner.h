@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef REPLICATION_RUNNER_H
+#define REPLICATION_RUNNER_H
+
+#include "ns3/callback.h"
+#include "ns3/ptr.h"
+#include "ns3/data-collector.h"
+#include "ns3/data-output-interface.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief run independent replications of a simulation on several threads
+ *
+ * Each replication is a complete simulation, built and run by the
+ * replication callback in a thread of its own, with its own run number
+ * (see RngSeedManager::SetRun): the Simulator, the nodes, the channels,
+ * the Config namespace, Names and the address allocators of a
+ * replication are private to it (see Replication). The process, the
+ * TypeId registry and the attribute defaults are set up once for all
+ * the replications.
+ *
+ * \code
+ *   void
+ *   RunOne (Ptr<DataCollector> collector)
+ *   {
+ *     NodeContainer nodes;
+ *     nodes.Create (10);
+ *     ...
+ *     Ptr<PacketCounterCalculator> received = CreateObject<PacketCounterCalculator> ();
+ *     received->SetKey ("received");
+ *     collector->AddDataCalculator (received);
+ *     ...
+ *     Simulator::Run ();
+ *   }
+ *
+ *   ReplicationRunner runner;
+ *   runner.SetThreads (8);
+ *   runner.DescribeExperiment ("red", "min-th=5", "dumbbell");
+ *   runner.Run (MakeCallback (&RunOne), 1, 30);
+ *   Ptr<OmnetDataOutput> output = CreateObject<OmnetDataOutput> ();
+ *   runner.Output (*output);
+ * \endcode
+ *
+ * Each replication fills its own DataCollector, labeled with the
+ * description of the experiment and with its run number, so the results
+ * of all the replications are written through the same output, one run
+ * after the other, in the order of the run numbers.
+ *
+ * The first replication runs alone, so that the process-wide state which
+ * the models create on their first use, such as the Wi-Fi modes, exists
+ * before the other replications start. The replication callback must
+ * not modify the process-wide state: the attribute defaults
+ * (Config::SetDefault) and the global values other than RngRun and
+ * RngSeed. The log messages of concurrent replications are interleaved
+ * and not prefixed by their simulation time.
+ */
+class ReplicationRunner
+{
+public:
+  /**
+   * The callback which builds and runs one replication, and stores its
+   * results in the collector. Simulator::Destroy is called by the runner
+   * once the callback returns.
+   */
+  typedef Callback<void, Ptr<DataCollector> > ReplicationCallback;
+
+  ReplicationRunner ();
+
+  /**
+   * \param threads the number of replications which run at the same
+   *        time, or zero for the number of processors. The default is
+   *        one, that is the replications run one after the other.
+   */
+  void SetThreads (uint32_t threads);
+  /**
+   * \param experiment the experiment label of the collectors
+   * \param strategy the strategy label of the collectors
+   * \param input the input label of the collectors
+   * \param description the description of the collectors
+   *
+   * See DataCollector::DescribeRun: the run label of each collector is
+   * its run number.
+   */
+  void DescribeExperiment (std::string experiment, std::string strategy,
+                           std::string input, std::string description = "");
+  /**
+   * \param replication the callback which builds and runs a replication
+   * \param firstRun the run number of the first replication
+   * \param replications the number of replications, whose run numbers
+   *        follow firstRun
+   *
+   * Return once all the replications ended. Must not be called by a
+   * replication.
+   */
+  void Run (ReplicationCallback replication, uint64_t firstRun, uint32_t replications);
+  /**
+   * \returns the number of replications of the last call to Run
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param i the index of a replication, in the order of the run numbers
+   * \returns the results of the replication
+   */
+  Ptr<DataCollector> Get (uint32_t i) const;
+  /**
+   * \param output the output of the results
+   *
+   * Write the results of all the replications, in the order of the run
+   * numbers.
+   */
+  void Output (DataOutputInterface &output);
+
+private:
+  void Worker (void);
+  void RunReplication (uint32_t i);
+
+  uint32_t m_threads;
+  std::string m_experiment;
+  std::string m_strategy;
+  std::string m_input;
+  std::string m_description;
+
+  ReplicationCallback m_replication;
+  uint64_t m_firstRun;
+  // the next replication to start, shared by the workers
+  uint32_t m_next;
+  std::vector<Ptr<DataCollector> > m_collectors;
+};
+
+} // namespace ns3
+
+#endif /* REPLICATION_RUNNER_H */
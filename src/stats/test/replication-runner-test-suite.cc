@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/replication-runner.h"
+#include "ns3/basic-data-calculators.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include <sstream>
+
+using namespace ns3;
+
+namespace {
+
+void
+Sample (Ptr<UniformRandomVariable> random, Ptr<MinMaxAvgTotalCalculator<double> > values,
+        uint32_t left)
+{
+  values->Update (Simulator::Now ().GetSeconds ());
+  if (left > 0)
+    {
+      Simulator::Schedule (Seconds (random->GetValue (0, 1)), &Sample, random, values, left - 1);
+    }
+}
+
+/**
+ * A replication: the sum of the times of 1000 events spaced by random
+ * delays.
+ */
+void
+RunReplication (Ptr<DataCollector> collector)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  // the automatic stream indices of the main simulation depend on the
+  // other tests
+  random->SetStream (1);
+  Ptr<MinMaxAvgTotalCalculator<double> > values = CreateObject<MinMaxAvgTotalCalculator<double> > ();
+  values->SetKey ("times");
+  collector->AddDataCalculator (values);
+  std::ostringstream run;
+  run << RngSeedManager::GetRun ();
+  collector->AddMetadata ("run", run.str ());
+  Simulator::Schedule (Seconds (0), &Sample, random, values, 999);
+  Simulator::Run ();
+}
+
+Ptr<MinMaxAvgTotalCalculator<double> >
+GetValues (Ptr<DataCollector> collector)
+{
+  return DynamicCast<MinMaxAvgTotalCalculator<double> > (*collector->DataCalculatorBegin ());
+}
+
+} // anonymous namespace
+
+// ===========================================================================
+// The replications run in parallel give the results of separate runs
+// ===========================================================================
+class ReplicationRunnerTestCase : public TestCase
+{
+public:
+  ReplicationRunnerTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+};
+
+ReplicationRunnerTestCase::ReplicationRunnerTestCase ()
+  : TestCase ("Check that the replications run in parallel are independent and reproducible")
+{
+}
+
+void
+ReplicationRunnerTestCase::DoRun (void)
+{
+  const uint32_t n = 8;
+  const uint64_t firstRun = 3;
+
+  // the reference: one replication after the other, in the main
+  // simulation of the process
+  std::vector<double> expected;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      RngSeedManager::SetRun (firstRun + i);
+      Ptr<DataCollector> collector = CreateObject<DataCollector> ();
+      RunReplication (collector);
+      Simulator::Destroy ();
+      expected.push_back (GetValues (collector)->getSum ());
+    }
+  RngSeedManager::SetRun (1);
+
+  ReplicationRunner runner;
+  runner.SetThreads (4);
+  runner.DescribeExperiment ("experiment", "strategy", "input");
+  runner.Run (MakeCallback (&RunReplication), firstRun, n);
+
+  NS_TEST_ASSERT_MSG_EQ (runner.GetN (), n, "Wrong number of replications");
+  NS_TEST_EXPECT_MSG_EQ (RngSeedManager::GetRun (), 1, "The replications changed the run of the process");
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<DataCollector> collector = runner.Get (i);
+      std::ostringstream run;
+      run << firstRun + i;
+      NS_TEST_EXPECT_MSG_EQ (collector->GetRunLabel (), run.str (), "Wrong run label");
+      NS_TEST_EXPECT_MSG_EQ (collector->GetExperimentLabel (), "experiment", "Wrong experiment label");
+      NS_TEST_EXPECT_MSG_EQ (collector->MetadataBegin ()->second, run.str (), "Wrong run in the replication");
+      Ptr<MinMaxAvgTotalCalculator<double> > values = GetValues (collector);
+      NS_TEST_EXPECT_MSG_EQ (values->getCount (), 1000, "Missing events in replication " << i);
+      NS_TEST_EXPECT_MSG_EQ (values->getSum (), expected[i], "Replication " << i << " differs from a separate run");
+      if (i > 0)
+        {
+          NS_TEST_EXPECT_MSG_NE (values->getSum (), expected[i - 1], "Replications " << i - 1 << " and " << i << " are not independent");
+        }
+    }
+}
+
+void
+ReplicationRunnerTestCase::DoTeardown (void)
+{
+  RngSeedManager::SetRun (1);
+  Simulator::Destroy ();
+}
+
+class ReplicationRunnerTestSuite : public TestSuite
+{
+public:
+  ReplicationRunnerTestSuite ();
+};
+
+ReplicationRunnerTestSuite::ReplicationRunnerTestSuite ()
+  : TestSuite ("replication-runner", UNIT)
+{
+  AddTestCase (new ReplicationRunnerTestCase, TestCase::QUICK);
+}
+
+static ReplicationRunnerTestSuite replicationRunnerTestSuite;
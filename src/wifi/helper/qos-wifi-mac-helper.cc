@@ -21,6 +21,7 @@
 #include "ns3/msdu-aggregator.h"
 #include "ns3/wifi-mac.h"
 #include "ns3/edca-txop-n.h"
+#include "ns3/wifi-mac-queue.h"
 #include "ns3/pointer.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
@@ -112,6 +113,34 @@ QosWifiMacHelper::SetBlockAckInactivityTimeoutForAc (enum AcIndex ac, uint16_t t
   m_bAckInactivityTimeouts[ac] = timeout;
 }
 
+void
+QosWifiMacHelper::SetQueueForAc (AcIndex ac, std::string type,
+                                 std::string n0, const AttributeValue &v0,
+                                 std::string n1, const AttributeValue &v1,
+                                 std::string n2, const AttributeValue &v2,
+                                 std::string n3, const AttributeValue &v3)
+{
+  ObjectFactory &factory = m_queues[ac];
+  factory.SetTypeId (type);
+  factory.Set (n0, v0);
+  factory.Set (n1, v1);
+  factory.Set (n2, v2);
+  factory.Set (n3, v3);
+}
+
+void
+QosWifiMacHelper::SetQueueAttribute (AcIndex ac, std::string n, const AttributeValue &v)
+{
+  std::map<AcIndex, ObjectFactory>::iterator it = m_queues.find (ac);
+  if (it == m_queues.end ())
+    {
+      ObjectFactory factory;
+      factory.SetTypeId ("ns3::WifiMacQueue");
+      it = m_queues.insert (std::make_pair (ac, factory)).first;
+    }
+  it->second.Set (n, v);
+}
+
 void
 QosWifiMacHelper::Setup (Ptr<WifiMac> mac, enum AcIndex ac, std::string dcaAttrName) const
 {
@@ -126,6 +155,11 @@ QosWifiMacHelper::Setup (Ptr<WifiMac> mac, enum AcIndex ac, std::string dcaAttrN
       Ptr<MsduAggregator> aggregator = factory.Create<MsduAggregator> ();
       edca->SetMsduAggregator (aggregator);
     }
+  std::map<AcIndex, ObjectFactory>::const_iterator queue = m_queues.find (ac);
+  if (queue != m_queues.end ())
+    {
+      edca->SetQueue (queue->second.Create<WifiMacQueue> ());
+    }
   if (m_bAckThresholds.find (ac) != m_bAckThresholds.end ())
     {
       edca->SetBlockAckThreshold (m_bAckThresholds.find (ac)->second);
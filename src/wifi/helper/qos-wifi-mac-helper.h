@@ -131,6 +131,43 @@ public:
    * \param timeout number of block of 1024 microseconds.
    */
   void SetBlockAckInactivityTimeoutForAc (enum AcIndex ac, uint16_t timeout);
+  /**
+   * Set the type and attributes of the queue used by a specific access
+   * category, e.g. ns3::WifiMacQueueRed. If this method is not called
+   * for an access category, the queue created by ns3::EdcaTxopN is kept.
+   *
+   * \param ac access category for which we are setting the queue. Possibilities
+   *  are: AC_BK, AC_BE, AC_VI, AC_VO.
+   * \param type the type of ns3::WifiMacQueue to create.
+   * \param n0 the name of the attribute to set
+   * \param v0 the value of the attribute to set
+   * \param n1 the name of the attribute to set
+   * \param v1 the value of the attribute to set
+   * \param n2 the name of the attribute to set
+   * \param v2 the value of the attribute to set
+   * \param n3 the name of the attribute to set
+   * \param v3 the value of the attribute to set
+   *
+   * All the attributes specified in this method should exist
+   * in the requested queue.
+   */
+  void SetQueueForAc (AcIndex ac, std::string type,
+                      std::string n0 = "", const AttributeValue &v0 = EmptyAttributeValue (),
+                      std::string n1 = "", const AttributeValue &v1 = EmptyAttributeValue (),
+                      std::string n2 = "", const AttributeValue &v2 = EmptyAttributeValue (),
+                      std::string n3 = "", const AttributeValue &v3 = EmptyAttributeValue ());
+  /**
+   * Set an attribute of the queue used by a specific access category,
+   * e.g. the MinTh, MaxTh or QW of a ns3::WifiMacQueueRed. If no queue
+   * type was set with SetQueueForAc for this access category, a
+   * ns3::WifiMacQueue is used.
+   *
+   * \param ac access category for which we are setting the attribute. Possibilities
+   *  are: AC_BK, AC_BE, AC_VI, AC_VO.
+   * \param n the name of the attribute to set
+   * \param v the value of the attribute to set
+   */
+  void SetQueueAttribute (AcIndex ac, std::string n, const AttributeValue &v);
 private:
   /**
    * \internal
@@ -144,6 +181,7 @@ private:
 
   ObjectFactory m_mac;
   std::map<AcIndex, ObjectFactory> m_aggregators;
+  std::map<AcIndex, ObjectFactory> m_queues;
   /*
    * Next maps contain, for every access category, the values for
    * block ack threshold and block ack inactivity timeout.
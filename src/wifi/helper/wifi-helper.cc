@@ -23,6 +23,7 @@
 #include "ns3/wifi-net-device.h"
 #include "ns3/wifi-mac.h"
 #include "ns3/regular-wifi-mac.h"
+#include "ns3/ap-wifi-mac.h"
 #include "ns3/dca-txop.h"
 #include "ns3/edca-txop-n.h"
 #include "ns3/minstrel-wifi-manager.h"
@@ -215,6 +216,12 @@ WifiHelper::AssignStreams (NetDeviceContainer c, int64_t stream)
               rmac->GetAttribute ("BK_EdcaTxopN", ptr);
               Ptr<EdcaTxopN> bk_edcaTxopN = ptr.Get<EdcaTxopN> ();
               currentStream += bk_edcaTxopN->AssignStreams (currentStream);
+
+              Ptr<ApWifiMac> apmac = DynamicCast<ApWifiMac> (rmac);
+              if (apmac)
+                {
+                  currentStream += apmac->AssignStreams (currentStream);
+                }
             }
         }
     }
@@ -60,6 +60,14 @@ ApWifiMac::GetTypeId (void)
                    MakeBooleanAccessor (&ApWifiMac::SetBeaconGeneration,
                                         &ApWifiMac::GetBeaconGeneration),
                    MakeBooleanChecker ())
+    .AddAttribute ("EnableBeaconJitter",
+                   "If true, the first beacon is sent at a random offset within "
+                   "the first BeaconInterval, so that the beacons of co-located "
+                   "APs are not all scheduled at the same time.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ApWifiMac::SetBeaconJitter,
+                                        &ApWifiMac::GetBeaconJitter),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -78,6 +86,7 @@ ApWifiMac::ApWifiMac ()
   SetTypeOfStation (AP);
 
   m_enableBeaconGeneration = false;
+  m_enableBeaconJitter = false;
 
   m_dca->SetInAp ();
 }
@@ -122,6 +131,25 @@ ApWifiMac::SetBeaconGeneration (bool enable)
   m_enableBeaconGeneration = enable;
 }
 
+void
+ApWifiMac::SetBeaconJitter (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  m_enableBeaconJitter = enable;
+  // the random variable is only created when it is used, so that the
+  // APs without jitter do not take a stream
+  if (enable && m_beaconJitter == 0)
+    {
+      m_beaconJitter = CreateObject<UniformRandomVariable> ();
+    }
+}
+
+bool
+ApWifiMac::GetBeaconJitter (void) const
+{
+  return m_enableBeaconJitter;
+}
+
 bool
 ApWifiMac::GetBeaconGeneration (void) const
 {
@@ -174,6 +202,18 @@ ApWifiMac::StartBeaconing (void)
   SendOneBeacon ();
 }
 
+int64_t
+ApWifiMac::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  if (m_beaconJitter == 0)
+    {
+      return 0;
+    }
+  m_beaconJitter->SetStream (stream);
+  return 1;
+}
+
 void
 ApWifiMac::ForwardDown (Ptr<const Packet> packet, Mac48Address from,
                         Mac48Address to)
@@ -650,7 +690,16 @@ ApWifiMac::DoInitialize (void)
   m_beaconEvent.Cancel ();
   if (m_enableBeaconGeneration)
     {
-      m_beaconEvent = Simulator::ScheduleNow (&ApWifiMac::SendOneBeacon, this);
+      if (m_enableBeaconJitter)
+        {
+          int64_t jitter = m_beaconJitter->GetInteger (0, m_beaconInterval.GetMicroSeconds () - 1);
+          NS_LOG_DEBUG ("first beacon of " << GetAddress () << " in " << jitter << "us");
+          m_beaconEvent = Simulator::Schedule (MicroSeconds (jitter), &ApWifiMac::SendOneBeacon, this);
+        }
+      else
+        {
+          m_beaconEvent = Simulator::ScheduleNow (&ApWifiMac::SendOneBeacon, this);
+        }
     }
   RegularWifiMac::DoInitialize ();
 }
@@ -26,6 +26,7 @@
 #include "ht-capabilities.h"
 #include "amsdu-subframe-header.h"
 #include "supported-rates.h"
+#include "ns3/random-variable-stream.h"
 
 namespace ns3 {
 
@@ -95,6 +96,17 @@ public:
    */
   void StartBeaconing (void);
 
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.  The jitter of the first beacon only takes a
+   * stream when EnableBeaconJitter is set.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
 private:
   virtual void Receive (Ptr<Packet> packet, const WifiMacHeader *hdr);
   virtual void TxOk (const WifiMacHeader &hdr);
@@ -121,12 +133,16 @@ private:
   SupportedRates GetSupportedRates (void) const;
   void SetBeaconGeneration (bool enable);
   bool GetBeaconGeneration (void) const;
+  void SetBeaconJitter (bool enable);
+  bool GetBeaconJitter (void) const;
   virtual void DoDispose (void);
   virtual void DoInitialize (void);
 
   Ptr<DcaTxop> m_beaconDca;
   Time m_beaconInterval;
   bool m_enableBeaconGeneration;
+  bool m_enableBeaconJitter;
+  Ptr<UniformRandomVariable> m_beaconJitter;
   EventId m_beaconEvent;
 };
 
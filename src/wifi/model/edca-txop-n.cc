@@ -22,6 +22,8 @@
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
 
 #include "edca-txop-n.h"
 #include "mac-low.h"
@@ -161,8 +163,17 @@ EdcaTxopN::GetTypeId (void)
                    MakeUintegerChecker<uint16_t> ())
     .AddAttribute ("Queue", "The WifiMacQueue object",
                    PointerValue (),
-                   MakePointerAccessor (&EdcaTxopN::GetQueue),
+                   MakePointerAccessor (&EdcaTxopN::SetQueue,
+                                        &EdcaTxopN::GetQueue),
                    MakePointerChecker<WifiMacQueue> ())
+    .AddTraceSource ("Enqueue", "A packet has been accepted by the queue of this access category.",
+                     MakeTraceSourceAccessor (&EdcaTxopN::m_enqueueTrace))
+    .AddTraceSource ("Drop", "A packet has been dropped because the queue of this access category was full.",
+                     MakeTraceSourceAccessor (&EdcaTxopN::m_dropTrace))
+    .AddTraceSource ("Expire", "A packet has stayed longer than MaxDelay in the queue of this access category.",
+                     MakeTraceSourceAccessor (&EdcaTxopN::m_expireTrace))
+    .AddTraceSource ("Sojourn", "Time spent in the queue by a packet dequeued for transmission.",
+                     MakeTraceSourceAccessor (&EdcaTxopN::m_sojournTrace))
   ;
   return tid;
 }
@@ -177,15 +188,14 @@ EdcaTxopN::EdcaTxopN ()
   m_transmissionListener = new EdcaTxopN::TransmissionListener (this);
   m_blockAckListener = new EdcaTxopN::BlockAckEventListener (this);
   m_dcf = new EdcaTxopN::Dcf (this);
-  m_queue = CreateObject<WifiMacQueue> ();
   m_rng = new RealRandomStream ();
   m_qosBlockedDestinations = new QosBlockedDestinations ();
   m_baManager = new BlockAckManager ();
-  m_baManager->SetQueue (m_queue);
   m_baManager->SetBlockAckType (m_blockAckType);
   m_baManager->SetBlockDestinationCallback (MakeCallback (&QosBlockedDestinations::Block, m_qosBlockedDestinations));
   m_baManager->SetUnblockDestinationCallback (MakeCallback (&QosBlockedDestinations::Unblock, m_qosBlockedDestinations));
-  m_baManager->SetMaxPacketDelay (m_queue->GetMaxDelay ());
+  SetQueue (CreateObject<WifiMacQueue> ());
+  ResetQueueStats ();
 }
 
 EdcaTxopN::~EdcaTxopN ()
@@ -265,6 +275,67 @@ EdcaTxopN::GetQueue () const
   return m_queue;
 }
 
+void
+EdcaTxopN::SetQueue (Ptr<WifiMacQueue> queue)
+{
+  NS_LOG_FUNCTION (this << queue);
+  NS_ASSERT (m_queue == 0 || m_queue->IsEmpty ());
+  if (m_queue != 0)
+    {
+      m_queue->TraceDisconnectWithoutContext ("WifiQueueDrop", MakeCallback (&EdcaTxopN::NotifyQueueDrop, this));
+      m_queue->TraceDisconnectWithoutContext ("WifiQueueExpire", MakeCallback (&EdcaTxopN::NotifyQueueExpire, this));
+    }
+  m_queue = queue;
+  m_queue->TraceConnectWithoutContext ("WifiQueueDrop", MakeCallback (&EdcaTxopN::NotifyQueueDrop, this));
+  m_queue->TraceConnectWithoutContext ("WifiQueueExpire", MakeCallback (&EdcaTxopN::NotifyQueueExpire, this));
+  m_baManager->SetQueue (m_queue);
+  m_baManager->SetMaxPacketDelay (m_queue->GetMaxDelay ());
+}
+
+const EdcaTxopN::QueueStats &
+EdcaTxopN::GetQueueStats (void) const
+{
+  return m_queueStats;
+}
+
+void
+EdcaTxopN::ResetQueueStats (void)
+{
+  m_queueStats.enqueued = 0;
+  m_queueStats.dropped = 0;
+  m_queueStats.expired = 0;
+  m_queueStats.dequeued = 0;
+  m_queueStats.totalSojourn = Seconds (0);
+  m_queueStats.maxSojourn = Seconds (0);
+}
+
+void
+EdcaTxopN::NotifyQueueDrop (Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+  m_queueStats.dropped++;
+  m_dropTrace (packet);
+}
+
+void
+EdcaTxopN::NotifyQueueExpire (Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+  m_queueStats.expired++;
+  m_expireTrace (packet);
+}
+
+void
+EdcaTxopN::NotifyDequeue (Time timestamp)
+{
+  NS_LOG_FUNCTION (this << timestamp);
+  Time sojourn = Simulator::Now () - timestamp;
+  m_queueStats.dequeued++;
+  m_queueStats.totalSojourn += sojourn;
+  m_queueStats.maxSojourn = Max (m_queueStats.maxSojourn, sojourn);
+  m_sojournTrace (sojourn);
+}
+
 void
 EdcaTxopN::SetMinCw (uint32_t minCw)
 {
@@ -369,6 +440,7 @@ EdcaTxopN::NotifyAccessGranted (void)
             }
           m_currentPacket = m_queue->DequeueFirstAvailable (&m_currentHdr, m_currentPacketTimestamp, m_qosBlockedDestinations);
           NS_ASSERT (m_currentPacket != 0);
+          NotifyDequeue (m_currentPacketTimestamp);
 
           uint16_t sequence = m_txMiddle->GetNextSequenceNumberfor (&m_currentHdr);
           m_currentHdr.SetSequenceNumber (sequence);
@@ -454,9 +526,11 @@ EdcaTxopN::NotifyAccessGranted (void)
                                        MapDestAddressForAggregation (peekedHdr));
               bool aggregated = false;
               bool isAmsdu = false;
+              Time peekedTimestamp;
               Ptr<const Packet> peekedPacket = m_queue->PeekByTidAndAddress (&peekedHdr, m_currentHdr.GetQosTid (),
                                                                              WifiMacHeader::ADDR1,
-                                                                             m_currentHdr.GetAddr1 ());
+                                                                             m_currentHdr.GetAddr1 (),
+                                                                             peekedTimestamp);
               while (peekedPacket != 0)
                 {
                   aggregated = m_aggregator->Aggregate (peekedPacket, currentAggregatedPacket,
@@ -466,13 +540,15 @@ EdcaTxopN::NotifyAccessGranted (void)
                     {
                       isAmsdu = true;
                       m_queue->Remove (peekedPacket);
+                      NotifyDequeue (peekedTimestamp);
                     }
                   else
                     {
                       break;
                     }
                   peekedPacket = m_queue->PeekByTidAndAddress (&peekedHdr, m_currentHdr.GetQosTid (),
-                                                               WifiMacHeader::ADDR1, m_currentHdr.GetAddr1 ());
+                                                               WifiMacHeader::ADDR1, m_currentHdr.GetAddr1 (),
+                                                               peekedTimestamp);
                 }
               if (isAmsdu)
                 {
@@ -563,7 +639,11 @@ EdcaTxopN::Queue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
   uint32_t fullPacketSize = hdr.GetSerializedSize () + packet->GetSize () + fcs.GetSerializedSize ();
   m_stationManager->PrepareForQueue (hdr.GetAddr1 (), &hdr,
                                      packet, fullPacketSize);
-  m_queue->Enqueue (packet, hdr);
+  if (m_queue->Enqueue (packet, hdr))
+    {
+      m_queueStats.enqueued++;
+      m_enqueueTrace (packet);
+    }
   StartAccessIfNeeded ();
 }
 
@@ -873,7 +953,11 @@ EdcaTxopN::PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr)
   uint32_t fullPacketSize = hdr.GetSerializedSize () + packet->GetSize () + fcs.GetSerializedSize ();
   m_stationManager->PrepareForQueue (hdr.GetAddr1 (), &hdr,
                                      packet, fullPacketSize);
-  m_queue->PushFront (packet, hdr);
+  if (m_queue->PushFront (packet, hdr))
+    {
+      m_queueStats.enqueued++;
+      m_enqueueTrace (packet);
+    }
   StartAccessIfNeeded ();
 }
 
@@ -33,6 +33,8 @@
 #include "dcf.h"
 #include "ctrl-headers.h"
 #include "block-ack-manager.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
 
 #include <map>
 #include <list>
@@ -83,6 +85,20 @@ public:
   typedef Callback <void, const WifiMacHeader&> TxOk;
   typedef Callback <void, const WifiMacHeader&> TxFailed;
 
+  /**
+   * Queueing statistics of this access category, accumulated since
+   * creation or since the last call to ResetQueueStats.
+   */
+  struct QueueStats
+  {
+    uint32_t enqueued;  //!< packets accepted by the queue
+    uint32_t dropped;   //!< packets dropped on enqueue because the queue was full
+    uint32_t expired;   //!< packets removed because they stayed longer than MaxDelay
+    uint32_t dequeued;  //!< packets taken from the queue for transmission
+    Time totalSojourn;  //!< sum of the sojourn times of the dequeued packets
+    Time maxSojourn;    //!< largest sojourn time of a dequeued packet
+  };
+
   static TypeId GetTypeId (void);
   EdcaTxopN ();
   virtual ~EdcaTxopN ();
@@ -98,6 +114,22 @@ public:
   enum TypeOfStation GetTypeOfStation (void) const;
 
   Ptr<WifiMacQueue > GetQueue () const;
+  /**
+   * Replace the queue of this access category, e.g. with a
+   * ns3::WifiMacQueueRed configured for it. Must be called before
+   * any packet is queued.
+   *
+   * \param queue the new queue
+   */
+  void SetQueue (Ptr<WifiMacQueue> queue);
+  /**
+   * \returns the queueing statistics of this access category
+   */
+  const QueueStats & GetQueueStats (void) const;
+  /**
+   * Reset the queueing statistics of this access category.
+   */
+  void ResetQueueStats (void);
   virtual void SetMinCw (uint32_t minCw);
   virtual void SetMaxCw (uint32_t maxCw);
   virtual void SetAifsn (uint32_t aifsn);
@@ -201,6 +233,12 @@ private:
    * if an established block ack agreement exists with the receiver.
    */
   void VerifyBlockAck (void);
+  /* Connected to the WifiQueueDrop trace source of m_queue. */
+  void NotifyQueueDrop (Ptr<const Packet> packet);
+  /* Connected to the WifiQueueExpire trace source of m_queue. */
+  void NotifyQueueExpire (Ptr<const Packet> packet);
+  /* Accounts for a packet queued at <i>timestamp</i> and just taken from m_queue. */
+  void NotifyDequeue (Time timestamp);
 
   AcIndex m_ac;
   class Dcf;
@@ -239,6 +277,11 @@ private:
   Time m_currentPacketTimestamp;
   uint16_t m_blockAckInactivityTimeout;
   struct Bar m_currentBar;
+  QueueStats m_queueStats;
+  TracedCallback<Ptr<const Packet> > m_enqueueTrace;
+  TracedCallback<Ptr<const Packet> > m_dropTrace;
+  TracedCallback<Ptr<const Packet> > m_expireTrace;
+  TracedCallback<Time> m_sojournTrace;
 };
 
 }  // namespace ns3
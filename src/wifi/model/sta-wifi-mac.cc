@@ -39,6 +39,8 @@
 #include "mgt-headers.h"
 #include "ht-capabilities.h"
 
+#include <algorithm>
+
 NS_LOG_COMPONENT_DEFINE ("StaWifiMac");
 
 
@@ -465,30 +467,24 @@ StaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
     }
   else if (hdr->IsBeacon ())
     {
-      MgtBeaconHeader beacon;
-      packet->RemoveHeader (beacon);
-      bool goodBeacon = false;
-      if (GetSsid ().IsBroadcast ()
-          || beacon.GetSsid ().IsEqual (GetSsid ()))
+      if ((IsWaitAssocResp () || IsAssociated ()) && hdr->GetAddr3 () != GetBssid ())
         {
-          goodBeacon = true;
+          // A beacon from another BSS cannot change our state while
+          // we are associated or associating, so do not parse it.
+          NS_LOG_LOGIC ("Beacon from another BSS: ignore");
+          return;
         }
-      SupportedRates rates = beacon.GetSupportedRates ();
-      for (uint32_t i = 0; i < m_phy->GetNBssMembershipSelectors (); i++)
-        {
-           uint32_t selector = m_phy->GetBssMembershipSelector (i);
-           if (!rates.IsSupportedRate (selector))
-             {
-                goodBeacon = false;
-             }
-         }
-      if ((IsWaitAssocResp () || IsAssociated ()) && hdr->GetAddr3 () != GetBssid ())
+      const BeaconInfo &beacon = LookupBeacon (hdr->GetAddr3 (), packet);
+      bool goodBeacon = false;
+      if (beacon.ratesOk
+          && (GetSsid ().IsBroadcast ()
+              || beacon.ssid.IsEqual (GetSsid ())))
         {
-          goodBeacon = false;
+          goodBeacon = true;
         }
       if (goodBeacon)
         {
-          Time delay = MicroSeconds (beacon.GetBeaconIntervalUs () * m_maxMissedBeacons);
+          Time delay = MicroSeconds (beacon.beaconIntervalUs * m_maxMissedBeacons);
           RestartBeaconWatchdog (delay);
           SetBssid (hdr->GetAddr3 ());
         }
@@ -597,6 +593,66 @@ StaWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
   RegularWifiMac::Receive (packet, hdr);
 }
 
+const StaWifiMac::BeaconInfo &
+StaWifiMac::LookupBeacon (Mac48Address bssid, Ptr<Packet> packet)
+{
+  NS_LOG_FUNCTION (this << bssid << packet);
+  // The first 8 bytes of the beacon body hold the timestamp, which
+  // changes in every beacon and is not used by the STA.
+  static const uint32_t timestampSize = 8;
+  uint32_t size = packet->GetSize ();
+  m_beaconScratch.resize (size);
+  if (size > 0)
+    {
+      packet->CopyData (&m_beaconScratch[0], size);
+    }
+  BeaconCache::iterator it = m_beaconCache.find (bssid);
+  if (it == m_beaconCache.end ())
+    {
+      if (m_beaconCache.size () >= MAX_CACHED_BEACONS)
+        {
+          BeaconCache::iterator oldest = m_beaconCache.begin ();
+          for (BeaconCache::iterator i = m_beaconCache.begin (); i != m_beaconCache.end (); ++i)
+            {
+              if (i->second.lastReceived < oldest->second.lastReceived)
+                {
+                  oldest = i;
+                }
+            }
+          NS_LOG_LOGIC ("Forget the beacon of " << oldest->first);
+          m_beaconCache.erase (oldest);
+        }
+      it = m_beaconCache.insert (std::make_pair (bssid, BeaconInfo ())).first;
+    }
+  BeaconInfo &info = it->second;
+  info.lastReceived = Simulator::Now ();
+  if (size > timestampSize
+      && info.body.size () == size
+      && std::equal (m_beaconScratch.begin () + timestampSize, m_beaconScratch.end (),
+                     info.body.begin () + timestampSize))
+    {
+      NS_LOG_LOGIC ("Beacon from " << bssid << " unchanged");
+      return info;
+    }
+
+  MgtBeaconHeader beacon;
+  packet->RemoveHeader (beacon);
+  info.body.swap (m_beaconScratch);
+  info.ssid = beacon.GetSsid ();
+  info.beaconIntervalUs = beacon.GetBeaconIntervalUs ();
+  info.ratesOk = true;
+  SupportedRates rates = beacon.GetSupportedRates ();
+  for (uint32_t i = 0; i < m_phy->GetNBssMembershipSelectors (); i++)
+    {
+      uint32_t selector = m_phy->GetBssMembershipSelector (i);
+      if (!rates.IsSupportedRate (selector))
+        {
+          info.ratesOk = false;
+        }
+    }
+  return info;
+}
+
 SupportedRates
 StaWifiMac::GetSupportedRates (void) const
 {
@@ -28,6 +28,9 @@
 #include "ns3/packet.h"
 #include "ns3/traced-callback.h"
 
+#include <map>
+#include <vector>
+
 #include "supported-rates.h"
 #include "amsdu-subframe-header.h"
 
@@ -93,6 +96,28 @@ private:
     REFUSED
   };
 
+  /**
+   * The elements of the last beacon received from a given BSSID
+   * which are needed to decide whether the beacon is acceptable.
+   * The raw body (without the timestamp) is kept so that unchanged
+   * beacons can be recognized without deserializing them again.  At
+   * most MAX_CACHED_BEACONS BSSIDs are kept: the one heard least
+   * recently makes room for a new one.
+   */
+  struct BeaconInfo
+  {
+    std::vector<uint8_t> body;
+    Ssid ssid;
+    uint64_t beaconIntervalUs;
+    bool ratesOk;
+    Time lastReceived;
+  };
+  enum
+  {
+    MAX_CACHED_BEACONS = 32
+  };
+  typedef std::map<Mac48Address, BeaconInfo> BeaconCache;
+
   void SetActiveProbing (bool enable);
   bool GetActiveProbing (void) const;
   virtual void Receive (Ptr<Packet> packet, const WifiMacHeader *hdr);
@@ -107,6 +132,14 @@ private:
   void RestartBeaconWatchdog (Time delay);
   SupportedRates GetSupportedRates (void) const;
   void SetState (enum MacState value);
+  /**
+   * \param bssid the BSSID (Address3) of the received beacon.
+   * \param packet the beacon body.
+   * \returns the cached beacon information for this BSSID, parsed
+   *          again from \p packet only if the body changed since the
+   *          last beacon received from this BSSID.
+   */
+  const BeaconInfo & LookupBeacon (Mac48Address bssid, Ptr<Packet> packet);
 
   HtCapabilities GetHtCapabilities (void) const;
 
@@ -119,6 +152,8 @@ private:
   EventId m_beaconWatchdog;
   Time m_beaconWatchdogEnd;
   uint32_t m_maxMissedBeacons;
+  BeaconCache m_beaconCache;
+  std::vector<uint8_t> m_beaconScratch;
 
   TracedCallback<Mac48Address> m_assocLogger;
   TracedCallback<Mac48Address> m_deAssocLogger;
@@ -20,8 +20,8 @@
  * Author: Mirko Banchi <mk.banchi@gmail.com>
  */
 #include "ns3/assert.h"
-#include "ns3/address-utils.h"
 #include "wifi-mac-header.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -1074,31 +1074,67 @@ WifiMacHeader::GetSerializedSize (void) const
 {
   return GetSize ();
 }
+/*
+ * The header is at most 32 bytes long (data frame with four addresses
+ * and a QoS control field).  It is laid out in a local buffer and then
+ * written to (or read from) the packet buffer with a single bounded
+ * copy instead of going through the buffer iterator field by field.
+ */
+static const uint32_t WIFI_MAC_HEADER_MAX_SIZE = 2 + 2 + 6 + 6 + 6 + 2 + 6 + 2;
+
+static inline uint8_t *
+WriteLsbU16 (uint8_t *p, uint16_t data)
+{
+  p[0] = data & 0xff;
+  p[1] = (data >> 8) & 0xff;
+  return p + 2;
+}
+static inline uint8_t *
+WriteAddress (uint8_t *p, Mac48Address address)
+{
+  address.CopyTo (p);
+  return p + 6;
+}
+static inline const uint8_t *
+ReadLsbU16 (const uint8_t *p, uint16_t *data)
+{
+  *data = p[0] | (p[1] << 8);
+  return p + 2;
+}
+static inline const uint8_t *
+ReadAddress (const uint8_t *p, Mac48Address *address)
+{
+  address->CopyFrom (p);
+  return p + 6;
+}
+
 void
 WifiMacHeader::Serialize (Buffer::Iterator i) const
 {
-  i.WriteHtolsbU16 (GetFrameControl ());
-  i.WriteHtolsbU16 (m_duration);
-  WriteTo (i, m_addr1);
+  uint8_t buffer[WIFI_MAC_HEADER_MAX_SIZE];
+  uint8_t *p = buffer;
+  p = WriteLsbU16 (p, GetFrameControl ());
+  p = WriteLsbU16 (p, m_duration);
+  p = WriteAddress (p, m_addr1);
   switch (m_ctrlType)
     {
     case TYPE_MGT:
-      WriteTo (i, m_addr2);
-      WriteTo (i, m_addr3);
-      i.WriteHtolsbU16 (GetSequenceControl ());
+      p = WriteAddress (p, m_addr2);
+      p = WriteAddress (p, m_addr3);
+      p = WriteLsbU16 (p, GetSequenceControl ());
       break;
     case TYPE_CTL:
       switch (m_ctrlSubtype)
         {
         case SUBTYPE_CTL_RTS:
-          WriteTo (i, m_addr2);
+          p = WriteAddress (p, m_addr2);
           break;
         case SUBTYPE_CTL_CTS:
         case SUBTYPE_CTL_ACK:
           break;
         case SUBTYPE_CTL_BACKREQ:
         case SUBTYPE_CTL_BACKRESP:
-          WriteTo (i, m_addr2);
+          p = WriteAddress (p, m_addr2);
           break;
         default:
           //NOTREACHED
@@ -1108,16 +1144,16 @@ WifiMacHeader::Serialize (Buffer::Iterator i) const
       break;
     case TYPE_DATA:
       {
-        WriteTo (i, m_addr2);
-        WriteTo (i, m_addr3);
-        i.WriteHtolsbU16 (GetSequenceControl ());
+        p = WriteAddress (p, m_addr2);
+        p = WriteAddress (p, m_addr3);
+        p = WriteLsbU16 (p, GetSequenceControl ());
         if (m_ctrlToDs && m_ctrlFromDs)
           {
-            WriteTo (i, m_addr4);
+            p = WriteAddress (p, m_addr4);
           }
         if (m_ctrlSubtype & 0x08)
           {
-            i.WriteHtolsbU16 (GetQosControl ());
+            p = WriteLsbU16 (p, GetQosControl ());
           }
       } break;
     default:
@@ -1125,6 +1161,7 @@ WifiMacHeader::Serialize (Buffer::Iterator i) const
       NS_ASSERT (false);
       break;
     }
+  i.Write (buffer, p - buffer);
 }
 uint32_t
 WifiMacHeader::Deserialize (Buffer::Iterator start)
@@ -1132,45 +1169,93 @@ WifiMacHeader::Deserialize (Buffer::Iterator start)
   Buffer::Iterator i = start;
   uint16_t frame_control = i.ReadLsbtohU16 ();
   SetFrameControl (frame_control);
-  m_duration = i.ReadLsbtohU16 ();
-  ReadFrom (i, m_addr1);
+
+  // the number of bytes parsed below. GetSize cannot be used since it
+  // returns 0 for the reserved type and counts fields of the control
+  // wrapper frames which are not parsed: duration and addr1 are always
+  // read, whatever the type of the frame off the air.
+  uint32_t size = 2 + 6;
+  switch (m_ctrlType)
+    {
+    case TYPE_MGT:
+      size += 6 + 6 + 2;
+      break;
+    case TYPE_CTL:
+      switch (m_ctrlSubtype)
+        {
+        case SUBTYPE_CTL_RTS:
+        case SUBTYPE_CTL_BACKREQ:
+        case SUBTYPE_CTL_BACKRESP:
+          size += 6;
+          break;
+        default:
+          break;
+        }
+      break;
+    case TYPE_DATA:
+      size += 6 + 6 + 2;
+      if (m_ctrlToDs && m_ctrlFromDs)
+        {
+          size += 6;
+        }
+      if (m_ctrlSubtype & 0x08)
+        {
+          size += 2;
+        }
+      break;
+    default:
+      break;
+    }
+  uint8_t buffer[WIFI_MAC_HEADER_MAX_SIZE - 2];
+  NS_ASSERT (size <= sizeof (buffer));
+  size = std::min<uint32_t> (size, sizeof (buffer));
+  i.Read (buffer, size);
+
+  const uint8_t *p = buffer;
+  uint16_t tmp;
+  p = ReadLsbU16 (p, &m_duration);
+  p = ReadAddress (p, &m_addr1);
   switch (m_ctrlType)
     {
     case TYPE_MGT:
-      ReadFrom (i, m_addr2);
-      ReadFrom (i, m_addr3);
-      SetSequenceControl (i.ReadLsbtohU16 ());
+      p = ReadAddress (p, &m_addr2);
+      p = ReadAddress (p, &m_addr3);
+      p = ReadLsbU16 (p, &tmp);
+      SetSequenceControl (tmp);
       break;
     case TYPE_CTL:
       switch (m_ctrlSubtype)
         {
         case SUBTYPE_CTL_RTS:
-          ReadFrom (i, m_addr2);
+          p = ReadAddress (p, &m_addr2);
           break;
         case SUBTYPE_CTL_CTS:
         case SUBTYPE_CTL_ACK:
           break;
         case SUBTYPE_CTL_BACKREQ:
         case SUBTYPE_CTL_BACKRESP:
-          ReadFrom (i, m_addr2);
+          p = ReadAddress (p, &m_addr2);
           break;
         }
       break;
     case TYPE_DATA:
-      ReadFrom (i, m_addr2);
-      ReadFrom (i, m_addr3);
-      SetSequenceControl (i.ReadLsbtohU16 ());
+      p = ReadAddress (p, &m_addr2);
+      p = ReadAddress (p, &m_addr3);
+      p = ReadLsbU16 (p, &tmp);
+      SetSequenceControl (tmp);
       if (m_ctrlToDs && m_ctrlFromDs)
         {
-          ReadFrom (i, m_addr4);
+          p = ReadAddress (p, &m_addr4);
         }
       if (m_ctrlSubtype & 0x08)
         {
-          SetQosControl (i.ReadLsbtohU16 ());
+          p = ReadLsbU16 (p, &tmp);
+          SetQosControl (tmp);
         }
       break;
     }
-  return i.GetDistanceFrom (start);
+  NS_ASSERT (static_cast<uint32_t> (p - buffer) == size);
+  return 2 + size;
 }
 
 } // namespace ns3
@@ -43,6 +43,8 @@
 #include "ns3/double.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
 
 NS_LOG_COMPONENT_DEFINE ("WifiMacQueueRed");
 
@@ -54,21 +56,76 @@ TypeId WifiMacQueueRed::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::WifiMacQueueRed")
     .SetParent<WifiMacQueue> ()
-    .AddConstructor<WifiMacQueueRed> ();
+    .AddConstructor<WifiMacQueueRed> ()
+    .AddAttribute ("MeanPktSize",
+                   "Average of packet size",
+                   UintegerValue (530),
+                   MakeUintegerAccessor (&WifiMacQueueRed::m_meanPktSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("IdlePktSize",
+                   "Average packet size used during idle times. Used when m_cautions = 3",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&WifiMacQueueRed::m_idlePktSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Wait",
+                   "True for waiting between dropped packets",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&WifiMacQueueRed::m_isWait),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Gentle",
+                   "True to increases dropping probability slowly when average queue exceeds maxthresh",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&WifiMacQueueRed::m_isGentle),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MinTh",
+                   "Minimum average length threshold in bytes",
+                   DoubleValue (20 * 1024),
+                   MakeDoubleAccessor (&WifiMacQueueRed::m_minTh),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxTh",
+                   "Maximum average length threshold in bytes",
+                   DoubleValue (60 * 1024 + 512),
+                   MakeDoubleAccessor (&WifiMacQueueRed::m_maxTh),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("QueueLimit",
+                   "Queue limit in bytes",
+                   UintegerValue (100 * 1000),
+                   MakeUintegerAccessor (&WifiMacQueueRed::m_maxBytes),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("QW",
+                   "Queue weight related to the exponential weighted moving average (EWMA)",
+                   DoubleValue (0.002),
+                   MakeDoubleAccessor (&WifiMacQueueRed::m_qW),
+                   MakeDoubleChecker <double> ())
+    .AddAttribute ("LInterm",
+                   "The maximum probability of dropping a packet",
+                   DoubleValue (50),
+                   MakeDoubleAccessor (&WifiMacQueueRed::m_lInterm),
+                   MakeDoubleChecker <double> ())
+    .AddAttribute ("Ns1Compat",
+                   "NS-1 compatibility",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&WifiMacQueueRed::m_isNs1Compat),
+                   MakeBooleanChecker ())
+    .AddAttribute ("LinkBandwidth",
+                   "The RED link bandwidth",
+                   DataRateValue (DataRate ("6Mbps")),
+                   MakeDataRateAccessor (&WifiMacQueueRed::m_linkBandwidth),
+                   MakeDataRateChecker ())
+    .AddAttribute ("LinkDelay",
+                   "The RED link delay",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&WifiMacQueueRed::m_linkDelay),
+                   MakeTimeChecker ())
+  ;
 
   return tid;
 }
 
 WifiMacQueueRed::WifiMacQueueRed ()
 {
-  std::cout << "WifiMacQueueREDDDDD created" << std::endl;
-
   m_size = 0;
   m_inAp = false;
-  m_maxBytes = 100 * 1000; // incrivelmente com fila de 25 os resultados foram otimos
-  //  m_maxBytes = 25 * 100; // for grid
-
-  std::cout << "Queuesize " << m_maxBytes << std::endl;
 
   m_bytesInQueue = 0;
   m_totalDrops = 0;
@@ -82,8 +139,6 @@ WifiMacQueueRed::WifiMacQueueRed ()
 
 WifiMacQueueRed::~WifiMacQueueRed ()
 {
-  //  std::cout << "m_totalDrops = " << m_totalDrops << std::endl;
-  //  std::cout << "(RED) Real avgPktSize = " << m_totalBytes / m_totalEnqueue << std::endl;
   Flush ();
 }
 
@@ -93,13 +148,11 @@ WifiMacQueueRed::MetodoSimples()
   std::cout << "metodo simples en red" << std::endl;
 }
 
-void
+bool
 WifiMacQueueRed::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
 {
   Cleanup ();
 
-  //  std::cout << "Enqueue in RED" << std::endl;
-
   if (!m_hasRedStarted )
     {
       NS_LOG_INFO ("Initializing RED params.");
@@ -197,7 +250,7 @@ WifiMacQueueRed::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
       m_stats.unforcedDrop++;
       m_totalDrops++;
       m_wifiQueueDropTrace (packet);
-      return;
+      return false;
     }
   else if (dropType == DTYPE_FORCED)
     {
@@ -210,13 +263,9 @@ WifiMacQueueRed::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
         }
       m_totalDrops++;
       m_wifiQueueDropTrace (packet);
-      return;
+      return false;
     }
 
-  //  std::cout << "pkt size " << packet->GetSize() << std::endl;
-
-  //  if (m_inAp)
-  //    std::cout << "queue size: " << m_size << std::endl;
   Time now = Simulator::Now ();
   Ptr<Packet> aCopy = packet->Copy ();
   m_queue.push_back (Item (aCopy, hdr, now));
@@ -226,6 +275,7 @@ WifiMacQueueRed::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
   // just to calcule avgpktsize
   //  m_totalEnqueue++;
   //  m_totalBytes += packet->GetSize();
+  return true;
 }
 
 Ptr<const Packet>
@@ -233,8 +283,6 @@ WifiMacQueueRed::Dequeue (WifiMacHeader *hdr)
 {
   Cleanup ();
 
-  //  std::cout << "Dequeue in RED" << std::endl;
-
   if (m_queue.empty ())
     {
       NS_LOG_LOGIC ("Queue empty");
@@ -261,6 +309,19 @@ WifiMacQueueRed::Dequeue (WifiMacHeader *hdr)
     }
 }
 
+void
+WifiMacQueueRed::DequeueProcess (Ptr<Packet> packet)
+{
+  WifiMacQueue::DequeueProcess (packet);
+  // called once the packet left the queue: the queue becomes idle
+  // when the last packet leaves it.
+  if (m_queue.empty ())
+    {
+      m_idle = 1;
+      m_idleTime = Simulator::Now ();
+    }
+}
+
 /*
  * Note: if the link bandwidth changes in the course of the
  * simulation, the bandwidth-dependent RED parameters do not change.
@@ -277,59 +338,10 @@ WifiMacQueueRed::InitializeParams (void)
 {
   NS_LOG_FUNCTION (this);
 
-  ///////////////////////////////////////////  // Fixed params
-  uint32_t tcp_segment_size = 1000;
-  uint32_t bytes_queue_size = m_maxBytes; // default in wifi-mac-queue
-  std::string backboneLinkDataRate = "6Mbps";
-  std::string backboneLinkDelay = "0ms";
-
-  //  uint32_t meanPktSize = tcp_segment_size;
-  // avg in tests
-  uint32_t meanPktSize = 530;
-  std::string redLinkDataRate = backboneLinkDataRate;
-  std::string redLinkDelay = backboneLinkDelay;
-
-
-  //  Config::SetDefault ("ns3::RedQueue::Mode", StringValue("Bytes"));
+  // MinTh, MaxTh, QW and the other RED parameters are attributes, so
+  // that each access category can be given its own thresholds.
   m_mode = QUEUE_MODE_BYTES;
-
-  //  Config::SetDefault ("ns3::RedQueue::QueueLimit", UintegerValue (bytes_queue_size));
-  m_queueLimit = bytes_queue_size;
-
-  //  Config::SetDefault ("ns3::RedQueue::MeanPktSize", UintegerValue (meanPktSize));
-  m_meanPktSize = meanPktSize;
-
-  //  Config::SetDefault ("ns3::RedQueue::Wait", BooleanValue (true));
-  m_isWait = true;
-
-  //  Config::SetDefault ("ns3::RedQueue::Gentle", BooleanValue (true));
-  m_isGentle = true;
-
-  //  Config::SetDefault ("ns3::RedQueue::QW", DoubleValue (0.002));
-  m_qW = 0.002;
-
-  // 3 KB
-  //  Config::SetDefault ("ns3::RedQueue::MinTh", DoubleValue (3 * 1024));
-  ////  m_minTh = 3 * 1024;
-  m_minTh = 20 * 1024;
-
-  // 48.5 KB
-  //  Config::SetDefault ("ns3::RedQueue::MaxTh", DoubleValue (48 * 1024 + 512));
-  ////  m_maxTh = 48 * 1024 + 512;
-  m_maxTh = 60 * 1024 + 512;
-
-  //  Config::SetDefault ("ns3::RedQueue::LinkBandwidth", StringValue(redLinkDataRate));
-  m_linkBandwidth = DataRate(redLinkDataRate);
-
-  //Config::SetDefault ("ns3::RedQueue::LinkDelay", StringValue(redLinkDelay));
-  m_linkDelay = Seconds(0);
-
-  //  Config::SetDefault ("ns3::RedQueue::Ns1Compat", BooleanValue (true));
-  m_isNs1Compat = true;
-
-  std::cout << "linkbitrate = " << m_linkBandwidth.GetBitRate() << std::endl;
-  /////////////////////////////////////////////////////////////////
-
+  m_queueLimit = m_maxBytes;
 
   NS_ASSERT (m_minTh <= m_maxTh);
   m_stats.forcedDrop = 0;
@@ -451,7 +463,6 @@ WifiMacQueueRed::DropEarly (Ptr<const Packet> p, uint32_t qSize)
     }
 
   double u = m_uv->GetValue ();
-  //  std::cout << "m_uv = " << u << std::endl;
 
   if (m_cautious == 2)
     {
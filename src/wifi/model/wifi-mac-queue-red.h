@@ -87,8 +87,9 @@ public:
     DTYPE_UNFORCED,    // An "unforced" (random) drop
   };
 
-  void Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr);
+  bool Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr);
   Ptr<const Packet> Dequeue (WifiMacHeader *hdr);
+  virtual void DequeueProcess (Ptr<Packet> packet);
 
   // ...
   void InitializeParams (void);
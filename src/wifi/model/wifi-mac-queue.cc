@@ -65,8 +65,11 @@ WifiMacQueue::GetTypeId (void)
                    MakeTimeAccessor (&WifiMacQueue::m_maxDelay),
                    MakeTimeChecker ())
     .AddTraceSource ("WifiQueueDrop",
-                     "Drop in a wifi queue.",
+                     "A packet was dropped because the queue was full.",
                      MakeTraceSourceAccessor (&WifiMacQueue::m_wifiQueueDropTrace))
+    .AddTraceSource ("WifiQueueExpire",
+                     "A packet was removed because it stayed longer than MaxDelay in the queue.",
+                     MakeTraceSourceAccessor (&WifiMacQueue::m_wifiQueueExpireTrace))
   ;
   return tid;
 }
@@ -79,12 +82,11 @@ WifiMacQueue::WifiMacQueue ()
   std::cout << "Queuesize " << m_maxBytes << std::endl;
   m_bytesInQueue = 0;
   m_totalDrops = 0;
+  m_totalExpired = 0;
 }
 
 WifiMacQueue::~WifiMacQueue ()
 {
-  //  std::cout << "m_totalDrops = " << m_totalDrops << std::endl;
-  //  std::cout << "ecc_q = " << ecc_q << std::endl;
   Flush ();
 }
 
@@ -92,12 +94,6 @@ WifiMacQueue::~WifiMacQueue ()
 void
 WifiMacQueue::DequeueProcess(Ptr<Packet> packet)
 {
-  //  if (InAp())
-  //    std::cout << "InAp!" << std::endl;
-
-// inAp() off for mesh
-//  if (InAp())
-
   m_bytesInQueue -= packet->GetSize();
 }
 
@@ -125,43 +121,23 @@ WifiMacQueue::GetMaxDelay (void) const
   return m_maxDelay;
 }
 
-void
+bool
 WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
 {
   Cleanup ();
 
-  //  std::cout << "enqueue in default wifi-mac-queue" << std::endl;
-
-  //  std::cout << "pkt size " << packet->GetSize() << std::endl;
-
-  if (InAp()) {
-    //    std::cout << "queue size in ap " << m_bytesInQueue << std::endl;
-  }
-
   if (m_bytesInQueue + packet->GetSize () >= m_maxBytes) {
-    //    if (InAp())
-    //      std::cout << "queue full in AP" << std::endl;
     m_wifiQueueDropTrace (packet);
     m_totalDrops++;
-    return;
+    return false;
   }
 
-  // if (m_size == m_maxSize)
-  //   {
-  //     if (m_inAp)
-  //       std::cout << "queue in ap" << std::endl;
-  //     NS_ABORT_MSG("queue full");
-  //     return;
-  //   }
-
-
-  //  if (m_inAp)
-  //    std::cout << "queue size: " << m_size << std::endl;
   Time now = Simulator::Now ();
   Ptr<Packet> aCopy = packet->Copy ();
   m_queue.push_back (Item (aCopy, hdr, now));
   m_size++;
   m_bytesInQueue += packet->GetSize();
+  return true;
 }
 
 void
@@ -182,15 +158,14 @@ WifiMacQueue::Cleanup (void)
         }
       else
         {
-          //          std::cout << "erase" << std::endl;
-          m_bytesInQueue -= i->packet->GetSize();
+          Ptr<const Packet> packet = i->packet;
+          m_bytesInQueue -= packet->GetSize();
           i = m_queue.erase (i);
           n++;
+          m_wifiQueueExpireTrace (packet);
+          m_totalExpired++;
         }
     }
-  //  if (n !=0)
-  //    NS_ABORT_MSG("not used 1?");
-
   m_size -= n;
 }
 
@@ -198,7 +173,6 @@ uint32_t
 WifiMacQueue::GetBytesAvailable ()
 {
   uint32_t max_available = m_maxBytes - m_bytesInQueue;
-  //  uint32_t max_available = m_maxBytes - m_avgPktSize * m_size;
 
   if (max_available < 0 )
     max_available = 0;
@@ -226,7 +200,6 @@ Ptr<const Packet>
 WifiMacQueue::Peek (WifiMacHeader *hdr)
 {
   Cleanup ();
-  NS_ABORT_MSG ("not used by RED");
   if (!m_queue.empty ())
     {
       Item i = m_queue.front ();
@@ -240,9 +213,6 @@ Ptr<const Packet>
 WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                                       WifiMacHeader::AddressType type, Mac48Address dest)
 {
-  NS_ABORT_MSG("not used 2?");
-  NS_ABORT_MSG ("not used by RED");
-
   Cleanup ();
   Ptr<const Packet> packet = 0;
   if (!m_queue.empty ())
@@ -256,11 +226,12 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
               if (GetAddressForPacket (type, it) == dest
                   && it->hdr.GetQosTid () == tid)
                 {
-                  packet = it->packet;
+                  Ptr<Packet> item = it->packet;
                   *hdr = it->hdr;
-                  std::cout << "erase" << std::endl;
                   m_queue.erase (it);
                   m_size--;
+                  DequeueProcess (item);
+                  packet = item;
                   break;
                 }
             }
@@ -272,9 +243,17 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
 Ptr<const Packet>
 WifiMacQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                                    WifiMacHeader::AddressType type, Mac48Address dest)
+{
+  Time timestamp;
+  return PeekByTidAndAddress (hdr, tid, type, dest, timestamp);
+}
+
+Ptr<const Packet>
+WifiMacQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
+                                   WifiMacHeader::AddressType type, Mac48Address dest,
+                                   Time &timestamp)
 {
   Cleanup ();
-  NS_ABORT_MSG ("not used by RED");
   if (!m_queue.empty ())
     {
       PacketQueueI it;
@@ -287,6 +266,7 @@ WifiMacQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                   && it->hdr.GetQosTid () == tid)
                 {
                   *hdr = it->hdr;
+                  timestamp = it->tstamp;
                   return it->packet;
                 }
             }
@@ -342,29 +322,30 @@ WifiMacQueue::Remove (Ptr<const Packet> packet)
     {
       if (it->packet == packet)
         {
-          NS_ABORT_MSG("not used 3?");
-          std::cout << "erase" << std::endl;
+          Ptr<Packet> item = it->packet;
           m_queue.erase (it);
           m_size--;
+          DequeueProcess (item);
           return true;
         }
     }
   return false;
 }
 
-void
+bool
 WifiMacQueue::PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr)
 {
-    NS_ABORT_MSG("not used 4?");
   Cleanup ();
   if (m_size == m_maxSize)
     {
-      return;
+      return false;
     }
   Time now = Simulator::Now ();
   Ptr<Packet> aCopy = packet->Copy ();
   m_queue.push_front (Item (aCopy, hdr, now));
   m_size++;
+  m_bytesInQueue += packet->GetSize ();
+  return true;
 }
 
 uint32_t
@@ -396,7 +377,6 @@ WifiMacQueue::DequeueFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
                                      const QosBlockedDestinations *blockedPackets)
 {
   Cleanup ();
-  NS_ABORT_MSG ("not used by RED");
 
   Ptr<const Packet> packet = 0;
   for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
@@ -406,11 +386,11 @@ WifiMacQueue::DequeueFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
         {
           *hdr = it->hdr;
           timestamp = it->tstamp;
-          packet = it->packet;
-          DequeueProcess(it->packet);
+          Ptr<Packet> item = it->packet;
           m_queue.erase (it);
           m_size--;
-          return packet;
+          DequeueProcess(item);
+          return item;
         }
     }
   return packet;
@@ -421,7 +401,6 @@ WifiMacQueue::PeekFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
                                   const QosBlockedDestinations *blockedPackets)
 {
   Cleanup ();
-  NS_ABORT_MSG ("not used by RED");
 
   for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
     {
@@ -441,10 +420,4 @@ WifiMacQueue::InAp() {
   return m_inAp;
 }
 
-// void 
-// WifiMacQueue::MetodoSimples()
-// {
-//   std::cout << "metodo simples (droptail)" << std::endl;
-// }
-
 } // namespace ns3
@@ -62,8 +62,18 @@ public:
   uint32_t GetMaxSize (void) const;
   Time GetMaxDelay (void) const;
 
-  virtual void Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr);
-  void PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr);
+  /**
+   * \param packet the packet to queue
+   * \param hdr the header of the packet
+   * \returns true if the packet was queued, false if it was dropped
+   */
+  virtual bool Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr);
+  /**
+   * \param packet the packet to queue at the head of the queue
+   * \param hdr the header of the packet
+   * \returns true if the packet was queued, false if the queue was full
+   */
+  bool PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr);
   virtual Ptr<const Packet> Dequeue (WifiMacHeader *hdr);
   Ptr<const Packet> Peek (WifiMacHeader *hdr);
   /**
@@ -88,6 +98,15 @@ public:
                                          uint8_t tid,
                                          WifiMacHeader::AddressType type,
                                          Mac48Address addr);
+  /**
+   * Same as above, but also returns in <i>tStamp</i> the time at which the
+   * packet was queued.
+   */
+  Ptr<const Packet> PeekByTidAndAddress (WifiMacHeader *hdr,
+                                         uint8_t tid,
+                                         WifiMacHeader::AddressType type,
+                                         Mac48Address addr,
+                                         Time &tStamp);
   /**
    * If exists, removes <i>packet</i> from queue and returns true. Otherwise it
    * takes no effects and return false. Deletion of the packet is
@@ -128,8 +147,9 @@ public:
   uint32_t m_maxBytes;
   uint32_t m_bytesInQueue;
   uint32_t m_totalDrops;
+  uint32_t m_totalExpired;
   uint32_t GetBytesAvailable ();
-  void DequeueProcess(Ptr<Packet> packet);
+  virtual void DequeueProcess(Ptr<Packet> packet);
   struct Item;
 
   //private:
@@ -163,6 +183,7 @@ public:
   void Cleanup (void);
 
   TracedCallback<Ptr<const Packet> > m_wifiQueueDropTrace;
+  TracedCallback<Ptr<const Packet> > m_wifiQueueExpireTrace;
   PacketQueue m_queue;
 
   // ecc q param
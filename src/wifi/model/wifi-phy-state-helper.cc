@@ -21,6 +21,7 @@
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("WifiPhyStateHelper");
 
@@ -28,6 +29,8 @@ namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (WifiPhyStateHelper);
 
+const uint32_t WifiPhyStateHelper::STATE_HISTORY_SIZE;
+
 TypeId
 WifiPhyStateHelper::GetTypeId (void)
 {
@@ -59,7 +62,9 @@ WifiPhyStateHelper::WifiPhyStateHelper ()
     m_startRx (Seconds (0)),
     m_startCcaBusy (Seconds (0)),
     m_startSwitching (Seconds (0)),
-    m_previousStateChangeTime (Seconds (0))
+    m_previousStateChangeTime (Seconds (0)),
+    m_historyNext (0),
+    m_historySize (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -231,6 +236,34 @@ WifiPhyStateHelper::NotifySwitchingStart (Time duration)
     }
 }
 
+uint32_t
+WifiPhyStateHelper::GetStateHistorySize (void) const
+{
+  return m_historySize;
+}
+
+const WifiPhyStateHelper::StateRecord &
+WifiPhyStateHelper::GetStateHistory (uint32_t i) const
+{
+  NS_ASSERT (i < m_historySize);
+  return m_history[(m_historyNext + STATE_HISTORY_SIZE - m_historySize + i) % STATE_HISTORY_SIZE];
+}
+
+void
+WifiPhyStateHelper::LogState (Time start, Time duration, enum WifiPhy::State state)
+{
+  StateRecord &record = m_history[m_historyNext];
+  record.start = start;
+  record.duration = duration;
+  record.state = state;
+  m_historyNext = (m_historyNext + 1) % STATE_HISTORY_SIZE;
+  m_historySize = std::min (m_historySize + 1, STATE_HISTORY_SIZE);
+  if (!m_stateLogger.IsEmpty ())
+    {
+      m_stateLogger (start, duration, state);
+    }
+}
+
 void
 WifiPhyStateHelper::LogPreviousIdleAndCcaBusyStates (void)
 {
@@ -246,9 +279,9 @@ WifiPhyStateHelper::LogPreviousIdleAndCcaBusyStates (void)
       Time ccaBusyStart = Max (m_endTx, m_endRx);
       ccaBusyStart = Max (ccaBusyStart, m_startCcaBusy);
       ccaBusyStart = Max (ccaBusyStart, m_endSwitching);
-      m_stateLogger (ccaBusyStart, idleStart - ccaBusyStart, WifiPhy::CCA_BUSY);
+      LogState (ccaBusyStart, idleStart - ccaBusyStart, WifiPhy::CCA_BUSY);
     }
-  m_stateLogger (idleStart, now - idleStart, WifiPhy::IDLE);
+  LogState (idleStart, now - idleStart, WifiPhy::IDLE);
 }
 
 void
@@ -265,7 +298,7 @@ WifiPhyStateHelper::SwitchToTx (Time txDuration, Ptr<const Packet> packet, WifiM
        * as its endRx event are cancelled by the caller.
        */
       m_rxing = false;
-      m_stateLogger (m_startRx, now - m_startRx, WifiPhy::RX);
+      LogState (m_startRx, now - m_startRx, WifiPhy::RX);
       m_endRx = now;
       break;
     case WifiPhy::CCA_BUSY:
@@ -273,7 +306,7 @@ WifiPhyStateHelper::SwitchToTx (Time txDuration, Ptr<const Packet> packet, WifiM
         Time ccaStart = Max (m_endRx, m_endTx);
         ccaStart = Max (ccaStart, m_startCcaBusy);
         ccaStart = Max (ccaStart, m_endSwitching);
-        m_stateLogger (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
+        LogState (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
       } break;
     case WifiPhy::IDLE:
       LogPreviousIdleAndCcaBusyStates ();
@@ -283,7 +316,7 @@ WifiPhyStateHelper::SwitchToTx (Time txDuration, Ptr<const Packet> packet, WifiM
       NS_FATAL_ERROR ("Invalid WifiPhy state.");
       break;
     }
-  m_stateLogger (now, txDuration, WifiPhy::TX);
+  LogState (now, txDuration, WifiPhy::TX);
   m_previousStateChangeTime = now;
   m_endTx = now + txDuration;
   m_startTx = now;
@@ -305,7 +338,7 @@ WifiPhyStateHelper::SwitchToRx (Time rxDuration)
         Time ccaStart = Max (m_endRx, m_endTx);
         ccaStart = Max (ccaStart, m_startCcaBusy);
         ccaStart = Max (ccaStart, m_endSwitching);
-        m_stateLogger (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
+        LogState (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
       } break;
     case WifiPhy::SWITCHING:
     case WifiPhy::RX:
@@ -332,7 +365,7 @@ WifiPhyStateHelper::SwitchToChannelSwitching (Time switchingDuration)
        * as its endRx event are cancelled by the caller.
        */
       m_rxing = false;
-      m_stateLogger (m_startRx, now - m_startRx, WifiPhy::RX);
+      LogState (m_startRx, now - m_startRx, WifiPhy::RX);
       m_endRx = now;
       break;
     case WifiPhy::CCA_BUSY:
@@ -340,7 +373,7 @@ WifiPhyStateHelper::SwitchToChannelSwitching (Time switchingDuration)
         Time ccaStart = Max (m_endRx, m_endTx);
         ccaStart = Max (ccaStart, m_startCcaBusy);
         ccaStart = Max (ccaStart, m_endSwitching);
-        m_stateLogger (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
+        LogState (ccaStart, now - ccaStart, WifiPhy::CCA_BUSY);
       } break;
     case WifiPhy::IDLE:
       LogPreviousIdleAndCcaBusyStates ();
@@ -357,7 +390,7 @@ WifiPhyStateHelper::SwitchToChannelSwitching (Time switchingDuration)
       m_endCcaBusy = now;
     }
 
-  m_stateLogger (now, switchingDuration, WifiPhy::SWITCHING);
+  LogState (now, switchingDuration, WifiPhy::SWITCHING);
   m_previousStateChangeTime = now;
   m_startSwitching = now;
   m_endSwitching = now + switchingDuration;
@@ -395,7 +428,7 @@ WifiPhyStateHelper::DoSwitchFromRx (void)
   NS_ASSERT (m_rxing);
 
   Time now = Simulator::Now ();
-  m_stateLogger (m_startRx, now - m_startRx, WifiPhy::RX);
+  LogState (m_startRx, now - m_startRx, WifiPhy::RX);
   m_previousStateChangeTime = now;
   m_rxing = false;
 
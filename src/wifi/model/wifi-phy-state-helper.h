@@ -35,6 +35,17 @@ namespace ns3 {
 class WifiPhyStateHelper : public Object
 {
 public:
+  /**
+   * A closed interval of the PHY state machine: the PHY was in
+   * <i>state</i> from <i>start</i> for <i>duration</i>.
+   */
+  struct StateRecord
+  {
+    Time start;
+    Time duration;
+    enum WifiPhy::State state;
+  };
+
   static TypeId GetTypeId (void);
 
   WifiPhyStateHelper ();
@@ -60,11 +71,30 @@ public:
   void SwitchFromRxEndError (Ptr<const Packet> packet, double snr);
   void SwitchMaybeToCcaBusy (Time duration);
 
+  /**
+   * \returns the number of state intervals held in the history ring,
+   * at most STATE_HISTORY_SIZE.
+   *
+   * The history ring keeps the last intervals reported through the
+   * State trace source, so that the recent state of the PHY can be
+   * pulled on demand instead of being pushed to a trace sink on every
+   * transition.
+   */
+  uint32_t GetStateHistorySize (void) const;
+  /**
+   * \param i index of the record, 0 being the oldest record still held
+   * \returns the i-th state interval of the history ring
+   */
+  const StateRecord & GetStateHistory (uint32_t i) const;
+
+  static const uint32_t STATE_HISTORY_SIZE = 32;
+
   TracedCallback<Time,Time,enum WifiPhy::State> m_stateLogger;
 private:
   typedef std::vector<WifiPhyListener *> Listeners;
 
   void LogPreviousIdleAndCcaBusyStates (void);
+  void LogState (Time start, Time duration, enum WifiPhy::State state);
 
   void NotifyTxStart (Time duration);
   void NotifyWakeup (void);
@@ -86,6 +116,10 @@ private:
   Time m_startSwitching;
   Time m_previousStateChangeTime;
 
+  StateRecord m_history[STATE_HISTORY_SIZE];
+  uint32_t m_historyNext;
+  uint32_t m_historySize;
+
   Listeners m_listeners;
   TracedCallback<Ptr<const Packet>, double, WifiMode, enum WifiPreamble> m_rxOkTrace;
   TracedCallback<Ptr<const Packet>, double> m_rxErrorTrace;
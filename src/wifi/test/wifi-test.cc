@@ -23,8 +23,11 @@
 #include "ns3/wifi-net-device.h"
 #include "ns3/yans-wifi-channel.h"
 #include "ns3/adhoc-wifi-mac.h"
+#include "ns3/ap-wifi-mac.h"
+#include "ns3/sta-wifi-mac.h"
 #include "ns3/yans-wifi-phy.h"
 #include "ns3/arf-wifi-manager.h"
+#include "ns3/constant-rate-wifi-manager.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/error-rate-model.h"
@@ -33,11 +36,29 @@
 #include "ns3/node.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
+#include "ns3/address-utils.h"
+#include "ns3/buffer.h"
 #include "ns3/object-factory.h"
 #include "ns3/dca-txop.h"
 #include "ns3/mac-rx-middle.h"
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
+#include "ns3/boolean.h"
+#include "ns3/nstime.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/packet.h"
+#include "ns3/edca-txop-n.h"
+#include "ns3/wifi-mac-queue-red.h"
+#include "ns3/qos-tag.h"
+#include "ns3/qos-utils.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/qos-wifi-mac-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/ssid.h"
+#include "ns3/wifi-phy-state-helper.h"
 
 namespace ns3 {
 
@@ -433,6 +454,493 @@ Bug555TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_secondTransmissionTime, expectedSecondTransmissionTime, "The second transmission time not correct!");
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the first beacon of an AP with EnableBeaconJitter set
+ * is sent within the first beacon interval, and that a STA which caches
+ * the beacons of the AP parses them again when they change: the AP
+ * advertises another SSID than the one of the STA until it changes its
+ * SSID, and the STA must then associate.
+ */
+class BeaconJitterTestCase : public TestCase
+{
+public:
+  BeaconJitterTestCase ();
+
+  virtual void DoRun (void);
+
+private:
+  Ptr<WifiNetDevice> CreateOne (Ptr<YansWifiChannel> channel, Ptr<WifiMac> mac, Vector pos);
+  void NotifyApTxBegin (Ptr<const Packet> p);
+  void NotifyAssoc (Mac48Address bssid);
+
+  Time m_firstBeaconTime;
+  Time m_assocTime;
+  uint32_t m_nAssoc;
+};
+
+BeaconJitterTestCase::BeaconJitterTestCase ()
+  : TestCase ("Beacon jitter and beacon cache")
+{
+}
+
+void
+BeaconJitterTestCase::NotifyApTxBegin (Ptr<const Packet> p)
+{
+  if (m_firstBeaconTime.IsZero ())
+    {
+      m_firstBeaconTime = Simulator::Now ();
+    }
+}
+
+void
+BeaconJitterTestCase::NotifyAssoc (Mac48Address bssid)
+{
+  m_nAssoc++;
+  m_assocTime = Simulator::Now ();
+}
+
+Ptr<WifiNetDevice>
+BeaconJitterTestCase::CreateOne (Ptr<YansWifiChannel> channel, Ptr<WifiMac> mac, Vector pos)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+  mac->SetAddress (Mac48Address::Allocate ());
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetMobility (node);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (CreateObject<ConstantRateWifiManager> ());
+  node->AddDevice (dev);
+  return dev;
+}
+
+void
+BeaconJitterTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+
+  Ptr<ApWifiMac> apMac = CreateObject<ApWifiMac> ();
+  apMac->SetAttribute ("EnableBeaconJitter", BooleanValue (true));
+  apMac->SetAttribute ("BeaconGeneration", BooleanValue (true));
+  apMac->SetSsid (Ssid ("other"));
+  Ptr<StaWifiMac> staMac = CreateObject<StaWifiMac> ();
+  staMac->SetSsid (Ssid ("jitter"));
+
+  Ptr<WifiNetDevice> apDev = CreateOne (channel, apMac, Vector (0.0, 0.0, 0.0));
+  CreateOne (channel, staMac, Vector (5.0, 0.0, 0.0));
+  apMac->AssignStreams (1);
+
+  apDev->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&BeaconJitterTestCase::NotifyApTxBegin, this));
+  staMac->TraceConnectWithoutContext ("Assoc", MakeCallback (&BeaconJitterTestCase::NotifyAssoc, this));
+
+  m_firstBeaconTime = Seconds (0.0);
+  m_nAssoc = 0;
+
+  Simulator::Schedule (Seconds (0.5), &ApWifiMac::SetSsid, apMac, Ssid ("jitter"));
+  Simulator::Stop (Seconds (1.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_firstBeaconTime.IsStrictlyPositive (), true, "Beacon was not jittered");
+  NS_TEST_ASSERT_MSG_EQ ((m_firstBeaconTime <= apMac->GetBeaconInterval () + MilliSeconds (1)), true,
+                         "First beacon not sent within the first beacon interval");
+  NS_TEST_ASSERT_MSG_EQ (m_nAssoc, 1, "STA did not associate exactly once");
+  NS_TEST_ASSERT_MSG_EQ ((m_assocTime > Seconds (0.5)), true, "STA associated with a foreign SSID");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * \internal
+ * Check that every shape of 802.11 MAC header (management, control with
+ * and without a transmitter address, data with three and four addresses,
+ * with and without QoS control) survives a serialization round trip and
+ * occupies exactly GetSize () bytes in the packet, and that the frames
+ * which are never sent by the models (control wrapper, reserved subtypes
+ * and types) are read without overflowing.
+ */
+class WifiMacHeaderRoundTripTest : public TestCase
+{
+public:
+  WifiMacHeaderRoundTripTest ();
+
+  virtual void DoRun (void);
+private:
+  void Check (WifiMacHeader hdr);
+  void CheckRaw (uint16_t frameControl, std::string name);
+};
+
+WifiMacHeaderRoundTripTest::WifiMacHeaderRoundTripTest ()
+  : TestCase ("WifiMacHeader serialization round trip")
+{
+}
+
+void
+WifiMacHeaderRoundTripTest::Check (WifiMacHeader hdr)
+{
+  hdr.SetAddr1 (Mac48Address ("00:00:00:00:00:01"));
+  hdr.SetAddr2 (Mac48Address ("00:00:00:00:00:02"));
+  hdr.SetAddr3 (Mac48Address ("00:00:00:00:00:03"));
+  hdr.SetAddr4 (Mac48Address ("00:00:00:00:00:04"));
+  hdr.SetRawDuration (0x1234);
+
+  Ptr<Packet> packet = Create<Packet> (10);
+  packet->AddHeader (hdr);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 10 + hdr.GetSize (), "Unexpected serialized size for " << hdr.GetTypeString ());
+
+  WifiMacHeader copy;
+  uint32_t read = packet->RemoveHeader (copy);
+  NS_TEST_ASSERT_MSG_EQ (read, hdr.GetSize (), "Unexpected deserialized size for " << hdr.GetTypeString ());
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 10, "Header not fully removed for " << hdr.GetTypeString ());
+  NS_TEST_ASSERT_MSG_EQ (copy.GetType (), hdr.GetType (), "Type mismatch");
+  NS_TEST_ASSERT_MSG_EQ (copy.GetRawDuration (), hdr.GetRawDuration (), "Duration mismatch for " << hdr.GetTypeString ());
+  NS_TEST_ASSERT_MSG_EQ (copy.GetAddr1 (), hdr.GetAddr1 (), "Addr1 mismatch for " << hdr.GetTypeString ());
+  if (hdr.IsMgt () || hdr.IsData () || hdr.IsRts () || hdr.IsBlockAckReq () || hdr.IsBlockAck ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (copy.GetAddr2 (), hdr.GetAddr2 (), "Addr2 mismatch for " << hdr.GetTypeString ());
+    }
+  if (hdr.IsMgt () || hdr.IsData ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (copy.GetAddr3 (), hdr.GetAddr3 (), "Addr3 mismatch for " << hdr.GetTypeString ());
+      NS_TEST_ASSERT_MSG_EQ (copy.GetSequenceControl (), hdr.GetSequenceControl (), "Sequence control mismatch for " << hdr.GetTypeString ());
+    }
+  if (hdr.IsData () && hdr.IsToDs () && hdr.IsFromDs ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (copy.GetAddr4 (), hdr.GetAddr4 (), "Addr4 mismatch for " << hdr.GetTypeString ());
+    }
+  if (hdr.IsQosData ())
+    {
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t)copy.GetQosTid (), (uint32_t)hdr.GetQosTid (), "TID mismatch");
+      NS_TEST_ASSERT_MSG_EQ (copy.GetQosAckPolicy (), hdr.GetQosAckPolicy (), "Ack policy mismatch");
+      NS_TEST_ASSERT_MSG_EQ (copy.IsQosAmsdu (), hdr.IsQosAmsdu (), "A-MSDU bit mismatch");
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t)copy.GetQosTxopLimit (), (uint32_t)hdr.GetQosTxopLimit (), "TXOP limit mismatch");
+    }
+}
+
+void
+WifiMacHeaderRoundTripTest::CheckRaw (uint16_t frameControl, std::string name)
+{
+  // frames which are never sent by the models but may be received: only
+  // the duration and addr1 are parsed after the frame control.
+  Buffer buffer;
+  buffer.AddAtStart (40);
+  Buffer::Iterator i = buffer.Begin ();
+  i.WriteHtolsbU16 (frameControl);
+  i.WriteHtolsbU16 (0x1234);
+  WriteTo (i, Mac48Address ("00:00:00:00:00:01"));
+  for (uint32_t j = 0; j < 40 - 10; j++)
+    {
+      i.WriteU8 (0xff);
+    }
+  WifiMacHeader hdr;
+  uint32_t read = hdr.Deserialize (buffer.Begin ());
+  NS_TEST_ASSERT_MSG_EQ (read, 10, "Unexpected deserialized size for " << name);
+  NS_TEST_ASSERT_MSG_EQ (hdr.GetRawDuration (), 0x1234, "Duration mismatch for " << name);
+  NS_TEST_ASSERT_MSG_EQ (hdr.GetAddr1 (), Mac48Address ("00:00:00:00:00:01"), "Addr1 mismatch for " << name);
+}
+
+void
+WifiMacHeaderRoundTripTest::DoRun (void)
+{
+  // control wrapper: type 1, subtype 7
+  CheckRaw (0x0074, "control wrapper");
+  // reserved control subtype 3
+  CheckRaw (0x0034, "reserved control subtype");
+  // reserved type 3
+  CheckRaw (0x000c, "reserved type");
+
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_CTL_RTS);
+  Check (hdr);
+  hdr.SetType (WIFI_MAC_CTL_CTS);
+  Check (hdr);
+  hdr.SetType (WIFI_MAC_CTL_ACK);
+  Check (hdr);
+  hdr.SetType (WIFI_MAC_CTL_BACKREQ);
+  Check (hdr);
+  hdr.SetType (WIFI_MAC_CTL_BACKRESP);
+  Check (hdr);
+
+  hdr = WifiMacHeader ();
+  hdr.SetType (WIFI_MAC_MGT_BEACON);
+  hdr.SetSequenceNumber (1234);
+  hdr.SetFragmentNumber (3);
+  hdr.SetRetry ();
+  Check (hdr);
+
+  hdr = WifiMacHeader ();
+  hdr.SetType (WIFI_MAC_DATA);
+  hdr.SetDsTo ();
+  hdr.SetDsNotFrom ();
+  hdr.SetSequenceNumber (4095);
+  hdr.SetMoreFragments ();
+  Check (hdr);
+  hdr.SetDsFrom ();
+  Check (hdr);
+
+  hdr = WifiMacHeader ();
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetDsNotTo ();
+  hdr.SetDsFrom ();
+  hdr.SetSequenceNumber (17);
+  hdr.SetQosTid (5);
+  hdr.SetQosNoEosp ();
+  hdr.SetQosBlockAck ();
+  hdr.SetQosAmsdu ();
+  hdr.SetQosTxopLimit (42);
+  Check (hdr);
+  hdr.SetDsTo ();
+  Check (hdr);
+  NS_TEST_ASSERT_MSG_EQ (hdr.GetSize (), 32, "Largest header shape should be 32 bytes");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * \internal
+ * Give the voice access category a small ns3::WifiMacQueueRed and an
+ * A-MSDU aggregator through QosWifiMacHelper, send a burst of voice
+ * packets and check the per-AC queue statistics kept by ns3::EdcaTxopN.
+ */
+class PerAcQueueTestCase : public TestCase
+{
+public:
+  PerAcQueueTestCase ();
+
+  virtual void DoRun (void);
+private:
+  void SendBurst (Ptr<NetDevice> device, Mac48Address to, uint32_t n);
+  void NotifyDrop (Ptr<const Packet> packet);
+  void NotifyExpire (Ptr<const Packet> packet);
+  void Expire (Ptr<WifiMacQueue> queue);
+
+  uint32_t m_drops;
+  uint32_t m_expired;
+};
+
+PerAcQueueTestCase::PerAcQueueTestCase ()
+  : TestCase ("Per access category queues and queue statistics"),
+    m_drops (0),
+    m_expired (0)
+{
+}
+
+void
+PerAcQueueTestCase::NotifyDrop (Ptr<const Packet> packet)
+{
+  m_drops++;
+}
+
+void
+PerAcQueueTestCase::NotifyExpire (Ptr<const Packet> packet)
+{
+  m_expired++;
+}
+
+void
+PerAcQueueTestCase::Expire (Ptr<WifiMacQueue> queue)
+{
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "The packet should have expired");
+}
+
+void
+PerAcQueueTestCase::SendBurst (Ptr<NetDevice> device, Mac48Address to, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> packet = Create<Packet> (1000);
+      QosTag tag (6);
+      packet->AddPacketTag (tag);
+      device->Send (packet, to, 1);
+    }
+}
+
+void
+PerAcQueueTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiHelper wifi = WifiHelper::Default ();
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"));
+  Ssid ssid = Ssid ("per-ac");
+  QosWifiMacHelper mac = QosWifiMacHelper::Default ();
+  mac.SetType ("ns3::StaWifiMac",
+               "Ssid", SsidValue (ssid),
+               "ActiveProbing", BooleanValue (false));
+  mac.SetQueueForAc (AC_VO, "ns3::WifiMacQueueRed",
+                     "QueueLimit", UintegerValue (3000));
+  mac.SetQueueAttribute (AC_VO, "MinTh", DoubleValue (1000));
+  mac.SetQueueAttribute (AC_VO, "MaxTh", DoubleValue (2000));
+  // aggregated packets leave the queue through another path
+  mac.SetMsduAggregatorForAc (AC_VO, "ns3::MsduStandardAggregator",
+                              "MaxAmsduSize", UintegerValue (3839));
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes.Get (0));
+  mac.SetType ("ns3::ApWifiMac",
+               "Ssid", SsidValue (ssid));
+  devices.Add (wifi.Install (phy, mac, nodes.Get (1)));
+
+  MobilityHelper mobility;
+  mobility.Install (nodes);
+
+  Ptr<WifiMac> senderMac = DynamicCast<WifiNetDevice> (devices.Get (0))->GetMac ();
+  PointerValue ptr;
+  senderMac->GetAttribute ("VO_EdcaTxopN", ptr);
+  Ptr<EdcaTxopN> vo = ptr.Get<EdcaTxopN> ();
+  senderMac->GetAttribute ("BE_EdcaTxopN", ptr);
+  Ptr<EdcaTxopN> be = ptr.Get<EdcaTxopN> ();
+  Ptr<WifiMacQueueRed> red = DynamicCast<WifiMacQueueRed> (vo->GetQueue ());
+  NS_TEST_ASSERT_MSG_NE (red, 0, "Voice queue is not a WifiMacQueueRed");
+  DoubleValue minTh;
+  red->GetAttribute ("MinTh", minTh);
+  NS_TEST_ASSERT_MSG_EQ_TOL (minTh.Get (), 1000, 1e-9, "MinTh not set on the voice queue");
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<WifiMacQueueRed> (be->GetQueue ()), 0, "Best effort queue should be left alone");
+
+  uint32_t nPackets = 10;
+  Mac48Address to = Mac48Address::ConvertFrom (devices.Get (1)->GetAddress ());
+  Simulator::Schedule (Seconds (1.0), &PerAcQueueTestCase::SendBurst, this, devices.Get (0), to, nPackets);
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  const EdcaTxopN::QueueStats &stats = vo->GetQueueStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.enqueued + stats.dropped, nPackets, "Every packet is either enqueued or dropped");
+  NS_TEST_ASSERT_MSG_GT (stats.dropped, 0, "The 3000 byte voice queue should have dropped part of the burst");
+  NS_TEST_ASSERT_MSG_EQ (stats.dequeued, stats.enqueued, "Every enqueued packet should have been sent");
+  NS_TEST_ASSERT_MSG_EQ (stats.maxSojourn.IsStrictlyPositive (), true, "Packets of a burst have to wait");
+  NS_TEST_ASSERT_MSG_EQ ((stats.totalSojourn >= stats.maxSojourn), true, "Inconsistent sojourn statistics");
+  NS_TEST_ASSERT_MSG_EQ (be->GetQueueStats ().enqueued, 0, "No best effort traffic was sent");
+  NS_TEST_ASSERT_MSG_EQ (stats.expired, 0, "No packet should have expired");
+
+  // a packet which stays longer than MaxDelay expires, it is not a drop
+  Ptr<WifiMacQueue> queue = CreateObject<WifiMacQueue> ();
+  queue->SetMaxDelay (MilliSeconds (1));
+  queue->TraceConnectWithoutContext ("WifiQueueDrop", MakeCallback (&PerAcQueueTestCase::NotifyDrop, this));
+  queue->TraceConnectWithoutContext ("WifiQueueExpire", MakeCallback (&PerAcQueueTestCase::NotifyExpire, this));
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_DATA);
+  NS_TEST_ASSERT_MSG_EQ (queue->Enqueue (Create<Packet> (100), hdr), true, "The packet should have been queued");
+  Simulator::Schedule (MilliSeconds (2), &PerAcQueueTestCase::Expire, this, queue);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (m_expired, 1, "The expired packet was not traced");
+  NS_TEST_ASSERT_MSG_EQ (queue->m_totalExpired, 1, "The expired packet was not counted");
+  NS_TEST_ASSERT_MSG_EQ (m_drops, 0, "The expired packet should not be traced as a drop");
+  NS_TEST_ASSERT_MSG_EQ (queue->m_totalDrops, 0, "The expired packet should not be counted as a drop");
+  NS_TEST_ASSERT_MSG_EQ (queue->m_bytesInQueue, 0, "The expired packet is still accounted in the queue");
+
+  // every way out of the queue keeps the byte count
+  Mac48Address to1 = Mac48Address ("00:00:00:00:00:01");
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetAddr1 (to1);
+  hdr.SetQosTid (6);
+  queue = CreateObject<WifiMacQueue> ();
+  queue->Enqueue (Create<Packet> (100), hdr);
+  queue->Enqueue (Create<Packet> (200), hdr);
+  NS_TEST_ASSERT_MSG_EQ (queue->PushFront (Create<Packet> (400), hdr), true, "The packet should have been queued");
+  NS_TEST_ASSERT_MSG_EQ (queue->m_bytesInQueue, 700, "PushFront does not count the bytes");
+  WifiMacHeader peekedHdr;
+  NS_TEST_ASSERT_MSG_EQ (queue->Peek (&peekedHdr)->GetSize (), 400, "PushFront did not queue at the head");
+  Time timestamp;
+  Ptr<const Packet> peeked = queue->PeekByTidAndAddress (&peekedHdr, 6, WifiMacHeader::ADDR1, to1, timestamp);
+  NS_TEST_ASSERT_MSG_EQ (queue->Remove (peeked), true, "The peeked packet should have been removed");
+  NS_TEST_ASSERT_MSG_EQ (queue->m_bytesInQueue, 300, "Remove does not count the bytes");
+  peeked = queue->DequeueByTidAndAddress (&peekedHdr, 6, WifiMacHeader::ADDR1, to1);
+  NS_TEST_ASSERT_MSG_EQ (peeked->GetSize (), 100, "DequeueByTidAndAddress should return the oldest matching packet");
+  NS_TEST_ASSERT_MSG_EQ (queue->m_bytesInQueue, 200, "DequeueByTidAndAddress does not count the bytes");
+  queue->Dequeue (&peekedHdr);
+  NS_TEST_ASSERT_MSG_EQ (queue->m_bytesInQueue, 0, "Dequeue does not count the bytes");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * \internal
+ * Check that the state history ring of WifiPhyStateHelper holds the
+ * same intervals as those reported by its State trace source.
+ */
+class PhyStateHistoryTestCase : public TestCase
+{
+public:
+  PhyStateHistoryTestCase ();
+
+  virtual void DoRun (void);
+private:
+  void LogState (Time start, Time duration, enum WifiPhy::State state);
+  void SwitchToTx (Ptr<WifiPhyStateHelper> helper, Time duration);
+
+  std::vector<WifiPhyStateHelper::StateRecord> m_traced;
+};
+
+PhyStateHistoryTestCase::PhyStateHistoryTestCase ()
+  : TestCase ("WifiPhyStateHelper state history")
+{
+}
+
+void
+PhyStateHistoryTestCase::LogState (Time start, Time duration, enum WifiPhy::State state)
+{
+  WifiPhyStateHelper::StateRecord record;
+  record.start = start;
+  record.duration = duration;
+  record.state = state;
+  m_traced.push_back (record);
+}
+
+void
+PhyStateHistoryTestCase::SwitchToTx (Ptr<WifiPhyStateHelper> helper, Time duration)
+{
+  helper->SwitchToTx (duration, Create<Packet> (), WifiPhy::GetOfdmRate6Mbps (), WIFI_PREAMBLE_LONG, 0);
+}
+
+void
+PhyStateHistoryTestCase::DoRun (void)
+{
+  Ptr<WifiPhyStateHelper> helper = CreateObject<WifiPhyStateHelper> ();
+  helper->TraceConnectWithoutContext ("State", MakeCallback (&PhyStateHistoryTestCase::LogState, this));
+
+  // enough transitions to wrap the ring around
+  uint32_t n = WifiPhyStateHelper::STATE_HISTORY_SIZE;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Simulator::Schedule (MilliSeconds (10 * i + 1), &WifiPhyStateHelper::SwitchMaybeToCcaBusy, helper, MilliSeconds (2));
+      Simulator::Schedule (MilliSeconds (10 * i + 2), &PhyStateHistoryTestCase::SwitchToTx, this, helper, MilliSeconds (3));
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_GT (m_traced.size (), WifiPhyStateHelper::STATE_HISTORY_SIZE, "Ring did not wrap around");
+  NS_TEST_ASSERT_MSG_EQ (helper->GetStateHistorySize (), WifiPhyStateHelper::STATE_HISTORY_SIZE, "Ring should be full");
+  uint32_t offset = m_traced.size () - helper->GetStateHistorySize ();
+  for (uint32_t i = 0; i < helper->GetStateHistorySize (); i++)
+    {
+      const WifiPhyStateHelper::StateRecord &record = helper->GetStateHistory (i);
+      NS_TEST_ASSERT_MSG_EQ (record.start, m_traced[offset + i].start, "Start mismatch at " << i);
+      NS_TEST_ASSERT_MSG_EQ (record.duration, m_traced[offset + i].duration, "Duration mismatch at " << i);
+      NS_TEST_ASSERT_MSG_EQ (record.state, m_traced[offset + i].state, "State mismatch at " << i);
+    }
+  const WifiPhyStateHelper::StateRecord &last = helper->GetStateHistory (helper->GetStateHistorySize () - 1);
+  NS_TEST_ASSERT_MSG_EQ (last.state, WifiPhy::TX, "Last interval should be the last transmission");
+  NS_TEST_ASSERT_MSG_EQ (last.start, MilliSeconds (10 * (n - 1) + 2), "Wrong start of the last transmission");
+}
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -446,7 +954,13 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new WifiTest, TestCase::QUICK);
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); // Bug 991
+  // the test cases which draw random numbers come after Bug 555, whose
+  // expected times depend on the streams assigned to its devices
   AddTestCase (new Bug555TestCase, TestCase::QUICK); // Bug 555
+  AddTestCase (new BeaconJitterTestCase, TestCase::QUICK);
+  AddTestCase (new WifiMacHeaderRoundTripTest, TestCase::QUICK);
+  AddTestCase (new PerAcQueueTestCase, TestCase::QUICK);
+  AddTestCase (new PhyStateHistoryTestCase, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measure the cost of the int64x64_t operations behind the Time
+ * arithmetic: the products and quotients of integers (Time * int,
+ * Time / Time), of an integer and a fraction (Time * double) and of two
+ * fractions, and the unit conversions (GetSeconds, Seconds (double),
+ * MicroSeconds (int64x64_t)).
+ *
+ * The program measures the implementation selected at configuration
+ * time; compare the implementations by running it in builds configured
+ * with the default (128-bit integer), --int64x64-as-cairo and
+ * --int64x64-as-double options.
+ */
+
+#include "ns3/int64x64.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/command-line.h"
+#include "ns3/core-config.h"
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+static const uint32_t VALUES = 1024;
+
+static void
+Print (char const *name, uint32_t n, uint64_t deltaMs)
+{
+  double ns = deltaMs;
+  ns *= 1000000;
+  ns /= n;
+  std::cout << name << "\t" << ns << " ns/op"
+            << " (" << deltaMs << " ms elapsed)" << std::endl;
+}
+
+static uint64_t
+BenchMul (const std::vector<int64x64_t> &a, const std::vector<int64x64_t> &b,
+          uint32_t n, int64x64_t *sink)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      *sink += a[i % VALUES] * b[i % VALUES];
+    }
+  return time.End ();
+}
+
+static uint64_t
+BenchDiv (const std::vector<int64x64_t> &a, const std::vector<int64x64_t> &b,
+          uint32_t n, int64x64_t *sink)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      *sink += a[i % VALUES] / b[i % VALUES];
+    }
+  return time.End ();
+}
+
+static uint64_t
+BenchGetSeconds (const std::vector<Time> &t, uint32_t n, double *sink)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      *sink += t[i % VALUES].GetSeconds ();
+    }
+  return time.End ();
+}
+
+static uint64_t
+BenchSeconds (const std::vector<double> &d, uint32_t n, Time *sink)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      *sink += Seconds (d[i % VALUES]);
+    }
+  return time.End ();
+}
+
+static uint64_t
+BenchMicroSeconds (const std::vector<int64x64_t> &us, uint32_t n, Time *sink)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      *sink += MicroSeconds (us[i % VALUES]);
+    }
+  return time.End ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 10000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("n", "number of operations of each kind", n);
+  cmd.Parse (argc, argv);
+
+#if defined (INT64X64_USE_128)
+  std::cout << "implementation: 128-bit integer" << std::endl;
+#elif defined (INT64X64_USE_CAIRO)
+  std::cout << "implementation: cairo 128-bit integer" << std::endl;
+#elif defined (INT64X64_USE_DOUBLE)
+  std::cout << "implementation: long double" << std::endl;
+#endif
+
+  // integers such as times in nanoseconds, small integers such as
+  // packet sizes and fractions such as scale factors
+  std::vector<int64x64_t> times, sizes, fractions, micro;
+  std::vector<Time> t;
+  std::vector<double> seconds;
+  for (uint32_t i = 0; i < VALUES; i++)
+    {
+      int64_t ns = 1000000 + 7919 * (int64_t)i;
+      times.push_back (int64x64_t (ns));
+      sizes.push_back (int64x64_t (40 + (int64_t)i));
+      fractions.push_back (int64x64_t (0.5 + i / (2.0 * VALUES)));
+      micro.push_back (int64x64_t (i / 3.0));
+      t.push_back (NanoSeconds (ns));
+      seconds.push_back (ns / 1e9);
+    }
+
+  // measure the Time operations as in a running simulation, without the
+  // recording of the Time instances done before Simulator::Run
+  Simulator::Run ();
+
+  int64x64_t sink = 0;
+  double dsink = 0;
+  Time tsink;
+  Print ("integer * integer", n, BenchMul (times, sizes, n, &sink));
+  Print ("integer * fraction", n, BenchMul (times, fractions, n, &sink));
+  Print ("fraction * fraction", n, BenchMul (fractions, fractions, n, &sink));
+  Print ("integer / integer", n, BenchDiv (times, sizes, n, &sink));
+  Print ("fraction / integer", n, BenchDiv (fractions, sizes, n, &sink));
+  Print ("integer / fraction", n, BenchDiv (times, fractions, n, &sink));
+  Print ("Time::GetSeconds", n, BenchGetSeconds (t, n, &dsink));
+  Print ("Seconds (double)", n, BenchSeconds (seconds, n, &tsink));
+  Print ("MicroSeconds (int64x64_t)", n, BenchMicroSeconds (micro, n, &tsink));
+  // keep the operations from being optimized out
+  std::cout << "sums " << sink << " " << dsink << " " << tsink << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measure the cost of the per-hop route lookups done by the mesh
+ * routing protocols.  Every mesh point of an x-by-y grid gets a
+ * routing table with a route to every other mesh point (XY routing),
+ * then n frames are forwarded hop by hop between random pairs of
+ * mesh points, with one routing table lookup per hop.
+ */
+
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/command-line.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/nstime.h"
+#include "ns3/hwmp-rtable.h"
+#include "ns3/flame-rtable.h"
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+using namespace ns3::dot11s;
+
+static uint32_t g_xSize = 20;
+static uint32_t g_ySize = 20;
+static std::vector<Mac48Address> g_addresses;
+
+/* Next hop from (x, y) towards (dx, dy): first along x, then along y. */
+static uint32_t
+NextHop (uint32_t from, uint32_t to)
+{
+  uint32_t x = from % g_xSize;
+  uint32_t y = from / g_xSize;
+  uint32_t dx = to % g_xSize;
+  uint32_t dy = to / g_xSize;
+  if (x != dx)
+    {
+      x += (x < dx) ? 1 : -1;
+    }
+  else
+    {
+      y += (y < dy) ? 1 : -1;
+    }
+  return y * g_xSize + x;
+}
+
+static uint64_t
+BenchHwmp (uint32_t n, Ptr<UniformRandomVariable> rng)
+{
+  uint32_t nNodes = g_xSize * g_ySize;
+  std::vector<Ptr<HwmpRtable> > tables;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<HwmpRtable> table = CreateObject<HwmpRtable> ();
+      for (uint32_t j = 0; j < nNodes; j++)
+        {
+          if (i != j)
+            {
+              table->AddReactivePath (g_addresses[j], g_addresses[NextHop (i, j)], 1, 1, Seconds (100), 1);
+            }
+        }
+      tables.push_back (table);
+    }
+
+  uint64_t hops = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t k = 0; k < n; k++)
+    {
+      uint32_t current = rng->GetInteger (0, nNodes - 1);
+      uint32_t to = rng->GetInteger (0, nNodes - 1);
+      while (current != to)
+        {
+          HwmpRtable::LookupResult result = tables[current]->LookupReactive (g_addresses[to]);
+          NS_ASSERT (result.IsValid ());
+          // the retransmitter must be the next hop on the XY path
+          current = NextHop (current, to);
+          NS_ASSERT (result.retransmitter == g_addresses[current]);
+          hops++;
+        }
+    }
+  uint64_t deltaMs = time.End ();
+  std::cout << "HwmpRtable: " << hops << " hops in " << deltaMs << " ms, "
+            << (hops > 0 ? deltaMs * 1e6 / hops : 0) << " ns/hop" << std::endl;
+  return hops;
+}
+
+static uint64_t
+BenchFlame (uint32_t n, Ptr<UniformRandomVariable> rng)
+{
+  uint32_t nNodes = g_xSize * g_ySize;
+  std::vector<Ptr<FlameRtable> > tables;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<FlameRtable> table = CreateObject<FlameRtable> ();
+      for (uint32_t j = 0; j < nNodes; j++)
+        {
+          if (i != j)
+            {
+              table->AddPath (g_addresses[j], g_addresses[NextHop (i, j)], 1, 1, 1);
+            }
+        }
+      tables.push_back (table);
+    }
+
+  uint64_t hops = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t k = 0; k < n; k++)
+    {
+      uint32_t current = rng->GetInteger (0, nNodes - 1);
+      uint32_t to = rng->GetInteger (0, nNodes - 1);
+      while (current != to)
+        {
+          FlameRtable::LookupResult result = tables[current]->Lookup (g_addresses[to]);
+          NS_ASSERT (result.IsValid ());
+          current = NextHop (current, to);
+          NS_ASSERT (result.retransmitter == g_addresses[current]);
+          hops++;
+        }
+    }
+  uint64_t deltaMs = time.End ();
+  std::cout << "FlameRtable: " << hops << " hops in " << deltaMs << " ms, "
+            << (hops > 0 ? deltaMs * 1e6 / hops : 0) << " ns/hop" << std::endl;
+  return hops;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 100000;
+
+  CommandLine cmd;
+  cmd.AddValue ("n", "Number of frames to forward", n);
+  cmd.AddValue ("x-size", "Number of mesh points in a row", g_xSize);
+  cmd.AddValue ("y-size", "Number of rows in the grid", g_ySize);
+  cmd.Parse (argc, argv);
+
+  for (uint32_t i = 0; i < g_xSize * g_ySize; i++)
+    {
+      g_addresses.push_back (Mac48Address::Allocate ());
+    }
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+
+  std::cout << "Forwarding " << n << " frames on a " << g_xSize << "x" << g_ySize << " grid" << std::endl;
+  BenchHwmp (n, rng);
+  BenchFlame (n, rng);
+
+  return 0;
+}
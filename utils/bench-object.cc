@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measure the cost of Object::GetObject as a function of the number of
+ * objects aggregated together, for a lookup which succeeds on the first
+ * object, a lookup which succeeds on the last aggregated object and a
+ * lookup which fails.
+ */
+
+#include "ns3/object.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/command-line.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace ns3;
+
+template <int N>
+class BenchObject : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+private:
+  static std::string GetTypeName (void);
+};
+
+template <int N>
+std::string
+BenchObject<N>::GetTypeName (void)
+{
+  std::ostringstream oss;
+  oss << "ns3::BenchObject<" << N << ">";
+  return oss.str ();
+}
+
+template <int N>
+TypeId
+BenchObject<N>::GetTypeId (void)
+{
+  static TypeId tid = TypeId (GetTypeName ().c_str ())
+    .SetParent<Object> ()
+    .AddConstructor<BenchObject<N> > ()
+  ;
+  return tid;
+}
+
+static Ptr<Object>
+CreateBenchObject (uint32_t i)
+{
+  switch (i)
+    {
+    case 0: return CreateObject<BenchObject<0> > ();
+    case 1: return CreateObject<BenchObject<1> > ();
+    case 2: return CreateObject<BenchObject<2> > ();
+    case 3: return CreateObject<BenchObject<3> > ();
+    case 4: return CreateObject<BenchObject<4> > ();
+    case 5: return CreateObject<BenchObject<5> > ();
+    case 6: return CreateObject<BenchObject<6> > ();
+    case 7: return CreateObject<BenchObject<7> > ();
+    case 8: return CreateObject<BenchObject<8> > ();
+    case 9: return CreateObject<BenchObject<9> > ();
+    case 10: return CreateObject<BenchObject<10> > ();
+    case 11: return CreateObject<BenchObject<11> > ();
+    case 12: return CreateObject<BenchObject<12> > ();
+    case 13: return CreateObject<BenchObject<13> > ();
+    case 14: return CreateObject<BenchObject<14> > ();
+    default: return CreateObject<BenchObject<15> > ();
+    }
+}
+
+template <typename T>
+static uint64_t
+BenchLookup (Ptr<Object> object, uint32_t n, uint32_t *found)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (object->GetObject<T> () != 0)
+        {
+          (*found)++;
+        }
+    }
+  return time.End ();
+}
+
+static void
+Print (uint32_t size, char const *name, uint32_t n, uint64_t deltaMs)
+{
+  double ns = deltaMs;
+  ns *= 1000000;
+  ns /= n;
+  std::cout << size << "\t" << name << "\t" << ns << " ns/lookup"
+            << " (" << deltaMs << " ms elapsed)" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 10000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("n", "number of lookups of each kind", n);
+  cmd.Parse (argc, argv);
+
+  std::cout << "aggregates\tlookup\tcost" << std::endl;
+  uint32_t found = 0;
+  uint32_t sizes[] = { 1, 2, 4, 8, 16 };
+  for (uint32_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++)
+    {
+      uint32_t size = sizes[i];
+      // BenchObject<15> is always the last aggregate and BenchObject<16>
+      // is never aggregated.
+      Ptr<Object> object = CreateBenchObject (0);
+      for (uint32_t j = 1; j < size - 1; j++)
+        {
+          object->AggregateObject (CreateBenchObject (j));
+        }
+      if (size > 1)
+        {
+          object->AggregateObject (CreateBenchObject (15));
+        }
+      Print (size, "first", n, BenchLookup<BenchObject<0> > (object, n, &found));
+      Print (size, "last", n, BenchLookup<BenchObject<15> > (object, n, &found));
+      Print (size, "missing", n, BenchLookup<BenchObject<16> > (object, n, &found));
+      object->Dispose ();
+    }
+  // keep the lookups from being optimized out
+  std::cout << "found " << found << std::endl;
+  return 0;
+}
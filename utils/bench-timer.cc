@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measure the cost of rescheduling timers which seldom expire, such as
+ * the retransmission timers of many TCP connections: every ten
+ * microseconds, one of the timers is cancelled and scheduled again with a
+ * 200 ms timeout, with the timers either scheduled in the simulator event
+ * list or held in a timer wheel.  With the event list, the cancelled
+ * events are removed from it right away, compacted away, or left in it
+ * until they come up, depending on the scheduler and on the "cancel"
+ * option.
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/timer.h"
+#include "ns3/nstime.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/command-line.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+static std::vector<Timer *> g_timers;
+static uint32_t g_rearms;
+static uint32_t g_expired = 0;
+
+static void
+Expire (void)
+{
+  g_expired++;
+}
+
+static void
+Rearm (uint32_t i)
+{
+  Timer *timer = g_timers[i % g_timers.size ()];
+  timer->Cancel ();
+  timer->Schedule ();
+  if (i + 1 < g_rearms)
+    {
+      Simulator::Schedule (MicroSeconds (10), &Rearm, i + 1);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 10000;
+  bool wheel = true;
+  std::string scheduler = "ns3::MapScheduler";
+  std::string cancel = "remove";
+  double threshold = 0.75;
+  g_rearms = 10000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("timers", "number of timers", n);
+  cmd.AddValue ("rearms", "number of times a timer is rescheduled", g_rearms);
+  cmd.AddValue ("wheel", "hold the timers in a timer wheel", wheel);
+  cmd.AddValue ("scheduler", "the simulator event list", scheduler);
+  cmd.AddValue ("cancel", "what becomes of the cancelled events: remove, compact or keep", cancel);
+  cmd.AddValue ("threshold", "the fraction of cancelled events which triggers a compaction", threshold);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::RemoveCancelledEvents", BooleanValue (cancel == "remove"));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::CompactionThreshold", DoubleValue (cancel == "keep" ? 1.0 : threshold));
+  ObjectFactory factory;
+  factory.SetTypeId (scheduler);
+  Simulator::SetScheduler (factory);
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Timer *timer = new Timer (Timer::CANCEL_ON_DESTROY, wheel ? Timer::SCHEDULE_WHEEL : Timer::SCHEDULE_EVENT);
+      timer->SetFunction (&Expire);
+      timer->SetDelay (MilliSeconds (200));
+      g_timers.push_back (timer);
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Schedule (MicroSeconds (10), &Rearm, 0);
+  Simulator::Run ();
+  uint64_t deltaMs = time.End ();
+  double ns = deltaMs;
+  ns *= 1000000;
+  ns /= g_rearms;
+  std::cout << (wheel ? "wheel" : "event") << "\t" << ns << " ns/rearm"
+            << " (" << deltaMs << " ms elapsed, " << g_expired << " expired)" << std::endl;
+  Ptr<DefaultSimulatorImpl> impl = DynamicCast<DefaultSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      DefaultSimulatorImpl::CancelStats stats = impl->GetCancelStats ();
+      std::cout << "cancelled " << stats.cancelled << ", removed " << stats.removed
+                << ", compacted " << stats.compacted << " in " << stats.compactions
+                << " compactions" << std::endl;
+    }
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      delete g_timers[i];
+    }
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measure the time taken to build a large point-to-point topology before
+ * the simulation starts: the creation of the nodes, the installation of
+ * the internet stack, the creation of the links and the assignment of one
+ * /30 network per link.  The links are either created one at a time, as
+ * the topology-read examples do, or in bulk with
+ * PointToPointHelper::InstallLinks and Ipv4AddressHelper::AssignNetworks.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+static void
+Print (char const *phase, uint32_t n, uint64_t deltaMs)
+{
+  double us = deltaMs;
+  us *= 1000;
+  us /= n;
+  std::cout << phase << "\t" << deltaMs << " ms\t" << us << " us/item" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 10000;
+  uint32_t nLinks = 30000;
+  bool bulk = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("nodes", "number of nodes", nNodes);
+  cmd.AddValue ("links", "number of links", nLinks);
+  cmd.AddValue ("bulk", "create the links and assign their addresses in bulk", bulk);
+  cmd.Parse (argc, argv);
+
+  SystemWallClockMs time;
+  time.Start ();
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  Print ("nodes", nNodes, time.End ());
+
+  time.Start ();
+  InternetStackHelper stack;
+  stack.SetIpv6StackInstall (false);
+  stack.Install (nodes);
+  Print ("stack", nNodes, time.End ());
+
+  // a ring, plus random chords
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  NodeContainer from, to;
+  for (uint32_t i = 0; i < nLinks; i++)
+    {
+      uint32_t a = i % nNodes;
+      uint32_t b = (i < nNodes) ? (i + 1) % nNodes : random->GetInteger (0, nNodes - 1);
+      if (a == b)
+        {
+          b = (b + 1) % nNodes;
+        }
+      from.Add (nodes.Get (a));
+      to.Add (nodes.Get (b));
+    }
+
+  PointToPointHelper p2p;
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.255.252");
+  if (bulk)
+    {
+      time.Start ();
+      p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+      p2p.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+      NetDeviceContainer devices = p2p.InstallLinks (from, to);
+      Print ("links", nLinks, time.End ());
+
+      time.Start ();
+      address.AssignNetworks (devices, 2);
+      Print ("addresses", nLinks, time.End ());
+    }
+  else
+    {
+      time.Start ();
+      std::vector<NetDeviceContainer> devices (nLinks);
+      for (uint32_t i = 0; i < nLinks; i++)
+        {
+          p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+          p2p.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+          devices[i] = p2p.Install (from.Get (i), to.Get (i));
+        }
+      Print ("links", nLinks, time.End ());
+
+      time.Start ();
+      for (uint32_t i = 0; i < nLinks; i++)
+        {
+          address.Assign (devices[i]);
+          address.NewNetwork ();
+        }
+      Print ("addresses", nLinks, time.End ());
+    }
+
+  time.Start ();
+  Simulator::Destroy ();
+  Print ("destroy", nNodes, time.End ());
+
+  return 0;
+}
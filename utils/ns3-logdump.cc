@@ -0,0 +1,47 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Print the messages of a log ring buffer, written by a program run
+ * with NS_LOG_RING_BUFFER=file, as they would have been printed on
+ * std::clog:
+ *
+ *   ./waf --run "ns3-logdump --file=log.bin"
+ */
+
+#include "ns3/log.h"
+#include "ns3/command-line.h"
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string file;
+
+  CommandLine cmd;
+  cmd.AddValue ("file", "the log ring buffer to print", file);
+  cmd.Parse (argc, argv);
+
+  if (file.empty ())
+    {
+      std::cerr << "usage: ns3-logdump --file=<log ring buffer>" << std::endl;
+      return 1;
+    }
+  LogRingBufferDump (file.c_str (), std::cout);
+  return 0;
+}